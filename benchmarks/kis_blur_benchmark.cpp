@@ -37,6 +37,16 @@
 #include "kis_selection.h"
 #include <kis_iterator_ng.h>
 
+#include "kis_convolution_painter.h"
+#include "kis_convolution_kernel.h"
+#include "kis_gaussian_kernel.h"
+
+#include "config_convolution.h"
+
+#ifdef HAVE_FFTW3
+#include "kis_fftw_plan_cache.h"
+#endif
+
 void KisBlurBenchmark::initTestCase()
 {
     m_colorSpace = KoColorSpaceRegistry::instance()->rgb8();    
@@ -87,6 +97,81 @@ void KisBlurBenchmark::benchmarkFilter()
     }
 }
 
+void KisBlurBenchmark::benchmarkConvolution_data()
+{
+    QTest::addColumn<int>("engine");
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("spatial") << int(KisConvolutionPainter::SPATIAL) << 1;
+
+#ifdef HAVE_FFTW3
+    QTest::newRow("fft-single") << int(KisConvolutionPainter::FFTW) << 1;
+    QTest::newRow("fft-parallel") << int(KisConvolutionPainter::FFTW) << QThread::idealThreadCount();
+#endif
+}
+
+void KisBlurBenchmark::benchmarkConvolution()
+{
+    QFETCH(int, engine);
+    QFETCH(int, numThreads);
+
+    const qreal radius = 8.0;
+
+    Matrix<qreal, Dynamic, Dynamic> matrix =
+        KisGaussianKernel::createVerticalMatrix(radius) *
+        KisGaussianKernel::createHorizontalMatrix(radius);
+
+    KisConvolutionKernelSP kernel =
+        KisConvolutionKernel::fromMatrix(matrix, 0, matrix.sum());
+
+#ifdef HAVE_FFTW3
+    const int oldNumThreads = KisFFTWPlanCache::instance()->maxThreads();
+    KisFFTWPlanCache::instance()->setMaxThreads(numThreads);
+#else
+    Q_UNUSED(numThreads);
+#endif
+
+    const QRect rc(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+    KisPaintDeviceSP dst = new KisPaintDevice(m_colorSpace);
+
+    QBENCHMARK{
+        KisConvolutionPainter gc(dst, KisConvolutionPainter::TestingEnginePreference(engine));
+        gc.applyMatrix(kernel, m_device, rc.topLeft(), rc.topLeft(), rc.size());
+    }
+
+#ifdef HAVE_FFTW3
+    KisFFTWPlanCache::instance()->setMaxThreads(oldNumThreads);
+#endif
+}
+
+void KisBlurBenchmark::benchmarkGaussian_data()
+{
+    QTest::addColumn<int>("engine");
+    QTest::addColumn<qreal>("radius");
+
+    const QList<qreal> radii = QList<qreal>() << 5.0 << 20.0 << 100.0;
+
+    Q_FOREACH (qreal radius, radii) {
+        QTest::newRow(QString("kernel-r%1").arg(radius).toLatin1())
+            << int(KisGaussianKernel::CONVOLUTION) << radius;
+        QTest::newRow(QString("recursive-r%1").arg(radius).toLatin1())
+            << int(KisGaussianKernel::RECURSIVE) << radius;
+    }
+}
+
+void KisBlurBenchmark::benchmarkGaussian()
+{
+    QFETCH(int, engine);
+    QFETCH(qreal, radius);
+
+    const QRect rc(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+
+    QBENCHMARK{
+        KisPaintDeviceSP dev = new KisPaintDevice(*m_device);
+        KisGaussianKernel::applyGaussian(dev, rc, radius, radius, QBitArray(), 0,
+                                         KisGaussianKernel::Engine(engine));
+    }
+}
 
 
 QTEST_MAIN(KisBlurBenchmark)
@@ -39,6 +39,12 @@ private Q_SLOTS:
     void cleanupTestCase();
     
     void benchmarkFilter();
+
+    void benchmarkConvolution_data();
+    void benchmarkConvolution();
+
+    void benchmarkGaussian_data();
+    void benchmarkGaussian();
     
 };
 
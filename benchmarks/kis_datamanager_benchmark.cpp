@@ -20,6 +20,8 @@
 #include "kis_benchmark_values.h"
 
 #include <QTest>
+#include <QThreadPool>
+#include <QRunnable>
 #include <kis_datamanager.h>
 
 // RGBA
@@ -198,5 +200,94 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+/**
+ * Emulates several updater threads walking over the same layer. Every
+ * job requests all the tiles of the image (both for reading and for
+ * writing), so the run time is dominated by the contention on the tile
+ * hash table of the data manager.
+ */
+class KisConcurrentTileAccessJob : public QRunnable
+{
+public:
+    KisConcurrentTileAccessJob(KisDataManager &dm, qint32 firstRow, qint32 numCycles)
+        : m_dm(dm), m_firstRow(firstRow), m_numCycles(numCycles)
+    {
+    }
+
+    void run() {
+        const qint32 numCols = TEST_IMAGE_WIDTH / KisTileData::WIDTH;
+        const qint32 numRows = TEST_IMAGE_HEIGHT / KisTileData::HEIGHT;
+
+        for (qint32 i = 0; i < m_numCycles; i++) {
+            for (qint32 j = 0; j < numRows; j++) {
+                const qint32 row = (m_firstRow + j) % numRows;
+
+                for (qint32 col = 0; col < numCols; col++) {
+                    KisTileSP tile = m_dm.getTile(col, row, (col + i) & 0x1);
+                    Q_UNUSED(tile);
+                }
+            }
+        }
+    }
+
+private:
+    KisDataManager &m_dm;
+    qint32 m_firstRow;
+    qint32 m_numCycles;
+};
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+    QTest::newRow("16 threads") << 16;
+    QTest::newRow("32 threads") << 32;
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess()
+{
+    QFETCH(int, numThreads);
+
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    quint8 *bytes = new quint8[PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT];
+    memset(bytes, 128, PIXEL_SIZE * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT);
+    dm.writeBytes(bytes, 0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+    delete[] bytes;
+
+    /**
+     * The total amount of work is constant, so in the ideal case the
+     * time should decrease linearly with the number of threads
+     */
+    const qint32 totalCycles = 64;
+    const qint32 numRows = TEST_IMAGE_HEIGHT / KisTileData::HEIGHT;
+
+    QList<KisConcurrentTileAccessJob*> jobs;
+    for (int i = 0; i < numThreads; i++) {
+        KisConcurrentTileAccessJob *job =
+            new KisConcurrentTileAccessJob(dm, i * numRows / numThreads,
+                                           totalCycles / numThreads);
+        job->setAutoDelete(false);
+        jobs.append(job);
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        Q_FOREACH (KisConcurrentTileAccessJob *job, jobs) {
+            pool.start(job);
+        }
+        pool.waitForDone();
+    }
+
+    qDeleteAll(jobs);
+}
 
 QTEST_MAIN(KisDatamanagerBenchmark)
@@ -36,6 +36,8 @@ private Q_SLOTS:
     void benchmarkExtent();
     void benchmarkClear();
     void benchmarkMemCpy();
+    void benchmarkConcurrentTileAccess_data();
+    void benchmarkConcurrentTileAccess();
 };
 
 #endif
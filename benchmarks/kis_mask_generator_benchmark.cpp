@@ -37,6 +37,15 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_cubic_curve.h"
+#include "kis_fixed_paint_device.h"
+#include "kis_brush_mask_applicator_base.h"
+
+#include <KoColorSpaceRegistry.h>
 
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
@@ -83,4 +92,82 @@ void KisMaskGeneratorBenchmark::benchmarkSquare()
     }
 }
 
+enum GeneratorType {
+    CIRCLE,
+    RECT,
+    GAUSS_CIRCLE,
+    GAUSS_RECT,
+    CURVE_CIRCLE,
+    CURVE_RECT
+};
+
+static KisMaskGenerator* createGenerator(int type, qreal diameter)
+{
+    switch (type) {
+    case CIRCLE:
+        return new KisCircleMaskGenerator(diameter, 1.0, 0.5, 0.5, 2, true);
+    case RECT:
+        return new KisRectangleMaskGenerator(diameter, 1.0, 0.5, 0.5, 2, true);
+    case GAUSS_CIRCLE:
+        return new KisGaussCircleMaskGenerator(diameter, 1.0, 0.5, 0.5, 2, true);
+    case GAUSS_RECT:
+        return new KisGaussRectangleMaskGenerator(diameter, 1.0, 0.5, 0.5, 2, true);
+    case CURVE_CIRCLE:
+        return new KisCurveCircleMaskGenerator(diameter, 1.0, 0.5, 0.5, 2, KisCubicCurve(), true);
+    case CURVE_RECT:
+        return new KisCurveRectangleMaskGenerator(diameter, 1.0, 0.5, 0.5, 2, KisCubicCurve(), true);
+    }
+
+    return 0;
+}
+
+void KisMaskGeneratorBenchmark::benchmarkApplicator_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("numThreads");
+
+    const int numThreads = QThread::idealThreadCount();
+
+    QTest::newRow("circle-single") << int(CIRCLE) << 1;
+    QTest::newRow("circle-parallel") << int(CIRCLE) << numThreads;
+    QTest::newRow("rect-single") << int(RECT) << 1;
+    QTest::newRow("rect-parallel") << int(RECT) << numThreads;
+    QTest::newRow("gauss-circle-single") << int(GAUSS_CIRCLE) << 1;
+    QTest::newRow("gauss-circle-parallel") << int(GAUSS_CIRCLE) << numThreads;
+    QTest::newRow("gauss-rect-single") << int(GAUSS_RECT) << 1;
+    QTest::newRow("gauss-rect-parallel") << int(GAUSS_RECT) << numThreads;
+    QTest::newRow("curve-circle-single") << int(CURVE_CIRCLE) << 1;
+    QTest::newRow("curve-circle-parallel") << int(CURVE_CIRCLE) << numThreads;
+    QTest::newRow("curve-rect-single") << int(CURVE_RECT) << 1;
+    QTest::newRow("curve-rect-parallel") << int(CURVE_RECT) << numThreads;
+}
+
+void KisMaskGeneratorBenchmark::benchmarkApplicator()
+{
+    QFETCH(int, type);
+    QFETCH(int, numThreads);
+
+    const qreal diameter = 1000;
+    QScopedPointer<KisMaskGenerator> gen(createGenerator(type, diameter));
+    gen->setScale(1.0, 1.0);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rc(0, 0, diameter, diameter);
+
+    KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+    dev->setRect(rc);
+    dev->initialize(255);
+
+    MaskProcessingData data(dev, cs, 0.0, 1.0,
+                            0.5 * rc.width(), 0.5 * rc.height(),
+                            0.0);
+
+    KisBrushMaskApplicatorBase *applicator = gen->applicator();
+    applicator->initializeData(&data);
+
+    QBENCHMARK{
+        applicator->processInBands(rc, numThreads);
+    }
+}
+
 QTEST_MAIN(KisMaskGeneratorBenchmark)
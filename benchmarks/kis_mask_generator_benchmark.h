@@ -28,6 +28,9 @@ private Q_SLOTS:
     void benchmarkCircle();
     void benchmarkSIMD();
     void benchmarkSquare();
+
+    void benchmarkApplicator_data();
+    void benchmarkApplicator();
     
 };
 
@@ -27,6 +27,10 @@
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <KisPart.h>
+#include <kis_image_config.h>
+#include <kis_paint_layer.h>
+#include <kis_simple_update_queue.h>
+#include <KoColorSpaceRegistry.h>
 
 void KisProjectionBenchmark::initTestCase()
 {
@@ -58,5 +62,78 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+void KisProjectionBenchmark::benchmarkProjectionThreads_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+    QTest::newRow("16 threads") << 16;
+    QTest::newRow("32 threads") << 32;
+}
+
+void KisProjectionBenchmark::benchmarkProjectionThreads()
+{
+    QFETCH(int, numThreads);
+
+    KisImageConfig config;
+    const int oldNumThreads = config.maxNumberOfThreads();
+    config.setMaxNumberOfThreads(numThreads);
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->loadNativeFormat(QString(FILES_DATA_DIR) + QDir::separator() + "load_test.kra");
+
+    KisImageSP image = doc->image();
+    image->waitForDone();
+
+    QBENCHMARK {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    image = 0;
+    delete doc;
+
+    config.setMaxNumberOfThreads(oldNumThreads);
+}
+
+/**
+ * Pushes 10k tiny updates (like the ones generated by a brush
+ * with a small dab) through the updates queue and dispatches them
+ * into the updater context. The jobs themselves are not executed,
+ * so only the queueing and the conflict checks are measured.
+ */
+void KisProjectionBenchmark::benchmarkUpdateQueueStress()
+{
+    const QRect imageRect(0, 0, 2000, 2000);
+    const QRect tinyRect(0, 0, 3, 3);
+    const int step = 20;
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "stress test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->lock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QBENCHMARK {
+        KisTestableSimpleUpdateQueue queue;
+        KisTestableUpdaterContext context(8);
+
+        for (int y = 0; y < imageRect.height(); y += step) {
+            for (int x = 0; x < imageRect.width(); x += step) {
+                queue.addUpdateJob(paintLayer, tinyRect.translated(x, y), imageRect, 0);
+            }
+        }
+
+        while (!queue.isEmpty()) {
+            queue.processQueue(context);
+            context.clear();
+        }
+    }
+}
 
 QTEST_MAIN(KisProjectionBenchmark)
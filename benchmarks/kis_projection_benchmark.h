@@ -32,6 +32,11 @@ private Q_SLOTS:
 
     void benchmarkProjection();
     void benchmarkLoading();
+
+    void benchmarkProjectionThreads_data();
+    void benchmarkProjectionThreads();
+
+    void benchmarkUpdateQueueStress();
 };
 
 #endif
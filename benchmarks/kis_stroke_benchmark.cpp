@@ -27,6 +27,7 @@ inline double drand48()
 #endif
 
 #include <QTest>
+#include <QDomDocument>
 
 #include "kis_stroke_benchmark.h"
 #include "kis_benchmark_values.h"
@@ -48,6 +49,7 @@ inline double drand48()
 #define GMP_IMAGE_HEIGHT 2067
 #include <kis_painter.h>
 #include <brushengine/kis_paintop_registry.h>
+#include <kis_image_config.h>
 
 //#define SAVE_OUTPUT
 
@@ -138,6 +140,36 @@ void KisStrokeBenchmark::pixelbrush300px()
     benchmarkStroke(presetFileName);
 }
 
+void KisStrokeBenchmark::autobrushSoft1000px()
+{
+    benchmarkBigAutoBrush(1000, "default", false);
+}
+
+void KisStrokeBenchmark::autobrushSoft1000pxParallel()
+{
+    benchmarkBigAutoBrush(1000, "default", true);
+}
+
+void KisStrokeBenchmark::autobrushGaussian1000px()
+{
+    benchmarkBigAutoBrush(1000, "gauss", false);
+}
+
+void KisStrokeBenchmark::autobrushGaussian1000pxParallel()
+{
+    benchmarkBigAutoBrush(1000, "gauss", true);
+}
+
+void KisStrokeBenchmark::autobrushGaussian2000px()
+{
+    benchmarkBigAutoBrush(2000, "gauss", false);
+}
+
+void KisStrokeBenchmark::autobrushGaussian2000pxParallel()
+{
+    benchmarkBigAutoBrush(2000, "gauss", true);
+}
+
 void KisStrokeBenchmark::pixelbrush300pxRL()
 {
     QString presetFileName = "autobrush_300px.kpp";
@@ -487,6 +519,45 @@ void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
 #endif
 }
 
+void KisStrokeBenchmark::benchmarkBigAutoBrush(int diameter, const QString &generatorId, bool parallelDabs)
+{
+    QString presetFileName = "autobrush_300px.kpp";
+    KisPaintOpPresetSP preset = new KisPaintOpPreset(m_dataPath + presetFileName);
+    bool loadedOk = preset->load();
+    KIS_ASSERT_RECOVER_RETURN(loadedOk);
+    KIS_ASSERT_RECOVER_RETURN(preset->settings());
+
+    QDomDocument doc;
+    doc.setContent(preset->settings()->getString("brush_definition"));
+    QDomElement generator = doc.documentElement().firstChildElement("MaskGenerator");
+    KIS_ASSERT_RECOVER_RETURN(!generator.isNull());
+
+    generator.setAttribute("diameter", QString::number(diameter));
+    generator.setAttribute("hfade", QString::number(0.5));
+    generator.setAttribute("vfade", QString::number(0.5));
+    generator.setAttribute("id", generatorId);
+    preset->settings()->setProperty("brush_definition", doc.toString());
+
+    KisImageConfig cfg;
+    const bool oldParallelDabs = cfg.parallelDabRendering();
+    cfg.setParallelDabRendering(parallelDabs);
+
+    // the option is read when the paintop is created
+    m_painter->setPaintOpPreset(preset, m_layer, m_image);
+
+    QBENCHMARK{
+        KisDistanceInformation currentDistance;
+        m_painter->paintBezierCurve(m_pi1, m_c1, m_c1, m_pi2, &currentDistance);
+        m_painter->paintBezierCurve(m_pi2, m_c2, m_c2, m_pi3, &currentDistance);
+    }
+
+    cfg.setParallelDabRendering(oldParallelDabs);
+
+#ifdef SAVE_OUTPUT
+    m_layer->paintDevice()->convertToQImage(0).save(m_outputPath + QString("autobrush_%1_%2px").arg(generatorId).arg(diameter) + OUTPUT_FORMAT);
+#endif
+}
+
 static const int COUNT = 1000000;
 void KisStrokeBenchmark::benchmarkRand48()
 {
@@ -62,6 +62,7 @@ private:
         inline void benchmarkStroke(QString presetFileName);
         inline void benchmarkLine(QString presetFileName);
         inline void benchmarkCircle(QString presetFileName);
+        inline void benchmarkBigAutoBrush(int diameter, const QString &generatorId, bool parallelDabs);
 
 private Q_SLOTS:
     void initTestCase();
@@ -73,6 +74,14 @@ private Q_SLOTS:
     void pixelbrush300px();
     void pixelbrush300pxRL();
 
+    // Big soft autobrush, serial and parallel dab rendering
+    void autobrushSoft1000px();
+    void autobrushSoft1000pxParallel();
+    void autobrushGaussian1000px();
+    void autobrushGaussian1000pxParallel();
+    void autobrushGaussian2000px();
+    void autobrushGaussian2000pxParallel();
+
     // Soft brush benchmarks
     void softbrushDefault30();
     void softbrushDefault30RL();
@@ -4,6 +4,8 @@
 #  FFTW3_FOUND - system has fftw3
 #  FFTW3_INCLUDE_DIRS - the fftw3 include directories
 #  FFTW3_LIBRARIES - the libraries needed to use fftw3
+#  FFTW3_THREADS_FOUND - fftw3 was built with the threads support,
+#                        FFTW3_LIBRARIES contain fftw3_threads then
 # Redistribution and use is allowed according to the terms of the BSD license.
 # For details see the accompanying COPYING-CMAKE-SCRIPTS file.
 #
@@ -28,6 +30,17 @@ libfind_process(FFTW3)
 
 if(FFTW3_FOUND)
     message(STATUS "FFTW Found Version: " ${FFTW_VERSION})
+
+    find_library(FFTW3_THREADS_LIBRARY
+        NAMES fftw3_threads
+        HINTS ${FFTW3_PKGCONF_LIBRARY_DIRS} ${FFTW3_PKGCONF_LIBDIR}
+    )
+
+    if(FFTW3_THREADS_LIBRARY)
+        set(FFTW3_THREADS_FOUND TRUE)
+        set(FFTW3_LIBRARIES ${FFTW3_THREADS_LIBRARY} ${FFTW3_LIBRARIES})
+        message(STATUS "FFTW threads support found: " ${FFTW3_THREADS_LIBRARY})
+    endif()
 endif()
 
 else()
@@ -50,6 +63,8 @@ set (FFTW3_LIBRARIES ${FFTW3_LIBRARY})
 
 if(FFTW3_INCLUDE_DIR AND FFTW3_LIBRARY_DIR)
  set (FFTW3_FOUND true)
+ # the prebuilt windows dlls have the threads support compiled in
+ set (FFTW3_THREADS_FOUND true)
  message(STATUS "Correctly found FFTW3")
 else()
   message(STATUS "Could not find FFTW3")
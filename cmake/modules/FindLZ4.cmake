@@ -0,0 +1,25 @@
+# - Try to find the LZ4 compression library
+# Once done this will define
+#
+#  LZ4_FOUND - system has lz4
+#  LZ4_INCLUDE_DIRS - the lz4 include directories
+#  LZ4_LIBRARIES - the libraries needed to use lz4
+# Redistribution and use is allowed according to the terms of the BSD license.
+# For details see the accompanying COPYING-CMAKE-SCRIPTS file.
+#
+include(LibFindMacros)
+libfind_pkg_check_modules(LZ4_PKGCONF liblz4)
+
+find_path(LZ4_INCLUDE_DIR
+    NAMES lz4.h
+    HINTS ${LZ4_PKGCONF_INCLUDE_DIRS} ${LZ4_PKGCONF_INCLUDEDIR}
+)
+
+find_library(LZ4_LIBRARY
+    NAMES lz4 liblz4
+    HINTS ${LZ4_PKGCONF_LIBRARY_DIRS} ${LZ4_PKGCONF_LIBDIR}
+)
+
+set(LZ4_PROCESS_LIBS LZ4_LIBRARY)
+set(LZ4_PROCESS_INCLUDES LZ4_INCLUDE_DIR)
+libfind_process(LZ4)
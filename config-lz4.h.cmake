@@ -0,0 +1,4 @@
+/* config-lz4.h.  Generated by cmake from config-lz4.h.cmake */
+
+/* Defines if your system has the LZ4 library */
+#cmakedefine HAVE_LZ4 1
@@ -0,0 +1,4 @@
+/* config-tile-hash-table.h.  Generated by cmake from config-tile-hash-table.h.cmake */
+
+/* Define if the tiled data manager should use the sharded tile hash table */
+#cmakedefine USE_SHARDED_TILE_HASH_TABLE 1
@@ -26,7 +26,6 @@
 
 #include <QRect>
 #include <QDomElement>
-#include <QtConcurrentMap>
 #include <QByteArray>
 #include <QBuffer>
 #include <QFile>
@@ -110,6 +109,11 @@ KisBrush* KisAutoBrush::clone() const
     return new KisAutoBrush(*this);
 }
 
+void KisAutoBrush::setThreadCount(int value)
+{
+    d->idealThreadCountCached = qMax(1, value);
+}
+
 inline void fillPixelOptimized_4bytes(quint8 *color, quint8 *buf, int size)
 {
     /**
@@ -279,21 +283,8 @@ void KisAutoBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst
     KisBrushMaskApplicatorBase *applicator = d->shape->applicator();
     applicator->initializeData(&data);
 
-    int jobs = d->idealThreadCountCached;
-    if (dstHeight > 100 && jobs >= 4) {
-        int splitter = dstHeight / jobs;
-        QVector<QRect> rects;
-        for (int i = 0; i < jobs - 1; i++) {
-            rects << QRect(0, i * splitter, dstWidth, splitter);
-        }
-        rects << QRect(0, (jobs - 1)*splitter, dstWidth, dstHeight - (jobs - 1)*splitter);
-        OperatorWrapper wrapper(applicator);
-        QtConcurrent::blockingMap(rects, wrapper);
-    }
-    else {
-        QRect rect(0, 0, dstWidth, dstHeight);
-        applicator->process(rect);
-    }
+    QRect rect(0, 0, dstWidth, dstHeight);
+    applicator->processInBands(rect, d->idealThreadCountCached);
 }
 
 
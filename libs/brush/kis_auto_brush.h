@@ -83,6 +83,13 @@ public:
 
     void lodLimitations(KisPaintopLodLimitations *l) const;
 
+    /**
+     * Sets the number of threads the mask of a single dab is generated
+     * in. The dabs rendered in parallel by the paintop should use only
+     * one thread each. By default all the cores are used.
+     */
+    void setThreadCount(int value);
+
 private:
 
     QImage createBrushPreview();
@@ -21,6 +21,8 @@
 
 #include "kis_global.h"
 
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
 template <class BaseFade>
 class KisAntialiasingFadeMaker1D
 {
@@ -83,6 +85,25 @@ public:
         return false;
     }
 
+#if defined HAVE_VC
+    /**
+     * Vectorized version of needFade(). The fade is written into
+     * \p value normalized to [0, 1], the other elements are kept
+     */
+    inline void applyFade(Vc::float_v &value, const Vc::float_v &dist) const {
+        if (m_enableAntialiasing) {
+            Vc::float_m fadeMask = dist > Vc::float_v(m_antialiasingFadeStart);
+            value(fadeMask) =
+                (Vc::float_v(float(m_fadeStartValue)) +
+                 (dist - Vc::float_v(m_antialiasingFadeStart)) * Vc::float_v(m_antialiasingFadeCoeff)) *
+                Vc::float_v(1.0f / 255.0f);
+        }
+
+        Vc::float_m outsideMask = dist > Vc::float_v(m_radius);
+        value(outsideMask) = Vc::float_v(1.0f);
+    }
+#endif /* defined HAVE_VC */
+
 private:
     qreal m_radius;
     quint8 m_fadeStartValue;
@@ -174,6 +195,35 @@ public:
         return false;
     }
 
+#if defined HAVE_VC
+    /**
+     * Vectorized version of needFade(). The fade is applied to
+     * \p value normalized to [0, 1]. Applying the fade in x and in y
+     * one after another multiplies the transparency by both the
+     * factors, so the order doesn't matter.
+     */
+    inline void applyFade(Vc::float_v &value, Vc::float_v x, Vc::float_v y) const {
+        const Vc::float_v vOne(1.0f);
+        const Vc::float_v vZero(0.0f);
+
+        x = Vc::abs(x);
+        y = Vc::abs(y);
+
+        if (m_enableAntialiasing) {
+            Vc::float_v xFade = (x - Vc::float_v(m_xFadeLimitStart)) * Vc::float_v(m_xFadeCoeff);
+            Vc::float_v yFade = (y - Vc::float_v(m_yFadeLimitStart)) * Vc::float_v(m_yFadeCoeff);
+
+            xFade = Vc::min(Vc::max(xFade, vZero), vOne);
+            yFade = Vc::min(Vc::max(yFade, vZero), vOne);
+
+            value = vOne - (vOne - value) * (vOne - xFade) * (vOne - yFade);
+        }
+
+        Vc::float_m outsideMask = x > Vc::float_v(m_xLimit) || y > Vc::float_v(m_yLimit);
+        value(outsideMask) = vOne;
+    }
+#endif /* defined HAVE_VC */
+
 private:
     qreal m_xLimit;
     qreal m_yLimit;
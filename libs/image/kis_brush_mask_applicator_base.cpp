@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_brush_mask_applicator_base.h"
+
+#include <QVector>
+#include <QtConcurrent>
+
+/**
+ * A band smaller than that is processed faster than a job is
+ * scheduled for it
+ */
+static const int MIN_PIXELS_PER_BAND = 128 * 64;
+
+
+void KisBrushMaskApplicatorBase::processInBands(const QRect &rect, int numThreads)
+{
+    const int numBands =
+        qMin(qMin(numThreads, rect.height()),
+             rect.width() * rect.height() / MIN_PIXELS_PER_BAND);
+
+    if (numBands < 2) {
+        process(rect);
+        return;
+    }
+
+    const int bandHeight = rect.height() / numBands;
+
+    QVector<QRect> bands;
+    for (int i = 0; i < numBands - 1; i++) {
+        bands << QRect(rect.x(), rect.y() + i * bandHeight, rect.width(), bandHeight);
+    }
+    bands << QRect(rect.x(), rect.y() + (numBands - 1) * bandHeight,
+                   rect.width(), rect.height() - (numBands - 1) * bandHeight);
+
+    OperatorWrapper wrapper(this);
+    QtConcurrent::blockingMap(bands, wrapper);
+}
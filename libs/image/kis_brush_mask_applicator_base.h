@@ -19,6 +19,7 @@
 #ifndef __KIS_BRUSH_MASK_APPLICATOR_BASE_H
 #define __KIS_BRUSH_MASK_APPLICATOR_BASE_H
 
+#include "kritaimage_export.h"
 #include "kis_types.h"
 #include "kis_fixed_paint_device.h"
 #include "math.h"
@@ -59,12 +60,20 @@ struct MaskProcessingData {
     qint32 pixelSize;
 };
 
-class KisBrushMaskApplicatorBase
+class KRITAIMAGE_EXPORT KisBrushMaskApplicatorBase
 {
 public:
     virtual ~KisBrushMaskApplicatorBase() {}
     virtual void process(const QRect &rect) = 0;
 
+    /**
+     * Processes \p rect splitting it into horizontal bands. The bands
+     * are processed in parallel by up to \p numThreads threads. The
+     * masks too small to be worth splitting are processed in the
+     * calling thread.
+     */
+    void processInBands(const QRect &rect, int numThreads);
+
     inline void initializeData(const MaskProcessingData *data) {
         m_d = data;
     }
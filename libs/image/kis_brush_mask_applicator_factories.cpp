@@ -20,8 +20,19 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_circle_mask_generator_p.h"
+#include "kis_rect_mask_generator.h"
+#include "kis_rect_mask_generator_p.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_circle_mask_generator_p.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_circle_mask_generator_p.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_gauss_rect_mask_generator_p.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_curve_rect_mask_generator_p.h"
 #include "kis_brush_mask_applicators.h"
 #include "kis_brush_mask_applicator_base.h"
+#include "vc_extra_math.h"
 
 #define a(_s) #_s
 #define b(_s) a(_s)
@@ -42,6 +53,46 @@ MaskApplicatorFactory<KisCircleMaskGenerator, KisBrushMaskVectorApplicator>::cre
     return new KisBrushMaskVectorApplicator<KisCircleMaskGenerator,VC_IMPL>(maskGenerator);
 }
 
+template<>
+template<>
+MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisRectangleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisGaussCircleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisGaussCircleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisCurveCircleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisCurveCircleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisGaussRectangleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
+template<>
+template<>
+MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator>::ReturnType
+MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator>::create<VC_IMPL>(ParamType maskGenerator)
+{
+    return new KisBrushMaskVectorApplicator<KisCurveRectangleMaskGenerator,VC_IMPL>(maskGenerator);
+}
+
 #if defined HAVE_VC
 
 struct KisCircleMaskGenerator::FastRowProcessor
@@ -116,4 +167,370 @@ FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa
     }
 }
 
+struct KisRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisRectangleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    const bool useSmoothing = d->copyOfAntialiasEdges;
+
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoeff);
+    Vc::float_v vYCoeff(d->ycoeff);
+
+    Vc::float_v vTransformedFadeX(d->transformedFadeX);
+    Vc::float_v vTransformedFadeY(d->transformedFadeY);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(0.0f);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = Vc::abs(x_ * vCosa - vSinaY_);
+        Vc::float_v yr = Vc::abs(x_ * vSina + vCosaY_);
+
+        Vc::float_v nxr = xr * vXCoeff;
+        Vc::float_v nyr = yr * vYCoeff;
+
+        if (useSmoothing) {
+            xr += vOne;
+            yr += vOne;
+        }
+
+        Vc::float_v fxr = xr * vTransformedFadeX;
+        Vc::float_v fyr = yr * vTransformedFadeY;
+
+        // the fade of the side which is closer to the edge wins
+        Vc::float_m fadeXMask = fxr > vOne && (fxr > fyr || fyr < vOne);
+        Vc::float_m fadeYMask = !fadeXMask && fyr > vOne && (fyr > fxr || fxr < vOne);
+
+        Vc::float_v vValue(vZero);
+        vValue(fadeXMask) = nxr * (fxr - vOne) / (fxr - nxr);
+        vValue(fadeYMask) = nyr * (fyr - vOne) / (fyr - nyr);
+
+        Vc::float_m outsideMask = nxr > vOne || nyr > vOne;
+        vValue(outsideMask) = vOne;
+
+        vValue = Vc::min(Vc::max(vValue, vZero), vOne);
+
+        vValue.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisGaussCircleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisGaussCircleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisGaussCircleMaskGenerator::Private *d;
+};
+
+template<> void KisGaussCircleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vYCoeff(d->ycoef);
+    Vc::float_v vDistfactor(d->distfactor);
+    Vc::float_v vCenter(d->center);
+    Vc::float_v vAlphafactor(d->alphafactor / 255.0);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(0.0f);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v dist = Vc::sqrt(pow2(xr) + pow2(yr * vYCoeff));
+        Vc::float_v scaledDist = dist * vDistfactor;
+
+        Vc::float_v vValue = vOne - vAlphafactor *
+            (VcExtraMath::erf(scaledDist + vCenter) - VcExtraMath::erf(scaledDist - vCenter));
+
+        d->fadeMaker.applyFade(vValue, dist);
+        vValue = Vc::min(Vc::max(vValue, vZero), vOne);
+
+        vValue.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisCurveCircleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisCurveCircleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisCurveCircleMaskGenerator::Private *d;
+};
+
+template<> void KisCurveCircleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoef);
+    Vc::float_v vYCoeff(d->ycoef);
+    Vc::float_v vCurveResolution(d->curveResolution);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(0.0f);
+
+    const qreal *curveData = d->curveData.constData();
+    const float maxDistance = d->curveResolution;
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v dist = pow2(xr * vXCoeff) + pow2(yr * vYCoeff);
+        Vc::float_v vDistance = dist * vCurveResolution;
+
+        Vc::float_v vValue;
+
+        /**
+         * Vc cannot gather from a double array, so the curve is
+         * sampled element-wise. The elements lying outside the
+         * curve are replaced by the fade below, just keep their
+         * indexes in range.
+         */
+        for (int j = 0; j < (int)Vc::float_v::Size; j++) {
+            const float distance = qMin(float(vDistance[j]), maxDistance);
+            const int index = distance;
+            const float alphaValueF = distance - index;
+
+            const qreal alpha =
+                (1.0 - alphaValueF) * curveData[index] +
+                alphaValueF * curveData[index + 1];
+
+            vValue[j] = 1.0 - alpha;
+        }
+
+        d->fadeMaker.applyFade(vValue, dist);
+        vValue = Vc::min(Vc::max(vValue, vZero), vOne);
+
+        vValue.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisGaussRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisGaussRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisGaussRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisGaussRectangleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXFade(d->xfade);
+    Vc::float_v vYFade(d->yfade);
+    Vc::float_v vHalfWidth(d->halfWidth);
+    Vc::float_v vHalfHeight(d->halfHeight);
+    Vc::float_v vAlphafactor(d->alphafactor / 255.0);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(0.0f);
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v vValue = vOne - vAlphafactor *
+            (VcExtraMath::erf((vHalfWidth + xr) * vXFade) + VcExtraMath::erf((vHalfWidth - xr) * vXFade)) *
+            (VcExtraMath::erf((vHalfHeight + yr) * vYFade) + VcExtraMath::erf((vHalfHeight - yr) * vYFade));
+
+        d->fadeMaker.applyFade(vValue, xr, yr);
+        vValue = Vc::min(Vc::max(vValue, vZero), vOne);
+
+        vValue.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
+struct KisCurveRectangleMaskGenerator::FastRowProcessor
+{
+    FastRowProcessor(KisCurveRectangleMaskGenerator *maskGenerator)
+        : d(maskGenerator->d.data()) {}
+
+    template<Vc::Implementation _impl>
+    void process(float* buffer, int width, float y, float cosa, float sina,
+                 float centerX, float centerY);
+
+    KisCurveRectangleMaskGenerator::Private *d;
+};
+
+template<> void KisCurveRectangleMaskGenerator::
+FastRowProcessor::process<VC_IMPL>(float* buffer, int width, float y, float cosa, float sina,
+                                   float centerX, float centerY)
+{
+    float y_ = y - centerY;
+    float sinay_ = sina * y_;
+    float cosay_ = cosa * y_;
+
+    float* bufferPointer = buffer;
+
+    Vc::float_v currentIndices(Vc::int_v::IndexesFromZero());
+
+    Vc::float_v increment((float)Vc::float_v::Size);
+    Vc::float_v vCenterX(centerX);
+
+    Vc::float_v vCosa(cosa);
+    Vc::float_v vSina(sina);
+    Vc::float_v vCosaY_(cosay_);
+    Vc::float_v vSinaY_(sinay_);
+
+    Vc::float_v vXCoeff(d->xcoeff);
+    Vc::float_v vYCoeff(d->ycoeff);
+
+    Vc::float_v vOne(1.0f);
+    Vc::float_v vZero(0.0f);
+
+    const qreal *curveData = d->curveData.constData();
+    const int curveResolution = d->curveResolution;
+
+    for (int i=0; i < width; i+= Vc::float_v::Size){
+
+        Vc::float_v x_ = currentIndices - vCenterX;
+
+        Vc::float_v xr = x_ * vCosa - vSinaY_;
+        Vc::float_v yr = x_ * vSina + vCosaY_;
+
+        Vc::float_v vS = Vc::abs(xr) * vXCoeff;
+        Vc::float_v vT = Vc::abs(yr) * vYCoeff;
+
+        Vc::float_v vValue;
+
+        // see a comment in the curve circle processor
+        for (int j = 0; j < (int)Vc::float_v::Size; j++) {
+            const int sIndex = qMin(qRound(float(vS[j]) * curveResolution), curveResolution);
+            const int tIndex = qMin(qRound(float(vT[j]) * curveResolution), curveResolution);
+
+            const int sIndexInverted = curveResolution - sIndex;
+            const int tIndexInverted = curveResolution - tIndex;
+
+            const qreal blend =
+                curveData[sIndex] * (1.0 - curveData[sIndexInverted]) *
+                curveData[tIndex] * (1.0 - curveData[tIndexInverted]);
+
+            vValue[j] = 1.0 - blend;
+        }
+
+        d->fadeMaker.applyFade(vValue, xr, yr);
+        vValue = Vc::min(Vc::max(vValue, vZero), vOne);
+
+        vValue.store(bufferPointer);
+        currentIndices = currentIndices + increment;
+
+        bufferPointer += Vc::float_v::Size;
+    }
+}
+
 #endif /* defined HAVE_VC */
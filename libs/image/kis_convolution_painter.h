@@ -69,6 +69,7 @@ public:
 
 protected:
     friend class KisConvolutionPainterTest;
+    friend class KisBlurBenchmark;
     enum TestingEnginePreference {
         NONE,
         SPATIAL,
@@ -32,9 +32,12 @@
 #include <QTextStream>
 #include <QFile>
 #include <QDir>
+#include <QtConcurrent>
 
 #include <fftw3.h>
 
+#include "kis_fftw_plan_cache.h"
+
 template<class _IteratorFactory_> class KisConvolutionWorkerFFT;
 class KisConvolutionWorkerFFTLock
 {
@@ -129,35 +132,48 @@ public:
         const float progressPerFFT = (100 - 30) / (double)(convChannelList.count() * 2 + 1);
 
         // perform FFT
-        fftw_plan fftwPlanForward, fftwPlanBackward;
+        KisFFTWPlanCache *planCache = KisFFTWPlanCache::instance();
+        KisFFTWPlanCache::PlansSP plans =
+            planCache->plans(m_fftWidth, m_fftHeight, m_channelFFT.size());
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)m_kernelFFT, m_kernelFFT, FFTW_ESTIMATE);
-        fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, m_kernelFFT, (double*)m_kernelFFT, FFTW_ESTIMATE);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
-
-        fftw_execute(fftwPlanForward);
+        fftw_execute_dft_r2c(plans->forward, (double*)m_kernelFFT, m_kernelFFT);
         addToProgress(progressPerFFT);
         if (isInterrupted()) return;
 
-        for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
-        {
-            fftw_execute_dft_r2c(fftwPlanForward, (double*)(*k), *k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+        /**
+         * The channels are independent from each other, so if we have
+         * spare threads, transform them in parallel. The transforms
+         * themselves may also be threaded by FFTW when the number of
+         * channels is lower than the number of threads (see
+         * KisFFTWPlanCache::threadsPerTransform()).
+         */
+        if (m_channelFFT.size() > 1 && planCache->maxThreads() > 1) {
+            const KisFFTWPlanCache::Plans *plansPtr = plans.data();
 
-            fftMultiply(*k, m_kernelFFT);
+            QtConcurrent::blockingMap(m_channelFFT,
+                [this, plansPtr] (fftw_complex *channel) {
+                    if (this->m_progress && this->m_progress->interrupted()) return;
+                    convolveChannel(channel, plansPtr);
+                });
 
-            fftw_execute_dft_c2r(fftwPlanBackward, *k, (double*)*k);
-            addToProgress(progressPerFFT);
+            // the progress cannot be reported from the pool threads
+            addToProgress(2 * progressPerFFT * m_channelFFT.size());
             if (isInterrupted()) return;
-        }
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftw_destroy_plan(fftwPlanForward);
-        fftw_destroy_plan(fftwPlanBackward);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+        } else {
+            for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
+            {
+                fftw_execute_dft_r2c(plans->forward, (double*)(*k), *k);
+                addToProgress(progressPerFFT);
+                if (isInterrupted()) return;
 
+                fftMultiply(*k, m_kernelFFT);
+
+                fftw_execute_dft_c2r(plans->backward, *k, (double*)*k);
+                addToProgress(progressPerFFT);
+                if (isInterrupted()) return;
+            }
+        }
 
         writeResultToDevice(QRect(dstPos.x(), dstPos.y(), areaSize.width(), areaSize.height()),
                             cacheRowStride, halfKernelWidth, halfKernelHeight,
@@ -427,6 +443,13 @@ private:
         }
     }
 
+    void convolveChannel(fftw_complex *channel, const KisFFTWPlanCache::Plans *plans)
+    {
+        fftw_execute_dft_r2c(plans->forward, (double*)channel, channel);
+        fftMultiply(channel, m_kernelFFT);
+        fftw_execute_dft_c2r(plans->backward, channel, (double*)channel);
+    }
+
     void fftMultiply(fftw_complex* channel, fftw_complex* kernel)
     {
         // perform complex multiplication
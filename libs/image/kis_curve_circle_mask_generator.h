@@ -38,7 +38,8 @@ class QPointF;
  */
 class KRITAIMAGE_EXPORT KisCurveCircleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisCurveCircleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes,const KisCubicCurve& curve, bool antialiasEdges);
@@ -50,6 +51,9 @@ public:
 
     void setScale(qreal scaleX, qreal scaleY);
 
+    virtual bool shouldVectorize() const;
+    KisBrushMaskApplicatorBase* applicator();
+
     bool shouldSupersample() const;
 
     virtual void toXML(QDomDocument& , QDomElement&) const;
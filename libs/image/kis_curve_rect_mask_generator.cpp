@@ -27,38 +27,12 @@
 #include <kis_fast_math.h>
 #include "kis_curve_rect_mask_generator.h"
 #include "kis_cubic_curve.h"
+#include "kis_curve_rect_mask_generator_p.h"
 #include "kis_antialiasing_fade_maker.h"
+#include "kis_brush_mask_applicator_factories.h"
+#include "kis_brush_mask_applicator_base.h"
 
 
-struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
-{
-    Private(bool enableAntialiasing)
-        : fadeMaker(*this, enableAntialiasing)
-    {
-    }
-
-    Private(const Private &rhs)
-        : xcoeff(rhs.xcoeff),
-        ycoeff(rhs.ycoeff),
-        curveResolution(rhs.curveResolution),
-        curveData(rhs.curveData),
-        curvePoints(rhs.curvePoints),
-        dirty(rhs.dirty),
-        fadeMaker(rhs.fadeMaker, *this)
-    {
-    }
-
-    qreal xcoeff, ycoeff;
-    qreal curveResolution;
-    QVector<qreal> curveData;
-    QList<QPointF> curvePoints;
-    bool dirty;
-
-    KisAntialiasingFadeMaker2D<Private> fadeMaker;
-
-    quint8 value(qreal xr, qreal yr) const;
-};
-
 KisCurveRectangleMaskGenerator::KisCurveRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, const KisCubicCurve &curve, bool antialiasEdges)
     : KisMaskGenerator(diameter, ratio, fh, fv, spikes, antialiasEdges, RECTANGLE, SoftId), d(new Private(antialiasEdges))
 {
@@ -69,12 +43,15 @@ KisCurveRectangleMaskGenerator::KisCurveRectangleMaskGenerator(qreal diameter, q
     d->dirty = false;
 
     setScale(1.0, 1.0);
+
+    d->applicator.reset(createOptimizedClass<MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this));
 }
 
 KisCurveRectangleMaskGenerator::KisCurveRectangleMaskGenerator(const KisCurveRectangleMaskGenerator &rhs)
     : KisMaskGenerator(rhs),
       d(new Private(*rhs.d))
 {
+    d->applicator.reset(createOptimizedClass<MaskApplicatorFactory<KisCurveRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this));
 }
 
 KisMaskGenerator* KisCurveRectangleMaskGenerator::clone() const
@@ -82,6 +59,16 @@ KisMaskGenerator* KisCurveRectangleMaskGenerator::clone() const
     return new KisCurveRectangleMaskGenerator(*this);
 }
 
+bool KisCurveRectangleMaskGenerator::shouldVectorize() const
+{
+    return !shouldSupersample() && spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisCurveRectangleMaskGenerator::applicator()
+{
+    return d->applicator.data();
+}
+
 void KisCurveRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 {
     KisMaskGenerator::setScale(scaleX, scaleY);
@@ -97,7 +84,6 @@ void KisCurveRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 
 KisCurveRectangleMaskGenerator::~KisCurveRectangleMaskGenerator()
 {
-    delete d;
 }
 
 quint8 KisCurveRectangleMaskGenerator::Private::value(qreal xr, qreal yr) const
@@ -19,6 +19,7 @@
 #ifndef _KIS_CURVE_RECT_MASK_GENERATOR_H_
 #define _KIS_CURVE_RECT_MASK_GENERATOR_H_
 
+#include <QScopedPointer>
 #include "kritaimage_export.h"
 
 class KisCubicCurve;
@@ -32,7 +33,8 @@ class QDomDocument;
  */
 class KRITAIMAGE_EXPORT KisCurveRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisCurveRectangleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes, const KisCubicCurve& curve, bool antialiasEdges);
@@ -44,13 +46,16 @@ public:
 
     void setScale(qreal scaleX, qreal scaleY);
 
+    virtual bool shouldVectorize() const;
+    KisBrushMaskApplicatorBase* applicator();
+
     virtual void toXML(QDomDocument& , QDomElement&) const;
     
     virtual void setSoftness(qreal softness);
 
 private:
     struct Private;
-    Private* const d;
+    const QScopedPointer<Private> d;
 };
 
 #endif
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_fftw_plan_cache.h"
+
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QList>
+
+#include <fftw3.h>
+
+#include <config_convolution.h>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+
+
+Q_GLOBAL_STATIC(KisFFTWPlanCache, s_instance)
+
+/**
+ * The planner of FFTW uses global state, so all the calls to
+ * fftw_plan_*() and fftw_destroy_plan() should be serialized.
+ * The lock is separate from the one of the cache, because the
+ * plans may be destroyed by the workers long after being evicted.
+ */
+Q_GLOBAL_STATIC(QMutex, s_plannerMutex)
+
+/**
+ * Patches of the image are mostly of the same size, so we don't
+ * need a lot of plans. The plans created with FFTW_ESTIMATE are
+ * cheap to keep around.
+ */
+static const int MAX_CACHED_PLANS = 16;
+
+
+KisFFTWPlanCache::Plans::Plans()
+    : forward(0),
+      backward(0)
+{
+}
+
+KisFFTWPlanCache::Plans::~Plans()
+{
+    QMutexLocker l(s_plannerMutex);
+
+    if (forward) {
+        fftw_destroy_plan(forward);
+    }
+
+    if (backward) {
+        fftw_destroy_plan(backward);
+    }
+}
+
+
+struct KisFFTWPlanCache::Private
+{
+    struct Entry {
+        int fftWidth;
+        int fftHeight;
+        int numChannels;
+        PlansSP plans;
+    };
+
+    QMutex mutex;
+
+    /**
+     * The most recently used plans are kept in the head of the list
+     */
+    QList<Entry> entries;
+
+    int maxThreads;
+
+    int threadsPerTransform(int numChannels) const {
+        return qMax(1, maxThreads / qMax(1, numChannels));
+    }
+};
+
+
+KisFFTWPlanCache::KisFFTWPlanCache()
+    : m_d(new Private)
+{
+    KisImageConfig config;
+    m_d->maxThreads = qMax(1, config.maxNumberOfThreads());
+
+    /**
+     * Touching the planner lock here guarantees it is destroyed after
+     * the cache, which destroys the remaining plans on exit
+     */
+    QMutexLocker l(s_plannerMutex);
+
+#ifdef HAVE_FFTW3_THREADS
+    if (!fftw_init_threads()) {
+        warnKrita << "Failed to initialize the threads support of FFTW";
+    }
+#endif
+}
+
+KisFFTWPlanCache::~KisFFTWPlanCache()
+{
+}
+
+KisFFTWPlanCache* KisFFTWPlanCache::instance()
+{
+    return s_instance;
+}
+
+KisFFTWPlanCache::PlansSP KisFFTWPlanCache::plans(int fftWidth, int fftHeight, int numChannels)
+{
+    /**
+     * The evicted plans should be destroyed after the lock is
+     * released, so declare the holder before the locker.
+     */
+    PlansSP evictedPlans;
+    QMutexLocker l(&m_d->mutex);
+
+    for (int i = 0; i < m_d->entries.size(); i++) {
+        const Private::Entry &entry = m_d->entries[i];
+
+        if (entry.fftWidth == fftWidth &&
+            entry.fftHeight == fftHeight &&
+            entry.numChannels == numChannels) {
+
+            if (i > 0) {
+                m_d->entries.move(i, 0);
+            }
+
+            return m_d->entries.first().plans;
+        }
+    }
+
+    const int fftLength = fftHeight * (fftWidth / 2 + 1);
+
+    /**
+     * FFTW_ESTIMATE doesn't touch the contents of the array, but the
+     * plan remembers its alignment, so it should be allocated the
+     * same way the workers allocate their buffers.
+     */
+    fftw_complex *buffer = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * fftLength);
+
+    Plans *newPlans = new Plans();
+
+    {
+        QMutexLocker plannerLocker(s_plannerMutex);
+
+#ifdef HAVE_FFTW3_THREADS
+        fftw_plan_with_nthreads(m_d->threadsPerTransform(numChannels));
+#endif
+
+        newPlans->forward = fftw_plan_dft_r2c_2d(fftHeight, fftWidth, (double*)buffer, buffer, FFTW_ESTIMATE);
+        newPlans->backward = fftw_plan_dft_c2r_2d(fftHeight, fftWidth, buffer, (double*)buffer, FFTW_ESTIMATE);
+    }
+
+    fftw_free(buffer);
+
+    Private::Entry entry;
+    entry.fftWidth = fftWidth;
+    entry.fftHeight = fftHeight;
+    entry.numChannels = numChannels;
+    entry.plans = PlansSP(newPlans);
+
+    m_d->entries.prepend(entry);
+
+    if (m_d->entries.size() > MAX_CACHED_PLANS) {
+        evictedPlans = m_d->entries.takeLast().plans;
+    }
+
+    return entry.plans;
+}
+
+int KisFFTWPlanCache::maxThreads() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->maxThreads;
+}
+
+void KisFFTWPlanCache::setMaxThreads(int value)
+{
+    QList<Private::Entry> droppedEntries;
+    QMutexLocker l(&m_d->mutex);
+
+    value = qMax(1, value);
+    if (value == m_d->maxThreads) return;
+
+    m_d->maxThreads = value;
+    droppedEntries.swap(m_d->entries);
+}
+
+int KisFFTWPlanCache::threadsPerTransform(int numChannels) const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->threadsPerTransform(numChannels);
+}
+
+void KisFFTWPlanCache::clear()
+{
+    QList<Private::Entry> droppedEntries;
+    QMutexLocker l(&m_d->mutex);
+
+    droppedEntries.swap(m_d->entries);
+}
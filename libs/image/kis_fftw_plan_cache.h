@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_FFTW_PLAN_CACHE_H
+#define __KIS_FFTW_PLAN_CACHE_H
+
+#include <QScopedPointer>
+#include <QSharedPointer>
+
+#include "kritaimage_export.h"
+
+/**
+ * Opaque FFTW plan type. We don't include fftw3.h here to let the
+ * users of the cache (e.g. benchmarks) be built without FFTW headers.
+ */
+struct fftw_plan_s;
+
+
+/**
+ * Keeps the FFTW plans used by KisConvolutionWorkerFFT between the
+ * calls to the convolution painter.
+ *
+ * Planning is the only part of FFTW that is not thread-safe, so
+ * before the cache every worker had to take a global lock, create a
+ * pair of plans and destroy them right after the convolution. The
+ * filters are usually applied to the image patch-by-patch, so the
+ * same sizes come again and again and the plans can be reused.
+ *
+ * The plans are created for in-place transforms and should be
+ * executed with the new-array interface (fftw_execute_dft_r2c() and
+ * fftw_execute_dft_c2r()) on the buffers allocated with
+ * fftw_malloc(). Such execution is thread-safe, so one plan can be
+ * used by several threads at the same time.
+ *
+ * The cache is keyed by the size of the transform and the number of
+ * the channels the worker is going to convolve: when there are fewer
+ * channels than the threads available, every transform is planned to
+ * use several threads itself (if FFTW has the threads support).
+ */
+class KRITAIMAGE_EXPORT KisFFTWPlanCache
+{
+public:
+    struct KRITAIMAGE_EXPORT Plans {
+        Plans();
+        ~Plans();
+
+        fftw_plan_s *forward;
+        fftw_plan_s *backward;
+
+    private:
+        Q_DISABLE_COPY(Plans)
+    };
+    typedef QSharedPointer<const Plans> PlansSP;
+
+public:
+    KisFFTWPlanCache();
+    ~KisFFTWPlanCache();
+
+    static KisFFTWPlanCache* instance();
+
+    /**
+     * Returns a forward r2c and backward c2r plans for a 2D transform
+     * of fftHeight x fftWidth real values. The plans stay valid while
+     * the returned pointer is alive, even if the cache evicts them
+     * in the meantime.
+     */
+    PlansSP plans(int fftWidth, int fftHeight, int numChannels);
+
+    /**
+     * The number of threads a single convolution is allowed to use.
+     * Defaults to KisImageConfig::maxNumberOfThreads(). Changing the
+     * value drops all the cached plans.
+     */
+    int maxThreads() const;
+    void setMaxThreads(int value);
+
+    /**
+     * The number of threads a single transform of the plans for
+     * \p numChannels channels is planned for
+     */
+    int threadsPerTransform(int numChannels) const;
+
+    void clear();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_FFTW_PLAN_CACHE_H */
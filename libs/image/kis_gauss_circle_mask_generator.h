@@ -29,7 +29,8 @@
  */
 class KRITAIMAGE_EXPORT KisGaussCircleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisGaussCircleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
@@ -41,6 +42,9 @@ public:
 
     void setScale(qreal scaleX, qreal scaleY);
 
+    virtual bool shouldVectorize() const;
+    KisBrushMaskApplicatorBase* applicator();
+
 private:
 
     qreal norme(qreal a, qreal b) const {
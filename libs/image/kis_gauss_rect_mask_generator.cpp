@@ -31,7 +31,10 @@
 
 #include "kis_base_mask_generator.h"
 #include "kis_gauss_rect_mask_generator.h"
+#include "kis_gauss_rect_mask_generator_p.h"
 #include "kis_antialiasing_fade_maker.h"
+#include "kis_brush_mask_applicator_factories.h"
+#include "kis_brush_mask_applicator_base.h"
 
 #define M_SQRT_2 1.41421356237309504880
 
@@ -41,42 +44,20 @@
 #define erf(x) boost::math::erf(x)
 #endif
 
-struct Q_DECL_HIDDEN KisGaussRectangleMaskGenerator::Private
-{
-    Private(bool enableAntialiasing)
-        : fadeMaker(*this, enableAntialiasing)
-    {
-    }
-
-    Private(const Private &rhs)
-        : xfade(rhs.xfade),
-        yfade(rhs.yfade),
-        halfWidth(rhs.halfWidth),
-        halfHeight(rhs.halfHeight),
-        alphafactor(rhs.alphafactor),
-        fadeMaker(rhs.fadeMaker, *this)
-    {
-    }
-
-    qreal xfade, yfade;
-    qreal halfWidth, halfHeight;
-    qreal alphafactor;
-
-    KisAntialiasingFadeMaker2D <Private> fadeMaker;
-
-    inline quint8 value(qreal x, qreal y) const;
-};
 
 KisGaussRectangleMaskGenerator::KisGaussRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges)
     : KisMaskGenerator(diameter, ratio, fh, fv, spikes, antialiasEdges, RECTANGLE, GaussId), d(new Private(antialiasEdges))
 {
     setScale(1.0, 1.0);
+
+    d->applicator.reset(createOptimizedClass<MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this));
 }
 
 KisGaussRectangleMaskGenerator::KisGaussRectangleMaskGenerator(const KisGaussRectangleMaskGenerator &rhs)
     : KisMaskGenerator(rhs),
       d(new Private(*rhs.d))
 {
+    d->applicator.reset(createOptimizedClass<MaskApplicatorFactory<KisGaussRectangleMaskGenerator, KisBrushMaskVectorApplicator> >(this));
 }
 
 KisMaskGenerator* KisGaussRectangleMaskGenerator::clone() const
@@ -84,6 +65,16 @@ KisMaskGenerator* KisGaussRectangleMaskGenerator::clone() const
     return new KisGaussRectangleMaskGenerator(*this);
 }
 
+bool KisGaussRectangleMaskGenerator::shouldVectorize() const
+{
+    return !shouldSupersample() && spikes() == 2;
+}
+
+KisBrushMaskApplicatorBase* KisGaussRectangleMaskGenerator::applicator()
+{
+    return d->applicator.data();
+}
+
 void KisGaussRectangleMaskGenerator::setScale(qreal scaleX, qreal scaleY)
 {
     KisMaskGenerator::setScale(scaleX, scaleY);
@@ -29,7 +29,8 @@
  */
 class KRITAIMAGE_EXPORT KisGaussRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisGaussRectangleMaskGenerator(qreal diameter, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
@@ -40,6 +41,9 @@ public:
     virtual quint8 valueAt(qreal x, qreal y) const;
     void setScale(qreal scaleX, qreal scaleY);
 
+    virtual bool shouldVectorize() const;
+    KisBrushMaskApplicatorBase* applicator();
+
 private:
     struct Private;
     const QScopedPointer<Private> d;
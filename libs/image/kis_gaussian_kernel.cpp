@@ -20,14 +20,27 @@
 
 #include "kis_convolution_kernel.h"
 #include <kis_convolution_painter.h>
+#include "kis_recursive_gaussian.h"
+#include "kis_default_bounds_base.h"
 #include <QRect>
 
+/**
+ * Starting from this sigma the recursive filter is both faster than
+ * the kernel and accurate enough to be used by default
+ */
+static const qreal AUTO_RECURSIVE_MIN_SIGMA = 2.5;
+
 
 qreal KisGaussianKernel::sigmaFromRadius(qreal radius)
 {
     return 0.3 * radius + 0.3;
 }
 
+qreal KisGaussianKernel::radiusFromSigma(qreal sigma)
+{
+    return qMax(0.0, (sigma - 0.3) / 0.3);
+}
+
 int KisGaussianKernel::kernelSizeFromRadius(qreal radius)
 {
     return 6 * ceil(sigmaFromRadius(radius)) + 1;
@@ -102,8 +115,34 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
                                       const QRect& rect,
                                       qreal xRadius, qreal yRadius,
                                       const QBitArray &channelFlags,
-                                      KoUpdater *progressUpdater)
+                                      KoUpdater *progressUpdater,
+                                      Engine engine)
 {
+    const qreal xSigma = xRadius > 0.0 ? sigmaFromRadius(xRadius) : 0.0;
+    const qreal ySigma = yRadius > 0.0 ? sigmaFromRadius(yRadius) : 0.0;
+
+    const qreal minSigma =
+        engine == AUTO ? AUTO_RECURSIVE_MIN_SIGMA : KisRecursiveGaussian::minimalSigma();
+
+    /**
+     * The recursive filter reads the device directly, so it cannot
+     * handle the wraparound mode. In that mode the convolution painter
+     * uses the special iterators of the device.
+     */
+    const bool useRecursive =
+        engine != CONVOLUTION &&
+        (xSigma > 0.0 || ySigma > 0.0) &&
+        (xSigma <= 0.0 || xSigma >= minSigma) &&
+        (ySigma <= 0.0 || ySigma >= minSigma) &&
+        !device->defaultBounds()->wrapAroundMode();
+
+    if (useRecursive) {
+        KisRecursiveGaussian::applyGaussian(device, rect,
+                                            xSigma, ySigma,
+                                            channelFlags, progressUpdater);
+        return;
+    }
+
     QPoint srcTopLeft = rect.topLeft();
 
     if (xRadius > 0.0 && yRadius > 0.0) {
@@ -29,6 +29,13 @@ class QRect;
 
 class KRITAIMAGE_EXPORT KisGaussianKernel
 {
+public:
+    enum Engine {
+        AUTO,        // the recursive filter for big radii, the kernel otherwise
+        CONVOLUTION, // separable kernel applied with KisConvolutionPainter
+        RECURSIVE    // KisRecursiveGaussian, constant time per pixel
+    };
+
 public:
     static Matrix<qreal, Dynamic, Dynamic>
         createHorizontalMatrix(qreal radius);
@@ -43,13 +50,15 @@ public:
         createVerticalKernel(qreal radius);
 
     static qreal sigmaFromRadius(qreal radius);
+    static qreal radiusFromSigma(qreal sigma);
     static int kernelSizeFromRadius(qreal radius);
 
     static void applyGaussian(KisPaintDeviceSP device,
                               const QRect& rect,
                               qreal xRadius, qreal yRadius,
                               const QBitArray &channelFlags,
-                              KoUpdater *updater);
+                              KoUpdater *updater,
+                              Engine engine = AUTO);
 };
 
 #endif /* __KIS_GAUSSIAN_KERNEL_H */
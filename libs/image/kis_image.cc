@@ -83,6 +83,7 @@
 #include "kis_wrapped_rect.h"
 #include "kis_crop_saved_extra_data.h"
 #include "kis_layer_utils.h"
+#include "kis_clone_layer.h"
 
 #include "kis_lod_transform.h"
 
@@ -255,11 +256,79 @@ KisImage::~KisImage()
      */
     m_d->rootLayer = 0;
 
+    qDeleteAll(m_d->compositions);
+
     delete m_d->undoStore;
     delete m_d;
     disconnect(); // in case Qt gets confused
 }
 
+KisImageSP KisImage::clone() const
+{
+    KisImageSP image = new KisImage(0, width(), height(), m_d->colorSpace, objectName());
+    image->setResolution(m_d->xres, m_d->yres);
+
+    KisGroupLayerSP rootLayer = dynamic_cast<KisGroupLayer*>(m_d->rootLayer->clone().data());
+    KIS_ASSERT_RECOVER_RETURN_VALUE(rootLayer, image);
+
+    image->setRootLayer(rootLayer);
+    rootLayer->setImage(image);
+
+    /**
+     * The copied clone layers still point to their sources in the
+     * original image. The cloned graph has exactly the same structure,
+     * so the sources can be found by their position in it.
+     */
+    QVector<KisNodeSP> srcNodes;
+    QVector<KisNodeSP> dstNodes;
+    KisLayerUtils::recursiveApplyNodes(m_d->rootLayer, [&srcNodes] (KisNodeSP node) { srcNodes.append(node); });
+    KisLayerUtils::recursiveApplyNodes(rootLayer, [&dstNodes] (KisNodeSP node) { dstNodes.append(node); });
+    KIS_ASSERT_RECOVER_NOOP(srcNodes.size() == dstNodes.size());
+
+    /**
+     * Keep the uuids of the nodes, otherwise the copied compositions
+     * would refer to nonexistent nodes when the copy is saved.
+     */
+    for (int i = 0; i < qMin(srcNodes.size(), dstNodes.size()); i++) {
+        dstNodes[i]->setUuid(srcNodes[i]->uuid());
+    }
+
+    Q_FOREACH (KisNodeSP node, dstNodes) {
+        KisCloneLayer *cloneLayer = dynamic_cast<KisCloneLayer*>(node.data());
+        if (!cloneLayer || !cloneLayer->copyFrom()) continue;
+
+        const int index = srcNodes.indexOf(KisNodeSP(cloneLayer->copyFrom()));
+        KisLayer *source = index >= 0 && index < dstNodes.size() ?
+            dynamic_cast<KisLayer*>(dstNodes[index].data()) : 0;
+
+        KIS_ASSERT_RECOVER(source) { continue; }
+        cloneLayer->setCopyFrom(source);
+    }
+
+    /**
+     * setRootLayer() resets the default pixel of the new root to
+     * the one of the previous (empty) root layer, so we should restore
+     * it manually
+     */
+    image->setDefaultProjectionColor(defaultProjectionColor());
+
+    KisImageAnimationInterface *animation = image->animationInterface();
+    animation->setFullClipRange(m_d->animationInterface->fullClipRange());
+    animation->setPlaybackRange(m_d->animationInterface->playbackRange());
+    animation->setFramerate(m_d->animationInterface->framerate());
+    animation->explicitlySetCurrentTime(m_d->animationInterface->currentUITime());
+
+    Q_FOREACH (KisLayerComposition *composition, m_d->compositions) {
+        image->addComposition(new KisLayerComposition(*composition, image));
+    }
+
+    Q_FOREACH (KisAnnotationSP annotation, m_d->annotations) {
+        image->addAnnotation(annotation);
+    }
+
+    return image;
+}
+
 void KisImage::aboutToAddANode(KisNode *parent, int index)
 {
     KisNodeGraphListener::aboutToAddANode(parent, index);
@@ -82,6 +82,22 @@ public:
     KisImage(KisUndoStore *undoStore, qint32 width, qint32 height, const KoColorSpace * colorSpace, const QString& name);
     virtual ~KisImage();
 
+    /**
+     * Creates a copy of the image sharing all the pixel data with the
+     * original one copy-on-write, including the frames of the animated
+     * layers. The copy has its own update scheduler and animation
+     * interface, so it can regenerate frames independently from the
+     * original, e.g. for rendering several frames of an animation in
+     * parallel, or for saving the image in background. The nodes of the
+     * copy keep the uuids of the original ones, so the compositions and
+     * the current time are copied as well. The annotations are shared
+     * with the original. The undo history is not copied.
+     *
+     * The graph of the image should not be changed while cloning, so
+     * the caller should hold a barrier lock on the image.
+     */
+    KisImageSP clone() const;
+
 public: // KisNodeGraphListener implementation
 
     void aboutToAddANode(KisNode *parent, int index);
@@ -178,6 +178,12 @@ void KisImageAnimationInterface::switchCurrentTimeAsync(int frameId)
     emit sigTimeChanged(frameId);
 }
 
+void KisImageAnimationInterface::explicitlySetCurrentTime(int frameId)
+{
+    m_d->currentTime = frameId;
+    m_d->currentUITime = frameId;
+}
+
 void KisImageAnimationInterface::requestFrameRegeneration(int frameId, const QRegion &dirtyRegion)
 {
     KisStrokeStrategy *strategy =
@@ -84,6 +84,14 @@ public Q_SLOTS:
     void switchCurrentTimeAsync(int frameId);
 public:
 
+    /**
+     * Sets the current time without regenerating the image and without
+     * emitting any signals. Used for copies of the image whose
+     * projection already corresponds to \p frameId, e.g. in
+     * KisImage::clone().
+     */
+    void explicitlySetCurrentTime(int frameId);
+
     /**
      * Start a backgroud thread that will recalculate some extra frame.
      * The result will be reported using two types of signals:
@@ -30,6 +30,7 @@
 #include <QDir>
 
 #include "kis_global.h"
+#include "tiles3/swap/kis_compression_registry.h"
 #include <cmath>
 
 #ifdef Q_OS_MAC
@@ -160,6 +161,93 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+QString KisImageConfig::swapCompression(bool requestDefault) const
+{
+    const QString defaultValue =
+        KisCompressionRegistry::instance()->contains("LZ4") ?
+        "LZ4" : KisCompressionRegistry::fallbackId();
+
+    return !requestDefault ?
+        m_config.readEntry("swapCompression", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setSwapCompression(const QString &value)
+{
+    m_config.writeEntry("swapCompression", value);
+}
+
+int KisImageConfig::swapCompressionThreads(bool requestDefault) const
+{
+    const int defaultValue = qMax(1, QThread::idealThreadCount() / 2);
+
+    return !requestDefault ?
+        qMax(1, m_config.readEntry("swapCompressionThreads", defaultValue)) : defaultValue;
+}
+
+void KisImageConfig::setSwapCompressionThreads(int value)
+{
+    m_config.writeEntry("swapCompressionThreads", value);
+}
+
+int KisImageConfig::maxNumberOfThreads(bool requestDefault) const
+{
+    const int defaultValue = qMax(1, QThread::idealThreadCount());
+
+    return !requestDefault ?
+        qMax(1, m_config.readEntry("maxthreads", defaultValue)) : defaultValue;
+}
+
+void KisImageConfig::setMaxNumberOfThreads(int value)
+{
+    m_config.writeEntry("maxthreads", value);
+}
+
+QString KisImageConfig::tileSaveCompression(bool requestDefault) const
+{
+    const QString defaultValue = KisCompressionRegistry::fallbackId();
+
+    return !requestDefault ?
+        m_config.readEntry("tileSaveCompression", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setTileSaveCompression(const QString &value)
+{
+    m_config.writeEntry("tileSaveCompression", value);
+}
+
+bool KisImageConfig::tileDataDeduplication(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tileDataDeduplication", false) : false;
+}
+
+void KisImageConfig::setTileDataDeduplication(bool value)
+{
+    m_config.writeEntry("tileDataDeduplication", value);
+}
+
+bool KisImageConfig::lazyTileLoading(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("lazyTileLoading", false) : false;
+}
+
+void KisImageConfig::setLazyTileLoading(bool value)
+{
+    m_config.writeEntry("lazyTileLoading", value);
+}
+
+bool KisImageConfig::parallelDabRendering(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("parallelDabRendering", true) : true;
+}
+
+void KisImageConfig::setParallelDabRendering(bool value)
+{
+    m_config.writeEntry("parallelDabRendering", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
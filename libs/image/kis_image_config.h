@@ -57,6 +57,60 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * The id of the compression backend used for swapping the tiles
+     * out (see KisCompressionRegistry). Optimized for speed: LZ4 is
+     * used when available, LZF otherwise.
+     */
+    QString swapCompression(bool requestDefault = false) const;
+    void setSwapCompression(const QString &value);
+
+    /**
+     * The number of threads compressing the tiles when the swapper
+     * pushes a batch of them to the swap file
+     */
+    int swapCompressionThreads(bool requestDefault = false) const;
+    void setSwapCompressionThreads(int value);
+
+    /**
+     * The number of threads the image uses for updating the
+     * projection and running the strokes. This is the same option
+     * as KisConfig::maxNumberOfThreads(), libs/image just cannot
+     * access KisConfig.
+     */
+    int maxNumberOfThreads(bool requestDefault = false) const;
+    void setMaxNumberOfThreads(int value);
+
+    /**
+     * The id of the compression backend used for writing the tiles
+     * into .kra files. Optimized for ratio, but defaults to LZF,
+     * because the older versions of Krita can read LZF tiles only.
+     */
+    QString tileSaveCompression(bool requestDefault = false) const;
+    void setTileSaveCompression(const QString &value);
+
+    /**
+     * When enabled, the tiles changed by a transaction are hashed on
+     * commit and the tiles with equal content share a single tile
+     * data (see KisTileDataStore::deduplicateTileData()). Costs some
+     * CPU time on every commit, so it is disabled by default.
+     */
+    bool tileDataDeduplication(bool requestDefault = false) const;
+    void setTileDataDeduplication(bool value);
+
+    /**
+     * Load the tiles of the .kra layers, stored without zip
+     * compression, lazily: the file is mapped into memory and every
+     * tile is decompressed on the first access only. The file must
+     * not be replaced while it is open, which some platforms cannot
+     * guarantee, so it is disabled by default.
+     */
+    bool lazyTileLoading(bool requestDefault = false) const;
+    void setLazyTileLoading(bool value);
+
+    bool parallelDabRendering(bool requestDefault = false) const;
+    void setParallelDabRendering(bool value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
@@ -91,6 +91,15 @@ KisLayerComposition::KisLayerComposition(KisImageWSP image, const QString& name)
 
 }
 
+KisLayerComposition::KisLayerComposition(const KisLayerComposition &rhs, KisImageWSP otherImage)
+    : m_image(otherImage),
+      m_name(rhs.m_name),
+      m_visibilityMap(rhs.m_visibilityMap),
+      m_collapsedMap(rhs.m_collapsedMap),
+      m_exportEnabled(rhs.m_exportEnabled)
+{
+}
+
 KisLayerComposition::~KisLayerComposition()
 {
 
@@ -36,6 +36,13 @@ class KRITAIMAGE_EXPORT KisLayerComposition
 {
 public:
     KisLayerComposition(KisImageWSP image, const QString& name);
+
+    /**
+     * Creates a copy of \p rhs attached to \p otherImage. The nodes of
+     * \p otherImage are expected to have the same uuids as the ones of
+     * the original image, like the ones of KisImage::clone() do.
+     */
+    KisLayerComposition(const KisLayerComposition &rhs, KisImageWSP otherImage);
     ~KisLayerComposition();
 
    /**
@@ -108,6 +108,13 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.swapFileSize = tileStats.swapFileSize;
+    stats.swapFreeSize = tileStats.swapFreeSize;
+    stats.swapFragmentation = tileStats.swapFragmentation;
+
+    stats.deduplicationEnabled = KisTileDataStore::instance()->deduplicationEnabled();
+    stats.deduplicatedTiles = tileStats.deduplicatedTiles;
+    stats.deduplicationRatio = tileStats.deduplicationRatio;
 
     KisImageConfig cfg;
 
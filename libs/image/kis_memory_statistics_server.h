@@ -42,6 +42,13 @@ public:
               poolSize(0),
 
               swapSize(0),
+              swapFileSize(0),
+              swapFreeSize(0),
+              swapFragmentation(0),
+
+              deduplicationEnabled(false),
+              deduplicatedTiles(0),
+              deduplicationRatio(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -58,6 +65,17 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapFileSize;
+        qint64 swapFreeSize;
+        qreal swapFragmentation;
+
+        /**
+         * The share of the committed tiles that have been found equal
+         * to an already existing tile and share its data now
+         */
+        bool deduplicationEnabled;
+        qint64 deduplicatedTiles;
+        qreal deduplicationRatio;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
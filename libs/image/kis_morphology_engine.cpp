@@ -0,0 +1,677 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_morphology_engine.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QtConcurrent>
+
+#include "kis_debug.h"
+#include "kis_global.h"
+#include "kis_paint_device.h"
+
+
+/**
+ * In APPROXIMATE_ELLIPSE mode the ellipses with the smaller radius up
+ * to this value are still processed exactly, as a set of vertical chords
+ */
+static const int MAX_EXACT_ELLIPSE_RADIUS = 16;
+
+/**
+ * The maximum relative difference between the support functions of
+ * the polygon and the ellipse we accept for the decomposition. Circles
+ * are approximated with about 2% error, very elongated ellipses fall
+ * back to the exact chords.
+ */
+static const qreal MAX_POLYGON_ERROR = 0.03;
+
+/**
+ * The blocks are aligned to the tiles. The bigger the element, the
+ * bigger blocks we use to keep the overhead of the margins low.
+ */
+static const int MIN_BLOCK_SIZE = 256;
+static const int MAX_BLOCK_SIZE = 1024;
+
+
+namespace {
+
+struct MaxOp {
+    static inline quint8 identity() { return 0; }
+    static inline quint8 apply(quint8 a, quint8 b) { return a > b ? a : b; }
+};
+
+struct MinOp {
+    static inline quint8 identity() { return 255; }
+    static inline quint8 apply(quint8 a, quint8 b) { return a < b ? a : b; }
+};
+
+struct Buffer {
+    Buffer(int _width, int _height)
+        : width(_width),
+          height(_height),
+          data(_width * _height)
+    {
+    }
+
+    inline quint8* row(int y) {
+        return data.data() + y * width;
+    }
+
+    inline const quint8* row(int y) const {
+        return data.constData() + y * width;
+    }
+
+    int width;
+    int height;
+    QVector<quint8> data;
+};
+
+/**
+ * dst[x] = op(src[x], shifted[x - shift]), where the pixels of
+ * \p shifted outside the row are considered to be the identity of
+ * the operation. \p dst may be the same as \p src.
+ */
+template <class Op>
+inline void combineShifted(quint8 *dst, const quint8 *src, const quint8 *shifted, int shift, int width)
+{
+    const int begin = qBound(0, shift, width);
+    const int end = qBound(0, width + shift, width);
+
+    if (dst != src) {
+        memcpy(dst, src, begin);
+        memcpy(dst + end, src + end, width - end);
+    }
+
+    for (int x = begin; x < end; x++) {
+        dst[x] = Op::apply(src[x], shifted[x - shift]);
+    }
+}
+
+/**
+ * dst[x] = src[x - shift], the pixels outside the row are the identity
+ */
+template <class Op>
+inline void copyShifted(quint8 *dst, const quint8 *src, int shift, int width)
+{
+    const int begin = qBound(0, shift, width);
+    const int end = qBound(0, width + shift, width);
+
+    memset(dst, Op::identity(), begin);
+    memset(dst + end, Op::identity(), width - end);
+
+    if (end > begin) {
+        memcpy(dst + begin, src + begin - shift, end - begin);
+    }
+}
+
+/**
+ * van Herk/Gil-Werman along every row
+ */
+template <class Op>
+void applyHorizontalLine(const Buffer &src, Buffer &dst, Buffer &g, Buffer &h, int length)
+{
+    const int width = src.width;
+    const int blockSize = 2 * length + 1;
+
+    for (int y = 0; y < src.height; y++) {
+        const quint8 *s = src.row(y);
+        quint8 *gRow = g.row(y);
+        quint8 *hRow = h.row(y);
+        quint8 *d = dst.row(y);
+
+        for (int x = 0; x < width; x++) {
+            gRow[x] = x % blockSize ? Op::apply(s[x], gRow[x - 1]) : s[x];
+        }
+
+        for (int x = width - 1; x >= 0; x--) {
+            hRow[x] = x % blockSize != blockSize - 1 && x < width - 1 ?
+                Op::apply(s[x], hRow[x + 1]) : s[x];
+        }
+
+        for (int x = 0; x < width; x++) {
+            const quint8 left = x - length >= 0 ? hRow[x - length] : Op::identity();
+            const quint8 right = x + length < width ? gRow[x + length] : Op::identity();
+            d[x] = Op::apply(left, right);
+        }
+    }
+}
+
+/**
+ * van Herk/Gil-Werman along the lines with direction (dx, dy), dy > 0.
+ *
+ * The pixels of one line lie in the rows with the same remainder of
+ * division by dy, so the position of the pixel along the line can be
+ * derived from its row only and the blocks of the algorithm are formed
+ * by the rows. It lets us process the whole row in one go.
+ *
+ * The lines are cut by the borders of the buffer, so the pixels whose
+ * window doesn't fit the buffer get partial results. The caller
+ * should provide enough margins.
+ */
+template <class Op>
+void applySlantedLine(const Buffer &src, Buffer &dst, Buffer &g, Buffer &h, int dx, int dy, int length)
+{
+    const int width = src.width;
+    const int height = src.height;
+    const int blockSize = 2 * length + 1;
+
+    for (int y = 0; y < height; y++) {
+        const int pos = y / dy;
+
+        if (pos % blockSize == 0) {
+            memcpy(g.row(y), src.row(y), width);
+        } else {
+            combineShifted<Op>(g.row(y), src.row(y), g.row(y - dy), dx, width);
+        }
+    }
+
+    for (int y = height - 1; y >= 0; y--) {
+        const int pos = y / dy;
+
+        if (pos % blockSize == blockSize - 1 || y + dy >= height) {
+            memcpy(h.row(y), src.row(y), width);
+        } else {
+            combineShifted<Op>(h.row(y), src.row(y), h.row(y + dy), -dx, width);
+        }
+    }
+
+    const int shiftX = length * dx;
+    const int shiftY = length * dy;
+
+    for (int y = 0; y < height; y++) {
+        quint8 *d = dst.row(y);
+
+        if (y - shiftY >= 0) {
+            copyShifted<Op>(d, h.row(y - shiftY), shiftX, width);
+        } else {
+            memset(d, Op::identity(), width);
+        }
+
+        if (y + shiftY < height) {
+            combineShifted<Op>(d, d, g.row(y + shiftY), -shiftX, width);
+        }
+    }
+}
+
+template <class Op>
+void applyLine(const Buffer &src, Buffer &dst, Buffer &g, Buffer &h, int dx, int dy, int length)
+{
+    if (dy == 0) {
+        applyHorizontalLine<Op>(src, dst, g, h, length);
+    } else {
+        applySlantedLine<Op>(src, dst, g, h, dx, dy, length);
+    }
+}
+
+template <class Op>
+void applyVerticalChords(const Buffer &src, Buffer &dst, Buffer &tmp, Buffer &g, Buffer &h,
+                         const QVector<int> &halfHeights)
+{
+    const int width = src.width;
+    const int center = halfHeights.size() / 2;
+
+    memset(dst.data.data(), Op::identity(), dst.data.size());
+
+    QVector<int> heights = halfHeights;
+    std::sort(heights.begin(), heights.end());
+    heights.erase(std::unique(heights.begin(), heights.end()), heights.end());
+
+    Q_FOREACH (int height, heights) {
+        if (height < 0) continue;
+
+        const Buffer *column = &src;
+
+        if (height > 0) {
+            applySlantedLine<Op>(src, tmp, g, h, 0, 1, height);
+            column = &tmp;
+        }
+
+        for (int i = 0; i < halfHeights.size(); i++) {
+            if (halfHeights[i] != height) continue;
+
+            const int offset = i - center;
+
+            for (int y = 0; y < src.height; y++) {
+                combineShifted<Op>(dst.row(y), dst.row(y), column->row(y), -offset, width);
+            }
+        }
+    }
+}
+
+/**
+ * The height of the ellipse at every column, the same discretization
+ * as in the GIMP-derived filters we used before.
+ */
+QVector<int> ellipseChords(int xRadius, int yRadius)
+{
+    QVector<int> chords(2 * xRadius + 1);
+
+    for (int i = 0; i < chords.size(); i++) {
+        const qreal tmp = i != xRadius ? qAbs(i - xRadius) - 0.5 : 0.0;
+        chords[i] = std::floor(qreal(yRadius) / xRadius * std::sqrt(xRadius * xRadius - tmp * tmp) + 0.5);
+    }
+
+    return chords;
+}
+
+/**
+ * The lengths of the segments in directions (1,0), (0,1), (1,±1),
+ * (2,±1), (1,±2). The segments of each pair of symmetric directions
+ * have equal lengths.
+ */
+struct EllipseDecomposition {
+    int horizontal;
+    int vertical;
+    int diagonal;
+    int wideKnight;
+    int tallKnight;
+};
+
+/**
+ * The Minkowski sum of the segments is a convex polygon with the
+ * support function h(u) = sum(length_i * |v_i . u|), so we look for the
+ * lengths that minimize the maximum relative difference between it and
+ * the support function of the ellipse. The extents of the polygon are
+ * kept equal to the radii, and the horizontal and vertical segments are
+ * never empty: they fill the gaps between the points of the slanted
+ * periodic lines.
+ *
+ * The error is a convex function of the diagonal length, so we scan
+ * the lengths of the knight segments and binary-search the diagonal.
+ */
+qreal decomposeEllipse(int xRadius, int yRadius, EllipseDecomposition *result)
+{
+    const int numAngles = 32;
+
+    struct Coeffs {
+        qreal horizontal, vertical, diagonal, wideKnight, tallKnight, ellipse;
+    };
+
+    QVector<Coeffs> coeffs(numAngles + 1);
+    for (int i = 0; i <= numAngles; i++) {
+        const qreal angle = 0.5 * M_PI * i / numAngles;
+        const qreal c = std::cos(angle);
+        const qreal s = std::sin(angle);
+
+        Coeffs &k = coeffs[i];
+        k.horizontal = c;
+        k.vertical = s;
+        k.diagonal = qAbs(c + s) + qAbs(c - s);
+        k.wideKnight = qAbs(2 * c + s) + qAbs(2 * c - s);
+        k.tallKnight = qAbs(c + 2 * s) + qAbs(c - 2 * s);
+        k.ellipse = std::sqrt(pow2(xRadius * c) + pow2(yRadius * s));
+    }
+
+    auto makeDecomposition = [xRadius, yRadius] (int diagonal, int wideKnight, int tallKnight) {
+        EllipseDecomposition d;
+        d.horizontal = xRadius - 2 * diagonal - 4 * wideKnight - 2 * tallKnight;
+        d.vertical = yRadius - 2 * diagonal - 2 * wideKnight - 4 * tallKnight;
+        d.diagonal = diagonal;
+        d.wideKnight = wideKnight;
+        d.tallKnight = tallKnight;
+        return d;
+    };
+
+    auto error = [&coeffs] (const EllipseDecomposition &d) {
+        qreal maxError = 0;
+        Q_FOREACH (const Coeffs &k, coeffs) {
+            const qreal support =
+                d.horizontal * k.horizontal +
+                d.vertical * k.vertical +
+                d.diagonal * k.diagonal +
+                d.wideKnight * k.wideKnight +
+                d.tallKnight * k.tallKnight;
+
+            maxError = qMax(maxError, qAbs(support - k.ellipse) / k.ellipse);
+        }
+        return maxError;
+    };
+
+    qreal bestError = std::numeric_limits<qreal>::max();
+
+    for (int wide = 0; 4 * wide + 1 <= xRadius && 2 * wide + 1 <= yRadius; wide++) {
+        for (int tall = 0;
+             4 * wide + 2 * tall + 1 <= xRadius &&
+             2 * wide + 4 * tall + 1 <= yRadius; tall++) {
+
+            const int maxDiagonal =
+                qMin(xRadius - 1 - 4 * wide - 2 * tall,
+                     yRadius - 1 - 2 * wide - 4 * tall) / 2;
+
+            int lo = 0;
+            int hi = maxDiagonal;
+
+            while (lo < hi) {
+                const int mid = (lo + hi) / 2;
+
+                if (error(makeDecomposition(mid, wide, tall)) <=
+                    error(makeDecomposition(mid + 1, wide, tall))) {
+
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+
+            const EllipseDecomposition d = makeDecomposition(lo, wide, tall);
+            const qreal e = error(d);
+
+            if (e < bestError) {
+                bestError = e;
+                *result = d;
+            }
+        }
+    }
+
+    return bestError;
+}
+
+} // namespace
+
+
+struct KisMorphologyEngine::Private
+{
+    Private(Operation _operation, BorderMode _borderMode)
+        : operation(_operation),
+          borderMode(_borderMode)
+    {
+    }
+
+    /**
+     * Either a line segment or a union of vertical chords
+     */
+    struct Stage {
+        Stage() : dx(0), dy(0), length(0) {}
+
+        int dx;
+        int dy;
+        int length;
+
+        QVector<int> chords;
+    };
+
+    Operation operation;
+    BorderMode borderMode;
+    QVector<Stage> stages;
+
+    QPoint extent() const;
+    int blockSize() const;
+
+    void readBlock(KisPaintDeviceSP source, const QRect &rect,
+                   const QRect &paddedRect, Buffer &buffer) const;
+
+    template <class Op>
+    void processBlock(KisPaintDeviceSP source, KisPaintDeviceSP dst,
+                      const QRect &rect, const QRect &block) const;
+};
+
+
+KisMorphologyEngine::KisMorphologyEngine(Operation operation, BorderMode borderMode)
+    : m_d(new Private(operation, borderMode))
+{
+}
+
+KisMorphologyEngine::~KisMorphologyEngine()
+{
+}
+
+void KisMorphologyEngine::addLine(int dx, int dy, int length)
+{
+    if (length <= 0 || (!dx && !dy)) return;
+
+    // the lines are processed from top to bottom (or left to right)
+    if (dy < 0 || (dy == 0 && dx < 0)) {
+        dx = -dx;
+        dy = -dy;
+    }
+
+    KIS_ASSERT_RECOVER_RETURN(dy > 0 || dx == 1);
+
+    Private::Stage stage;
+    stage.dx = dx;
+    stage.dy = dy;
+    stage.length = length;
+
+    m_d->stages.append(stage);
+}
+
+void KisMorphologyEngine::addVerticalChords(const QVector<int> &halfHeights)
+{
+    KIS_ASSERT_RECOVER_RETURN(halfHeights.size() & 0x1);
+
+    Private::Stage stage;
+    stage.chords = halfHeights;
+
+    m_d->stages.append(stage);
+}
+
+void KisMorphologyEngine::addEllipse(int xRadius, int yRadius, EllipseMode mode)
+{
+    if (xRadius <= 0 && yRadius <= 0) return;
+
+    if (xRadius <= 0) {
+        addLine(0, 1, yRadius);
+        return;
+    }
+
+    if (yRadius <= 0) {
+        addLine(1, 0, xRadius);
+        return;
+    }
+
+    EllipseDecomposition d;
+
+    if (mode == EXACT_ELLIPSE ||
+        qMin(xRadius, yRadius) <= MAX_EXACT_ELLIPSE_RADIUS ||
+        decomposeEllipse(xRadius, yRadius, &d) > MAX_POLYGON_ERROR) {
+
+        addVerticalChords(ellipseChords(xRadius, yRadius));
+        return;
+    }
+
+    addLine(1, 0, d.horizontal);
+    addLine(0, 1, d.vertical);
+    addLine(1, 1, d.diagonal);
+    addLine(-1, 1, d.diagonal);
+    addLine(2, 1, d.wideKnight);
+    addLine(-2, 1, d.wideKnight);
+    addLine(1, 2, d.tallKnight);
+    addLine(-1, 2, d.tallKnight);
+}
+
+QPoint KisMorphologyEngine::extent() const
+{
+    return m_d->extent();
+}
+
+QVector<QPoint> KisMorphologyEngine::structuringElement() const
+{
+    QVector<QPoint> result;
+    result << QPoint();
+
+    Q_FOREACH (const Private::Stage &stage, m_d->stages) {
+        QVector<QPoint> stagePoints;
+
+        if (!stage.chords.isEmpty()) {
+            const int center = stage.chords.size() / 2;
+            for (int i = 0; i < stage.chords.size(); i++) {
+                for (int y = -stage.chords[i]; y <= stage.chords[i]; y++) {
+                    stagePoints << QPoint(i - center, y);
+                }
+            }
+        } else {
+            for (int t = -stage.length; t <= stage.length; t++) {
+                stagePoints << QPoint(stage.dx, stage.dy) * t;
+            }
+        }
+
+        QVector<QPoint> sum;
+        Q_FOREACH (const QPoint &pt, result) {
+            Q_FOREACH (const QPoint &offset, stagePoints) {
+                const QPoint newPoint = pt + offset;
+                if (!sum.contains(newPoint)) {
+                    sum << newPoint;
+                }
+            }
+        }
+
+        result.swap(sum);
+    }
+
+    return result;
+}
+
+QPoint KisMorphologyEngine::Private::extent() const
+{
+    QPoint result;
+
+    Q_FOREACH (const Stage &stage, stages) {
+        if (!stage.chords.isEmpty()) {
+            const int maxHeight = *std::max_element(stage.chords.begin(), stage.chords.end());
+            result += QPoint(stage.chords.size() / 2, qMax(0, maxHeight));
+        } else {
+            result += QPoint(qAbs(stage.dx), stage.dy) * stage.length;
+        }
+    }
+
+    return result;
+}
+
+int KisMorphologyEngine::Private::blockSize() const
+{
+    // rounds up to the tile size
+    auto alignToTiles = [] (int value) { return (value + 63) & ~63; };
+
+    const QPoint ext = extent();
+    return qBound(MIN_BLOCK_SIZE, alignToTiles(4 * qMax(ext.x(), ext.y())), MAX_BLOCK_SIZE);
+}
+
+void KisMorphologyEngine::Private::readBlock(KisPaintDeviceSP source, const QRect &rect,
+                                             const QRect &paddedRect, Buffer &buffer) const
+{
+    const QRect srcRect = paddedRect & rect;
+    const int srcWidth = srcRect.width();
+
+    const int left = srcRect.x() - paddedRect.x();
+    const int right = left + srcWidth;
+    const int top = srcRect.y() - paddedRect.y();
+    const int bottom = top + srcRect.height();
+
+    QVector<quint8> srcData(srcWidth * srcRect.height());
+    source->readBytes(srcData.data(), srcRect);
+
+    for (int y = top; y < bottom; y++) {
+        quint8 *dstRow = buffer.row(y);
+        memcpy(dstRow + left, srcData.constData() + (y - top) * srcWidth, srcWidth);
+
+        if (borderMode == BORDER_REPEAT) {
+            memset(dstRow, dstRow[left], left);
+            memset(dstRow + right, dstRow[right - 1], buffer.width - right);
+        }
+    }
+
+    if (borderMode == BORDER_REPEAT) {
+        for (int y = 0; y < top; y++) {
+            memcpy(buffer.row(y), buffer.row(top), buffer.width);
+        }
+
+        for (int y = bottom; y < buffer.height; y++) {
+            memcpy(buffer.row(y), buffer.row(bottom - 1), buffer.width);
+        }
+    }
+}
+
+template <class Op>
+void KisMorphologyEngine::Private::processBlock(KisPaintDeviceSP source, KisPaintDeviceSP dst,
+                                                const QRect &rect, const QRect &block) const
+{
+    const QPoint ext = extent();
+    const QRect paddedRect = block.adjusted(-ext.x(), -ext.y(), ext.x(), ext.y());
+
+    Buffer src(paddedRect.width(), paddedRect.height());
+    Buffer dstBuffer(src.width, src.height);
+    Buffer tmp(src.width, src.height);
+    Buffer g(src.width, src.height);
+    Buffer h(src.width, src.height);
+
+    readBlock(source, rect, paddedRect, src);
+
+    Q_FOREACH (const Stage &stage, stages) {
+        if (!stage.chords.isEmpty()) {
+            applyVerticalChords<Op>(src, dstBuffer, tmp, g, h, stage.chords);
+        } else {
+            applyLine<Op>(src, dstBuffer, g, h, stage.dx, stage.dy, stage.length);
+        }
+
+        std::swap(src.data, dstBuffer.data);
+    }
+
+    const int blockWidth = block.width();
+    QVector<quint8> result(blockWidth * block.height());
+
+    for (int y = 0; y < block.height(); y++) {
+        memcpy(result.data() + y * blockWidth,
+               src.row(y + ext.y()) + ext.x(),
+               blockWidth);
+    }
+
+    dst->writeBytes(result.constData(), block);
+}
+
+void KisMorphologyEngine::process(KisPaintDeviceSP device, const QRect &rect) const
+{
+    if (rect.isEmpty() || m_d->stages.isEmpty()) return;
+
+    KIS_ASSERT_RECOVER_RETURN(device->pixelSize() == 1);
+
+    const int blockSize = m_d->blockSize();
+
+    QVector<QRect> blocks;
+
+    const int firstCol = std::floor(qreal(rect.left()) / blockSize);
+    const int lastCol = std::floor(qreal(rect.right()) / blockSize);
+    const int firstRow = std::floor(qreal(rect.top()) / blockSize);
+    const int lastRow = std::floor(qreal(rect.bottom()) / blockSize);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            blocks << (QRect(col * blockSize, row * blockSize, blockSize, blockSize) & rect);
+        }
+    }
+
+    /**
+     * The blocks read the pixels of their neighbours, so they read
+     * from a snapshot of the device. The tiles are shared between the
+     * copies, so it doesn't cost much.
+     */
+    KisPaintDeviceSP source = new KisPaintDevice(*device);
+
+    if (m_d->operation == DILATE) {
+        QtConcurrent::blockingMap(blocks,
+            [this, source, device, rect] (const QRect &block) {
+                m_d->processBlock<MaxOp>(source, device, rect, block);
+            });
+    } else {
+        QtConcurrent::blockingMap(blocks,
+            [this, source, device, rect] (const QRect &block) {
+                m_d->processBlock<MinOp>(source, device, rect, block);
+            });
+    }
+}
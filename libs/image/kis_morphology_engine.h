@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_MORPHOLOGY_ENGINE_H
+#define __KIS_MORPHOLOGY_ENGINE_H
+
+#include <QPoint>
+#include <QRect>
+#include <QScopedPointer>
+#include <QVector>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+
+/**
+ * Applies a flat morphological dilation or erosion to a single-channel
+ * 8-bit paint device (e.g. a pixel selection).
+ *
+ * The structuring element is described as a Minkowski sum of
+ * "stages", each of them being either a discrete line segment or an
+ * arbitrary (small) set of offsets. Dilation by a sum is the same as
+ * consecutive dilations by all its summands, so the stages are applied
+ * one by one:
+ *
+ * - a line segment {t * (dx, dy) | -length <= t <= length} is processed
+ *   with van Herk/Gil-Werman algorithm, which takes three min/max
+ *   operations per pixel regardless of the length. For all the
+ *   directions except the horizontal one the operations are done on
+ *   whole rows of the buffer at once, so the compiler can vectorize
+ *   them.
+ *
+ * - a union of vertical chords centered at the origin row is
+ *   processed as a set of vertical van Herk passes (one per distinct
+ *   chord height) followed by one shifted min/max of whole rows per
+ *   chord. The cost is linear in the number of the chords, but all the
+ *   operations are vectorizable.
+ *
+ * Ellipses are added as exact sets of chords. On request the big ones
+ * are decomposed into lines at 0, 90, 45, 135 degrees and the four
+ * "knight move" directions (see addEllipse()), which approximates the
+ * ellipse with a 16-gon and makes the cost independent of the radius.
+ *
+ * The rect is processed in tile-aligned blocks in parallel. Every
+ * block reads its area extended by the size of the structuring element
+ * from a copy-on-write snapshot of the device, so the blocks are
+ * independent of each other.
+ */
+class KRITAIMAGE_EXPORT KisMorphologyEngine
+{
+public:
+    enum Operation {
+        DILATE,
+        ERODE
+    };
+
+    enum BorderMode {
+        BORDER_ZERO,   // the pixels outside the rect are considered transparent
+        BORDER_REPEAT  // the pixels outside the rect are equal to the nearest edge pixel
+    };
+
+    enum EllipseMode {
+        EXACT_ELLIPSE,      // the ellipse is always added as a set of chords
+        APPROXIMATE_ELLIPSE // the big ellipses are replaced with a 16-gon, up to 3% error
+    };
+
+public:
+    KisMorphologyEngine(Operation operation, BorderMode borderMode);
+    ~KisMorphologyEngine();
+
+    /**
+     * Adds a segment {t * (dx, dy) | -length <= t <= length}.
+     * Horizontal segments are supported only with the unit step.
+     */
+    void addLine(int dx, int dy, int length);
+
+    /**
+     * Adds a union of vertical chords. The chord i is placed at column
+     * (i - halfHeights.size() / 2) and covers the rows in range
+     * [-halfHeights[i], halfHeights[i]]. The number of the chords
+     * should be odd. Negative height means there is no chord in the
+     * column.
+     */
+    void addVerticalChords(const QVector<int> &halfHeights);
+
+    /**
+     * Adds an ellipse with the given radii. By default the ellipse is
+     * exact. In APPROXIMATE_ELLIPSE mode the big ellipses are decomposed
+     * into line segments with the same extent, which changes the shape
+     * slightly, but makes the cost independent of the radius.
+     */
+    void addEllipse(int xRadius, int yRadius, EllipseMode mode = EXACT_ELLIPSE);
+
+    /**
+     * The maximum distance the element reaches in each direction
+     */
+    QPoint extent() const;
+
+    /**
+     * Computes the points of the whole structuring element explicitly.
+     * Used for testing only.
+     */
+    QVector<QPoint> structuringElement() const;
+
+    /**
+     * Applies the operation to \p rect of \p device. The pixels outside
+     * \p rect are neither read nor written.
+     */
+    void process(KisPaintDeviceSP device, const QRect &rect) const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_MORPHOLOGY_ENGINE_H */
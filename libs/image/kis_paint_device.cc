@@ -326,6 +326,9 @@ public:
         return data->dataManager()->defaultPixel();
     }
 
+    bool framesHaveEqualContent(int frameId1, int frameId2) const;
+    uint frameContentHash(int frameId) const;
+
     void fetchFrame(int frameId, KisPaintDeviceSP targetDevice);
     void uploadFrame(int srcFrameId, int dstFrameId, KisPaintDeviceSP srcDevice);
     void uploadFrame(int dstFrameId, KisPaintDeviceSP srcDevice);
@@ -677,6 +680,127 @@ void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targ
     targetDevice->m_d->currentStrategy()->fastBitBltRough(data->dataManager(), extent);
 }
 
+bool KisPaintDevice::Private::framesHaveEqualContent(int frameId1, int frameId2) const
+{
+    DataSP data1 = m_frames[frameId1];
+    DataSP data2 = m_frames[frameId2];
+
+    KIS_ASSERT_RECOVER_RETURN_VALUE(data1 && data2, false);
+
+    if (data1 == data2) return true;
+
+    if (data1->x() != data2->x() || data1->y() != data2->y()) {
+        return false;
+    }
+
+    if (data1->colorSpace() != data2->colorSpace() &&
+        !(*data1->colorSpace() == *data2->colorSpace())) {
+
+        return false;
+    }
+
+    KisDataManagerSP dm1 = data1->dataManager();
+    KisDataManagerSP dm2 = data2->dataManager();
+
+    const int pixelSize = dm1->pixelSize();
+    if (pixelSize != dm2->pixelSize() ||
+        memcmp(dm1->defaultPixel(), dm2->defaultPixel(), pixelSize)) {
+
+        return false;
+    }
+
+    /**
+     * The extents may differ for the equal frames only if one of them
+     * has tiles filled with the default pixel. That is rare enough to
+     * consider such frames different, saving a lot of comparisons.
+     */
+    const QRect extent = dm1->extent();
+    if (extent != dm2->extent()) {
+        return false;
+    }
+
+    if (extent.isEmpty()) return true;
+
+    /**
+     * The extent of a data manager is always aligned to the tiles
+     */
+    const qint32 firstColumn = extent.left() / KisTileData::WIDTH;
+    const qint32 lastColumn = (extent.left() + extent.width()) / KisTileData::WIDTH - 1;
+    const qint32 firstRow = extent.top() / KisTileData::HEIGHT;
+    const qint32 lastRow = (extent.top() + extent.height()) / KisTileData::HEIGHT - 1;
+
+    const int tileDataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 column = firstColumn; column <= lastColumn; column++) {
+            KisTileSP tile1 = dm1->getTile(column, row, false);
+            KisTileSP tile2 = dm2->getTile(column, row, false);
+
+            tile1->lockForRead();
+            tile2->lockForRead();
+
+            /**
+             * The tiles of the duplicated frames share the tile data
+             * copy-on-write, so we can skip the comparison for them
+             */
+            const bool equal =
+                tile1->tileData() == tile2->tileData() ||
+                !memcmp(tile1->data(), tile2->data(), tileDataSize);
+
+            tile2->unlock();
+            tile1->unlock();
+
+            if (!equal) return false;
+        }
+    }
+
+    return true;
+}
+
+uint KisPaintDevice::Private::frameContentHash(int frameId) const
+{
+    DataSP data = m_frames[frameId];
+    KIS_ASSERT_RECOVER_RETURN_VALUE(data, 0);
+
+    KisDataManagerSP dm = data->dataManager();
+    const int pixelSize = dm->pixelSize();
+    const QRect extent = dm->extent();
+
+    /**
+     * Only the properties checked by framesHaveEqualContent() may go
+     * into the hash. The equal color spaces always have the same id.
+     */
+    uint hash = qHash(data->colorSpace()->id());
+    hash = qHash(QByteArray::fromRawData(reinterpret_cast<const char*>(dm->defaultPixel()), pixelSize), hash);
+    hash = qHash(data->x(), hash);
+    hash = qHash(data->y(), hash);
+    hash = qHash(extent.left(), hash);
+    hash = qHash(extent.top(), hash);
+    hash = qHash(extent.width(), hash);
+    hash = qHash(extent.height(), hash);
+
+    if (extent.isEmpty()) return hash;
+
+    const qint32 firstColumn = extent.left() / KisTileData::WIDTH;
+    const qint32 lastColumn = (extent.left() + extent.width()) / KisTileData::WIDTH - 1;
+    const qint32 firstRow = extent.top() / KisTileData::HEIGHT;
+    const qint32 lastRow = (extent.top() + extent.height()) / KisTileData::HEIGHT - 1;
+
+    const int tileDataSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 column = firstColumn; column <= lastColumn; column++) {
+            KisTileSP tile = dm->getTile(column, row, false);
+
+            tile->lockForRead();
+            hash = qHash(QByteArray::fromRawData(reinterpret_cast<const char*>(tile->data()), tileDataSize), hash);
+            tile->unlock();
+        }
+    }
+
+    return hash;
+}
+
 void KisPaintDevice::Private::fetchFrame(int frameId, KisPaintDeviceSP targetDevice)
 {
     DataSP data = m_frames[frameId];
@@ -1614,6 +1738,11 @@ void KisPaintDevice::readBytes(quint8 *data, const QRect &rect) const
     m_d->currentStrategy()->readBytes(data, rect);
 }
 
+void KisPaintDevice::prefetchRect(const QRect &rect) const
+{
+    m_d->dataManager()->prefetchTiles(rect.translated(-m_d->x(), -m_d->y()));
+}
+
 void KisPaintDevice::writeBytes(const quint8 *data, qint32 x, qint32 y, qint32 w, qint32 h)
 {
     writeBytes(data, QRect(x, y, w, h));
@@ -1790,6 +1919,18 @@ void KisPaintDeviceFramesInterface::deleteFrame(int frame, KUndo2Command *parent
     return q->m_d->deleteFrame(frame, parentCommand);
 }
 
+bool KisPaintDeviceFramesInterface::framesHaveEqualContent(int frameId1, int frameId2) const
+{
+    KIS_ASSERT_RECOVER(frameId1 >= 0 && frameId2 >= 0) { return false; }
+    return q->m_d->framesHaveEqualContent(frameId1, frameId2);
+}
+
+uint KisPaintDeviceFramesInterface::frameContentHash(int frameId) const
+{
+    KIS_ASSERT_RECOVER(frameId >= 0) { return 0; }
+    return q->m_d->frameContentHash(frameId);
+}
+
 void KisPaintDeviceFramesInterface::fetchFrame(int frameId, KisPaintDeviceSP targetDevice)
 {
     q->m_d->fetchFrame(frameId, targetDevice);
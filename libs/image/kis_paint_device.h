@@ -415,6 +415,13 @@ public:
      */
     void readBytes(quint8 * data, const QRect &rect) const;
 
+    /**
+     * Hints the tile engine that the area \p rect is going to be
+     * read soon. If some tiles of this area have been swapped out,
+     * they will be loaded back in background. The call never blocks.
+     */
+    void prefetchRect(const QRect &rect) const;
+
     /**
      * Copy the bytes in data into the rect specified by x, y, w, h. If the
      * data is too small or uninitialized, Krita will happily read parts of
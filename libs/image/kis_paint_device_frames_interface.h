@@ -51,6 +51,22 @@ public:
      */
     void deleteFrame(int frame, KUndo2Command *parentCommand);
 
+    /**
+     * @return true if the two frames have exactly the same pixels,
+     *         offset and default pixel. The tiles shared copy-on-write
+     *         (e.g. by the duplicated keyframes) are not compared pixel
+     *         by pixel.
+     */
+    bool framesHaveEqualContent(int frameId1, int frameId2) const;
+
+    /**
+     * @return a hash of the pixels, offset and default pixel of the
+     *         frame. The frames with equal content (see
+     *         framesHaveEqualContent()) always have equal hashes, so the
+     *         hash can be used to find the candidates for a comparison.
+     */
+    uint frameContentHash(int frameId) const;
+
     /**
      * Copy the given frame into the target device
      * @param frameId ID of the frame to be copied
@@ -38,6 +38,7 @@
 #include "kis_image.h"
 #include "kis_fill_painter.h"
 #include "kis_outline_generator.h"
+#include "kis_tiled_outline_cache.h"
 #include <kis_iterator_ng.h>
 #include "kis_lod_transform.h"
 
@@ -49,6 +50,17 @@ struct Q_DECL_HIDDEN KisPixelSelection::Private {
     bool outlineCacheValid;
     QMutex outlineCacheMutex;
 
+    KisTiledOutlineCache outlineTiles;
+
+    /**
+     * The outline traced at reduced level of detail for the zoomed
+     * out canvas. Unlike outlineCache it is never updated in place,
+     * every change just invalidates it.
+     */
+    KisTiledOutlineCache previewTiles;
+    QPainterPath outlinePreview;
+    bool outlinePreviewValid;
+
     bool thumbnailImageValid;
     QImage thumbnailImage;
     QTransform thumbnailImageTransform;
@@ -60,13 +72,66 @@ struct Q_DECL_HIDDEN KisPixelSelection::Private {
         thumbnailImage = QImage();
         thumbnailImageTransform = QTransform();
     }
+
+    void addOutlineDirtyRect(const QRect &rc) {
+        outlineTiles.addDirtyRect(rc);
+        previewTiles.addDirtyRect(rc);
+        outlinePreviewValid = false;
+    }
+
+    void invalidateOutlineTiles() {
+        outlineTiles.invalidate();
+        previewTiles.invalidate();
+        outlinePreviewValid = false;
+    }
+
+    QVector<QPolygon> tiledOutline(KisPixelSelection *q, KisTiledOutlineCache &tiles);
+    static QPainterPath pathFromPolygons(const QVector<QPolygon> &polygons);
 };
 
+QVector<QPolygon> KisPixelSelection::Private::tiledOutline(KisPixelSelection *q, KisTiledOutlineCache &tiles)
+{
+    /**
+     * The tiles cannot handle the outline going along the image
+     * bounds, so inverted selections are traced as a whole
+     */
+    if (*q->defaultPixel() != MIN_SELECTED) {
+        tiles.invalidate();
+        return q->outline();
+    }
+
+    return tiles.outline(q);
+}
+
+QPainterPath KisPixelSelection::Private::pathFromPolygons(const QVector<QPolygon> &polygons)
+{
+    QPainterPath path;
+
+    Q_FOREACH (const QPolygon &polygon, polygons) {
+        path.addPolygon(polygon);
+
+        /**
+         * The outline generation algorithm has a small bug, which
+         * results in the starting point be repeated twice in the
+         * beginning of the path, instead of being put to the
+         * end. The tiled outline doesn't repeat the point at
+         * all. Here we just explicitly close the path to workaround
+         * both.
+         *
+         * \see KisSelectionTest::testOutlineGeneration()
+         */
+        path.closeSubpath();
+    }
+
+    return path;
+}
+
 KisPixelSelection::KisPixelSelection(KisDefaultBoundsBaseSP defaultBounds, KisSelectionWSP parentSelection)
         : KisPaintDevice(0, KoColorSpaceRegistry::instance()->alpha8(), defaultBounds)
         , m_d(new Private)
 {
     m_d->outlineCacheValid = true;
+    m_d->outlinePreviewValid = true;
     m_d->invalidateThumbnailImage();
 
     m_d->parentSelection = parentSelection;
@@ -80,6 +145,11 @@ KisPixelSelection::KisPixelSelection(const KisPixelSelection& rhs)
     // parent selection is not supposed to be shared
     m_d->outlineCache = rhs.m_d->outlineCache;
     m_d->outlineCacheValid = rhs.m_d->outlineCacheValid;
+    m_d->outlineTiles = rhs.m_d->outlineTiles;
+
+    m_d->previewTiles = rhs.m_d->previewTiles;
+    m_d->outlinePreview = rhs.m_d->outlinePreview;
+    m_d->outlinePreviewValid = rhs.m_d->outlinePreviewValid;
 
     m_d->thumbnailImageValid = rhs.m_d->thumbnailImageValid;
     m_d->thumbnailImage = rhs.m_d->thumbnailImage;
@@ -108,6 +178,7 @@ bool KisPixelSelection::read(QIODevice *stream)
 {
     bool retval = KisPaintDevice::read(stream);
     m_d->outlineCacheValid = false;
+    m_d->invalidateOutlineTiles();
     m_d->invalidateThumbnailImage();
     return retval;
 }
@@ -121,6 +192,8 @@ void KisPixelSelection::select(const QRect & rc, quint8 selectedness)
     const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
     painter.fillRect(r, KoColor(Qt::white, cs), selectedness);
 
+    m_d->addOutlineDirtyRect(r);
+
     if (m_d->outlineCacheValid) {
         QPainterPath path;
         path.addRect(r);
@@ -174,6 +247,7 @@ void KisPixelSelection::addSelection(KisPixelSelectionSP selection)
         src->nextRow();
     }
 
+    m_d->addOutlineDirtyRect(r);
     m_d->outlineCacheValid &= selection->outlineCacheValid();
 
     if (m_d->outlineCacheValid) {
@@ -203,6 +277,7 @@ void KisPixelSelection::subtractSelection(KisPixelSelectionSP selection)
         src->nextRow();
     }
 
+    m_d->addOutlineDirtyRect(r);
     m_d->outlineCacheValid &= selection->outlineCacheValid();
 
     if (m_d->outlineCacheValid) {
@@ -227,6 +302,7 @@ void KisPixelSelection::intersectSelection(KisPixelSelectionSP selection)
         src->nextRow();
     }
 
+    m_d->addOutlineDirtyRect(r);
     m_d->outlineCacheValid &= selection->outlineCacheValid();
 
     if (m_d->outlineCacheValid) {
@@ -246,6 +322,8 @@ void KisPixelSelection::clear(const QRect & r)
         KisPaintDevice::clear(r);
     }
 
+    m_d->addOutlineDirtyRect(r);
+
     if (m_d->outlineCacheValid) {
         QPainterPath path;
         path.addRect(r);
@@ -265,6 +343,16 @@ void KisPixelSelection::clear()
     m_d->outlineCacheValid = true;
     m_d->outlineCache = QPainterPath();
 
+    /**
+     * The selection is empty now, but the tiles are traced from
+     * scratch anyway, because the callers are free to paint on the
+     * cleared device directly
+     */
+    m_d->outlineTiles.invalidate();
+    m_d->previewTiles.invalidate();
+    m_d->outlinePreview = QPainterPath();
+    m_d->outlinePreviewValid = true;
+
     // Empty the thumbnail image. It is a valid state.
     m_d->invalidateThumbnailImage();
     m_d->thumbnailImageValid = true;
@@ -285,6 +373,8 @@ void KisPixelSelection::invert()
     quint8 defPixel = MAX_SELECTED - *defaultPixel();
     setDefaultPixel(&defPixel);
 
+    m_d->invalidateOutlineTiles();
+
     if (m_d->outlineCacheValid) {
         QPainterPath path;
         path.addRect(defaultBounds()->bounds());
@@ -307,6 +397,13 @@ void KisPixelSelection::move(const QPoint &pt)
         m_d->outlineCache.translate(offset);
     }
 
+    m_d->outlineTiles.translate(offset);
+    m_d->previewTiles.translate(offset);
+
+    if (m_d->outlinePreviewValid) {
+        m_d->outlinePreview.translate(offset);
+    }
+
     if (m_d->thumbnailImageValid) {
         m_d->thumbnailImageTransform =
             QTransform::fromTranslate(offset.x(), offset.y()) *
@@ -390,6 +487,7 @@ void KisPixelSelection::setOutlineCache(const QPainterPath &cache)
     QMutexLocker locker(&m_d->outlineCacheMutex);
     m_d->outlineCache = cache;
     m_d->outlineCacheValid = true;
+    m_d->outlinePreviewValid = false;
     m_d->thumbnailImageValid = false;
 }
 
@@ -403,31 +501,66 @@ void KisPixelSelection::invalidateOutlineCache()
 {
     QMutexLocker locker(&m_d->outlineCacheMutex);
     m_d->outlineCacheValid = false;
+    m_d->invalidateOutlineTiles();
+    m_d->thumbnailImageValid = false;
+}
+
+void KisPixelSelection::invalidateOutlineCache(const QRect &changedRect)
+{
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+    m_d->outlineCacheValid = false;
+    m_d->addOutlineDirtyRect(changedRect);
     m_d->thumbnailImageValid = false;
 }
 
+void KisPixelSelection::addOutlineCacheDirtyRect(const QRect &changedRect)
+{
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+    m_d->addOutlineDirtyRect(changedRect);
+}
+
 void KisPixelSelection::recalculateOutlineCache()
 {
     QMutexLocker locker(&m_d->outlineCacheMutex);
 
-    m_d->outlineCache = QPainterPath();
+    m_d->outlineCache =
+        Private::pathFromPolygons(m_d->tiledOutline(this, m_d->outlineTiles));
 
-    Q_FOREACH (const QPolygon &polygon, outline()) {
-        m_d->outlineCache.addPolygon(polygon);
+    m_d->outlineCacheValid = true;
+}
 
-        /**
-         * The outline generation algorithm has a small bug, which
-         * results in the starting point be repeated twice in the
-         * beginning of the path, instead of being put to the
-         * end. Here we just explicitly close the path to workaround
-         * it.
-         *
-         * \see KisSelectionTest::testOutlineGeneration()
-         */
-        m_d->outlineCache.closeSubpath();
+bool KisPixelSelection::outlinePreviewValid(int levelOfDetail) const
+{
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+
+    return levelOfDetail > 0 ?
+        m_d->outlinePreviewValid && m_d->previewTiles.levelOfDetail() == levelOfDetail :
+        m_d->outlineCacheValid;
+}
+
+QPainterPath KisPixelSelection::outlinePreview(int levelOfDetail) const
+{
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+    return levelOfDetail > 0 ? m_d->outlinePreview : m_d->outlineCache;
+}
+
+void KisPixelSelection::recalculateOutlinePreview(int levelOfDetail)
+{
+    if (levelOfDetail <= 0) {
+        recalculateOutlineCache();
+        return;
     }
 
-    m_d->outlineCacheValid = true;
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+
+    if (m_d->previewTiles.levelOfDetail() != levelOfDetail) {
+        m_d->previewTiles = KisTiledOutlineCache(levelOfDetail);
+    }
+
+    m_d->outlinePreview =
+        Private::pathFromPolygons(m_d->tiledOutline(this, m_d->previewTiles));
+
+    m_d->outlinePreviewValid = true;
 }
 
 bool KisPixelSelection::thumbnailImageValid() const
@@ -115,11 +115,45 @@ public:
     bool isEmpty() const;
     QPainterPath outlineCache() const;
     bool outlineCacheValid() const;
+
+    /**
+     * Recalculates the outline cache. Only the tiles changed since the
+     * previous recalculation are traced again.
+     */
     void recalculateOutlineCache();
 
     void setOutlineCache(const QPainterPath &cache);
+
+    /**
+     * Invalidates the outline cache after the pixels have been changed
+     * in an unknown way. The next recalculation traces the whole
+     * selection.
+     */
     void invalidateOutlineCache();
 
+    /**
+     * Invalidates the outline cache after the pixels in \p changedRect
+     * have been changed. Only that area is traced again on the next
+     * recalculation.
+     */
+    void invalidateOutlineCache(const QRect &changedRect);
+
+    /**
+     * Reports the change of the pixels in \p changedRect to the
+     * incremental tracer without invalidating the cache, e.g. when
+     * the caller has updated the cache itself.
+     */
+    void addOutlineCacheDirtyRect(const QRect &changedRect);
+
+    /**
+     * A coarse outline for the zoomed out canvas, traced on the grid of
+     * 2^levelOfDetail pixel cells. Zero level of detail means the usual
+     * outline cache.
+     */
+    bool outlinePreviewValid(int levelOfDetail) const;
+    QPainterPath outlinePreview(int levelOfDetail) const;
+    void recalculateOutlinePreview(int levelOfDetail);
+
     bool thumbnailImageValid() const;
     QImage thumbnailImage() const;
     QTransform thumbnailImageTransform() const;
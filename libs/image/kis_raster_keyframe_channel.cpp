@@ -19,6 +19,8 @@
 #include "kis_node.h"
 #include "kis_dom_utils.h"
 
+#include <QMultiHash>
+
 #include "kis_global.h"
 #include "kis_paint_device.h"
 #include "kis_paint_device_frames_interface.h"
@@ -36,6 +38,12 @@ struct KisRasterKeyframeChannel::Private
 
   KisPaintDeviceWSP paintDevice;
   QMap<int, QString> frameFilenames;
+
+  /**
+   * The frames named by chooseFrameFilename() by their content hash,
+   * valid only while saving
+   */
+  QMultiHash<uint, int> namedFramesByHash;
   bool onionSkinsEnabled;
 };
 
@@ -99,6 +107,26 @@ QString KisRasterKeyframeChannel::chooseFrameFilename(int frameId, const QString
 {
     QString filename;
 
+    /**
+     * Holds and cycles are usually made of duplicated keyframes, so
+     * the frames with equal content reuse the same file and their
+     * data is written only once
+     */
+    KisPaintDeviceFramesInterface *framesInterface = m_d->paintDevice->framesInterface();
+
+    const uint hash = framesInterface->frameContentHash(frameId);
+
+    QMultiHash<uint, int>::const_iterator it = m_d->namedFramesByHash.constFind(hash);
+    for (; it != m_d->namedFramesByHash.constEnd() && it.key() == hash; ++it) {
+        if (framesInterface->framesHaveEqualContent(it.value(), frameId)) {
+            filename = frameFilename(it.value());
+            setFrameFilename(frameId, filename);
+            return filename;
+        }
+    }
+
+    m_d->namedFramesByHash.insert(hash, frameId);
+
     int firstFrame = constKeys().begin().value()->value();
     if (frameId == firstFrame) {
         // Use legacy naming convention for first keyframe
@@ -188,6 +216,7 @@ void KisRasterKeyframeChannel::requestUpdate(const KisTimeRange &range, const QR
 QDomElement KisRasterKeyframeChannel::toXML(QDomDocument doc, const QString &layerFilename)
 {
     m_d->frameFilenames.clear();
+    m_d->namedFramesByHash.clear();
 
     return KisKeyframeChannel::toXML(doc, layerFilename);
 }
@@ -195,6 +224,7 @@ QDomElement KisRasterKeyframeChannel::toXML(QDomDocument doc, const QString &lay
 void KisRasterKeyframeChannel::loadXML(const QDomElement &channelNode)
 {
     m_d->frameFilenames.clear();
+    m_d->namedFramesByHash.clear();
 
     KisKeyframeChannel::loadXML(channelNode);
 }
@@ -54,6 +54,10 @@ public:
 
     QRect frameExtents(KisKeyframeSP keyframe);
 
+    /**
+     * @return the name of the file the frame is stored in. Frames with
+     *         equal content share the same file.
+     */
     QString frameFilename(int frameId) const;
 
     bool hasScalarValue() const;
@@ -30,7 +30,8 @@
  */
 class KRITAIMAGE_EXPORT KisRectangleMaskGenerator : public KisMaskGenerator
 {
-
+public:
+    struct FastRowProcessor;
 public:
 
     KisRectangleMaskGenerator(qreal radius, qreal ratio, qreal fh, qreal fv, int spikes, bool antialiasEdges);
@@ -40,6 +41,8 @@ public:
     KisMaskGenerator* clone() const;
 
     virtual bool shouldSupersample() const;
+    virtual bool shouldVectorize() const;
+    KisBrushMaskApplicatorBase* applicator();
     virtual quint8 valueAt(qreal x, qreal y) const;
     void setScale(qreal scaleX, qreal scaleY);
     void setSoftness(qreal softness);
@@ -0,0 +1,422 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_recursive_gaussian.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QBitArray>
+#include <QRect>
+#include <QtConcurrent>
+
+#include <KoChannelInfo.h>
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include "kis_debug.h"
+#include "kis_global.h"
+#include "kis_math_toolbox.h"
+#include "kis_paint_device.h"
+
+
+/**
+ * The blocks are aligned to the tiles. The bigger the margin, the
+ * bigger blocks we use to keep the overhead of the padding low.
+ */
+static const int MIN_BLOCK_SIZE = 256;
+static const int MAX_BLOCK_SIZE = 1024;
+
+/**
+ * The number of rows read from the device at once
+ */
+static const int READ_STRIPE_HEIGHT = 64;
+
+
+namespace {
+
+struct ChannelsData {
+    QList<KoChannelInfo*> channels;
+    QVector<PtrToDouble> toDouble;
+    QVector<PtrFromDouble> fromDouble;
+    QVector<qreal> minValue;
+    QVector<qreal> maxValue;
+
+    /// index of alpha in the list of convolved channels or -1
+    int alphaIndex;
+    int pixelSize;
+};
+
+/**
+ * Runs the recurrence over \p count elements, each of them being a
+ * vector of \p width floats placed \p stride floats apart. The
+ * horizontal pass uses the pixels as elements, the vertical one takes
+ * whole rows, which lets the compiler vectorize the inner loop.
+ *
+ * The signal is assumed to be continued by its first element, so the
+ * filter starts from the steady state for that value. For the backward
+ * pass the same is done with the last element of the forward output.
+ */
+template <bool forward>
+void recursivePass(float *data, int count, int stride, int width,
+                   const KisRecursiveGaussian::Coefficients &c)
+{
+    const float b = c.b;
+    const float a1 = c.a1;
+    const float a2 = c.a2;
+    const float a3 = c.a3;
+
+    float *p = forward ? data : data + (count - 1) * stride;
+    const int step = forward ? stride : -stride;
+
+    QVector<float> steadyState(width);
+    memcpy(steadyState.data(), p, width * sizeof(float));
+
+    const float *w1 = steadyState.constData();
+    const float *w2 = w1;
+    const float *w3 = w1;
+
+    for (int n = 0; n < count; n++) {
+        for (int i = 0; i < width; i++) {
+            p[i] = b * p[i] + a1 * w1[i] + a2 * w2[i] + a3 * w3[i];
+        }
+
+        w3 = w2;
+        w2 = w1;
+        w1 = p;
+        p += step;
+    }
+}
+
+void filterLine(float *data, int count, int stride, int width,
+                const KisRecursiveGaussian::Coefficients &c)
+{
+    recursivePass<true>(data, count, stride, width, c);
+    recursivePass<false>(data, count, stride, width, c);
+}
+
+inline void loadPixel(const ChannelsData &d, const quint8 *src, float *dst)
+{
+    const int numChannels = d.channels.size();
+
+    // no alpha is rare case, so just multiply by 1.0 in that case
+    const qreal alpha = d.alphaIndex >= 0 ?
+        d.toDouble[d.alphaIndex](src, d.channels[d.alphaIndex]->pos()) : 1.0;
+
+    for (int k = 0; k < numChannels; k++) {
+        dst[k] = k != d.alphaIndex ?
+            d.toDouble[k](src, d.channels[k]->pos()) * alpha : alpha;
+    }
+}
+
+inline void storePixel(const ChannelsData &d, const float *src, quint8 *dst)
+{
+    const int numChannels = d.channels.size();
+
+    qreal alphaInv = 1.0;
+
+    if (d.alphaIndex >= 0) {
+        const qreal alpha = src[d.alphaIndex];
+        alphaInv = alpha > 0.0 ? 1.0 / alpha : 0.0;
+
+        d.fromDouble[d.alphaIndex](dst, d.channels[d.alphaIndex]->pos(),
+                                   qBound(d.minValue[d.alphaIndex], alpha, d.maxValue[d.alphaIndex]));
+    }
+
+    for (int k = 0; k < numChannels; k++) {
+        if (k == d.alphaIndex) continue;
+
+        const qreal value = src[k] * alphaInv;
+        d.fromDouble[k](dst, d.channels[k]->pos(),
+                        qBound(d.minValue[k], value, d.maxValue[k]));
+    }
+}
+
+struct BlockProcessor {
+    BlockProcessor(const ChannelsData &_d,
+                   KisPaintDeviceSP _source, KisPaintDeviceSP _dst,
+                   const QRect &_dataRect,
+                   qreal xSigma, qreal ySigma)
+        : d(_d),
+          source(_source),
+          dst(_dst),
+          dataRect(_dataRect),
+          xMargin(xSigma > 0.0 ? KisRecursiveGaussian::marginFromSigma(xSigma) : 0),
+          yMargin(ySigma > 0.0 ? KisRecursiveGaussian::marginFromSigma(ySigma) : 0),
+          hasX(xSigma > 0.0),
+          hasY(ySigma > 0.0)
+    {
+        if (hasX) {
+            xCoeffs = KisRecursiveGaussian::coefficientsFromSigma(xSigma);
+        }
+
+        if (hasY) {
+            yCoeffs = KisRecursiveGaussian::coefficientsFromSigma(ySigma);
+        }
+    }
+
+    void process(const QRect &block) const;
+
+    const ChannelsData &d;
+    KisPaintDeviceSP source;
+    KisPaintDeviceSP dst;
+    QRect dataRect;
+
+    int xMargin;
+    int yMargin;
+    bool hasX;
+    bool hasY;
+
+    KisRecursiveGaussian::Coefficients xCoeffs;
+    KisRecursiveGaussian::Coefficients yCoeffs;
+};
+
+void BlockProcessor::process(const QRect &block) const
+{
+    const int numChannels = d.channels.size();
+    const int pixelSize = d.pixelSize;
+
+    const QRect paddedRect = block.adjusted(-xMargin, -yMargin, xMargin, yMargin);
+    const QRect srcRect = paddedRect & dataRect;
+
+    const int paddedWidth = paddedRect.width();
+    const int blockWidth = block.width();
+    const int rowSize = blockWidth * numChannels;
+
+    const int srcLeft = srcRect.x() - paddedRect.x();
+    const int srcRight = srcLeft + srcRect.width();
+    const int srcTop = srcRect.y() - paddedRect.y();
+    const int srcBottom = srcTop + srcRect.height();
+
+    /**
+     * The horizontal pass is done stripe by stripe right after
+     * reading, so we need to keep only the columns of the block for
+     * the vertical pass.
+     */
+    QVector<float> columns(rowSize * paddedRect.height());
+    QVector<float> line(paddedWidth * numChannels);
+
+    const int stripeHeight = qMin(READ_STRIPE_HEIGHT, srcRect.height());
+    QVector<quint8> srcData(srcRect.width() * stripeHeight * pixelSize);
+
+    for (int stripeTop = srcTop; stripeTop < srcBottom; stripeTop += stripeHeight) {
+        const int numRows = qMin(stripeHeight, srcBottom - stripeTop);
+        const QRect stripeRect(srcRect.x(), paddedRect.y() + stripeTop,
+                               srcRect.width(), numRows);
+
+        source->readBytes(srcData.data(), stripeRect);
+
+        const quint8 *srcPtr = srcData.constData();
+
+        for (int y = stripeTop; y < stripeTop + numRows; y++) {
+            float *linePtr = line.data() + srcLeft * numChannels;
+            for (int x = srcLeft; x < srcRight; x++) {
+                loadPixel(d, srcPtr, linePtr);
+                srcPtr += pixelSize;
+                linePtr += numChannels;
+            }
+
+            float *data = line.data();
+
+            for (int x = 0; x < srcLeft; x++) {
+                memcpy(data + x * numChannels, data + srcLeft * numChannels, numChannels * sizeof(float));
+            }
+
+            for (int x = srcRight; x < paddedWidth; x++) {
+                memcpy(data + x * numChannels, data + (srcRight - 1) * numChannels, numChannels * sizeof(float));
+            }
+
+            if (hasX) {
+                filterLine(data, paddedWidth, numChannels, numChannels, xCoeffs);
+            }
+
+            memcpy(columns.data() + y * rowSize,
+                   data + xMargin * numChannels,
+                   rowSize * sizeof(float));
+        }
+    }
+
+    for (int y = 0; y < srcTop; y++) {
+        memcpy(columns.data() + y * rowSize, columns.constData() + srcTop * rowSize, rowSize * sizeof(float));
+    }
+
+    for (int y = srcBottom; y < paddedRect.height(); y++) {
+        memcpy(columns.data() + y * rowSize, columns.constData() + (srcBottom - 1) * rowSize, rowSize * sizeof(float));
+    }
+
+    if (hasY) {
+        filterLine(columns.data(), paddedRect.height(), rowSize, rowSize, yCoeffs);
+    }
+
+    /**
+     * The channels we don't touch should keep their values, so we
+     * write the results over the original pixels.
+     */
+    QVector<quint8> result(blockWidth * block.height() * pixelSize);
+    source->readBytes(result.data(), block);
+
+    quint8 *dstPtr = result.data();
+
+    for (int y = 0; y < block.height(); y++) {
+        const float *rowPtr = columns.constData() + (y + yMargin) * rowSize;
+
+        for (int x = 0; x < blockWidth; x++) {
+            storePixel(d, rowPtr, dstPtr);
+            rowPtr += numChannels;
+            dstPtr += pixelSize;
+        }
+    }
+
+    dst->writeBytes(result.constData(), block);
+}
+
+}
+
+
+KisRecursiveGaussian::Coefficients
+KisRecursiveGaussian::coefficientsFromSigma(qreal sigma)
+{
+    KIS_ASSERT_RECOVER(sigma >= minimalSigma()) {
+        sigma = minimalSigma();
+    }
+
+    /**
+     * Equations (11b) and (8c) of the paper
+     */
+    const qreal q = sigma >= 2.5 ?
+        0.98711 * sigma - 0.96330 :
+        3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+
+    const qreal q2 = q * q;
+    const qreal q3 = q2 * q;
+
+    const qreal b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const qreal b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    const qreal b2 = -1.4281 * q2 - 1.26661 * q3;
+    const qreal b3 = 0.422205 * q3;
+
+    Coefficients c;
+    c.a1 = b1 / b0;
+    c.a2 = b2 / b0;
+    c.a3 = b3 / b0;
+
+    // normalize the gain to exactly one
+    c.b = 1.0 - (c.a1 + c.a2 + c.a3);
+
+    return c;
+}
+
+qreal KisRecursiveGaussian::minimalSigma()
+{
+    return 0.5;
+}
+
+int KisRecursiveGaussian::marginFromSigma(qreal sigma)
+{
+    return 3 * std::ceil(sigma);
+}
+
+void KisRecursiveGaussian::applyGaussian(KisPaintDeviceSP device,
+                                         const QRect& rect,
+                                         qreal xSigma, qreal ySigma,
+                                         const QBitArray &channelFlags,
+                                         KoUpdater *progressUpdater)
+{
+    if (rect.isEmpty() || (xSigma <= 0.0 && ySigma <= 0.0)) return;
+
+    const KoColorSpace *cs = device->colorSpace();
+
+    ChannelsData d;
+    d.pixelSize = cs->pixelSize();
+    d.alphaIndex = -1;
+
+    QBitArray flags = channelFlags;
+    if (flags.isEmpty()) {
+        flags = QBitArray(cs->channelCount(), true);
+    }
+    KIS_ASSERT_RECOVER_RETURN(static_cast<quint32>(flags.size()) == cs->channelCount());
+
+    QList<KoChannelInfo*> channelInfo = cs->channels();
+    for (int i = 0; i < channelInfo.size(); i++) {
+        if (!flags.testBit(i)) continue;
+
+        if (channelInfo[i]->channelType() == KoChannelInfo::ALPHA) {
+            d.alphaIndex = d.channels.size();
+        }
+        d.channels.append(channelInfo[i]);
+    }
+
+    if (d.channels.isEmpty()) return;
+
+    KisMathToolbox mathToolbox;
+    d.toDouble.resize(d.channels.size());
+    d.fromDouble.resize(d.channels.size());
+
+    if (!mathToolbox.getToDoubleChannelPtr(d.channels, d.toDouble) ||
+        !mathToolbox.getFromDoubleChannelPtr(d.channels, d.fromDouble)) {
+
+        return;
+    }
+
+    Q_FOREACH (KoChannelInfo *channel, d.channels) {
+        d.minValue.append(mathToolbox.minChannelValue(channel));
+        d.maxValue.append(mathToolbox.maxChannelValue(channel));
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(0);
+    }
+
+    // rounds up to the tile size
+    auto alignToTiles = [] (int value) { return (value + 63) & ~63; };
+
+    const int maxMargin = marginFromSigma(qMax(xSigma, ySigma));
+    const int blockSize = qBound(MIN_BLOCK_SIZE, alignToTiles(4 * maxMargin), MAX_BLOCK_SIZE);
+
+    QVector<QRect> blocks;
+
+    const int firstCol = std::floor(qreal(rect.left()) / blockSize);
+    const int lastCol = std::floor(qreal(rect.right()) / blockSize);
+    const int firstRow = std::floor(qreal(rect.top()) / blockSize);
+    const int lastRow = std::floor(qreal(rect.bottom()) / blockSize);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            blocks << (QRect(col * blockSize, row * blockSize, blockSize, blockSize) & rect);
+        }
+    }
+
+    /**
+     * The blocks read the pixels of their neighbours, so they read
+     * from a snapshot of the device. The tiles are shared between the
+     * copies, so it doesn't cost much.
+     */
+    KisPaintDeviceSP source = new KisPaintDevice(*device);
+    const QRect dataRect = rect | source->exactBounds();
+
+    BlockProcessor processor(d, source, device, dataRect, xSigma, ySigma);
+
+    QtConcurrent::blockingMap(blocks,
+        [&processor] (const QRect &block) {
+            processor.process(block);
+        });
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_RECURSIVE_GAUSSIAN_H
+#define __KIS_RECURSIVE_GAUSSIAN_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class QRect;
+class QBitArray;
+class KoUpdater;
+
+
+/**
+ * Approximates the Gaussian blur with a third order recursive (IIR)
+ * filter as described by Young and van Vliet in "Recursive
+ * implementation of the Gaussian filter" (Signal Processing, 1995).
+ *
+ * Every line is filtered with one causal and one anti-causal pass, each
+ * taking four multiplications per channel regardless of sigma, so the
+ * cost does not depend on the radius. The filter is accurate only for
+ * sigma >= minimalSigma(), smaller blurs should be done with the kernel.
+ *
+ * The color channels are filtered premultiplied by alpha, the same way
+ * KisConvolutionPainter does it. The pixels lying outside the union of
+ * the rect and the exact bounds of the device are considered to be
+ * equal to the nearest pixel inside it (BORDER_REPEAT).
+ */
+class KRITAIMAGE_EXPORT KisRecursiveGaussian
+{
+public:
+    struct Coefficients {
+        qreal b;
+        qreal a1;
+        qreal a2;
+        qreal a3;
+    };
+
+    /**
+     * Coefficients of the recurrence
+     * w[n] = b * x[n] + a1 * w[n-1] + a2 * w[n-2] + a3 * w[n-3]
+     */
+    static Coefficients coefficientsFromSigma(qreal sigma);
+
+    static qreal minimalSigma();
+
+    /**
+     * The number of pixels read on each side of the rect. It is the
+     * same as the half-size of the kernel created by KisGaussianKernel
+     * for this sigma, so the filters can use the same needed rects for
+     * both the engines.
+     */
+    static int marginFromSigma(qreal sigma);
+
+    /**
+     * Blurs \p rect of \p device in place. Zero sigma means the
+     * direction is not blurred.
+     */
+    static void applyGaussian(KisPaintDeviceSP device,
+                              const QRect& rect,
+                              qreal xSigma, qreal ySigma,
+                              const QBitArray &channelFlags,
+                              KoUpdater *progressUpdater);
+};
+
+#endif /* __KIS_RECURSIVE_GAUSSIAN_H */
@@ -143,6 +143,36 @@ void KisSelection::recalculateOutlineCache()
     }
 }
 
+bool KisSelection::outlinePreviewValid(int levelOfDetail) const
+{
+    return hasShapeSelection() ||
+        m_d->pixelSelection->outlinePreviewValid(levelOfDetail);
+}
+
+QPainterPath KisSelection::outlinePreview(int levelOfDetail) const
+{
+    QPainterPath outline;
+
+    if (hasShapeSelection()) {
+        outline += m_d->shapeSelection->outlineCache();
+    } else if (m_d->pixelSelection->outlinePreviewValid(levelOfDetail)) {
+        outline += m_d->pixelSelection->outlinePreview(levelOfDetail);
+    }
+
+    return outline;
+}
+
+void KisSelection::recalculateOutlinePreview(int levelOfDetail)
+{
+    Q_ASSERT(m_d->pixelSelection);
+
+    if (hasShapeSelection()) {
+        m_d->shapeSelection->recalculateOutlineCache();
+    } else if (!m_d->pixelSelection->outlinePreviewValid(levelOfDetail)) {
+        m_d->pixelSelection->recalculateOutlinePreview(levelOfDetail);
+    }
+}
+
 bool KisSelection::thumbnailImageValid() const
 {
     return m_d->pixelSelection->thumbnailImageValid();
@@ -197,6 +227,7 @@ void KisSelection::updateProjection(const QRect &rc)
 {
     if(hasShapeSelection()) {
         m_d->shapeSelection->renderToProjection(m_d->pixelSelection, rc);
+        m_d->pixelSelection->addOutlineCacheDirtyRect(rc);
         m_d->pixelSelection->setOutlineCache(m_d->shapeSelection->outlineCache());
     }
 }
@@ -98,6 +98,15 @@ public:
     QPainterPath outlineCache() const;
     void recalculateOutlineCache();
 
+    /**
+     * A coarse outline for the zoomed out canvas, see
+     * KisPixelSelection::outlinePreview(). For shape selections it is
+     * the same as the outline cache.
+     */
+    bool outlinePreviewValid(int levelOfDetail) const;
+    QPainterPath outlinePreview(int levelOfDetail) const;
+    void recalculateOutlinePreview(int levelOfDetail);
+
 
     /**
      * Tells whether the cached thumbnail of the selection is still valid
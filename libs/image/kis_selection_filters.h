@@ -42,8 +42,6 @@ public:
     virtual QRect changeRect(const QRect &rect);
 
 protected:
-    void computeBorder(qint32  *circ, qint32  xradius, qint32  yradius);
-
     void rotatePointers(quint8  **p, quint32 n);
 
     void computeTransition(quint8* transition, quint8** buf, qint32 width);
@@ -95,8 +93,12 @@ public:
     QRect changeRect(const QRect &rect);
 
     void process(KisPixelSelectionSP pixelSelection, const QRect &rect);
+private:
+    static qreal gaussianRadius(qint32 radius);
+
 private:
     qint32 m_radius;
+    qreal m_gaussianRadius;
 };
 
 class KRITAIMAGE_EXPORT KisGrowSelectionFilter : public KisSelectionFilter
@@ -23,6 +23,7 @@
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "kis_paint_device.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -51,6 +52,12 @@
     #define ACCUMULATOR_DEBUG()
 #endif /* ENABLE_ACCUMULATOR */
 
+/**
+ * The number of cells of the walkers index along each side
+ * of the update patch
+ */
+static const int GRID_CELLS_PER_PATCH = 4;
+
 
 KisSimpleUpdateQueue::KisSimpleUpdateQueue()
     : m_overrideLevelOfDetail(-1)
@@ -69,6 +76,8 @@ KisSimpleUpdateQueue::~KisSimpleUpdateQueue()
 
 void KisSimpleUpdateQueue::updateSettings()
 {
+    QMutexLocker locker(&m_lock);
+
     KisImageConfig config;
 
     m_patchWidth = config.updatePatchWidth();
@@ -77,6 +86,9 @@ void KisSimpleUpdateQueue::updateSettings()
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
+
+    m_updatesIndex.setCellSize(m_patchWidth / GRID_CELLS_PER_PATCH,
+                               m_patchHeight / GRID_CELLS_PER_PATCH);
 }
 
 int KisSimpleUpdateQueue::overrideLevelOfDetail() const
@@ -88,24 +100,33 @@ void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
 {
     updaterContext.lock();
 
+    /**
+     * The walkers that were not allowed to go in will not become
+     * allowed till the end of the pass: new jobs can only add more
+     * conflicts, and every finished job will cause one more call to
+     * processQueue() as soon as we unlock the context. So the search
+     * for the next job is continued from the position of the
+     * previous one instead of walking the whole list again.
+     */
+    int position = 0;
+
     while(updaterContext.hasSpareThread() &&
-          processOneJob(updaterContext));
+          processOneJob(updaterContext, position));
 
     updaterContext.unlock();
 }
 
-bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
+bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext, int &position)
 {
     QMutexLocker locker(&m_lock);
 
     KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
     bool jobAdded = false;
 
     int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
 
-    while(iter.hasNext()) {
-        item = iter.next();
+    for (; position < m_updatesList.size(); position++) {
+        item = m_updatesList[position];
 
         if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
             !item->checksumValid()) {
@@ -119,7 +140,8 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
             updaterContext.isJobAllowed(item)) {
 
             updaterContext.addMergeJob(item);
-            iter.remove();
+            m_updatesList.removeAt(position);
+            m_updatesIndex.removeWalker(item);
             jobAdded = true;
             break;
         }
@@ -189,12 +211,35 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QRect& rc,
     /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
 
     walker->collectRects(node, rc);
+    prefetchWalkerData(walker);
 
     m_lock.lock();
     m_updatesList.append(walker);
+    m_updatesIndex.addWalker(walker);
     m_lock.unlock();
 }
 
+void KisSimpleUpdateQueue::prefetchWalkerData(KisBaseRectsWalkerSP walker)
+{
+    /**
+     * The job will most probably wait in the queue for some time,
+     * so let the tile engine bring the swapped out data of the
+     * participating layers back into memory in the meantime
+     */
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walker->leafStack()) {
+        KisPaintDeviceSP projection = item.m_leaf->projection();
+        KisPaintDeviceSP original = item.m_leaf->original();
+
+        if (projection) {
+            projection->prefetchRect(item.m_applyRect);
+        }
+
+        if (original && original != projection) {
+            original->prefetchRect(item.m_applyRect);
+        }
+    }
+}
+
 void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
 {
     QMutexLocker locker(&m_lock);
@@ -266,7 +311,10 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
 
     KisBaseRectsWalkerSP goodCandidate;
     KisBaseRectsWalkerSP item;
-    KisWalkersListIterator iter(m_updatesList);
+
+    KisWalkersList candidates =
+        m_updatesIndex.walkersInArea(mergeCandidatesArea(rc));
+    KisWalkersListIterator iter(candidates);
 
     /**
      * We add new jobs to the tail of the list,
@@ -312,7 +360,10 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
                                        const qreal maxAlpha)
 {
     KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
+
+    KisWalkersList candidates =
+        m_updatesIndex.walkersInArea(mergeCandidatesArea(baseRect));
+    KisWalkersListIterator iter(candidates);
 
     while(iter.hasNext()) {
         item = iter.next();
@@ -324,12 +375,14 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
         if(item->levelOfDetail() != baseWalker->levelOfDetail()) continue;
 
         if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
-            iter.remove();
+            m_updatesList.removeOne(item);
+            m_updatesIndex.removeWalker(item);
         }
     }
 
     if(baseWalker->requestedRect() != baseRect) {
         baseWalker->collectRects(baseWalker->startNode(), baseRect);
+        m_updatesIndex.updateWalker(baseWalker);
     }
 }
 
@@ -362,6 +415,21 @@ bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
     return result;
 }
 
+QRect KisSimpleUpdateQueue::mergeCandidatesArea(const QRect &rc) const
+{
+    if (rc.isEmpty()) return QRect();
+
+    /**
+     * joinRects() never lets the united rect grow bigger than the
+     * patch, so the top-left corner of any rect that can be joined
+     * with \p rc lies inside this area
+     */
+    return QRect(QPoint(rc.right() - m_patchWidth + 1,
+                        rc.bottom() - m_patchHeight + 1),
+                 QPoint(rc.left() + m_patchWidth - 1,
+                        rc.top() + m_patchHeight - 1));
+}
+
 KisWalkersList& KisTestableSimpleUpdateQueue::getWalkersList()
 {
     return m_updatesList;
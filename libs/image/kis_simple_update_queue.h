@@ -21,6 +21,7 @@
 
 #include <QMutex>
 #include "kis_updater_context.h"
+#include "kis_walkers_grid_index.h"
 
 typedef QList<KisBaseRectsWalkerSP> KisWalkersList;
 typedef QListIterator<KisBaseRectsWalkerSP> KisWalkersListIterator;
@@ -57,7 +58,9 @@ public:
 protected:
     void addJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
-    bool processOneJob(KisUpdaterContext &updaterContext);
+    void prefetchWalkerData(KisBaseRectsWalkerSP walker);
+
+    bool processOneJob(KisUpdaterContext &updaterContext, int &position);
 
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
@@ -65,11 +68,18 @@ protected:
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
     bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
+    QRect mergeCandidatesArea(const QRect &rc) const;
 
 protected:
 
     mutable QMutex m_lock;
     KisWalkersList m_updatesList;
+
+    /**
+     * Indexes the walkers of m_updatesList by the position of
+     * their requested rects, used for searching merge candidates
+     */
+    KisWalkersGridIndex m_updatesIndex;
     KisSpontaneousJobsList m_spontaneousJobsList;
 
     /**
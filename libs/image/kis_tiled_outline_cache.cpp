@@ -0,0 +1,416 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tiled_outline_cache.h"
+
+#include <QtConcurrent>
+
+#include "kis_debug.h"
+#include "kis_global.h"
+#include "kis_paint_device.h"
+
+
+/**
+ * The size of the tile in cells. For zero level of detail it is the
+ * same as the size of the tiles of the paint device.
+ */
+static const int TILE_SIZE = 64;
+
+/**
+ * A tile owns the edges of its cells, whose vertices form a grid
+ * one vertex bigger than the tile
+ */
+static const int VERTEX_STRIDE = TILE_SIZE + 1;
+
+
+namespace {
+
+inline int divFloor(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+inline quint64 packKey(qint32 x, qint32 y)
+{
+    return (quint64(quint32(x)) << 32) | quint64(quint32(y));
+}
+
+inline qint32 keyX(quint64 key)
+{
+    return qint32(quint32(key >> 32));
+}
+
+inline qint32 keyY(quint64 key)
+{
+    return qint32(quint32(key & 0xFFFFFFFF));
+}
+
+inline bool isCollinear(const QPoint &a, const QPoint &b, const QPoint &c)
+{
+    return (a.x() == b.x() && b.x() == c.x()) ||
+        (a.y() == b.y() && b.y() == c.y());
+}
+
+/**
+ * Appends a point to the polyline merging the collinear segments, so
+ * that only the corners are stored
+ */
+inline void appendPoint(QPolygon &poly, const QPoint &pt)
+{
+    const int size = poly.size();
+
+    if (size >= 2 && isCollinear(poly[size - 2], poly[size - 1], pt)) {
+        poly[size - 1] = pt;
+    } else {
+        poly << pt;
+    }
+}
+
+void finalizeLoop(QPolygon &poly, int cellSize)
+{
+    if (poly.size() > 1 && poly.first() == poly.last()) {
+        poly.removeLast();
+    }
+
+    // the joint between the end and the beginning of the loop
+    if (poly.size() > 2 && isCollinear(poly.last(), poly[0], poly[1])) {
+        poly.removeFirst();
+    }
+
+    if (poly.size() > 2 && isCollinear(poly[poly.size() - 2], poly.last(), poly.first())) {
+        poly.removeLast();
+    }
+
+    if (cellSize > 1) {
+        for (int i = 0; i < poly.size(); i++) {
+            poly[i] *= cellSize;
+        }
+    }
+}
+
+struct TileJob {
+    quint64 key;
+    QVector<QPolygon> pieces;
+};
+
+}
+
+
+KisTiledOutlineCache::KisTiledOutlineCache(int levelOfDetail)
+    : m_levelOfDetail(levelOfDetail),
+      m_needsFullTrace(true)
+{
+}
+
+int KisTiledOutlineCache::levelOfDetail() const
+{
+    return m_levelOfDetail;
+}
+
+int KisTiledOutlineCache::tileSizeInPixels() const
+{
+    return TILE_SIZE << m_levelOfDetail;
+}
+
+void KisTiledOutlineCache::addDirtyRect(const QRect &rc)
+{
+    if (m_needsFullTrace || rc.isEmpty()) return;
+
+    const int cellSize = 1 << m_levelOfDetail;
+
+    /**
+     * A pixel owns its left and top edges, so its change affects the
+     * edges of the right and bottom neighbours as well
+     */
+    const int left = divFloor(rc.left(), cellSize);
+    const int top = divFloor(rc.top(), cellSize);
+    const int right = divFloor(rc.right(), cellSize) + 1;
+    const int bottom = divFloor(rc.bottom(), cellSize) + 1;
+
+    const int firstCol = divFloor(left, TILE_SIZE);
+    const int lastCol = divFloor(right, TILE_SIZE);
+    const int firstRow = divFloor(top, TILE_SIZE);
+    const int lastRow = divFloor(bottom, TILE_SIZE);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            m_dirtyTiles.insert(packKey(col, row));
+        }
+    }
+}
+
+void KisTiledOutlineCache::invalidate()
+{
+    m_needsFullTrace = true;
+    m_pieces.clear();
+    m_dirtyTiles.clear();
+}
+
+void KisTiledOutlineCache::translate(const QPoint &offset)
+{
+    if (m_needsFullTrace || offset.isNull()) return;
+
+    const int tileSize = tileSizeInPixels();
+
+    if (offset.x() % tileSize || offset.y() % tileSize) {
+        invalidate();
+        return;
+    }
+
+    const int dCol = offset.x() / tileSize;
+    const int dRow = offset.y() / tileSize;
+    const QPoint cellOffset(dCol * TILE_SIZE, dRow * TILE_SIZE);
+
+    QHash<quint64, QVector<QPolygon> > pieces;
+
+    for (auto it = m_pieces.constBegin(); it != m_pieces.constEnd(); ++it) {
+        QVector<QPolygon> tilePieces = it.value();
+        for (int i = 0; i < tilePieces.size(); i++) {
+            tilePieces[i].translate(cellOffset);
+        }
+
+        pieces.insert(packKey(keyX(it.key()) + dCol, keyY(it.key()) + dRow), tilePieces);
+    }
+
+    QSet<quint64> dirtyTiles;
+    Q_FOREACH (quint64 key, m_dirtyTiles) {
+        dirtyTiles.insert(packKey(keyX(key) + dCol, keyY(key) + dRow));
+    }
+
+    m_pieces = pieces;
+    m_dirtyTiles = dirtyTiles;
+}
+
+QVector<QPolygon> KisTiledOutlineCache::traceTile(const KisPaintDevice *device, qint32 col, qint32 row) const
+{
+    const int cellSize = 1 << m_levelOfDetail;
+    const int originX = col * TILE_SIZE;
+    const int originY = row * TILE_SIZE;
+
+    /**
+     * The cells of the tile plus one column on the left and one row on
+     * the top, which we need to find the edges owned by the tile
+     */
+    QVector<quint8> cells(VERTEX_STRIDE * VERTEX_STRIDE);
+
+    const int pixelsSize = VERTEX_STRIDE * cellSize;
+    QVector<quint8> pixels(pixelsSize * pixelsSize);
+    device->readBytes(pixels.data(),
+                      (originX - 1) * cellSize, (originY - 1) * cellSize,
+                      pixelsSize, pixelsSize);
+
+    bool hasSelectedCells = false;
+
+    if (cellSize == 1) {
+        for (int i = 0; i < cells.size(); i++) {
+            cells[i] = pixels[i] != MIN_SELECTED;
+            hasSelectedCells |= cells[i];
+        }
+    } else {
+        cells.fill(0);
+
+        for (int y = 0; y < pixelsSize; y++) {
+            const quint8 *pixelRow = pixels.constData() + y * pixelsSize;
+            quint8 *cellRow = cells.data() + (y / cellSize) * VERTEX_STRIDE;
+
+            for (int x = 0; x < pixelsSize; x++) {
+                cellRow[x / cellSize] |= pixelRow[x] != MIN_SELECTED;
+            }
+        }
+
+        for (int i = 0; i < cells.size(); i++) {
+            hasSelectedCells |= cells[i];
+        }
+    }
+
+    if (!hasSelectedCells) return QVector<QPolygon>();
+
+    /**
+     * Every vertex has at most two outgoing edges. The edges are
+     * directed so that the selected area lies on the right-hand side.
+     */
+    const int numVertices = VERTEX_STRIDE * VERTEX_STRIDE;
+    QVector<int> outTo(2 * numVertices);
+    QVector<quint8> outCount(numVertices, 0);
+    QVector<quint8> inCount(numVertices, 0);
+
+    auto addEdge = [&outTo, &outCount, &inCount] (int from, int to) {
+        outTo[2 * from + outCount[from]++] = to;
+        inCount[to]++;
+    };
+
+    for (int j = 0; j < TILE_SIZE; j++) {
+        for (int i = 0; i < TILE_SIZE; i++) {
+            const bool s = cells[(j + 1) * VERTEX_STRIDE + i + 1];
+            const bool l = cells[(j + 1) * VERTEX_STRIDE + i];
+            const bool u = cells[j * VERTEX_STRIDE + i + 1];
+
+            const int v = j * VERTEX_STRIDE + i;
+
+            if (s != l) {
+                if (s) {
+                    addEdge(v + VERTEX_STRIDE, v);
+                } else {
+                    addEdge(v, v + VERTEX_STRIDE);
+                }
+            }
+
+            if (s != u) {
+                if (s) {
+                    addEdge(v, v + 1);
+                } else {
+                    addEdge(v + 1, v);
+                }
+            }
+        }
+    }
+
+    QVector<quint8> remaining = outCount;
+    QVector<QPolygon> pieces;
+
+    auto vertexPoint = [originX, originY] (int v) {
+        return QPoint(originX + v % VERTEX_STRIDE, originY + v / VERTEX_STRIDE);
+    };
+
+    auto followChain = [&] (int v) {
+        QPolygon poly;
+        poly << vertexPoint(v);
+
+        while (remaining[v] > 0) {
+            v = outTo[2 * v + --remaining[v]];
+            appendPoint(poly, vertexPoint(v));
+        }
+
+        return poly;
+    };
+
+    /**
+     * The chains crossing the border start at the vertices having more
+     * outgoing edges than incoming ones. Such a chain can end only at a
+     * vertex with more incoming edges. All the edges left after that
+     * form closed loops.
+     */
+    for (int v = 0; v < numVertices; v++) {
+        for (int k = inCount[v]; k < outCount[v]; k++) {
+            pieces << followChain(v);
+        }
+    }
+
+    for (int v = 0; v < numVertices; v++) {
+        while (remaining[v] > 0) {
+            pieces << followChain(v);
+        }
+    }
+
+    return pieces;
+}
+
+QVector<QPolygon> KisTiledOutlineCache::stitchPieces() const
+{
+    const int cellSize = 1 << m_levelOfDetail;
+
+    QVector<QPolygon> result;
+    QVector<const QPolygon*> openChains;
+    QHash<quint64, QVector<int> > chainStarts;
+
+    for (auto it = m_pieces.constBegin(); it != m_pieces.constEnd(); ++it) {
+        for (const QPolygon &piece : it.value()) {
+            if (piece.first() == piece.last()) {
+                QPolygon poly = piece;
+                finalizeLoop(poly, cellSize);
+                result << poly;
+            } else {
+                chainStarts[packKey(piece.first().x(), piece.first().y())] << openChains.size();
+                openChains << &piece;
+            }
+        }
+    }
+
+    QVector<bool> used(openChains.size(), false);
+
+    for (int i = 0; i < openChains.size(); i++) {
+        if (used[i]) continue;
+
+        QPolygon poly = *openChains[i];
+        used[i] = true;
+
+        while (poly.last() != poly.first()) {
+            const QVector<int> &candidates =
+                chainStarts[packKey(poly.last().x(), poly.last().y())];
+
+            int next = -1;
+            Q_FOREACH (int candidate, candidates) {
+                if (!used[candidate]) {
+                    next = candidate;
+                    break;
+                }
+            }
+
+            KIS_SAFE_ASSERT_RECOVER_BREAK(next >= 0);
+
+            const QPolygon &chain = *openChains[next];
+            for (int k = 1; k < chain.size(); k++) {
+                appendPoint(poly, chain[k]);
+            }
+            used[next] = true;
+        }
+
+        finalizeLoop(poly, cellSize);
+        result << poly;
+    }
+
+    return result;
+}
+
+QVector<QPolygon> KisTiledOutlineCache::outline(const KisPaintDevice *device)
+{
+    if (m_needsFullTrace) {
+        m_needsFullTrace = false;
+        m_pieces.clear();
+        m_dirtyTiles.clear();
+        addDirtyRect(device->exactBounds());
+    }
+
+    if (!m_dirtyTiles.isEmpty()) {
+        QVector<TileJob> jobs;
+        jobs.reserve(m_dirtyTiles.size());
+
+        Q_FOREACH (quint64 key, m_dirtyTiles) {
+            TileJob job;
+            job.key = key;
+            jobs << job;
+        }
+
+        QtConcurrent::blockingMap(jobs,
+            [this, device] (TileJob &job) {
+                job.pieces = traceTile(device, keyX(job.key), keyY(job.key));
+            });
+
+        Q_FOREACH (const TileJob &job, jobs) {
+            if (job.pieces.isEmpty()) {
+                m_pieces.remove(job.key);
+            } else {
+                m_pieces.insert(job.key, job.pieces);
+            }
+        }
+
+        m_dirtyTiles.clear();
+    }
+
+    return stitchPieces();
+}
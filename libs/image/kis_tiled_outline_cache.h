@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_TILED_OUTLINE_CACHE_H
+#define __KIS_TILED_OUTLINE_CACHE_H
+
+#include <QHash>
+#include <QPolygon>
+#include <QRect>
+#include <QSet>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class KisPaintDevice;
+
+
+/**
+ * Keeps the outline of a selection split into pieces, one set of
+ * pieces per 64x64 tile, so that after a change only the dirty tiles
+ * are traced again.
+ *
+ * Every pixel owns its left and top edges, so a piece of a tile is a
+ * set of polylines whose ends lie on the tile border. outline() re-traces
+ * the dirty tiles (in parallel) and stitches all the pieces into closed
+ * polygons. The stitching is linear in the length of the outline, the
+ * tracing is linear in the area of the dirty tiles.
+ *
+ * With nonzero level of detail the outline is traced on a grid of
+ * 2^lod x 2^lod pixel cells, a cell being selected if any of its pixels
+ * is. That is enough for the zoomed out canvas and is much cheaper for
+ * huge selections. The returned polygons are in pixel coordinates.
+ *
+ * The device is expected to have fully deselected default pixel. The
+ * cache doesn't track the changes itself, the owner should report every
+ * change with addDirtyRect() or invalidate().
+ */
+class KRITAIMAGE_EXPORT KisTiledOutlineCache
+{
+public:
+    KisTiledOutlineCache(int levelOfDetail = 0);
+
+    int levelOfDetail() const;
+
+    /**
+     * The pixels in \p rc have changed
+     */
+    void addDirtyRect(const QRect &rc);
+
+    /**
+     * The device has changed in an unknown way, everything should be
+     * traced from scratch
+     */
+    void invalidate();
+
+    /**
+     * The device has been moved by \p offset. The pieces are kept when
+     * the offset is aligned to the tiles, otherwise the cache is
+     * invalidated.
+     */
+    void translate(const QPoint &offset);
+
+    /**
+     * Traces the dirty tiles of \p device and returns the stitched
+     * outline. The polygons are not closed explicitly, the last point
+     * is connected to the first one.
+     */
+    QVector<QPolygon> outline(const KisPaintDevice *device);
+
+private:
+    int tileSizeInPixels() const;
+    QVector<QPolygon> traceTile(const KisPaintDevice *device, qint32 col, qint32 row) const;
+    QVector<QPolygon> stitchPieces() const;
+
+private:
+    int m_levelOfDetail;
+    bool m_needsFullTrace;
+
+    /**
+     * The keys are packed (col, row) indexes of the tiles
+     */
+    QHash<quint64, QVector<QPolygon> > m_pieces;
+    QSet<quint64> m_dirtyTiles;
+};
+
+#endif /* __KIS_TILED_OUTLINE_CACHE_H */
@@ -55,6 +55,7 @@ public:
     KUndo2Command newFrameCommand;
 
     void possiblySwitchCurrentTime();
+    QRect changedRect() const;
     KisDataManagerSP dataManager();
     void moveDevice(const QPoint newOffset);
 
@@ -146,26 +147,31 @@ void KisTransactionData::endTransaction()
     }
 }
 
+QRect KisTransactionData::Private::changedRect() const
+{
+    QRect rc;
+    QRect mementoExtent = memento->extent();
+
+    if (newOffset == oldOffset) {
+        rc = mementoExtent.translated(device->x(), device->y());
+    } else {
+        QRect totalExtent =
+            savedDataManager->extent() | mementoExtent;
+
+        rc = totalExtent.translated(oldOffset) |
+            totalExtent.translated(newOffset);
+    }
+
+    return rc;
+}
+
 void KisTransactionData::startUpdates()
 {
     if (m_d->transactionFrameId == -1 ||
         m_d->transactionFrameId ==
         m_d->device->framesInterface()->currentFrameId()) {
 
-        QRect rc;
-        QRect mementoExtent = m_d->memento->extent();
-
-        if (m_d->newOffset == m_d->oldOffset) {
-            rc = mementoExtent.translated(m_d->device->x(), m_d->device->y());
-        } else {
-            QRect totalExtent =
-                m_d->savedDataManager->extent() | mementoExtent;
-
-            rc = totalExtent.translated(m_d->oldOffset) |
-                totalExtent.translated(m_d->newOffset);
-        }
-
-        m_d->device->setDirty(rc);
+        m_d->device->setDirty(m_d->changedRect());
     } else {
         m_d->device->framesInterface()->invalidateFrameCache(m_d->transactionFrameId);
     }
@@ -182,15 +188,22 @@ void KisTransactionData::possiblyNotifySelectionChanged()
     }
 }
 
-void KisTransactionData::possiblyResetOutlineCache()
+void KisTransactionData::possiblyResetOutlineCache(const QRect &changedRect)
 {
-    KisPixelSelectionSP pixelSelection;
+    KisPixelSelectionSP pixelSelection =
+        dynamic_cast<KisPixelSelection*>(m_d->device.data());
 
-    if (m_d->resetSelectionOutlineCache &&
-        (pixelSelection =
-         dynamic_cast<KisPixelSelection*>(m_d->device.data()))) {
+    if (!pixelSelection) return;
 
-        pixelSelection->invalidateOutlineCache();
+    /**
+     * The outline is traced incrementally, so the selection should
+     * know about every change of the pixels, even if the transaction
+     * doesn't touch its outline cache.
+     */
+    if (m_d->resetSelectionOutlineCache) {
+        pixelSelection->invalidateOutlineCache(changedRect);
+    } else {
+        pixelSelection->addOutlineCacheDirtyRect(changedRect);
     }
 }
 
@@ -209,7 +222,7 @@ void KisTransactionData::redo()
         m_d->firstRedo = false;
 
 
-        possiblyResetOutlineCache();
+        possiblyResetOutlineCache(m_d->changedRect());
         possiblyNotifySelectionChanged();
         return;
     }
@@ -264,7 +277,8 @@ void KisTransactionData::saveSelectionOutlineCache()
         if (m_d->savedOutlineCacheValid) {
             m_d->savedOutlineCache = pixelSelection->outlineCache();
 
-            possiblyResetOutlineCache();
+            // nothing has been painted yet
+            possiblyResetOutlineCache(QRect());
         }
 
         KisSelectionSP selection = pixelSelection->parentSelection();
@@ -291,10 +305,10 @@ void KisTransactionData::restoreSelectionOutlineCache(bool undo)
             savedOutlineCache = pixelSelection->outlineCache();
         }
 
+        pixelSelection->invalidateOutlineCache(m_d->changedRect());
+
         if (m_d->savedOutlineCacheValid) {
             pixelSelection->setOutlineCache(m_d->savedOutlineCache);
-        } else {
-            pixelSelection->invalidateOutlineCache();
         }
 
         m_d->savedOutlineCacheValid = savedOutlineCacheValid;
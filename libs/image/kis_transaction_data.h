@@ -53,7 +53,7 @@ private:
     void init(KisPaintDeviceSP device);
     void startUpdates();
     void possiblyNotifySelectionChanged();
-    void possiblyResetOutlineCache();
+    void possiblyResetOutlineCache(const QRect &changedRect);
 
 private:
     class Private;
@@ -19,10 +19,12 @@
 #include "kis_update_outline_job.h"
 
 
-KisUpdateOutlineJob::KisUpdateOutlineJob(KisSelectionSP selection, bool updateThumbnail, const QColor &maskColor)
+KisUpdateOutlineJob::KisUpdateOutlineJob(KisSelectionSP selection, bool updateThumbnail, const QColor &maskColor,
+                                         int outlineLevelOfDetail)
     : m_selection(selection),
       m_updateThumbnail(updateThumbnail),
-      m_maskColor(maskColor)
+      m_maskColor(maskColor),
+      m_outlineLevelOfDetail(outlineLevelOfDetail)
 {
 }
 
@@ -33,6 +35,18 @@ bool KisUpdateOutlineJob::overrides(const KisSpontaneousJob *otherJob)
 
 void KisUpdateOutlineJob::run()
 {
+    if (m_outlineLevelOfDetail > 0) {
+        m_selection->recalculateOutlinePreview(m_outlineLevelOfDetail);
+        m_selection->notifySelectionChanged();
+
+        /**
+         * The canvas can already show the preview, but the precise
+         * outline is still needed by the tools and actions
+         */
+        m_selection->recalculateOutlineCache();
+        return;
+    }
+
     m_selection->recalculateOutlineCache();
     if (m_updateThumbnail) {
         m_selection->recalculateThumbnailImage(m_maskColor);
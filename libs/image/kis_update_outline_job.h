@@ -27,7 +27,12 @@
 class KRITAIMAGE_EXPORT KisUpdateOutlineJob : public KisSpontaneousJob
 {
 public:
-    KisUpdateOutlineJob(KisSelectionSP selection, bool updateThumbnail, const QColor &maskColor);
+    /**
+     * With nonzero \p outlineLevelOfDetail the coarse outline preview
+     * is recalculated and reported first, see KisSelection::outlinePreview()
+     */
+    KisUpdateOutlineJob(KisSelectionSP selection, bool updateThumbnail, const QColor &maskColor,
+                        int outlineLevelOfDetail = 0);
 
     bool overrides(const KisSpontaneousJob *otherJob);
     void run();
@@ -37,6 +42,7 @@ private:
     KisSelectionSP m_selection;
     bool m_updateThumbnail;
     QColor m_maskColor;
+    int m_outlineLevelOfDetail;
 };
 
 #endif /* __KIS_UPDATE_OUTLINE_JOB_H */
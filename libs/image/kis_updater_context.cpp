@@ -19,20 +19,16 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
+#include "kis_image_config.h"
 
 
 KisUpdaterContext::KisUpdaterContext(qint32 threadCount)
+    : m_executor(effectiveThreadCount(threadCount))
 {
-    if(threadCount <= 0) {
-        threadCount = QThread::idealThreadCount();
-        threadCount = threadCount > 0 ? threadCount : 1;
-    }
-
-    m_jobs.resize(threadCount);
+    m_jobs.resize(m_executor.numThreads());
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(&m_exclusiveJobLock);
         connect(m_jobs[i], SIGNAL(sigContinueUpdate(const QRect&)),
@@ -49,7 +45,7 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount)
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
     for(qint32 i = 0; i < m_jobs.size(); i++)
         delete m_jobs[i];
 }
@@ -121,7 +117,7 @@ void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
     Q_ASSERT(jobIndex >= 0);
 
     m_jobs[jobIndex]->setWalker(walker);
-    m_threadPool.start(m_jobs[jobIndex]);
+    m_executor.start(m_jobs[jobIndex]);
 }
 
 /**
@@ -144,7 +140,7 @@ void KisUpdaterContext::addStrokeJob(KisStrokeJob *strokeJob)
     Q_ASSERT(jobIndex >= 0);
 
     m_jobs[jobIndex]->setStrokeJob(strokeJob);
-    m_threadPool.start(m_jobs[jobIndex]);
+    m_executor.start(m_jobs[jobIndex]);
 }
 
 /**
@@ -167,7 +163,7 @@ void KisUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
     Q_ASSERT(jobIndex >= 0);
 
     m_jobs[jobIndex]->setSpontaneousJob(spontaneousJob);
-    m_threadPool.start(m_jobs[jobIndex]);
+    m_executor.start(m_jobs[jobIndex]);
 }
 
 /**
@@ -185,7 +181,7 @@ void KisTestableUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneous
 
 void KisUpdaterContext::waitForDone()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 }
 
 bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
@@ -195,6 +191,15 @@ bool KisUpdaterContext::walkerIntersectsJob(KisBaseRectsWalkerSP walker,
         (job->accessRect().intersects(walker->changeRect()));
 }
 
+qint32 KisUpdaterContext::effectiveThreadCount(qint32 threadCount)
+{
+    if(threadCount <= 0) {
+        threadCount = KisImageConfig(true).maxNumberOfThreads();
+    }
+
+    return threadCount > 0 ? threadCount : 1;
+}
+
 qint32 KisUpdaterContext::findSpareThread()
 {
     for(qint32 i=0; i < m_jobs.size(); i++)
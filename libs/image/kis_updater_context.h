@@ -22,11 +22,11 @@
 #include <QObject>
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_lock_free_lod_counter.h"
+#include "kis_work_stealing_executor.h"
 
 
 class KisUpdateJobItem;
@@ -130,6 +130,8 @@ protected:
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
 
+    static qint32 effectiveThreadCount(qint32 threadCount);
+
 protected:
     /**
      * The lock is shared by all the child update job items.
@@ -141,7 +143,7 @@ protected:
 
     QMutex m_lock;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    KisWorkStealingExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
 };
 
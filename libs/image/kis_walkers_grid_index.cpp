@@ -0,0 +1,216 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_walkers_grid_index.h"
+
+#include <algorithm>
+
+#include "kis_debug.h"
+
+
+namespace {
+
+inline qint32 floorDiv(qint32 value, qint32 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+}
+
+KisWalkersGridIndex::KisWalkersGridIndex()
+    : m_cellWidth(128),
+      m_cellHeight(128),
+      m_nextSeqNo(0)
+{
+}
+
+void KisWalkersGridIndex::setCellSize(int cellWidth, int cellHeight)
+{
+    cellWidth = qMax(1, cellWidth);
+    cellHeight = qMax(1, cellHeight);
+
+    if (cellWidth == m_cellWidth && cellHeight == m_cellHeight) return;
+
+    QVector<Entry> entries;
+    Q_FOREACH (const Cell &cell, m_cells) {
+        entries += cell;
+    }
+
+    m_cells.clear();
+    m_positions.clear();
+
+    m_cellWidth = cellWidth;
+    m_cellHeight = cellHeight;
+
+    Q_FOREACH (const Entry &entry, entries) {
+        insertEntry(entry);
+    }
+}
+
+quint64 KisWalkersGridIndex::cellKey(qint32 col, qint32 row)
+{
+    return (quint64(quint32(col)) << 32) | quint32(row);
+}
+
+quint64 KisWalkersGridIndex::cellKeyForPoint(const QPoint &pt) const
+{
+    return cellKey(floorDiv(pt.x(), m_cellWidth),
+                   floorDiv(pt.y(), m_cellHeight));
+}
+
+void KisWalkersGridIndex::insertEntry(const Entry &entry)
+{
+    const quint64 key = cellKeyForPoint(entry.anchor);
+
+    m_cells[key].append(entry);
+
+    Position pos;
+    pos.cellKey = key;
+    pos.seqNo = entry.seqNo;
+    m_positions.insert(entry.walker.data(), pos);
+}
+
+void KisWalkersGridIndex::removeEntry(KisBaseRectsWalker *walker, quint64 key)
+{
+    QHash<quint64, Cell>::iterator cellIt = m_cells.find(key);
+    KIS_ASSERT_RECOVER_RETURN(cellIt != m_cells.end());
+
+    Cell &cell = cellIt.value();
+
+    for (int i = 0; i < cell.size(); i++) {
+        if (cell[i].walker.data() == walker) {
+            cell.remove(i);
+            break;
+        }
+    }
+
+    if (cell.isEmpty()) {
+        m_cells.erase(cellIt);
+    }
+}
+
+void KisWalkersGridIndex::addWalker(KisBaseRectsWalkerSP walker)
+{
+    KIS_ASSERT_RECOVER_RETURN(!m_positions.contains(walker.data()));
+
+    Entry entry;
+    entry.seqNo = m_nextSeqNo++;
+    entry.anchor = walker->requestedRect().topLeft();
+    entry.walker = walker;
+
+    insertEntry(entry);
+}
+
+void KisWalkersGridIndex::removeWalker(KisBaseRectsWalkerSP walker)
+{
+    QHash<KisBaseRectsWalker*, Position>::iterator it =
+        m_positions.find(walker.data());
+
+    if (it == m_positions.end()) return;
+
+    const quint64 key = it.value().cellKey;
+    m_positions.erase(it);
+    removeEntry(walker.data(), key);
+}
+
+void KisWalkersGridIndex::updateWalker(KisBaseRectsWalkerSP walker)
+{
+    QHash<KisBaseRectsWalker*, Position>::iterator it =
+        m_positions.find(walker.data());
+
+    KIS_ASSERT_RECOVER_RETURN(it != m_positions.end());
+
+    Entry entry;
+    entry.seqNo = it.value().seqNo;
+    entry.anchor = walker->requestedRect().topLeft();
+    entry.walker = walker;
+
+    const quint64 oldKey = it.value().cellKey;
+    m_positions.erase(it);
+    removeEntry(walker.data(), oldKey);
+
+    insertEntry(entry);
+}
+
+void KisWalkersGridIndex::clear()
+{
+    m_cells.clear();
+    m_positions.clear();
+}
+
+int KisWalkersGridIndex::size() const
+{
+    return m_positions.size();
+}
+
+QList<KisBaseRectsWalkerSP> KisWalkersGridIndex::walkersInArea(const QRect &area) const
+{
+    QList<KisBaseRectsWalkerSP> result;
+    if (!area.isValid() || m_cells.isEmpty()) return result;
+
+    QVector<Entry> entries;
+
+    const qint32 firstCol = floorDiv(area.left(), m_cellWidth);
+    const qint32 lastCol = floorDiv(area.right(), m_cellWidth);
+    const qint32 firstRow = floorDiv(area.top(), m_cellHeight);
+    const qint32 lastRow = floorDiv(area.bottom(), m_cellHeight);
+
+    const qint64 numAreaCells =
+        qint64(lastCol - firstCol + 1) * (lastRow - firstRow + 1);
+
+    /**
+     * When the area covers more cells than there are non-empty ones,
+     * it is cheaper to check all the non-empty cells directly
+     */
+    if (numAreaCells <= m_cells.size()) {
+        for (qint32 row = firstRow; row <= lastRow; row++) {
+            for (qint32 col = firstCol; col <= lastCol; col++) {
+                QHash<quint64, Cell>::const_iterator it =
+                    m_cells.constFind(cellKey(col, row));
+
+                if (it == m_cells.constEnd()) continue;
+
+                Q_FOREACH (const Entry &entry, it.value()) {
+                    if (area.contains(entry.anchor)) {
+                        entries.append(entry);
+                    }
+                }
+            }
+        }
+    } else {
+        Q_FOREACH (const Cell &cell, m_cells) {
+            Q_FOREACH (const Entry &entry, cell) {
+                if (area.contains(entry.anchor)) {
+                    entries.append(entry);
+                }
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [] (const Entry &lhs, const Entry &rhs) {
+                  return lhs.seqNo < rhs.seqNo;
+              });
+
+    result.reserve(entries.size());
+    Q_FOREACH (const Entry &entry, entries) {
+        result.append(entry.walker);
+    }
+
+    return result;
+}
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_WALKERS_GRID_INDEX_H
+#define __KIS_WALKERS_GRID_INDEX_H
+
+#include <QHash>
+#include <QVector>
+#include <QRect>
+
+#include "kritaimage_export.h"
+#include "kis_base_rects_walker.h"
+
+
+/**
+ * A spatial index over the walkers pending in KisSimpleUpdateQueue.
+ *
+ * Every walker is put into the cell of a uniform grid that contains
+ * the top-left corner of its requested rect (the anchor of the
+ * walker). Since the queue can merge only the walkers whose united
+ * rect doesn't exceed the size of the update patch, all the merge
+ * candidates of a rect are anchored inside a small window around it,
+ * so the queue needs to look into a few cells only instead of walking
+ * through the whole list.
+ *
+ * The index remembers the order in which the walkers have been added
+ * and returns the walkers in this very order, so the merging results
+ * do not depend on the layout of the grid.
+ *
+ * The class is not thread-safe, the queue guards it with its own lock.
+ */
+class KRITAIMAGE_EXPORT KisWalkersGridIndex
+{
+public:
+    KisWalkersGridIndex();
+
+    /**
+     * Changes the size of the grid cells. The walkers that are
+     * already in the index are redistributed among the new cells.
+     */
+    void setCellSize(int cellWidth, int cellHeight);
+
+    void addWalker(KisBaseRectsWalkerSP walker);
+    void removeWalker(KisBaseRectsWalkerSP walker);
+
+    /**
+     * Should be called when the requested rect of the walker
+     * has changed. The walker keeps its position in the order
+     * of addition.
+     */
+    void updateWalker(KisBaseRectsWalkerSP walker);
+
+    void clear();
+    int size() const;
+
+    /**
+     * Returns all the walkers anchored inside \p area, in the
+     * order of their addition to the index
+     */
+    QList<KisBaseRectsWalkerSP> walkersInArea(const QRect &area) const;
+
+private:
+    struct Entry {
+        quint64 seqNo;
+        QPoint anchor;
+        KisBaseRectsWalkerSP walker;
+    };
+
+    struct Position {
+        quint64 cellKey;
+        quint64 seqNo;
+    };
+
+    typedef QVector<Entry> Cell;
+
+private:
+    static inline quint64 cellKey(qint32 col, qint32 row);
+    inline quint64 cellKeyForPoint(const QPoint &pt) const;
+
+    void insertEntry(const Entry &entry);
+    void removeEntry(KisBaseRectsWalker *walker, quint64 key);
+
+private:
+    int m_cellWidth;
+    int m_cellHeight;
+    quint64 m_nextSeqNo;
+
+    QHash<quint64, Cell> m_cells;
+    QHash<KisBaseRectsWalker*, Position> m_positions;
+};
+
+#endif /* __KIS_WALKERS_GRID_INDEX_H */
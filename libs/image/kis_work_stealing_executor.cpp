@@ -0,0 +1,325 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_work_stealing_executor.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QVector>
+#include <QList>
+
+#include "kis_assert.h"
+
+
+const int KisWorkStealingExecutor::EXPIRY_TIMEOUT = 30000;
+
+
+class KisWorkStealingExecutor::Worker : public QThread
+{
+public:
+    Worker(KisWorkStealingExecutor::Private *executor, int index)
+        : m_executor(executor),
+          m_index(index)
+    {
+    }
+
+    void push(QRunnable *job) {
+        QMutexLocker l(&m_queueLock);
+        m_queue.append(job);
+    }
+
+    /**
+     * The own queue is used as a stack: the most recently added
+     * job is the one which data is most probably still in cache
+     */
+    bool popLocal(QRunnable **job) {
+        QMutexLocker l(&m_queueLock);
+
+        if (!m_queue.isEmpty()) {
+            *job = m_queue.takeLast();
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Other workers steal from the opposite end of the queue
+     */
+    bool steal(QRunnable **job) {
+        QMutexLocker l(&m_queueLock);
+
+        if (!m_queue.isEmpty()) {
+            *job = m_queue.takeFirst();
+            return true;
+        }
+
+        return false;
+    }
+
+    int numPendingJobs() {
+        QMutexLocker l(&m_queueLock);
+        return m_queue.size();
+    }
+
+    /**
+     * Guarded by KisWorkStealingExecutor::Private::idleLock
+     */
+    bool isActive = false;
+
+protected:
+    void run();
+
+private:
+    KisWorkStealingExecutor::Private *m_executor;
+    const int m_index;
+
+    QMutex m_queueLock;
+    QList<QRunnable*> m_queue;
+};
+
+
+struct KisWorkStealingExecutor::Private
+{
+    QVector<Worker*> workers;
+    QAtomicInt nextWorker;
+
+    /**
+     * The number of jobs sitting in the queues of the workers
+     */
+    QAtomicInt numPendingJobs;
+
+    /**
+     * The number of jobs that have been started but not
+     * finished yet (including the pending ones)
+     */
+    int numUnfinishedJobs = 0;
+    QMutex doneLock;
+    QWaitCondition doneCondition;
+
+    QMutex idleLock;
+    QWaitCondition idleCondition;
+    int numIdleWorkers = 0;
+    bool shouldExit = false;
+
+    int currentWorkerIndex() const {
+        QThread *thread = QThread::currentThread();
+
+        for (int i = 0; i < workers.size(); i++) {
+            if (workers[i] == thread) return i;
+        }
+
+        return -1;
+    }
+
+    bool takeJob(int workerIndex, QRunnable **job) {
+        if (!numPendingJobs.load()) return false;
+
+        if (workers[workerIndex]->popLocal(job)) {
+            numPendingJobs.deref();
+            return true;
+        }
+
+        for (int i = 1; i < workers.size(); i++) {
+            Worker *victim = workers[(workerIndex + i) % workers.size()];
+
+            if (victim->steal(job)) {
+                numPendingJobs.deref();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void wakeIdleWorker() {
+        QMutexLocker l(&idleLock);
+        if (numIdleWorkers > 0) {
+            idleCondition.wakeOne();
+        }
+    }
+
+    /**
+     * Wakes up an idle worker or, if there is none, starts a new
+     * one. The worker \p preferredIndex is started first, because
+     * the job has been put into its queue.
+     */
+    void wakeOrStartWorker(int preferredIndex) {
+        QMutexLocker l(&idleLock);
+
+        if (numIdleWorkers > 0) {
+            idleCondition.wakeOne();
+            return;
+        }
+
+        for (int i = 0; i < workers.size(); i++) {
+            Worker *worker = workers[(preferredIndex + i) % workers.size()];
+
+            if (!worker->isActive) {
+                worker->isActive = true;
+
+                /**
+                 * The worker might have just expired and still be
+                 * returning from run(), when start() would be a noop
+                 */
+                worker->wait();
+                worker->start();
+                return;
+            }
+        }
+    }
+
+    void jobFinished() {
+        QMutexLocker l(&doneLock);
+        if (--numUnfinishedJobs == 0) {
+            doneCondition.wakeAll();
+        }
+    }
+};
+
+void KisWorkStealingExecutor::Worker::run()
+{
+    while (1) {
+        QRunnable *job = 0;
+
+        if (m_executor->takeJob(m_index, &job)) {
+            /**
+             * The flag must be read before run(), because the job
+             * that is not auto-deleted may be restarted as soon as
+             * it reports its completion
+             */
+            const bool autoDelete = job->autoDelete();
+
+            job->run();
+
+            if (autoDelete) {
+                delete job;
+            }
+
+            m_executor->jobFinished();
+            continue;
+        }
+
+        QMutexLocker l(&m_executor->idleLock);
+
+        if (m_executor->shouldExit) break;
+
+        /**
+         * The producers increment the counter before taking
+         * idleLock to wake us up, so checking it under the
+         * lock guarantees no wake up is lost
+         */
+        if (!m_executor->numPendingJobs.load()) {
+            m_executor->numIdleWorkers++;
+            const bool woken =
+                m_executor->idleCondition.wait(&m_executor->idleLock, EXPIRY_TIMEOUT);
+            m_executor->numIdleWorkers--;
+
+            if (!woken && !m_executor->numPendingJobs.load()) {
+                isActive = false;
+                break;
+            }
+        }
+    }
+}
+
+
+KisWorkStealingExecutor::KisWorkStealingExecutor(int numThreads)
+    : m_d(new Private)
+{
+    KIS_ASSERT_RECOVER(numThreads > 0) { numThreads = 1; }
+
+    for (int i = 0; i < numThreads; i++) {
+        m_d->workers.append(new Worker(m_d.data(), i));
+    }
+}
+
+KisWorkStealingExecutor::~KisWorkStealingExecutor()
+{
+    waitForDone();
+
+    {
+        QMutexLocker l(&m_d->idleLock);
+        m_d->shouldExit = true;
+        m_d->idleCondition.wakeAll();
+    }
+
+    Q_FOREACH (Worker *worker, m_d->workers) {
+        worker->wait();
+        delete worker;
+    }
+}
+
+int KisWorkStealingExecutor::numThreads() const
+{
+    return m_d->workers.size();
+}
+
+int KisWorkStealingExecutor::numActiveThreads() const
+{
+    QMutexLocker l(&m_d->idleLock);
+
+    int result = 0;
+    Q_FOREACH (Worker *worker, m_d->workers) {
+        result += worker->isActive;
+    }
+
+    return result;
+}
+
+void KisWorkStealingExecutor::start(QRunnable *job)
+{
+    {
+        QMutexLocker l(&m_d->doneLock);
+        m_d->numUnfinishedJobs++;
+    }
+
+    int workerIndex = m_d->currentWorkerIndex();
+    const bool isLocalJob = workerIndex >= 0;
+
+    if (!isLocalJob) {
+        workerIndex = quint32(m_d->nextWorker.fetchAndAddOrdered(1)) % m_d->workers.size();
+    }
+
+    Worker *worker = m_d->workers[workerIndex];
+    worker->push(job);
+    m_d->numPendingJobs.ref();
+
+    /**
+     * The current worker will take its first local job itself right
+     * after the running one returns, all the other jobs should be
+     * picked up by the idle workers
+     */
+    if (!isLocalJob || worker->numPendingJobs() > 1) {
+        m_d->wakeOrStartWorker(workerIndex);
+    }
+}
+
+void KisWorkStealingExecutor::waitForDone()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_d->currentWorkerIndex() < 0);
+
+    QMutexLocker l(&m_d->doneLock);
+    while (m_d->numUnfinishedJobs > 0) {
+        m_d->doneCondition.wait(&m_d->doneLock);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_WORK_STEALING_EXECUTOR_H
+#define __KIS_WORK_STEALING_EXECUTOR_H
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+class QRunnable;
+
+
+/**
+ * A thread pool with a fixed maximum number of threads used by
+ * KisUpdaterContext instead of QThreadPool.
+ *
+ * Every worker has its own queue of jobs. A job started from inside
+ * a worker thread (e.g. the scheduler is asked for more work by a job
+ * that has just finished) is put into the queue of this very worker,
+ * so it is picked up without waking any other thread and with the
+ * caches still hot. Idle workers steal jobs from the queues of the
+ * busy ones.
+ *
+ * The queues are not lock-free: each of them is guarded by its own
+ * mutex, which is shared only by the owner and an occasional thief,
+ * so it is almost never contended.
+ *
+ * The worker threads are started lazily, when there is no idle worker
+ * to pick up a new job, and exit after staying idle for
+ * EXPIRY_TIMEOUT ms, so the images that are never updated (clones,
+ * snapshots) don't keep any threads.
+ *
+ * The runnables are deleted after run() if their autoDelete() flag is
+ * set, like QThreadPool does. Such a runnable must not be started
+ * twice.
+ */
+class KRITAIMAGE_EXPORT KisWorkStealingExecutor
+{
+public:
+    static const int EXPIRY_TIMEOUT;
+
+public:
+    KisWorkStealingExecutor(int numThreads);
+    ~KisWorkStealingExecutor();
+
+    /**
+     * The maximum number of the worker threads
+     */
+    int numThreads() const;
+
+    /**
+     * The number of the worker threads running at the moment
+     */
+    int numActiveThreads() const;
+
+    /**
+     * Schedules \p job for execution. The same runnable may be started
+     * again as soon as it has reported its completion, even if its
+     * run() method has not returned yet.
+     */
+    void start(QRunnable *job);
+
+    /**
+     * Blocks until all the started jobs are finished. Must not be
+     * called from a worker thread.
+     */
+    void waitForDone();
+
+private:
+    class Worker;
+    friend class Worker;
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_WORK_STEALING_EXECUTOR_H */
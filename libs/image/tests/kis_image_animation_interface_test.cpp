@@ -31,6 +31,7 @@
 #include "kis_signal_compressor_with_param.h"
 #include "kis_raster_keyframe_channel.h"
 #include "kis_time_range.h"
+#include "kis_clone_layer.h"
 
 
 void checkFrame(KisImageAnimationInterface *i, KisImageSP image, int frameId, bool externalFrameActive, const QRect &rc)
@@ -256,4 +257,135 @@ void KisImageAnimationInterfaceTest::testSwitchFrameWithUndo()
     QCOMPARE(i->currentTime(), 0);
 }
 
+void KisImageAnimationInterfaceTest::testRegenerateFrameInClone()
+{
+    QRect refRect(QRect(0,0,512,512));
+    TestUtil::MaskParent p(refRect);
+
+    KisPaintLayerSP layer2 = new KisPaintLayer(p.image, "paint2", OPACITY_OPAQUE_U8);
+    p.image->addNode(layer2);
+
+    const QRect rc1(101,101,100,100);
+    const QRect rc2(102,102,100,100);
+    const QRect rc3(103,103,100,100);
+    const QRect rc4(104,104,100,100);
+
+    KisImageAnimationInterface *i = p.image->animationInterface();
+    KisPaintDeviceSP dev1 = p.layer->paintDevice();
+    KisPaintDeviceSP dev2 = layer2->paintDevice();
+
+    dev1->fill(rc1, KoColor(Qt::red, dev1->colorSpace()));
+    dev2->fill(rc2, KoColor(Qt::green, dev2->colorSpace()));
+
+    i->switchCurrentTimeAsync(10);
+    p.image->waitForDone();
+
+    dev1->keyframeChannel()->addKeyframe(10);
+    dev2->keyframeChannel()->addKeyframe(10);
+
+    dev1->fill(rc3, KoColor(Qt::red, dev1->colorSpace()));
+    dev2->fill(rc4, KoColor(Qt::green, dev2->colorSpace()));
+
+    i->switchCurrentTimeAsync(0);
+    p.image->waitForDone();
+    checkFrame(i, p.image, 0, false, rc1 | rc2);
+
+    i->setFullClipRange(KisTimeRange::fromTime(0, 20));
+
+    p.image->barrierLock();
+    KisImageSP clone = p.image->clone();
+    p.image->unlock();
+
+    KisImageAnimationInterface *ci = clone->animationInterface();
+    QCOMPARE(ci->fullClipRange(), i->fullClipRange());
+    QCOMPARE(ci->framerate(), i->framerate());
+    QCOMPARE(clone->root()->childCount(), 2U);
+
+    KisPaintLayerSP cloneLayer1 = dynamic_cast<KisPaintLayer*>(clone->root()->at(0).data());
+    KisPaintLayerSP cloneLayer2 = dynamic_cast<KisPaintLayer*>(clone->root()->at(1).data());
+    QVERIFY(cloneLayer1);
+    QVERIFY(cloneLayer2);
+    QCOMPARE(cloneLayer1->image().data(), clone.data());
+    QVERIFY(cloneLayer1->paintDevice() != dev1);
+    QVERIFY(cloneLayer1->isAnimated());
+    QCOMPARE(cloneLayer1->paintDevice()->exactBounds(), rc1);
+
+    // regenerate frame 10 in the clone only
+    {
+        SignalToFunctionProxy proxy(std::bind(checkFrame, ci, clone, 10, true, rc3 | rc4));
+        connect(ci, SIGNAL(sigFrameReady(int)), &proxy, SLOT(start()), Qt::DirectConnection);
+        ci->requestFrameRegeneration(10, QRegion(refRect));
+        QTest::qWait(200);
+        clone->waitForDone();
+    }
+
+    // the original image is not affected
+    checkFrame(i, p.image, 0, false, rc1 | rc2);
+
+    // the pixel data is not shared after the write
+    cloneLayer1->paintDevice()->clear();
+    QVERIFY(cloneLayer1->paintDevice()->exactBounds().isEmpty());
+    QCOMPARE(dev1->exactBounds(), rc1);
+}
+
+void KisImageAnimationInterfaceTest::testRegenerateFrameInCloneWithCloneLayer()
+{
+    QRect refRect(QRect(0,0,512,512));
+    TestUtil::MaskParent p(refRect);
+
+    const QPoint cloneOffset(200, 0);
+
+    KisCloneLayerSP cloneLayer = new KisCloneLayer(p.layer, p.image, "clone", OPACITY_OPAQUE_U8);
+    cloneLayer->setX(cloneOffset.x());
+    cloneLayer->setY(cloneOffset.y());
+    p.image->addNode(cloneLayer);
+
+    const QRect rc1(101,101,100,100);
+    const QRect rc3(103,103,100,100);
+
+    KisImageAnimationInterface *i = p.image->animationInterface();
+    KisPaintDeviceSP dev1 = p.layer->paintDevice();
+
+    dev1->fill(rc1, KoColor(Qt::red, dev1->colorSpace()));
+
+    i->switchCurrentTimeAsync(10);
+    p.image->waitForDone();
+
+    dev1->keyframeChannel()->addKeyframe(10);
+    dev1->fill(rc3, KoColor(Qt::red, dev1->colorSpace()));
+
+    i->switchCurrentTimeAsync(0);
+    p.image->waitForDone();
+    checkFrame(i, p.image, 0, false, rc1 | rc1.translated(cloneOffset));
+
+    i->setFullClipRange(KisTimeRange::fromTime(0, 20));
+
+    p.image->barrierLock();
+    KisImageSP clone = p.image->clone();
+    p.image->unlock();
+
+    QCOMPARE(clone->root()->childCount(), 2U);
+
+    KisNodeSP clonedSource = clone->root()->at(0);
+    KisCloneLayerSP clonedCloneLayer = dynamic_cast<KisCloneLayer*>(clone->root()->at(1).data());
+    QVERIFY(clonedCloneLayer);
+
+    // the clone layer of the copy should read from the copy
+    QCOMPARE(KisNodeSP(clonedCloneLayer->copyFrom()), clonedSource);
+    QCOMPARE(KisNodeSP(cloneLayer->copyFrom()), KisNodeSP(p.layer));
+
+    // regenerate frame 10 in the copy only, the original stays at frame 0
+    KisImageAnimationInterface *ci = clone->animationInterface();
+    {
+        SignalToFunctionProxy proxy(std::bind(checkFrame, ci, clone, 10, true,
+                                              rc3 | rc3.translated(cloneOffset)));
+        connect(ci, SIGNAL(sigFrameReady(int)), &proxy, SLOT(start()), Qt::DirectConnection);
+        ci->requestFrameRegeneration(10, QRegion(refRect));
+        QTest::qWait(200);
+        clone->waitForDone();
+    }
+
+    checkFrame(i, p.image, 0, false, rc1 | rc1.translated(cloneOffset));
+}
+
 QTEST_MAIN(KisImageAnimationInterfaceTest)
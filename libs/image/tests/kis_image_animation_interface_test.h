@@ -36,6 +36,9 @@ private Q_SLOTS:
 
     void testSwitchFrameWithUndo();
 
+    void testRegenerateFrameInClone();
+    void testRegenerateFrameInCloneWithCloneLayer();
+
 
 
     void slotFrameDone();
@@ -181,5 +181,109 @@ void KisMaskGeneratorTest::testCopyCtorGaussRect()
     testCopyCtor(&gen);
 }
 
+#include <QtMath>
+#include <KoColorSpaceRegistry.h>
+#include "kis_fixed_paint_device.h"
+#include "kis_brush_mask_applicator_base.h"
+
+void testApplicator(KisMaskGenerator *gen)
+{
+    gen->setScale(1.0, 1.0);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rc(0, 0, qCeil(gen->width()) + 2, qCeil(gen->height()) + 2);
+    const qreal centerX = 0.5 * rc.width();
+    const qreal centerY = 0.5 * rc.height();
+
+    KisFixedPaintDeviceSP dev1 = new KisFixedPaintDevice(cs);
+    dev1->setRect(rc);
+    dev1->initialize(255);
+
+    KisFixedPaintDeviceSP dev2 = new KisFixedPaintDevice(cs);
+    dev2->setRect(rc);
+    dev2->initialize(255);
+
+    KisBrushMaskApplicatorBase *applicator = gen->applicator();
+
+    MaskProcessingData data1(dev1, cs, 0.0, 1.0, centerX, centerY, 0.0);
+    applicator->initializeData(&data1);
+    applicator->process(rc);
+
+    MaskProcessingData data2(dev2, cs, 0.0, 1.0, centerX, centerY, 0.0);
+    applicator->initializeData(&data2);
+    applicator->processInBands(rc, 4);
+
+    // the bands should not change the result
+    const int numBytes = rc.width() * rc.height() * cs->pixelSize();
+    QVERIFY(!memcmp(dev1->data(), dev2->data(), numBytes));
+
+    // the vectorized applicators should match valueAt() up to rounding
+    const quint8 *pixel = dev1->data();
+
+    for (int y = rc.top(); y <= rc.bottom(); y++) {
+        for (int x = rc.left(); x <= rc.right(); x++) {
+            const int expected = 255 - gen->valueAt(x - centerX, y - centerY);
+            const int result = cs->opacityU8(pixel);
+
+            if (qAbs(expected - result) > 2) {
+                QFAIL(QString("Pixel %1,%2 differs: expected %3, got %4")
+                      .arg(x).arg(y).arg(expected).arg(result).toLatin1());
+            }
+
+            pixel += cs->pixelSize();
+        }
+    }
+}
+
+void KisMaskGeneratorTest::testApplicatorCircle()
+{
+    KisCircleMaskGenerator gen(200, 0.8, 0.75, 0.85, 2, true);
+    testApplicator(&gen);
+}
+
+void KisMaskGeneratorTest::testApplicatorRect()
+{
+    KisRectangleMaskGenerator gen(200, 0.8, 0.75, 0.85, 2, true);
+    testApplicator(&gen);
+}
+
+void KisMaskGeneratorTest::testApplicatorCurveCircle()
+{
+    KisCurveCircleMaskGenerator gen(200, 0.8,
+                                    0.75, 0.85,
+                                    2,
+                                    KisCubicCurve(), // linear
+                                    true);
+    testApplicator(&gen);
+}
+
+void KisMaskGeneratorTest::testApplicatorCurveRect()
+{
+    KisCurveRectangleMaskGenerator gen(200, 0.8,
+                                       0.75, 0.85,
+                                       2,
+                                       KisCubicCurve(), // linear
+                                       true);
+    testApplicator(&gen);
+}
+
+void KisMaskGeneratorTest::testApplicatorGaussCircle()
+{
+    KisGaussCircleMaskGenerator gen(200, 0.8,
+                                    0.75, 0.85,
+                                    2,
+                                    true);
+    testApplicator(&gen);
+}
+
+void KisMaskGeneratorTest::testApplicatorGaussRect()
+{
+    KisGaussRectangleMaskGenerator gen(200, 0.8,
+                                       0.75, 0.85,
+                                       2,
+                                       true);
+    testApplicator(&gen);
+}
+
 
 QTEST_MAIN(KisMaskGeneratorTest)
@@ -37,6 +37,13 @@ private Q_SLOTS:
 
     void testCopyCtorGaussCircle();
     void testCopyCtorGaussRect();
+
+    void testApplicatorCircle();
+    void testApplicatorRect();
+    void testApplicatorCurveCircle();
+    void testApplicatorCurveRect();
+    void testApplicatorGaussCircle();
+    void testApplicatorGaussRect();
 };
 
 #endif
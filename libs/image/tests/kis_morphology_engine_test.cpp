@@ -0,0 +1,292 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_morphology_engine_test.h"
+
+#include <QTest>
+
+#include <algorithm>
+#include <cmath>
+
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_morphology_engine.h"
+#include "kis_paint_device.h"
+
+
+namespace {
+
+bool pointLessThan(const QPoint &p1, const QPoint &p2)
+{
+    return p1.y() < p2.y() || (p1.y() == p2.y() && p1.x() < p2.x());
+}
+
+KisPaintDeviceSP createRandomDevice(const QRect &rect)
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+
+    /**
+     * Fill a slightly bigger area to check that the pixels outside
+     * the rect are not read by the engine
+     */
+    const QRect fillRect = rect.adjusted(-20, -20, 20, 20);
+    QVector<quint8> data(fillRect.width() * fillRect.height());
+
+    qsrand(1);
+    for (int i = 0; i < data.size(); i++) {
+        // sparse spots make the errors in the shape of the element visible
+        data[i] = qrand() % 50 == 0 ? qrand() % 256 : 0;
+    }
+
+    dev->writeBytes(data.constData(), fillRect);
+    return dev;
+}
+
+QVector<quint8> bruteForce(KisMorphologyEngine::Operation operation,
+                           KisMorphologyEngine::BorderMode borderMode,
+                           const QVector<quint8> &src, const QRect &rect,
+                           const QVector<QPoint> &element)
+{
+    QVector<quint8> result(src.size());
+
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            int value = operation == KisMorphologyEngine::DILATE ? 0 : 255;
+
+            Q_FOREACH (const QPoint &offset, element) {
+                int sx = x + offset.x();
+                int sy = y + offset.y();
+                int sample = 0;
+
+                if (borderMode == KisMorphologyEngine::BORDER_REPEAT) {
+                    sx = qBound(0, sx, rect.width() - 1);
+                    sy = qBound(0, sy, rect.height() - 1);
+                    sample = src[sy * rect.width() + sx];
+                } else if (sx >= 0 && sx < rect.width() &&
+                           sy >= 0 && sy < rect.height()) {
+                    sample = src[sy * rect.width() + sx];
+                }
+
+                value = operation == KisMorphologyEngine::DILATE ?
+                    qMax(value, sample) : qMin(value, sample);
+            }
+
+            result[y * rect.width() + x] = value;
+        }
+    }
+
+    return result;
+}
+
+}
+
+void KisMorphologyEngineTest::checkEngine(const StageBuilder &addStages, const QRect &rect)
+{
+    for (int op = 0; op < 2; op++) {
+        for (int border = 0; border < 2; border++) {
+            const KisMorphologyEngine::Operation operation =
+                op ? KisMorphologyEngine::ERODE : KisMorphologyEngine::DILATE;
+            const KisMorphologyEngine::BorderMode borderMode =
+                border ? KisMorphologyEngine::BORDER_REPEAT : KisMorphologyEngine::BORDER_ZERO;
+
+            KisMorphologyEngine engine(operation, borderMode);
+            addStages(engine);
+
+            KisPaintDeviceSP dev = createRandomDevice(rect);
+            if (operation == KisMorphologyEngine::ERODE) {
+                // make the erosion meaningful: invert the sparse spots
+                KisPaintDeviceSP inverted = createRandomDevice(rect);
+                QVector<quint8> data(rect.width() * rect.height());
+                inverted->readBytes(data.data(), rect);
+                for (int i = 0; i < data.size(); i++) {
+                    data[i] = 255 - data[i];
+                }
+                dev->writeBytes(data.constData(), rect);
+            }
+
+            QVector<quint8> src(rect.width() * rect.height());
+            dev->readBytes(src.data(), rect);
+
+            const QVector<quint8> expected =
+                bruteForce(operation, borderMode, src, rect, engine.structuringElement());
+
+            const QRect outerRect = rect.adjusted(-20, -20, 20, 20);
+            QVector<quint8> outerBefore(outerRect.width() * outerRect.height());
+            dev->readBytes(outerBefore.data(), outerRect);
+
+            engine.process(dev, rect);
+
+            QVector<quint8> result(rect.width() * rect.height());
+            dev->readBytes(result.data(), rect);
+
+            for (int i = 0; i < result.size(); i++) {
+                if (result[i] != expected[i]) {
+                    qDebug() << "op" << op << "border" << border
+                             << "pixel" << rect.topLeft() + QPoint(i % rect.width(), i / rect.width())
+                             << "result" << result[i] << "expected" << expected[i];
+                    QFAIL("the result differs from the brute force one");
+                }
+            }
+
+            QVector<quint8> outerAfter(outerRect.width() * outerRect.height());
+            dev->readBytes(outerAfter.data(), outerRect);
+
+            for (int y = 0; y < outerRect.height(); y++) {
+                for (int x = 0; x < outerRect.width(); x++) {
+                    if (rect.contains(outerRect.topLeft() + QPoint(x, y))) continue;
+
+                    const int i = y * outerRect.width() + x;
+                    QCOMPARE(outerAfter[i], outerBefore[i]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * The rects are bigger than the minimum block size of the engine,
+ * so the seams between the parallel blocks are checked as well.
+ */
+
+void KisMorphologyEngineTest::testHorizontalLine()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addLine(1, 0, 7);
+        }, QRect(13, 7, 600, 300));
+}
+
+void KisMorphologyEngineTest::testVerticalLine()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addLine(0, 1, 9);
+        }, QRect(13, 7, 300, 600));
+}
+
+void KisMorphologyEngineTest::testSlantedLines()
+{
+    const QVector<QPoint> directions =
+        QVector<QPoint>() << QPoint(1, 1) << QPoint(-1, 1)
+                          << QPoint(2, 1) << QPoint(-2, 1)
+                          << QPoint(1, 2) << QPoint(-1, -2);
+
+    Q_FOREACH (const QPoint &dir, directions) {
+        checkEngine([dir] (KisMorphologyEngine &engine) {
+                engine.addLine(dir.x(), dir.y(), 5);
+            }, QRect(13, 7, 400, 300));
+    }
+}
+
+void KisMorphologyEngineTest::testChords()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addVerticalChords(QVector<int>() << 0 << 1 << 0);
+        }, QRect(13, 7, 600, 300));
+
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addVerticalChords(QVector<int>() << 1 << -1 << 4 << -1 << 1);
+        }, QRect(13, 7, 300, 300));
+}
+
+void KisMorphologyEngineTest::testStages()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addLine(1, 0, 3);
+            engine.addLine(1, 1, 2);
+            engine.addVerticalChords(QVector<int>() << 0 << 2 << 0);
+        }, QRect(13, 7, 300, 300));
+}
+
+void KisMorphologyEngineTest::testSmallEllipse()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addEllipse(5, 3);
+        }, QRect(13, 7, 300, 300));
+}
+
+void KisMorphologyEngineTest::testBigEllipse()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addEllipse(20, 20);
+        }, QRect(13, 7, 300, 280));
+}
+
+void KisMorphologyEngineTest::testBigEllipseIsExact()
+{
+    /**
+     * Grow/Shrink Selection and the layer styles should not change the
+     * result depending on the radius, so the element must be exactly
+     * the set of chords of the ellipse
+     */
+    const QVector<QPoint> radii =
+        QVector<QPoint>() << QPoint(17, 17) << QPoint(20, 20)
+                          << QPoint(40, 25) << QPoint(24, 60);
+
+    Q_FOREACH (const QPoint &r, radii) {
+        QVector<int> chords(2 * r.x() + 1);
+        for (int i = 0; i < chords.size(); i++) {
+            const qreal tmp = i != r.x() ? qAbs(i - r.x()) - 0.5 : 0.0;
+            chords[i] = std::floor(qreal(r.y()) / r.x() * std::sqrt(r.x() * r.x() - tmp * tmp) + 0.5);
+        }
+
+        KisMorphologyEngine engine(KisMorphologyEngine::DILATE,
+                                   KisMorphologyEngine::BORDER_ZERO);
+        engine.addEllipse(r.x(), r.y());
+
+        KisMorphologyEngine reference(KisMorphologyEngine::DILATE,
+                                      KisMorphologyEngine::BORDER_ZERO);
+        reference.addVerticalChords(chords);
+
+        QVector<QPoint> element = engine.structuringElement();
+        QVector<QPoint> expected = reference.structuringElement();
+        std::sort(element.begin(), element.end(), pointLessThan);
+        std::sort(expected.begin(), expected.end(), pointLessThan);
+
+        QCOMPARE(element, expected);
+    }
+}
+
+void KisMorphologyEngineTest::testApproximateEllipse()
+{
+    checkEngine([] (KisMorphologyEngine &engine) {
+            engine.addEllipse(20, 20, KisMorphologyEngine::APPROXIMATE_ELLIPSE);
+        }, QRect(13, 7, 300, 280));
+}
+
+void KisMorphologyEngineTest::testEllipseExtent()
+{
+    const QVector<QPoint> radii =
+        QVector<QPoint>() << QPoint(3, 3) << QPoint(7, 2) << QPoint(0, 5)
+                          << QPoint(5, 0) << QPoint(20, 20) << QPoint(40, 25);
+
+    Q_FOREACH (const QPoint &r, radii) {
+        KisMorphologyEngine engine(KisMorphologyEngine::DILATE,
+                                   KisMorphologyEngine::BORDER_ZERO);
+        engine.addEllipse(r.x(), r.y());
+
+        QCOMPARE(engine.extent(), r);
+
+        QRect bounds;
+        Q_FOREACH (const QPoint &pt, engine.structuringElement()) {
+            bounds |= QRect(pt, QSize(1, 1));
+        }
+
+        QCOMPARE(bounds, QRect(-r, r));
+    }
+}
+
+QTEST_MAIN(KisMorphologyEngineTest)
@@ -2182,6 +2182,64 @@ void KisPaintDeviceTest::testCopyPaintDeviceWithFrames()
     QVERIFY(channel->keyframeAt(10));
 }
 
+#include <QDomDocument>
+
+void KisPaintDeviceTest::testFramesEqualContent()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    TestUtil::TestingTimedDefaultBounds *bounds = new TestUtil::TestingTimedDefaultBounds();
+    dev->setDefaultBounds(bounds);
+
+    KisRasterKeyframeChannel *channel = dev->createKeyframeChannel(KisKeyframeChannel::Content, 0);
+    QVERIFY(channel);
+
+    KisPaintDeviceFramesInterface *i = dev->framesInterface();
+    QVERIFY(i);
+
+    const QRect rc(100, 100, 100, 100);
+    dev->fill(rc, KoColor(Qt::red, cs));
+
+    KUndo2Command parentCommand;
+
+    KisKeyframeSP key0 = channel->keyframeAt(0);
+    KisKeyframeSP key10 = channel->addKeyframe(10, &parentCommand);
+    KisKeyframeSP key20 = channel->copyKeyframe(key0, 20, &parentCommand);
+    QVERIFY(key0);
+    QVERIFY(key10);
+    QVERIFY(key20);
+
+    const int id0 = key0->value();
+    const int id10 = key10->value();
+    const int id20 = key20->value();
+
+    // the duplicated frame shares the tiles
+    QVERIFY(i->framesHaveEqualContent(id0, id20));
+    QVERIFY(!i->framesHaveEqualContent(id0, id10));
+
+    // the same content painted independently
+    bounds->testingSetTime(10);
+    dev->fill(rc, KoColor(Qt::red, cs));
+    QVERIFY(i->framesHaveEqualContent(id0, id10));
+    QVERIFY(i->framesHaveEqualContent(id10, id20));
+    QCOMPARE(i->frameContentHash(id0), i->frameContentHash(id10));
+    QCOMPARE(i->frameContentHash(id10), i->frameContentHash(id20));
+
+    dev->setPixel(150, 150, KoColor(Qt::green, cs));
+    QVERIFY(!i->framesHaveEqualContent(id0, id10));
+    QVERIFY(i->framesHaveEqualContent(id0, id20));
+    QVERIFY(i->frameContentHash(id0) != i->frameContentHash(id10));
+
+    // the frames with equal content share the file
+    QDomDocument doc;
+    channel->toXML(doc, "layer1");
+
+    QCOMPARE(channel->frameFilename(id0), QString("layer1"));
+    QCOMPARE(channel->frameFilename(id20), channel->frameFilename(id0));
+    QVERIFY(channel->frameFilename(id10) != channel->frameFilename(id0));
+}
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
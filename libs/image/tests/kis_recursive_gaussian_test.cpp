@@ -0,0 +1,301 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_recursive_gaussian_test.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_gaussian_kernel.h"
+#include "kis_recursive_gaussian.h"
+#include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
+#include "kis_selection_filters.h"
+#include "kis_convolution_painter.h"
+#include "kis_convolution_kernel.h"
+#include "kis_global.h"
+
+
+namespace {
+
+/**
+ * Fills a slightly bigger area than the rect with random 8x8 squares,
+ * so that the engines have real pixels in their margins and the edges
+ * of the squares make the differences between them visible
+ */
+KisPaintDeviceSP createSquaresDevice(const QRect &rect)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect fillRect = rect.adjusted(-40, -40, 40, 40);
+    const int squareSize = 8;
+
+    qsrand(1);
+
+    for (int y = fillRect.top(); y <= fillRect.bottom(); y += squareSize) {
+        for (int x = fillRect.left(); x <= fillRect.right(); x += squareSize) {
+            QColor color(qrand() % 256, qrand() % 256, qrand() % 256, 128 + qrand() % 128);
+            dev->fill(QRect(x, y, squareSize, squareSize), KoColor(color, cs));
+        }
+    }
+
+    return dev;
+}
+
+void compareDevices(KisPaintDeviceSP dev1, KisPaintDeviceSP dev2, const QRect &rect,
+                    int maxDifference, qreal maxMeanDifference)
+{
+    const int pixelSize = dev1->pixelSize();
+    const int size = rect.width() * rect.height() * pixelSize;
+
+    QVector<quint8> data1(size);
+    QVector<quint8> data2(size);
+
+    dev1->readBytes(data1.data(), rect);
+    dev2->readBytes(data2.data(), rect);
+
+    int maxDiff = 0;
+    qint64 sumDiff = 0;
+
+    for (int i = 0; i < size; i++) {
+        const int diff = qAbs(int(data1[i]) - int(data2[i]));
+        maxDiff = qMax(maxDiff, diff);
+        sumDiff += diff;
+    }
+
+    const qreal meanDiff = qreal(sumDiff) / size;
+
+    if (maxDiff > maxDifference || meanDiff > maxMeanDifference) {
+        qDebug() << "max difference" << maxDiff << "mean difference" << meanDiff;
+        QFAIL("the devices differ too much");
+    }
+}
+
+/**
+ * The feathering as KisFeatherSelectionFilter did it before it
+ * switched to KisGaussianKernel::applyGaussian(): a gaussian with
+ * sigma equal to the radius truncated at one sigma
+ */
+void applyLegacyFeather(KisPixelSelectionSP pixelSelection, const QRect &rect, int radius)
+{
+    const uint kernelSize = radius * 2 + 1;
+    Matrix<qreal, Dynamic, Dynamic> gaussianMatrix(1, kernelSize);
+
+    const qreal multiplicand = 1 / (2 * M_PI * radius * radius);
+    const qreal exponentMultiplicand = 1 / (2 * radius * radius);
+
+    for (uint x = 0; x < kernelSize; x++) {
+        uint xDistance = qAbs(radius - (int)x);
+        gaussianMatrix(0, x) = multiplicand * exp( -(qreal)((xDistance * xDistance) + (radius * radius)) * exponentMultiplicand );
+    }
+
+    KisConvolutionKernelSP kernelHoriz = KisConvolutionKernel::fromMatrix(gaussianMatrix, 0, gaussianMatrix.sum());
+    KisConvolutionKernelSP kernelVertical = KisConvolutionKernel::fromMatrix(gaussianMatrix.transpose(), 0, gaussianMatrix.sum());
+
+    KisPaintDeviceSP interm = new KisPaintDevice(pixelSelection->colorSpace());
+    KisConvolutionPainter horizPainter(interm);
+    horizPainter.setChannelFlags(interm->colorSpace()->channelFlags(false, true));
+    horizPainter.applyMatrix(kernelHoriz, pixelSelection, rect.topLeft(), rect.topLeft(), rect.size(), BORDER_REPEAT);
+    horizPainter.end();
+
+    KisConvolutionPainter verticalPainter(pixelSelection);
+    verticalPainter.setChannelFlags(pixelSelection->colorSpace()->channelFlags(false, true));
+    verticalPainter.applyMatrix(kernelVertical, interm, rect.topLeft(), rect.topLeft(), rect.size(), BORDER_REPEAT);
+    verticalPainter.end();
+}
+
+}
+
+void KisRecursiveGaussianTest::testCoefficients()
+{
+    const QVector<qreal> sigmas =
+        QVector<qreal>() << 0.5 << 1.0 << 2.4 << 2.5 << 10.0 << 100.0;
+
+    Q_FOREACH (qreal sigma, sigmas) {
+        KisRecursiveGaussian::Coefficients c =
+            KisRecursiveGaussian::coefficientsFromSigma(sigma);
+
+        // the filter should not change the brightness
+        QVERIFY(qAbs(c.b + c.a1 + c.a2 + c.a3 - 1.0) < 1e-9);
+
+        // the filter should be stable
+        QVERIFY(c.b > 0.0);
+        QVERIFY(c.b <= 1.0);
+    }
+
+    QCOMPARE(KisRecursiveGaussian::marginFromSigma(2.1),
+             KisGaussianKernel::kernelSizeFromRadius(6.0) / 2);
+}
+
+void KisRecursiveGaussianTest::testConstantColor()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect rect(13, 7, 600, 300);
+    dev->fill(rect.adjusted(-40, -40, 40, 40), KoColor(QColor(200, 100, 50, 150), cs));
+
+    KisPaintDeviceSP ref = new KisPaintDevice(*dev);
+
+    KisRecursiveGaussian::applyGaussian(dev, rect, 15.0, 15.0, QBitArray(), 0);
+
+    compareDevices(dev, ref, rect.adjusted(-40, -40, 40, 40), 0, 0.0);
+}
+
+void KisRecursiveGaussianTest::testCompareWithKernel_data()
+{
+    QTest::addColumn<qreal>("radius");
+    QTest::addColumn<int>("maxDifference");
+    QTest::addColumn<qreal>("maxMeanDifference");
+
+    /**
+     * The recursive filter is an approximation of the Gaussian, the
+     * difference is the biggest for the smaller radii and lies at the
+     * edges of the squares. The mean difference stays within two
+     * levels for all of them.
+     */
+    QTest::newRow("r8") << 8.0 << 10 << 2.0;
+    QTest::newRow("r10") << 10.0 << 10 << 2.0;
+    QTest::newRow("r20") << 20.0 << 8 << 1.5;
+    QTest::newRow("r40") << 40.0 << 6 << 1.0;
+}
+
+void KisRecursiveGaussianTest::testCompareWithKernel()
+{
+    QFETCH(qreal, radius);
+    QFETCH(int, maxDifference);
+    QFETCH(qreal, maxMeanDifference);
+
+    // bigger than a block, so the seams are checked as well
+    const QRect rect(13, 7, 600, 300);
+
+    KisPaintDeviceSP dev1 = createSquaresDevice(rect);
+    KisPaintDeviceSP dev2 = new KisPaintDevice(*dev1);
+
+    KisGaussianKernel::applyGaussian(dev1, rect, radius, radius, QBitArray(), 0,
+                                     KisGaussianKernel::CONVOLUTION);
+    KisGaussianKernel::applyGaussian(dev2, rect, radius, radius, QBitArray(), 0,
+                                     KisGaussianKernel::RECURSIVE);
+
+    compareDevices(dev1, dev2, rect, maxDifference, maxMeanDifference);
+
+    // the pixels outside the rect should not be touched
+    KisPaintDeviceSP original = createSquaresDevice(rect);
+    const QRect outerRect = rect.adjusted(-40, -40, 40, 40);
+
+    compareDevices(dev2, original, QRect(outerRect.left(), outerRect.top(), outerRect.width(), 40), 0, 0.0);
+    compareDevices(dev2, original, QRect(outerRect.left(), rect.bottom() + 1, outerRect.width(), 40), 0, 0.0);
+    compareDevices(dev2, original, QRect(outerRect.left(), rect.top(), 40, rect.height()), 0, 0.0);
+    compareDevices(dev2, original, QRect(rect.right() + 1, rect.top(), 40, rect.height()), 0, 0.0);
+}
+
+void KisRecursiveGaussianTest::testChannelFlags()
+{
+    const QRect rect(13, 7, 300, 300);
+
+    KisPaintDeviceSP dev = createSquaresDevice(rect);
+    KisPaintDeviceSP original = createSquaresDevice(rect);
+
+    const KoColorSpace *cs = dev->colorSpace();
+
+    // BGRA, skip green and alpha
+    QBitArray channelFlags(cs->channelCount(), true);
+    channelFlags.clearBit(1);
+    channelFlags.clearBit(3);
+
+    KisRecursiveGaussian::applyGaussian(dev, rect, 5.0, 5.0, channelFlags, 0);
+
+    QVector<quint8> data(rect.width() * rect.height() * cs->pixelSize());
+    QVector<quint8> originalData(data.size());
+
+    dev->readBytes(data.data(), rect);
+    original->readBytes(originalData.data(), rect);
+
+    bool blueChanged = false;
+
+    for (int i = 0; i < data.size(); i += cs->pixelSize()) {
+        QCOMPARE(data[i + 1], originalData[i + 1]);
+        QCOMPARE(data[i + 3], originalData[i + 3]);
+        blueChanged |= data[i] != originalData[i];
+    }
+
+    QVERIFY(blueChanged);
+}
+
+void KisRecursiveGaussianTest::testOneDirection()
+{
+    const QRect rect(13, 7, 300, 300);
+
+    KisPaintDeviceSP dev1 = createSquaresDevice(rect);
+    KisPaintDeviceSP dev2 = new KisPaintDevice(*dev1);
+
+    KisGaussianKernel::applyGaussian(dev1, rect, 20.0, 0.0, QBitArray(), 0,
+                                     KisGaussianKernel::CONVOLUTION);
+    KisGaussianKernel::applyGaussian(dev2, rect, 20.0, 0.0, QBitArray(), 0,
+                                     KisGaussianKernel::RECURSIVE);
+
+    compareDevices(dev1, dev2, rect, 8, 1.5);
+}
+
+void KisRecursiveGaussianTest::testFeatherSelection_data()
+{
+    QTest::addColumn<int>("radius");
+    QTest::addColumn<int>("maxDifference");
+    QTest::addColumn<qreal>("maxMeanDifference");
+
+    /**
+     * The old kernel was truncated, so the profiles of the edges
+     * differ slightly even when the deviations are equal. The biggest
+     * difference lies in the corners of the selection. A gaussian of
+     * the same radius, but not the same deviation, would differ by
+     * 50-75 levels.
+     */
+    QTest::newRow("r2") << 2 << 24 << 1.0;
+    QTest::newRow("r5") << 5 << 24 << 1.5;
+    QTest::newRow("r20") << 20 << 24 << 4.0;
+}
+
+void KisRecursiveGaussianTest::testFeatherSelection()
+{
+    QFETCH(int, radius);
+    QFETCH(int, maxDifference);
+    QFETCH(qreal, maxMeanDifference);
+
+    const QRect selectedRect(100, 100, 200, 200);
+    const QRect rect = selectedRect.adjusted(-100, -100, 100, 100);
+
+    KisPixelSelectionSP legacy = new KisPixelSelection();
+    legacy->select(selectedRect);
+
+    KisPixelSelectionSP feathered = new KisPixelSelection();
+    feathered->select(selectedRect);
+
+    applyLegacyFeather(legacy, rect, radius);
+
+    KisFeatherSelectionFilter filter(radius);
+    QVERIFY(filter.changeRect(selectedRect).contains(selectedRect.adjusted(-radius, -radius, radius, radius)));
+    filter.process(feathered, rect);
+
+    compareDevices(legacy, feathered, rect, maxDifference, maxMeanDifference);
+}
+
+QTEST_MAIN(KisRecursiveGaussianTest)
@@ -277,5 +277,65 @@ void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
     QCOMPARE(jobsList[0], job3);
 }
 
+void KisSimpleUpdateQueueTest::testManyTinyJobs()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->lock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    const int step = 16;
+    const QRect tinyRect(0,0,2,2);
+    const int numJobs = (imageRect.width() / step) * (imageRect.height() / step);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    for (int y = 0; y < imageRect.height(); y += step) {
+        for (int x = 0; x < imageRect.width(); x += step) {
+            queue.addUpdateJob(paintLayer, tinyRect.translated(x, y), imageRect, 0);
+        }
+    }
+
+    // the rects are too far from each other to be merged
+    QCOMPARE(walkersList.size(), numJobs);
+
+    // the same rects once more, now they should be merged
+    for (int y = 0; y < imageRect.height(); y += step) {
+        for (int x = 0; x < imageRect.width(); x += step) {
+            queue.addUpdateJob(paintLayer, tinyRect.translated(x, y), imageRect, 0);
+        }
+    }
+
+    QCOMPARE(walkersList.size(), numJobs);
+    QVERIFY(checkWalker(walkersList[0], tinyRect));
+    QVERIFY(checkWalker(walkersList[numJobs - 1],
+                        tinyRect.translated(imageRect.width() - step,
+                                            imageRect.height() - step)));
+
+    KisTestableUpdaterContext context(4);
+    int numProcessedJobs = 0;
+
+    while (!queue.isEmpty()) {
+        queue.processQueue(context);
+
+        Q_FOREACH (KisUpdateJobItem *job, context.getJobs()) {
+            if (job->isRunning()) {
+                numProcessedJobs++;
+            }
+        }
+
+        context.clear();
+    }
+
+    QCOMPARE(numProcessedJobs, numJobs);
+}
+
 QTEST_MAIN(KisSimpleUpdateQueueTest)
 
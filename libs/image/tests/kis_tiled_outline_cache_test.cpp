@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tiled_outline_cache_test.h"
+
+#include <QTest>
+#include <QPainter>
+#include <QPainterPath>
+
+#include "kis_tiled_outline_cache.h"
+#include "kis_pixel_selection.h"
+
+
+namespace {
+
+/**
+ * Renders the outline without antialiasing, so that every pixel whose
+ * center lies inside the polygons becomes black
+ */
+QImage renderOutline(QPainterPath path, const QRect &rect)
+{
+    path.setFillRule(Qt::OddEvenFill);
+
+    QImage image(rect.size(), QImage::Format_ARGB32);
+    image.fill(Qt::white);
+
+    QPainter gc(&image);
+    gc.translate(-rect.topLeft());
+    gc.fillPath(path, Qt::black);
+
+    return image;
+}
+
+QImage renderOutline(const QVector<QPolygon> &polygons, const QRect &rect)
+{
+    QPainterPath path;
+
+    Q_FOREACH (const QPolygon &poly, polygons) {
+        path.addPolygon(poly);
+        path.closeSubpath();
+    }
+
+    return renderOutline(path, rect);
+}
+
+void compareOutlines(const QVector<QPolygon> &outline, const QVector<QPolygon> &reference, const QRect &rect)
+{
+    QCOMPARE(renderOutline(outline, rect), renderOutline(reference, rect));
+}
+
+/**
+ * Selects and deselects random rects crossing the tile borders
+ */
+void randomEdit(KisPixelSelectionSP selection, KisTiledOutlineCache *cache, const QRect &area)
+{
+    const QRect rc(area.left() + qrand() % area.width(),
+                   area.top() + qrand() % area.height(),
+                   1 + qrand() % 90, 1 + qrand() % 90);
+
+    if (qrand() % 3) {
+        selection->select(rc);
+    } else {
+        selection->clear(rc);
+    }
+
+    if (cache) {
+        cache->addDirtyRect(rc);
+    }
+}
+
+}
+
+void KisTiledOutlineCacheTest::testCompareWithFullOutline()
+{
+    const QRect area(-70, -30, 300, 250);
+    KisPixelSelectionSP selection = new KisPixelSelection();
+
+    qsrand(1);
+    for (int i = 0; i < 50; i++) {
+        randomEdit(selection, 0, area);
+    }
+
+    KisTiledOutlineCache cache;
+    const QVector<QPolygon> outline = cache.outline(selection.data());
+
+    Q_FOREACH (const QPolygon &poly, outline) {
+        QVERIFY(poly.size() >= 4);
+        QVERIFY(poly.first() != poly.last());
+    }
+
+    compareOutlines(outline, selection->outline(), area.adjusted(-100, -100, 100, 100));
+}
+
+void KisTiledOutlineCacheTest::testIncrementalUpdates()
+{
+    const QRect area(-70, -30, 300, 250);
+    const QRect renderRect = area.adjusted(-100, -100, 100, 100);
+    KisPixelSelectionSP selection = new KisPixelSelection();
+
+    KisTiledOutlineCache cache;
+    QVERIFY(cache.outline(selection.data()).isEmpty());
+
+    qsrand(2);
+    for (int i = 0; i < 20; i++) {
+        randomEdit(selection, &cache, area);
+        randomEdit(selection, &cache, area);
+
+        KisTiledOutlineCache freshCache;
+        compareOutlines(cache.outline(selection.data()),
+                        freshCache.outline(selection.data()),
+                        renderRect);
+    }
+
+    selection->clear();
+    cache.invalidate();
+    QVERIFY(cache.outline(selection.data()).isEmpty());
+}
+
+void KisTiledOutlineCacheTest::testTranslate()
+{
+    const QRect area(0, 0, 200, 200);
+    KisPixelSelectionSP selection = new KisPixelSelection();
+
+    qsrand(3);
+    for (int i = 0; i < 20; i++) {
+        randomEdit(selection, 0, area);
+    }
+
+    KisTiledOutlineCache cache;
+    cache.outline(selection.data());
+
+    // aligned to the tiles, the pieces are just moved
+    selection->move(QPoint(64, -128));
+    cache.translate(QPoint(64, -128));
+
+    compareOutlines(cache.outline(selection.data()), selection->outline(),
+                    QRect(-200, -200, 600, 600));
+
+    // not aligned, everything is traced again
+    selection->move(QPoint(81, -123));
+    cache.translate(QPoint(17, 5));
+
+    compareOutlines(cache.outline(selection.data()), selection->outline(),
+                    QRect(-200, -200, 600, 600));
+}
+
+void KisTiledOutlineCacheTest::testLevelOfDetail()
+{
+    KisPixelSelectionSP selection = new KisPixelSelection();
+    selection->select(QRect(10, 10, 100, 50));
+    selection->select(QRect(3, 200, 1, 1));
+
+    KisTiledOutlineCache cache(2);
+    QCOMPARE(cache.levelOfDetail(), 2);
+
+    const QVector<QPolygon> outline = cache.outline(selection.data());
+    QCOMPARE(outline.size(), 2);
+
+    QRect bounds;
+    Q_FOREACH (const QPolygon &poly, outline) {
+        bounds |= poly.boundingRect();
+    }
+
+    // the cells are 4x4 pixels, the bounds are rounded outwards
+    QCOMPARE(bounds, QRect(0, 8, 113, 197));
+
+    selection->clear(QRect(3, 200, 1, 1));
+    cache.addDirtyRect(QRect(3, 200, 1, 1));
+    QCOMPARE(cache.outline(selection.data()).size(), 1);
+}
+
+void KisTiledOutlineCacheTest::testPixelSelectionCache()
+{
+    const QRect area(-70, -30, 300, 250);
+    const QRect renderRect = area.adjusted(-100, -100, 100, 100);
+    KisPixelSelectionSP selection = new KisPixelSelection();
+
+    qsrand(4);
+    for (int i = 0; i < 10; i++) {
+        randomEdit(selection, 0, area);
+        selection->recalculateOutlineCache();
+
+        QVERIFY(selection->outlineCacheValid());
+        QCOMPARE(renderOutline(selection->outlineCache(), renderRect),
+                 renderOutline(selection->outline(), renderRect));
+    }
+
+    selection->recalculateOutlinePreview(3);
+    QVERIFY(selection->outlinePreviewValid(3));
+    QVERIFY(!selection->outlinePreviewValid(2));
+    QVERIFY(selection->outlinePreview(3).boundingRect().contains(selection->outlineCache().boundingRect()));
+}
+
+QTEST_MAIN(KisTiledOutlineCacheTest)
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_work_stealing_executor_test.h"
+
+#include <QTest>
+#include <QRunnable>
+#include <QSemaphore>
+#include <functional>
+
+#include "kis_work_stealing_executor.h"
+
+
+class LambdaJob : public QRunnable
+{
+public:
+    LambdaJob(std::function<void()> func)
+        : m_func(func)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+};
+
+void KisWorkStealingExecutorTest::testManyJobs()
+{
+    const int numJobs = 1000;
+    QAtomicInt counter;
+
+    QVector<LambdaJob*> jobs;
+    for (int i = 0; i < numJobs; i++) {
+        jobs.append(new LambdaJob([&counter] () { counter.ref(); }));
+    }
+
+    KisWorkStealingExecutor executor(4);
+    QCOMPARE(executor.numThreads(), 4);
+
+    Q_FOREACH (LambdaJob *job, jobs) {
+        executor.start(job);
+    }
+
+    executor.waitForDone();
+    QCOMPARE(counter.load(), numJobs);
+
+    qDeleteAll(jobs);
+}
+
+void KisWorkStealingExecutorTest::testNestedJobs()
+{
+    const int numRootJobs = 16;
+    const int numChildJobs = 64;
+
+    QAtomicInt counter;
+
+    KisWorkStealingExecutor executor(4);
+
+    LambdaJob childJob([&counter] () { counter.ref(); });
+
+    QVector<LambdaJob*> rootJobs;
+    for (int i = 0; i < numRootJobs; i++) {
+        rootJobs.append(new LambdaJob([&] () {
+            /**
+             * These jobs are started from the worker thread, so
+             * they go to the local queue of the worker and should
+             * be stolen by the other ones
+             */
+            for (int j = 0; j < numChildJobs; j++) {
+                executor.start(&childJob);
+            }
+            counter.ref();
+        }));
+    }
+
+    Q_FOREACH (LambdaJob *job, rootJobs) {
+        executor.start(job);
+    }
+
+    executor.waitForDone();
+    QCOMPARE(counter.load(), numRootJobs * (numChildJobs + 1));
+
+    qDeleteAll(rootJobs);
+}
+
+void KisWorkStealingExecutorTest::testLazyStart()
+{
+    KisWorkStealingExecutor executor(4);
+
+    QCOMPARE(executor.numThreads(), 4);
+    QCOMPARE(executor.numActiveThreads(), 0);
+
+    QSemaphore blocker;
+    LambdaJob blockingJob([&blocker] () { blocker.acquire(); });
+
+    executor.start(&blockingJob);
+    QCOMPARE(executor.numActiveThreads(), 1);
+
+    blocker.release();
+    executor.waitForDone();
+
+    QVERIFY(executor.numActiveThreads() <= 1);
+}
+
+class CountedJob : public QRunnable
+{
+public:
+    CountedJob(QAtomicInt *numAlive)
+        : m_numAlive(numAlive)
+    {
+        m_numAlive->ref();
+    }
+
+    ~CountedJob() {
+        m_numAlive->deref();
+    }
+
+    void run() {
+    }
+
+private:
+    QAtomicInt *m_numAlive;
+};
+
+void KisWorkStealingExecutorTest::testAutoDelete()
+{
+    QAtomicInt numAlive;
+
+    KisWorkStealingExecutor executor(4);
+
+    for (int i = 0; i < 100; i++) {
+        executor.start(new CountedJob(&numAlive));
+    }
+
+    executor.waitForDone();
+    QCOMPARE(numAlive.load(), 0);
+}
+
+QTEST_MAIN(KisWorkStealingExecutorTest)
@@ -166,6 +166,22 @@ void KisMementoManager::registerTileDeleted(KisTile *tile)
     }
 }
 
+QVector<QPoint> KisMementoManager::uncommittedChangedTiles()
+{
+    QVector<QPoint> tiles;
+
+    KisMementoItemHashTableIterator iter(&m_index);
+    KisMementoItemSP mi;
+    while ((mi = iter.tile())) {
+        if (mi->type() == KisMementoItem::CHANGED) {
+            tiles.append(QPoint(mi->col(), mi->row()));
+        }
+        ++iter;
+    }
+
+    return tiles;
+}
+
 void KisMementoManager::commit()
 {
     if (m_index.isEmpty()) {
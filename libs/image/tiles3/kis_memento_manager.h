@@ -20,6 +20,8 @@
 #define KIS_MEMENTO_MANAGER_
 
 #include <QList>
+#include <QPoint>
+#include <QVector>
 
 #include "kis_memento_item.h"
 #include "kis_tile_hash_table.h"
@@ -76,6 +78,12 @@ public:
      */
     void commit();
 
+    /**
+     * Returns the indexes (col, row) of the tiles changed since the
+     * last commit. The deleted tiles are not included.
+     */
+    QVector<QPoint> uncommittedChangedTiles();
+
     /**
      * Undo and Redo stuff respectively.
      *
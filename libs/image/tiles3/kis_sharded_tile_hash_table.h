@@ -0,0 +1,286 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KIS_SHARDED_TILE_HASH_TABLE_H
+#define KIS_SHARDED_TILE_HASH_TABLE_H
+
+#include <QReadWriteLock>
+#include <QAtomicInt>
+
+#include "kis_tile.h"
+
+
+/**
+ * A drop-in replacement for KisTileHashTableTraits that splits the
+ * buckets of the table into NUM_SHARDS groups, each protected by its
+ * own read-write lock. The bucket layout and the hash function are the
+ * same as in the classic table, so neighbouring tiles of one row fall
+ * into different shards and the updater threads working on different
+ * parts of the layer don't contend on a single lock anymore.
+ *
+ * Operations touching a single tile lock only the shard of that tile.
+ * Operations that need the whole table to be consistent (copying,
+ * clear(), changing the default tile data) lock all the shards in
+ * ascending order.
+ *
+ * The table is selected at build time with USE_SHARDED_TILE_HASH_TABLE
+ * option (see kis_tile_hash_table.h).
+ */
+
+template<class T>
+class KisShardedTileHashTableTraits
+{
+public:
+    typedef T               TileType;
+    typedef KisSharedPtr<T> TileTypeSP;
+    typedef KisWeakSharedPtr<T> TileTypeWSP;
+
+    KisShardedTileHashTableTraits(KisMementoManager *mm);
+    KisShardedTileHashTableTraits(const KisShardedTileHashTableTraits<T> &ht,
+                                  KisMementoManager *mm);
+
+    ~KisShardedTileHashTableTraits();
+
+    bool isEmpty() {
+        return !numTiles();
+    }
+
+    bool tileExists(qint32 col, qint32 row);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * returns null.
+     * \param col column of the tile
+     * \param row row of the tile
+     */
+    TileTypeSP getExistedTile(qint32 col, qint32 row);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * creates a new one, attaches it to the list and returns.
+     * \param col column of the tile
+     * \param row row of the tile
+     * \param newTile out-parameter, returns true if a new tile
+     *                was created
+     */
+    TileTypeSP getTileLazy(qint32 col, qint32 row, bool& newTile);
+
+    /**
+     * Returns a tile in position (col,row). If no tile exists,
+     * creates nothing, but returns shared default tile object
+     * of the table. Be careful, this object has column and row
+     * parameters set to (qint32_MIN, qint32_MIN).
+     * \param col column of the tile
+     * \param row row of the tile
+     */
+    TileTypeSP getReadOnlyTileLazy(qint32 col, qint32 row);
+    void addTile(TileTypeSP tile);
+    void deleteTile(TileTypeSP tile);
+    void deleteTile(qint32 col, qint32 row);
+
+    void clear();
+
+    void setDefaultTileData(KisTileData *defaultTileData);
+    KisTileData* defaultTileData() const;
+
+    qint32 numTiles() {
+        return m_numTiles.load();
+    }
+
+    void debugPrintInfo();
+    void debugMaxListLength(qint32 &min, qint32 &max);
+
+private:
+    TileTypeSP getTile(qint32 col, qint32 row);
+    void linkTile(TileTypeSP tile);
+    TileTypeSP unlinkTile(qint32 col, qint32 row);
+
+    inline void setDefaultTileDataImp(KisTileData *defaultTileData);
+    inline KisTileData* defaultTileDataImp() const;
+
+    static inline quint32 calculateHash(qint32 col, qint32 row);
+    static inline qint32 shardForHash(quint32 idx);
+
+    inline QReadWriteLock* shardLock(qint32 col, qint32 row) const;
+    void lockAllShardsForRead() const;
+    void lockAllShardsForWrite() const;
+    void unlockAllShards() const;
+
+    inline qint32 debugChainLen(qint32 idx);
+    void debugListLengthDistibution();
+
+private:
+    template<class U> friend class KisShardedTileHashTableIteratorTraits;
+
+    static const qint32 TABLE_SIZE = 1024;
+    static const qint32 NUM_SHARDS = 64;
+    static const qint32 BUCKETS_PER_SHARD = TABLE_SIZE / NUM_SHARDS;
+
+    /**
+     * QReadWriteLock keeps its uncontended state in an atomic pointer,
+     * so the shards are padded to avoid false sharing of the cache
+     * lines between the neighbouring locks.
+     */
+    struct Shard {
+        QReadWriteLock lock;
+        char padding[64 - sizeof(QReadWriteLock) % 64];
+    };
+
+    TileTypeSP *m_hashTable;
+    QAtomicInt m_numTiles;
+
+    KisTileData *m_defaultTileData;
+    KisMementoManager *m_mementoManager;
+
+    mutable Shard m_shards[NUM_SHARDS];
+};
+
+#include "kis_sharded_tile_hash_table_p.h"
+
+
+/**
+ * Walks through all tiles inside the sharded hash table
+ *
+ * The buckets are visited shard-by-shard and only the shard the
+ * iterator currently points to is locked (for write). It means that
+ * other threads can access the rest of the table while the walk is in
+ * progress, so the caller should guard the data manager by its own
+ * lock if it needs a consistent snapshot of the whole table.
+ *
+ * The only modification allowed during the walk is deletion (or
+ * moving) of the current tile.
+ */
+template<class T>
+class KisShardedTileHashTableIteratorTraits
+{
+public:
+    typedef T               TileType;
+    typedef KisSharedPtr<T> TileTypeSP;
+    typedef KisShardedTileHashTableTraits<T> HashTable;
+
+    KisShardedTileHashTableIteratorTraits(HashTable *ht)
+        : m_position(-1),
+          m_lockedShard(-1),
+          m_hashTable(ht)
+    {
+        seekNonEmptyList(0);
+    }
+
+    ~KisShardedTileHashTableIteratorTraits<T>() {
+        destroy();
+    }
+
+    KisShardedTileHashTableIteratorTraits<T>& operator++() {
+        next();
+        return *this;
+    }
+
+    void next() {
+        if (m_tile) {
+            m_tile = m_tile->next();
+            if (!m_tile) {
+                seekNonEmptyList(m_position + 1);
+            }
+        }
+    }
+
+    TileTypeSP tile() const {
+        return m_tile;
+    }
+    bool isDone() const {
+        return !m_tile;
+    }
+
+    void deleteCurrent() {
+        unlinkCurrent();
+    }
+
+    void moveCurrentToHashTable(HashTable *newHashTable) {
+        TileTypeSP tile = unlinkCurrent();
+        newHashTable->addTile(tile);
+    }
+
+    void destroy() {
+        m_tile = 0;
+
+        if (m_lockedShard >= 0) {
+            m_hashTable->m_shards[m_lockedShard].lock.unlock();
+            m_lockedShard = -1;
+        }
+    }
+
+protected:
+    TileTypeSP m_tile;
+    qint32 m_position;
+    qint32 m_lockedShard;
+    HashTable *m_hashTable;
+
+protected:
+    static inline qint32 bucketForPosition(qint32 position) {
+        return position / HashTable::BUCKETS_PER_SHARD +
+            (position % HashTable::BUCKETS_PER_SHARD) * HashTable::NUM_SHARDS;
+    }
+
+    void seekNonEmptyList(qint32 position) {
+        for (; position < HashTable::TABLE_SIZE; position++) {
+            const qint32 shard = position / HashTable::BUCKETS_PER_SHARD;
+
+            if (shard != m_lockedShard) {
+                if (m_lockedShard >= 0) {
+                    m_hashTable->m_shards[m_lockedShard].lock.unlock();
+                }
+                m_hashTable->m_shards[shard].lock.lockForWrite();
+                m_lockedShard = shard;
+            }
+
+            TileTypeSP tile = m_hashTable->m_hashTable[bucketForPosition(position)];
+            if (tile) {
+                m_position = position;
+                m_tile = tile;
+                return;
+            }
+        }
+
+        //EOList reached
+        destroy();
+    }
+
+    /**
+     * The tile must be unlinked while its shard is still locked,
+     * so we fetch the next item before unlinking and only then
+     * let the iterator jump to the next shard
+     */
+    TileTypeSP unlinkCurrent() {
+        TileTypeSP tile = m_tile;
+        TileTypeSP nextTile = tile->next();
+
+        m_hashTable->unlinkTile(tile->col(), tile->row());
+
+        m_tile = nextTile;
+        if (!m_tile) {
+            seekNonEmptyList(m_position + 1);
+        }
+
+        return tile;
+    }
+
+private:
+    Q_DISABLE_COPY(KisShardedTileHashTableIteratorTraits<T>)
+};
+
+#endif /* KIS_SHARDED_TILE_HASH_TABLE_H */
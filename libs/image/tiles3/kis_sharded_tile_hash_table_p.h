@@ -0,0 +1,403 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtGlobal>
+#include "kis_debug.h"
+#include "kis_global.h"
+
+
+template<class T>
+KisShardedTileHashTableTraits<T>::KisShardedTileHashTableTraits(KisMementoManager *mm)
+    : m_numTiles(0),
+      m_defaultTileData(0),
+      m_mementoManager(mm)
+{
+    m_hashTable = new TileTypeSP [TABLE_SIZE];
+    Q_CHECK_PTR(m_hashTable);
+}
+
+template<class T>
+KisShardedTileHashTableTraits<T>::KisShardedTileHashTableTraits(const KisShardedTileHashTableTraits<T> &ht,
+                                                                KisMementoManager *mm)
+    : m_numTiles(0),
+      m_defaultTileData(0),
+      m_mementoManager(mm)
+{
+    ht.lockAllShardsForRead();
+
+    setDefaultTileDataImp(ht.m_defaultTileData);
+
+    m_hashTable = new TileTypeSP [TABLE_SIZE];
+    Q_CHECK_PTR(m_hashTable);
+
+    TileTypeSP foreignTile;
+    TileType* nativeTile;
+    TileType* nativeTileHead;
+    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+        nativeTileHead = 0;
+
+        foreignTile = ht.m_hashTable[i];
+        while (foreignTile) {
+            nativeTile = new TileType(*foreignTile, m_mementoManager);
+            nativeTile->setNext(nativeTileHead);
+            nativeTileHead = nativeTile;
+
+            foreignTile = foreignTile->next();
+        }
+
+        m_hashTable[i] = nativeTileHead;
+    }
+    m_numTiles.store(ht.m_numTiles.load());
+
+    ht.unlockAllShards();
+}
+
+template<class T>
+KisShardedTileHashTableTraits<T>::~KisShardedTileHashTableTraits()
+{
+    clear();
+    delete[] m_hashTable;
+    setDefaultTileDataImp(0);
+}
+
+template<class T>
+quint32 KisShardedTileHashTableTraits<T>::calculateHash(qint32 col, qint32 row)
+{
+    return ((row << 5) + (col & 0x1F)) & 0x3FF;
+}
+
+template<class T>
+qint32 KisShardedTileHashTableTraits<T>::shardForHash(quint32 idx)
+{
+    return idx & (NUM_SHARDS - 1);
+}
+
+template<class T>
+QReadWriteLock* KisShardedTileHashTableTraits<T>::shardLock(qint32 col, qint32 row) const
+{
+    return &m_shards[shardForHash(calculateHash(col, row))].lock;
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::lockAllShardsForRead() const
+{
+    for (qint32 i = 0; i < NUM_SHARDS; i++) {
+        m_shards[i].lock.lockForRead();
+    }
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::lockAllShardsForWrite() const
+{
+    for (qint32 i = 0; i < NUM_SHARDS; i++) {
+        m_shards[i].lock.lockForWrite();
+    }
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::unlockAllShards() const
+{
+    for (qint32 i = NUM_SHARDS - 1; i >= 0; i--) {
+        m_shards[i].lock.unlock();
+    }
+}
+
+template<class T>
+typename KisShardedTileHashTableTraits<T>::TileTypeSP
+KisShardedTileHashTableTraits<T>::getTile(qint32 col, qint32 row)
+{
+    qint32 idx = calculateHash(col, row);
+    TileTypeSP tile = m_hashTable[idx];
+
+    for (; tile; tile = tile->next()) {
+        if (tile->col() == col &&
+                tile->row() == row) {
+
+            return tile;
+        }
+    }
+
+    return 0;
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::linkTile(TileTypeSP tile)
+{
+    qint32 idx = calculateHash(tile->col(), tile->row());
+    TileTypeSP firstTile = m_hashTable[idx];
+
+    tile->setNext(firstTile);
+    m_hashTable[idx] = tile;
+    m_numTiles.ref();
+}
+
+template<class T>
+typename KisShardedTileHashTableTraits<T>::TileTypeSP
+KisShardedTileHashTableTraits<T>::unlinkTile(qint32 col, qint32 row)
+{
+    qint32 idx = calculateHash(col, row);
+    TileTypeSP tile = m_hashTable[idx];
+    TileTypeSP prevTile = 0;
+
+    for (; tile; tile = tile->next()) {
+        if (tile->col() == col &&
+                tile->row() == row) {
+
+            if (prevTile)
+                prevTile->setNext(tile->next());
+            else
+                m_hashTable[idx] = tile->next();
+
+            /**
+             * About disconnection of tiles see a comment in
+             * KisTileHashTableTraits<T>::unlinkTile()
+             */
+            tile->setNext(0);
+            tile->notifyDead();
+            tile = 0;
+
+            m_numTiles.deref();
+            return tile;
+        }
+        prevTile = tile;
+    }
+
+    return 0;
+}
+
+template<class T>
+inline void KisShardedTileHashTableTraits<T>::setDefaultTileDataImp(KisTileData *defaultTileData)
+{
+    if (m_defaultTileData) {
+        m_defaultTileData->unblockSwapping();
+        m_defaultTileData->release();
+        m_defaultTileData = 0;
+    }
+
+    if (defaultTileData) {
+        defaultTileData->acquire();
+        defaultTileData->blockSwapping();
+        m_defaultTileData = defaultTileData;
+    }
+}
+
+template<class T>
+inline KisTileData* KisShardedTileHashTableTraits<T>::defaultTileDataImp() const
+{
+    return m_defaultTileData;
+}
+
+
+template<class T>
+bool KisShardedTileHashTableTraits<T>::tileExists(qint32 col, qint32 row)
+{
+    QReadLocker locker(shardLock(col, row));
+    return getTile(col, row);
+}
+
+template<class T>
+typename KisShardedTileHashTableTraits<T>::TileTypeSP
+KisShardedTileHashTableTraits<T>::getExistedTile(qint32 col, qint32 row)
+{
+    QReadLocker locker(shardLock(col, row));
+    return getTile(col, row);
+}
+
+template<class T>
+typename KisShardedTileHashTableTraits<T>::TileTypeSP
+KisShardedTileHashTableTraits<T>::getTileLazy(qint32 col, qint32 row,
+                                              bool& newTile)
+{
+    QReadWriteLock *lock = shardLock(col, row);
+
+    newTile = false;
+
+    /**
+     * Most of the requests come for already existing tiles,
+     * so we try the read access first and take the write lock
+     * only when the tile should really be created
+     */
+    {
+        QReadLocker locker(lock);
+        TileTypeSP tile = getTile(col, row);
+        if (tile) return tile;
+    }
+
+    QWriteLocker locker(lock);
+
+    TileTypeSP tile = getTile(col, row);
+    if (!tile) {
+        tile = new TileType(col, row, m_defaultTileData, m_mementoManager);
+        linkTile(tile);
+        newTile = true;
+    }
+
+    return tile;
+}
+
+template<class T>
+typename KisShardedTileHashTableTraits<T>::TileTypeSP
+KisShardedTileHashTableTraits<T>::getReadOnlyTileLazy(qint32 col, qint32 row)
+{
+    QReadLocker locker(shardLock(col, row));
+
+    TileTypeSP tile = getTile(col, row);
+    if (!tile)
+        tile = new TileType(col, row, m_defaultTileData, 0);
+
+    return tile;
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::addTile(TileTypeSP tile)
+{
+    QWriteLocker locker(shardLock(tile->col(), tile->row()));
+    linkTile(tile);
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::deleteTile(qint32 col, qint32 row)
+{
+    QWriteLocker locker(shardLock(col, row));
+    unlinkTile(col, row);
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::deleteTile(TileTypeSP tile)
+{
+    deleteTile(tile->col(), tile->row());
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::clear()
+{
+    lockAllShardsForWrite();
+
+    TileTypeSP tile = 0;
+    qint32 i;
+
+    for (i = 0; i < TABLE_SIZE; i++) {
+        tile = m_hashTable[i];
+
+        while (tile) {
+            TileTypeSP tmp = tile;
+            tile = tile->next();
+
+            tmp->setNext(0);
+            tmp->notifyDead();
+            tmp = 0;
+
+            m_numTiles.deref();
+        }
+
+        m_hashTable[i] = 0;
+    }
+
+    Q_ASSERT(!m_numTiles.load());
+
+    unlockAllShards();
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::setDefaultTileData(KisTileData *defaultTileData)
+{
+    lockAllShardsForWrite();
+    setDefaultTileDataImp(defaultTileData);
+    unlockAllShards();
+}
+
+template<class T>
+KisTileData* KisShardedTileHashTableTraits<T>::defaultTileData() const
+{
+    /**
+     * The default tile data is changed only when all the shards
+     * are locked for write, so holding any of them is enough
+     */
+    QReadLocker locker(&m_shards[0].lock);
+    return defaultTileDataImp();
+}
+
+
+/*************** Debugging stuff ***************/
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::debugPrintInfo()
+{
+    dbgTiles << "==========================\n"
+             << "ShardedTileHashTable:"
+             << "\n   def. data:\t\t" << m_defaultTileData
+             << "\n   numTiles:\t\t" << m_numTiles.load()
+             << "\n   numShards:\t\t" << NUM_SHARDS;
+    debugListLengthDistibution();
+    dbgTiles << "==========================\n";
+}
+
+template<class T>
+qint32 KisShardedTileHashTableTraits<T>::debugChainLen(qint32 idx)
+{
+    qint32 len = 0;
+    for (TileTypeSP it = m_hashTable[idx]; it; it = it->next(), len++) ;
+    return len;
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::debugMaxListLength(qint32 &min, qint32 &max)
+{
+    qint32 maxLen = 0;
+    qint32 minLen = m_numTiles.load();
+    qint32 tmp = 0;
+
+    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+        tmp = debugChainLen(i);
+        if (tmp > maxLen)
+            maxLen = tmp;
+        if (tmp < minLen)
+            minLen = tmp;
+    }
+
+    min = minLen;
+    max = maxLen;
+}
+
+template<class T>
+void KisShardedTileHashTableTraits<T>::debugListLengthDistibution()
+{
+    qint32 min, max;
+    qint32 arraySize;
+    qint32 tmp;
+
+    debugMaxListLength(min, max);
+    arraySize = max - min + 1;
+
+    qint32 *array = new qint32[arraySize];
+    memset(array, 0, sizeof(qint32)*arraySize);
+
+    for (qint32 i = 0; i < TABLE_SIZE; i++) {
+        tmp = debugChainLen(i);
+        array[tmp-min]++;
+    }
+
+    dbgTiles << QString("   minChain:\t\t%1\n"
+                        "   maxChain:\t\t%2").arg(min).arg(max);
+
+    dbgTiles << "   Chain size distribution:";
+    for (qint32 i = 0; i < arraySize; i++)
+        dbgTiles << QString("      %1:\t%2\n").arg(i + min).arg(array[i]);
+
+    delete[] array;
+}
@@ -202,6 +202,39 @@ void KisTile::lockForWrite()
     DEBUG_LOG_ACTION("lock [W]");
 }
 
+bool KisTile::deduplicate()
+{
+    QMutexLocker cowLocker(&m_COWMutex);
+    KisTileData *oldTileData = 0;
+
+    {
+        QMutexLocker barrierLocker(&m_swapBarrierLock);
+
+        /**
+         * Someone may be writing into the data right now. When the
+         * counter is zero, every new reader or writer will wait for
+         * the barrier lock, and after that the writers will clone
+         * the data, because it is acquired by the index.
+         */
+        if (m_lockCounter > 0) return false;
+
+        KisTileData *tileData =
+            m_tileData->m_store->deduplicateTileData(m_tileData);
+
+        if (!tileData) return false;
+
+        oldTileData = m_tileData;
+        m_tileData = tileData;
+    }
+
+    oldTileData->release();
+
+    if (m_mementoManager)
+        m_mementoManager->registerTileChange(this);
+
+    return true;
+}
+
 void KisTile::unlock() const
 {
     unblockSwapping();
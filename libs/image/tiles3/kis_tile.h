@@ -75,6 +75,16 @@ public:
     void lockForWrite();
     void unlock() const;
 
+    /**
+     * Replaces the tile data with an equal one found in the
+     * deduplication index of the store. Does nothing if the tile is
+     * being accessed at the moment. Returns true if the data has
+     * been replaced.
+     *
+     * \see KisTileDataStore::deduplicateTileData()
+     */
+    bool deduplicate();
+
     /* this allows us work directly on tile's data */
     inline quint8 *data() const {
         return m_tileData->data();
@@ -52,6 +52,12 @@ public:
 private:
     KisTileData(const KisTileData& rhs, bool checkFreeMemory = true);
 
+    /**
+     * Creates a tile data with no memory allocated. Used by the store
+     * for the tile data, which are born swapped out.
+     */
+    KisTileData(qint32 pixelSize, KisTileDataStore *store);
+
 public:
     ~KisTileData();
 
@@ -19,11 +19,14 @@
 // to disable assert when the leak tracker is active
 #include "config-memory-leak-tracker.h"
 
+#include <QByteArray>
 #include <QGlobalStatic>
 
 #include "kis_tile_data_store.h"
 #include "kis_tile_data.h"
+#include "kis_tile.h"
 #include "kis_debug.h"
+#include "kis_image_config.h"
 
 #include "kis_tile_data_store_iterators.h"
 
@@ -69,17 +72,28 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
-      m_memoryMetric(0)
+      m_memoryMetric(0),
+      m_deduplicationInsertions(0),
+      m_deduplicationTotalInsertions(0),
+      m_deduplicationChecks(0),
+      m_deduplicatedTiles(0)
 {
+    m_deduplicationEnabled = KisImageConfig().tileDataDeduplication();
+
     m_clockIterator = m_tileDataList.end();
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start(QThread::LowPriority);
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    pruneDeduplicationIndex(true);
+
     m_pooler.terminatePooler();
+    m_prefetcher.terminatePrefetcher();
     m_swapper.terminateSwapper();
 
     if(numTiles() > 0) {
@@ -96,10 +110,31 @@ KisTileDataStore* KisTileDataStore::instance()
 
 KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 {
-    QMutexLocker lock(&m_listLock);
-
     MemoryStatistics stats;
 
+    /**
+     * The deduplication code takes m_listLock while holding
+     * m_deduplicationLock, so we should never do the reverse
+     */
+    {
+        QMutexLocker dedupLocker(&m_deduplicationLock);
+        stats.deduplicationChecks = m_deduplicationChecks;
+        stats.deduplicationInsertions = m_deduplicationTotalInsertions;
+        stats.deduplicatedTiles = m_deduplicatedTiles;
+    }
+
+    /**
+     * Every committed tile is either inserted into the index or checked
+     * against a candidate in it, so the ratio is taken over both
+     */
+    const qint64 deduplicationAttempts =
+        stats.deduplicationChecks + stats.deduplicationInsertions;
+
+    stats.deduplicationRatio = deduplicationAttempts > 0 ?
+        qreal(stats.deduplicatedTiles) / deduplicationAttempts : 0.0;
+
+    QMutexLocker lock(&m_listLock);
+
     const qint64 metricCoeff = KisTileData::WIDTH * KisTileData::HEIGHT;
 
     stats.realMemorySize = m_pooler.lastRealMemoryMetric() * metricCoeff;
@@ -110,6 +145,11 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
 
+    KisSwappedDataStore::SwapStatistics swapStats = m_swappedStore.swapStatistics();
+    stats.swapFileSize = swapStats.fileSize;
+    stats.swapFreeSize = swapStats.freeSize;
+    stats.swapFragmentation = swapStats.fragmentation;
+
     return stats;
 }
 
@@ -153,6 +193,15 @@ KisTileData *KisTileDataStore::allocTileData(qint32 pixelSize, const quint8 *def
     return td;
 }
 
+KisTileData* KisTileDataStore::createMappedTileData(qint32 pixelSize, KisMappedFileSP file,
+                                                   qint64 offset, qint32 size,
+                                                   const QString &compressionId)
+{
+    KisTileData *td = new KisTileData(pixelSize, this);
+    m_swappedStore.mapTileData(td, file, offset, size, compressionId);
+    return td;
+}
+
 KisTileData *KisTileDataStore::duplicateTileData(KisTileData *rhs)
 {
     KisTileData *td = 0;
@@ -248,19 +297,134 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
      * This function is called with m_listLock acquired
      */
 
-    bool result = false;
-    if(!td->m_swapLock.tryLockForWrite()) return result;
+    if(!tryBeginSwapOut(td)) return false;
 
-    if(td->data()) {
-        unregisterTileDataImp(td);
-        m_swappedStore.swapOutTileData(td);
-        result = true;
-    }
+    m_swappedStore.swapOutTileData(td);
     td->m_swapLock.unlock();
 
+    return true;
+}
+
+bool KisTileDataStore::tryBeginSwapOut(KisTileData *td)
+{
+    if(!td->m_swapLock.tryLockForWrite()) return false;
+
+    if(!td->data()) {
+        td->m_swapLock.unlock();
+        return false;
+    }
+
+    unregisterTileDataImp(td);
+    return true;
+}
+
+void KisTileDataStore::finishSwapOut(const QVector<KisTileData*> &tiles)
+{
+    m_swappedStore.swapOutTileData(tiles);
+
+    Q_FOREACH (KisTileData *td, tiles) {
+        td->m_swapLock.unlock();
+    }
+}
+
+void KisTileDataStore::setDeduplicationEnabled(bool value)
+{
+    m_deduplicationEnabled = value;
+
+    if (!value) {
+        pruneDeduplicationIndex(true);
+    }
+}
+
+KisTileData* KisTileDataStore::deduplicateTileData(KisTileData *td)
+{
+    KisTileData *result = 0;
+    const qint32 dataSize = KisTileData::WIDTH * KisTileData::HEIGHT * td->pixelSize();
+
+    td->blockSwapping();
+
+    const uint hash =
+        qHash(QByteArray::fromRawData(reinterpret_cast<const char*>(td->data()), dataSize),
+              td->pixelSize());
+
+    {
+        QMutexLocker locker(&m_deduplicationLock);
+
+        KisTileData *candidate = m_deduplicationIndex.value(hash, 0);
+
+        if (!candidate) {
+            /**
+             * From now on every write into the tile will clone the data
+             */
+            td->acquire();
+            m_deduplicationIndex.insert(hash, td);
+            m_deduplicationTotalInsertions++;
+
+            /**
+             * The datas left in the index only are removed after
+             * every N insertions, N being proportional to the size
+             * of the index, so the removal is amortized O(1)
+             */
+            if (++m_deduplicationInsertions > m_deduplicationIndex.size() / 2 + 64) {
+                pruneDeduplicationIndex(false);
+            }
+        } else if (candidate != td) {
+            m_deduplicationChecks++;
+
+            if (candidate->pixelSize() == td->pixelSize()) {
+                candidate->blockSwapping();
+
+                if (!memcmp(candidate->data(), td->data(), dataSize)) {
+                    candidate->acquire();
+                    result = candidate;
+                    m_deduplicatedTiles++;
+                }
+
+                candidate->unblockSwapping();
+            }
+        }
+    }
+
+    td->unblockSwapping();
+
     return result;
 }
 
+void KisTileDataStore::pruneDeduplicationIndex(bool dropAll)
+{
+    /**
+     * Called with m_deduplicationLock held, except when dropping
+     * the whole index
+     */
+    QVector<KisTileData*> orphans;
+
+    if (dropAll) {
+        QMutexLocker locker(&m_deduplicationLock);
+        orphans = m_deduplicationIndex.values().toVector();
+        m_deduplicationIndex.clear();
+        m_deduplicationInsertions = 0;
+    } else {
+        QHash<uint, KisTileData*>::iterator it = m_deduplicationIndex.begin();
+        while (it != m_deduplicationIndex.end()) {
+            /**
+             * Nobody but the index uses the data, and nobody can
+             * start using it without taking m_deduplicationLock
+             */
+            if ((*it)->numUsers() <= 1) {
+                orphans.append(*it);
+                it = m_deduplicationIndex.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_deduplicationInsertions = 0;
+    }
+
+    Q_FOREACH (KisTileData *td, orphans) {
+        td->release();
+    }
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_listLock.lock();
@@ -323,6 +487,11 @@ void KisTileDataStore::debugSwapAll()
 
 void KisTileDataStore::debugClear()
 {
+    {
+        QMutexLocker dedupLocker(&m_deduplicationLock);
+        m_deduplicationIndex.clear();
+    }
+
     QMutexLocker lock(&m_listLock);
 
     Q_FOREACH (KisTileData *item, m_tileDataList) {
@@ -336,9 +505,16 @@ void KisTileDataStore::debugClear()
     m_memoryMetric = 0;
 }
 
+void KisTileDataStore::prefetchTile(const KisTileSP &tile)
+{
+    m_prefetcher.prefetch(tile);
+}
+
 void KisTileDataStore::testingRereadConfig() {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_prefetcher.testingRereadConfig();
+    setDeduplicationEnabled(KisImageConfig().tileDataDeduplication());
     kickPooler();
 }
 
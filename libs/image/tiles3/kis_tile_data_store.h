@@ -20,11 +20,13 @@
 
 #include "kritaimage_export.h"
 
+#include <QHash>
 #include <QReadWriteLock>
 #include "kis_tile_data_interface.h"
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 
 class KisTileDataStoreIterator;
@@ -51,6 +53,14 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapFileSize;
+        qint64 swapFreeSize;
+        qreal swapFragmentation;
+
+        qint64 deduplicationChecks;
+        qint64 deduplicationInsertions;
+        qint64 deduplicatedTiles;
+        qreal deduplicationRatio;
     };
 
     MemoryStatistics memoryStatistics();
@@ -70,6 +80,29 @@ public:
         return m_numTiles;
     }
 
+    /**
+     * Returns true if at least one tile data object has been
+     * swapped out. Used as a fast-path check by the prefetching
+     * code, which has nothing to do while everything is in memory.
+     */
+    inline bool hasSwappedTiles() const {
+        return m_swappedStore.numTiles() > 0;
+    }
+
+    /**
+     * Asks the prefetcher thread to load the data of \p tile into
+     * memory in background. The call does not block.
+     */
+    void prefetchTile(const KisTileSP &tile);
+
+    /**
+     * Removes the holes from the swap file (if there are too many
+     * of them). Called periodically by the swapper thread.
+     */
+    inline void compactSwap() {
+        m_swappedStore.compact();
+    }
+
     inline void checkFreeMemory() {
         m_swapper.checkFreeMemory();
     }
@@ -94,6 +127,18 @@ public:
         return allocTileData(pixelSize, defPixel);
     }
 
+    /**
+     * Creates a tile data, whose content is stored in \p size bytes
+     * of a mapped \p file. No memory is allocated until the first
+     * access to the data, the data is loaded the same way as if it
+     * was swapped out.
+     *
+     * \see KisSwappedDataStore::mapTileData()
+     */
+    KisTileData* createMappedTileData(qint32 pixelSize, KisMappedFileSP file,
+                                      qint64 offset, qint32 size,
+                                      const QString &compressionId);
+
     // Called by The Memento Manager after every commit
     inline void kickPooler() {
         m_pooler.kick();
@@ -109,6 +154,44 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Enables content based sharing of the tile data. The store keeps
+     * an index of the committed tile datas by the hash of their
+     * content. Every entry of the index is acquired by the store, so
+     * the indexed data can never be changed in place: writing into a
+     * tile sharing it goes through the usual copy-on-write.
+     *
+     * Disabling the deduplication drops the index, the tiles keep
+     * sharing their data until they are changed.
+     */
+    void setDeduplicationEnabled(bool value);
+
+    inline bool deduplicationEnabled() const {
+        return m_deduplicationEnabled;
+    }
+
+    /**
+     * Looks up a tile data with the same content as \p td in the
+     * deduplication index. Returns the found data *acquired* or null
+     * if there is no such data. In the latter case \p td is added to
+     * the index itself.
+     *
+     * Called by KisTile::deduplicate() only, the caller must guarantee
+     * that nobody changes \p td while the call is in progress.
+     */
+    KisTileData* deduplicateTileData(KisTileData *td);
+
+    /**
+     * The two-phase version of trySwapTileData() used for swapping
+     * out the tiles in batches. tryBeginSwapOut() locks the tile
+     * data and removes it from the list of the tiles in memory,
+     * then finishSwapOut() compresses the whole batch in parallel
+     * and releases the locks.
+     * Both methods are called with m_listLock acquired.
+     */
+    bool tryBeginSwapOut(KisTileData *td);
+    void finishSwapOut(const QVector<KisTileData*> &tiles);
+
 
     /**
      * WARN: The following three method are only for usage
@@ -140,6 +223,8 @@ private:
     inline void unregisterTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
 
+    void pruneDeduplicationIndex(bool dropAll);
+
     friend class DeadlockyThread;
     friend class KisLowMemoryTests;
     void debugSwapAll();
@@ -154,6 +239,7 @@ private:
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -171,6 +257,19 @@ private:
      * metric = num_bytes / (KisTileData::WIDTH * KisTileData::HEIGHT)
      */
     qint64 m_memoryMetric;
+
+    /**
+     * The deduplication index: content hash -> acquired tile data.
+     * On a hash collision the first entry wins, the second data
+     * is just left unshared.
+     */
+    bool m_deduplicationEnabled;
+    QMutex m_deduplicationLock;
+    QHash<uint, KisTileData*> m_deduplicationIndex;
+    int m_deduplicationInsertions;
+    qint64 m_deduplicationTotalInsertions;
+    qint64 m_deduplicationChecks;
+    qint64 m_deduplicatedTiles;
 };
 
 template<typename T>
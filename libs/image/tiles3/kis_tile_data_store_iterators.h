@@ -62,6 +62,13 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline bool tryBeginSwapOut(KisTileData *td) {
+        if(td->m_listIterator == m_iterator)
+            m_iterator++;
+
+        return m_store->tryBeginSwapOut(td);
+    }
+
 private:
     KisTileDataList &m_list;
     KisTileDataListIterator m_iterator;
@@ -99,6 +106,13 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline bool tryBeginSwapOut(KisTileData *td) {
+        if(td->m_listIterator == m_iterator)
+            m_iterator++;
+
+        return m_store->tryBeginSwapOut(td);
+    }
+
 private:
     KisTileDataList &m_list;
     KisTileDataListIterator m_iterator;
@@ -157,6 +171,13 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline bool tryBeginSwapOut(KisTileData *td) {
+        if(td->m_listIterator == m_iterator)
+            m_iterator++;
+
+        return m_store->tryBeginSwapOut(td);
+    }
+
 private:
     friend class KisTileDataStore;
     inline KisTileDataListIterator getFinalPosition() {
@@ -22,6 +22,7 @@
 
 #include "kis_tile.h"
 
+#include "config-tile-hash-table.h"
 
 
 /**
@@ -220,7 +221,18 @@ private:
 };
 
 
+#ifdef USE_SHARDED_TILE_HASH_TABLE
+
+#include "kis_sharded_tile_hash_table.h"
+
+typedef KisShardedTileHashTableTraits<KisTile> KisTileHashTable;
+typedef KisShardedTileHashTableIteratorTraits<KisTile> KisTileHashTableIterator;
+
+#else /* USE_SHARDED_TILE_HASH_TABLE */
+
 typedef KisTileHashTableTraits<KisTile> KisTileHashTable;
 typedef KisTileHashTableIteratorTraits<KisTile> KisTileHashTableIterator;
 
+#endif /* USE_SHARDED_TILE_HASH_TABLE */
+
 #endif /* KIS_TILEHASHTABLE_H_ */
@@ -20,6 +20,7 @@
 
 #include <QRect>
 #include <QVector>
+#include <QtConcurrent>
 
 #include "kis_tile.h"
 #include "kis_tiled_data_manager.h"
@@ -28,8 +29,11 @@
 #include "kis_memento_manager.h"
 #include "swap/kis_legacy_tile_compressor.h"
 #include "swap/kis_tile_compressor_factory.h"
+#include "swap/kis_compression_registry.h"
+#include "swap/kis_mapped_file.h"
 
 #include "kis_paint_device_writer.h"
+#include "kis_image_config.h"
 
 #include "kis_global.h"
 
@@ -114,6 +118,18 @@ void KisTiledDataManager::setDefaultPixelImpl(const quint8 *defaultPixel)
     memcpy(m_defaultPixel, defaultPixel, pixelSize());
 }
 
+void KisTiledDataManager::deduplicateChangedTiles()
+{
+    if (!KisTileDataStore::instance()->deduplicationEnabled()) return;
+
+    Q_FOREACH (const QPoint &index, m_mementoManager->uncommittedChangedTiles()) {
+        KisTileSP tile = m_hashTable->getExistedTile(index.x(), index.y());
+        if (tile) {
+            tile->deduplicate();
+        }
+    }
+}
+
 bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 {
     QReadLocker locker(&m_lock);
@@ -134,7 +150,8 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
     KisTileSP tile;
 
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(CURRENT_VERSION,
+                                         KisImageConfig(true).tileSaveCompression());
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -182,13 +199,22 @@ bool KisTiledDataManager::read(QIODevice *stream)
         numTiles = line.toUInt();
     }
 
-    KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(tilesVersion);
-
     bool readSuccess = true;
-    for (quint32 i = 0; i < numTiles; i++) {
-        if (!compressor->readTile(stream, this)) {
-            readSuccess = false;
+
+    KisMappedFileDevice *mappedStream = dynamic_cast<KisMappedFileDevice*>(stream);
+
+    if (tilesVersion == 2 && mappedStream) {
+        readSuccess = readTilesMapped(mappedStream, numTiles);
+    } else if (tilesVersion == 2 && numTiles >= 2 * TILES_PER_READ_JOB) {
+        readSuccess = readTilesParallel(stream, numTiles);
+    } else {
+        KisAbstractTileCompressorSP compressor =
+            KisTileCompressorFactory::create(tilesVersion);
+
+        for (quint32 i = 0; i < numTiles; i++) {
+            if (!compressor->readTile(stream, this)) {
+                readSuccess = false;
+            }
         }
     }
 
@@ -196,6 +222,104 @@ bool KisTiledDataManager::read(QIODevice *stream)
     return readSuccess;
 }
 
+bool KisTiledDataManager::readTilesParallel(QIODevice *stream, quint32 numTiles)
+{
+    typedef KisTileCompressor2::TileRecord TileRecord;
+
+    /**
+     * Reading the stream cannot be parallelized (the store usually
+     * inflates a zip entry), so the compressed tiles are read into
+     * memory first, and only then decompressed by several threads
+     */
+    QVector<TileRecord> records(numTiles);
+    bool readSuccess = true;
+
+    {
+        KisTileCompressor2 compressor;
+        for (quint32 i = 0; i < numTiles; i++) {
+            if (!compressor.readTileRecord(stream, this, records[i])) {
+                readSuccess = false;
+            }
+        }
+    }
+
+    struct ReadJob {
+        int begin;
+        int end;
+        bool success;
+    };
+
+    QVector<ReadJob> jobs;
+    for (int i = 0; i < records.size(); i += TILES_PER_READ_JOB) {
+        ReadJob job = {i, qMin(i + TILES_PER_READ_JOB, records.size()), true};
+        jobs << job;
+    }
+
+    QtConcurrent::blockingMap(jobs,
+        [&records] (ReadJob &job) {
+            KisTileCompressor2 compressor;
+            for (int i = job.begin; i < job.end; i++) {
+                if (records[i].tile && !compressor.decompressTileRecord(records[i])) {
+                    job.success = false;
+                }
+            }
+        });
+
+    Q_FOREACH (const ReadJob &job, jobs) {
+        readSuccess &= job.success;
+    }
+
+    return readSuccess;
+}
+
+bool KisTiledDataManager::readTilesMapped(KisMappedFileDevice *stream, quint32 numTiles)
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    KisTileCompressor2 compressor;
+
+    for (quint32 i = 0; i < numTiles; i++) {
+        KisTileCompressor2::TileHeader header;
+
+        /**
+         * The stream cannot be synchronized after a broken header,
+         * so the rest of the tiles is lost anyway
+         */
+        if (!compressor.readTileHeader(stream, this, header)) return false;
+
+        const qint64 dataPos = stream->pos();
+        const qint64 dataOffset = stream->fileOffset() + dataPos;
+
+        if (header.dataSize <= 0 ||
+            dataPos + header.dataSize > stream->size() ||
+            !stream->seek(dataPos + header.dataSize)) {
+
+            return false;
+        }
+
+        if (!KisCompressionRegistry::instance()->contains(header.compressionName)) {
+            warnFile << "Failed to load a tile: unknown compression" << header.compressionName;
+            return false;
+        }
+
+        if (!KisTileCompressor2::checkTileDataSize(stream->file()->data(dataOffset),
+                                                   header.dataSize, m_pixelSize)) {
+            return false;
+        }
+
+        KisTileData *td =
+            store->createMappedTileData(m_pixelSize, stream->file(),
+                                        dataOffset, header.dataSize,
+                                        header.compressionName);
+
+        m_hashTable->deleteTile(header.col, header.row);
+        KisTileSP tile = new KisTile(header.col, header.row, td, m_mementoManager);
+        m_hashTable->addTile(tile);
+        updateExtent(header.col, header.row);
+    }
+
+    return true;
+}
+
 bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles)
 {
     QString buffer;
@@ -727,6 +851,31 @@ void KisTiledDataManager::readBytes(quint8 *data,
     readBytesBody(data, x, y, width, height, dataRowStride);
 }
 
+void KisTiledDataManager::prefetchTiles(const QRect &rect) const
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    if (!store->hasSwappedTiles()) return;
+
+    QReadLocker locker(&m_lock);
+
+    const QRect dataRect = rect & extentImpl();
+    if (dataRect.isEmpty()) return;
+
+    const qint32 firstColumn = xToCol(dataRect.left());
+    const qint32 firstRow = yToRow(dataRect.top());
+    const qint32 lastColumn = xToCol(dataRect.right());
+    const qint32 lastRow = yToRow(dataRect.bottom());
+
+    for (qint32 row = firstRow; row <= lastRow; ++row) {
+        for (qint32 column = firstColumn; column <= lastColumn; ++column) {
+            KisTileSP tile = m_hashTable->getExistedTile(column, row);
+            if (tile) {
+                store->prefetchTile(tile);
+            }
+        }
+    }
+}
+
 QVector<quint8*>
 KisTiledDataManager::readPlanarBytes(QVector<qint32> channelSizes,
                                      qint32 x, qint32 y,
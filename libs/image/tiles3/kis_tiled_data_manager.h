@@ -40,6 +40,7 @@ typedef KisSharedPtr<KisTiledDataManager> KisTiledDataManagerSP;
 class KisTiledIterator;
 class KisTiledRandomAccessor;
 class KisPaintDeviceWriter;
+class KisMappedFileDevice;
 class QIODevice;
 
 /**
@@ -125,6 +126,8 @@ public:
             memento->saveNewDefaultPixel(m_defaultPixel, m_pixelSize);
         }
 
+        deduplicateChangedTiles();
+
         m_mementoManager->commit();
     }
 
@@ -243,6 +246,16 @@ public:
                    qint32 x, qint32 y,
                    qint32 w, qint32 h,
                    qint32 dataRowStride = -1) const;
+
+    /**
+     * Asks the tile data store to load the swapped out tiles
+     * covering \p rect back into memory in background. The call
+     * returns immediately and is a no-op when nothing is swapped.
+     * Use it when you know in advance which area is going to be
+     * read soon.
+     */
+    void prefetchTiles(const QRect &rect) const;
+
     /**
      * Copy the bytes in the vector to the specified rect. If there are bytes left
      * in the vector after filling the rect, they will be ignored. If there are
@@ -324,11 +337,32 @@ private:
 private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
+    /**
+     * Shares the data of the tiles changed in the current transaction
+     * with the equal tiles known to the store, if the deduplication
+     * is enabled. Called under m_lock.
+     */
+    void deduplicateChangedTiles();
+
     QRect extentImpl() const;
 
     bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
     bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
 
+    /**
+     * Decompresses the tiles of a version 2 stream by several
+     * threads, TILES_PER_READ_JOB tiles per job
+     */
+    bool readTilesParallel(QIODevice *stream, quint32 numTiles);
+    static const int TILES_PER_READ_JOB = 32;
+
+    /**
+     * Reads the headers of a version 2 stream only. The tiles get the
+     * data that points to the mapped file and is decompressed on the
+     * first access.
+     */
+    bool readTilesMapped(KisMappedFileDevice *stream, quint32 numTiles);
+
     qint32 divideRoundDown(qint32 x, const qint32 y) const;
 
     void updateExtent(qint32 col, qint32 row);
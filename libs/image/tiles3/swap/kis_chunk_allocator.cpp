@@ -27,15 +27,28 @@
 
 #define PEEK_NEXT(iter) (*(iter))
 #define PEEK_PREVIOUS(iter) (*((iter)-1))
-#define WRAP_PREVIOUS_CHUNK_DATA(iter) (KisChunk((iter)-1))
+
+
+const quint64 KisChunkAllocator::SIZE_CLASS_GRANULARITY = 256;
+const qint32 KisChunkAllocator::NUM_SIZE_CLASSES = 256;
+
+/**
+ * The gaps in the size class of the requested chunk may be
+ * smaller than the chunk, so we check only a few of them before
+ * falling back to the bigger classes
+ */
+const qint32 KisChunkAllocator::MAX_EXACT_CLASS_PROBES = 8;
 
 
 KisChunkAllocator::KisChunkAllocator(quint64 slabSize, quint64 storeSize)
+    : m_freeLists(NUM_SIZE_CLASSES),
+      m_freeSize(0)
 {
+    m_compactionCursor = m_list.end();
+
     m_storeMaxSize = storeSize;
     m_storeSlabSize = slabSize;
 
-    m_iterator = m_list.begin();
     m_storeSize = m_storeSlabSize;
     INIT_FAIL_COUNTER();
 }
@@ -44,84 +57,190 @@ KisChunkAllocator::~KisChunkAllocator()
 {
 }
 
+inline qint32 KisChunkAllocator::sizeClass(quint64 size)
+{
+    return qMin(quint64(NUM_SIZE_CLASSES - 1), size / SIZE_CLASS_GRANULARITY);
+}
+
 KisChunk KisChunkAllocator::getChunk(quint64 size)
 {
-    KisChunkDataListIterator startPosition = m_iterator;
+    Q_ASSERT(size > 0);
     START_COUNTING();
 
-    forever {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
-
-        if(m_iterator == m_list.end())
-            break;
+    const qint32 exactClass = sizeClass(size);
 
-        m_iterator++;
+    KisChunkGapList &exactList = m_freeLists[exactClass];
+    KisChunkGapListIterator it = exactList.begin();
+    for (qint32 i = 0; it != exactList.end() && i < MAX_EXACT_CLASS_PROBES; ++it, ++i) {
+        if ((*it)->m_gapSize >= size) {
+            return insertIntoGap(*it, size);
+        }
         REGISTER_STEP();
     }
 
+    /**
+     * Any gap of the bigger classes is guaranteed to fit the chunk,
+     * except the last class, which is unbounded from above
+     */
+    for (qint32 sc = exactClass + 1; sc < NUM_SIZE_CLASSES; sc++) {
+        KisChunkGapList &list = m_freeLists[sc];
+
+        for (it = list.begin(); it != list.end(); ++it) {
+            if ((*it)->m_gapSize >= size) {
+                return insertIntoGap(*it, size);
+            }
+            REGISTER_STEP();
+        }
+    }
+
     REGISTER_FAIL();
-    m_iterator = m_list.begin();
+    return appendToTail(size);
+}
 
-    forever {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
+KisChunk KisChunkAllocator::insertIntoGap(KisChunkDataListIterator next, quint64 size)
+{
+    const quint64 begin = next->m_begin - next->m_gapSize;
 
-        if(m_iterator == m_list.end() || m_iterator == startPosition)
-            break;
+    unregisterGap(next);
+    KisChunkDataListIterator chunk = m_list.insert(next, KisChunkData(begin, size));
+    registerGap(next);
 
-        m_iterator++;
-        REGISTER_STEP();
-    }
+    return KisChunk(chunk);
+}
 
-    REGISTER_FAIL();
-    m_iterator = m_list.end();
+KisChunk KisChunkAllocator::appendToTail(quint64 size)
+{
+    const quint64 begin = usedSize();
 
-    while ((m_storeSize += m_storeSlabSize) <= m_storeMaxSize) {
-        if(tryInsertChunk(m_list, m_iterator, size))
-            return WRAP_PREVIOUS_CHUNK_DATA(m_iterator);
-    }
+    while (begin + size > m_storeSize) {
+        if (m_storeSize + m_storeSlabSize > m_storeMaxSize) {
+            qFatal("KisChunkAllocator: out of swap space");
+        }
 
-    qFatal("KisChunkAllocator: out of swap space");
+        m_storeSize += m_storeSlabSize;
+    }
 
-    // just let gcc be happy! :)
-    return KisChunk(m_list.end());
+    return KisChunk(m_list.insert(m_list.end(), KisChunkData(begin, size)));
 }
 
-bool KisChunkAllocator::tryInsertChunk(KisChunkDataList &list,
-                                       KisChunkDataListIterator &iterator,
-                                       quint64 size)
+void KisChunkAllocator::freeChunk(KisChunk chunk)
 {
-    bool result = false;
-    quint64 highBound = m_storeSize;
-    quint64 lowBound = 0;
-    quint64 shift = 0;
+    KisChunkDataListIterator position = chunk.position();
+    Q_ASSERT(position->m_begin == chunk.begin());
 
-    if(HAS_NEXT(list, iterator))
-        highBound = PEEK_NEXT(iterator).m_begin;
+    KisChunkDataListIterator next = position + 1;
 
-    if(HAS_PREVIOUS(list, iterator)) {
-        lowBound = PEEK_PREVIOUS(iterator).m_end;
-        shift = 1;
+    unregisterGap(position);
+    if (next != m_list.end()) {
+        unregisterGap(next);
     }
 
-    if(GAP_SIZE(lowBound, highBound) >= size) {
-        list.insert(iterator, KisChunkData(lowBound + shift, size));
-        result = true;
+    /**
+     * All the chunks before the compaction cursor are packed, so
+     * the new gap becomes the place where compaction resumes
+     */
+    const bool resetCursor =
+        m_compactionCursor == m_list.end() ||
+        position->m_begin <= m_compactionCursor->m_begin;
+
+    next = m_list.erase(position);
+
+    if (resetCursor) {
+        m_compactionCursor = next;
     }
 
-    return result;
+    /**
+     * If the last chunk has been freed, its space (and the
+     * gap before it) just becomes a part of the tail
+     */
+    if (next != m_list.end()) {
+        registerGap(next);
+    }
 }
 
-void KisChunkAllocator::freeChunk(KisChunk chunk)
+inline quint64 KisChunkAllocator::calculateGap(KisChunkDataListIterator chunk)
+{
+    const quint64 lowBound =
+        HAS_PREVIOUS(m_list, chunk) ? PEEK_PREVIOUS(chunk).m_end + 1 : 0;
+
+    return chunk->m_begin - lowBound;
+}
+
+void KisChunkAllocator::registerGap(KisChunkDataListIterator chunk)
+{
+    Q_ASSERT(chunk->m_freeListIndex < 0);
+
+    const quint64 gap = calculateGap(chunk);
+    if (!gap) return;
+
+    const qint32 index = sizeClass(gap);
+    KisChunkGapList &list = m_freeLists[index];
+
+    chunk->m_gapSize = gap;
+    chunk->m_freeListIndex = index;
+    chunk->m_freeListPosition = list.insert(list.begin(), chunk);
+
+    m_freeSize += gap;
+}
+
+void KisChunkAllocator::unregisterGap(KisChunkDataListIterator chunk)
 {
-    if(m_iterator != m_list.end() && m_iterator == chunk.position()) {
-        m_iterator = m_list.erase(m_iterator);
-        return;
+    if (chunk->m_freeListIndex < 0) return;
+
+    m_freeLists[chunk->m_freeListIndex].erase(chunk->m_freeListPosition);
+    m_freeSize -= chunk->m_gapSize;
+
+    chunk->m_gapSize = 0;
+    chunk->m_freeListIndex = -1;
+}
+
+bool KisChunkAllocator::compact(MoveFunction moveFunc, quint64 maxBytesToMove)
+{
+    quint64 bytesMoved = 0;
+
+    /**
+     * The chunks before the cursor have no gaps, so there is no
+     * need to rescan them on every call
+     */
+    KisChunkDataListIterator it = m_compactionCursor;
+    while (it != m_list.end() && m_freeSize > 0) {
+        KisChunkDataListIterator next = it + 1;
+
+        if (it->m_gapSize > 0) {
+            if (bytesMoved >= maxBytesToMove) break;
+
+            const KisChunkData newPosition(it->m_begin - it->m_gapSize, it->size());
+            moveFunc(*it, newPosition);
+            bytesMoved += newPosition.size();
+
+            /**
+             * The gap before the chunk is transferred to the next one
+             */
+            unregisterGap(it);
+            it->setChunk(newPosition.m_begin, newPosition.size());
+
+            if (next != m_list.end()) {
+                unregisterGap(next);
+                registerGap(next);
+            }
+        }
+
+        it = next;
     }
 
-    Q_ASSERT(chunk.position()->m_begin == chunk.begin());
-    m_list.erase(chunk.position());
+    m_compactionCursor = m_freeSize > 0 ? it : m_list.end();
+
+    shrinkStore();
+
+    return !m_freeSize;
+}
+
+void KisChunkAllocator::shrinkStore()
+{
+    const quint64 used = usedSize();
+    const quint64 numSlabs = qMax(quint64(1), (used + m_storeSlabSize - 1) / m_storeSlabSize);
+
+    m_storeSize = qMin(m_storeSize, numSlabs * m_storeSlabSize);
 }
 
 
@@ -20,6 +20,8 @@
 #define __KIS_CHUNK_LIST_H
 
 #include <QLinkedList>
+#include <QVector>
+#include <functional>
 
 #define MiB (1ULL << 20)
 
@@ -57,10 +59,15 @@ class KisChunkData;
 typedef QLinkedList<KisChunkData> KisChunkDataList;
 typedef KisChunkDataList::iterator KisChunkDataListIterator;
 
+typedef QLinkedList<KisChunkDataListIterator> KisChunkGapList;
+typedef KisChunkGapList::iterator KisChunkGapListIterator;
+
 class KisChunkData
 {
 public:
     KisChunkData(quint64 begin, quint64 size)
+        : m_gapSize(0),
+          m_freeListIndex(-1)
     {
         setChunk(begin, size);
     }
@@ -87,6 +94,16 @@ public:
 
     quint64 m_begin;
     quint64 m_end;
+
+    /**
+     * The free space between the previous chunk and this one.
+     * Every non-empty gap is registered in one of the free lists
+     * of KisChunkAllocator, m_freeListIndex and m_freeListPosition
+     * point to this registration.
+     */
+    quint64 m_gapSize;
+    qint32 m_freeListIndex;
+    KisChunkGapListIterator m_freeListPosition;
 };
 
 class KisChunk
@@ -124,8 +141,27 @@ private:
 };
 
 
+/**
+ * Manages the space of the swap file. The chunks are kept in a list
+ * sorted by their position in the file. The free gaps between the
+ * chunks are registered in segregated free lists by their size class
+ * (SIZE_CLASS_GRANULARITY bytes each), so finding a gap for a new
+ * chunk doesn't need a linear search through the whole file.
+ * When no gap fits, the chunk is appended to the tail of the file.
+ *
+ * The holes left by the freed chunks can be removed by compact(),
+ * which slides the chunks towards the beginning of the file.
+ */
 class KisChunkAllocator
 {
+public:
+    /**
+     * Is called by compact() for every chunk being relocated,
+     * before the chunk is actually updated, so the data can be
+     * copied from \p from to \p to position
+     */
+    typedef std::function<void (const KisChunkData &from, const KisChunkData &to)> MoveFunction;
+
 public:
     KisChunkAllocator(quint64 slabSize = DEFAULT_SLAB_SIZE,
                       quint64 storeSize = DEFAULT_STORE_SIZE);
@@ -138,23 +174,86 @@ public:
     KisChunk getChunk(quint64 size);
     void freeChunk(KisChunk chunk);
 
+    /**
+     * Relocates the chunks to fill the gaps between them. At most
+     * \p maxBytesToMove bytes are moved during one call, so the
+     * compaction can be done incrementally without blocking the
+     * users of the swap for too long. The next call resumes from
+     * the position where the previous one stopped. After the
+     * relocation the store is shrunk to the smallest number of
+     * slabs needed.
+     *
+     * \return true if there are no gaps left
+     */
+    bool compact(MoveFunction moveFunc, quint64 maxBytesToMove);
+
+    /**
+     * The size of the store reserved for the swap (multiple of
+     * the slab size)
+     */
+    inline quint64 storeSize() const {
+        return m_storeSize;
+    }
+
+    inline quint64 slabSize() const {
+        return m_storeSlabSize;
+    }
+
+    /**
+     * The position of the end of the last chunk
+     */
+    inline quint64 usedSize() const {
+        return !m_list.isEmpty() ? m_list.last().m_end + 1 : 0;
+    }
+
+    /**
+     * The total size of the gaps between the chunks
+     */
+    inline quint64 freeSize() const {
+        return m_freeSize;
+    }
+
+    inline qreal fragmentation() const {
+        const quint64 used = usedSize();
+        return used ? qreal(m_freeSize) / used : 0.0;
+    }
+
     void debugChunks();
     bool sanityCheck(bool pleaseCrash = true);
     qreal debugFragmentation(bool toStderr = true);
 
 private:
-    bool tryInsertChunk(KisChunkDataList &list,
-                        KisChunkDataListIterator &iterator,
-                        quint64 size);
+    KisChunk insertIntoGap(KisChunkDataListIterator next, quint64 size);
+    KisChunk appendToTail(quint64 size);
+
+    inline quint64 calculateGap(KisChunkDataListIterator chunk);
+    void registerGap(KisChunkDataListIterator chunk);
+    void unregisterGap(KisChunkDataListIterator chunk);
+
+    static inline qint32 sizeClass(quint64 size);
+
+    void shrinkStore();
 
 private:
+    static const quint64 SIZE_CLASS_GRANULARITY;
+    static const qint32 NUM_SIZE_CLASSES;
+    static const qint32 MAX_EXACT_CLASS_PROBES;
+
     quint64 m_storeMaxSize;
     quint64 m_storeSlabSize;
 
-
     KisChunkDataList m_list;
-    KisChunkDataListIterator m_iterator;
     quint64 m_storeSize;
+
+    QVector<KisChunkGapList> m_freeLists;
+    quint64 m_freeSize;
+
+    /**
+     * The first chunk that may have a gap before it. All the
+     * chunks before it are already packed.
+     */
+    KisChunkDataListIterator m_compactionCursor;
+
     DECLARE_FAIL_COUNTER()
 };
 
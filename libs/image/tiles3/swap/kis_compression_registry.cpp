@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_compression_registry.h"
+
+#include <QGlobalStatic>
+
+#include "kis_lzf_compression.h"
+#include "kis_zlib_compression.h"
+
+#include "config-lz4.h"
+#ifdef HAVE_LZ4
+#include "kis_lz4_compression.h"
+#endif
+
+Q_GLOBAL_STATIC(KisCompressionRegistry, s_instance)
+
+
+KisCompressionRegistry::KisCompressionRegistry()
+{
+    addFactory("LZF", [] () { return new KisLzfCompression(); });
+    addFactory("ZLIB", [] () { return new KisZlibCompression(); });
+
+#ifdef HAVE_LZ4
+    addFactory("LZ4", [] () { return new KisLz4Compression(); });
+#endif
+}
+
+KisCompressionRegistry::~KisCompressionRegistry()
+{
+}
+
+void KisCompressionRegistry::addFactory(const QString &id, const KisCompressionFactory &factory)
+{
+    m_map.insert(id, factory);
+}
+
+KisAbstractCompression* KisCompressionRegistry::create(const QString &id) const
+{
+    KisCompressionFactoryMap::const_iterator it = m_map.constFind(id);
+    return it != m_map.constEnd() ? (*it)() : 0;
+}
+
+bool KisCompressionRegistry::contains(const QString &id) const
+{
+    return m_map.contains(id);
+}
+
+QStringList KisCompressionRegistry::keys() const
+{
+    return m_map.keys();
+}
+
+QString KisCompressionRegistry::fallbackId()
+{
+    return "LZF";
+}
+
+KisCompressionRegistry* KisCompressionRegistry::instance()
+{
+    return s_instance;
+}
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_COMPRESSION_REGISTRY_H
+#define __KIS_COMPRESSION_REGISTRY_H
+
+#include <QMap>
+#include <QStringList>
+
+#include <functional>
+
+#include "kritaimage_export.h"
+
+class KisAbstractCompression;
+
+
+using KisCompressionFactory    = std::function<KisAbstractCompression* ()>;
+using KisCompressionFactoryMap = QMap<QString, KisCompressionFactory>;
+
+/**
+ * Keeps the list of the compression backends available for the tile
+ * compressors. The backends are identified by a short ASCII name,
+ * which is written into the header of every tile saved into a file,
+ * so the name of a backend must never change and must not contain
+ * commas or newlines.
+ *
+ * LZF backend is always available and is used as a fallback when
+ * the requested backend is not compiled in.
+ */
+class KRITAIMAGE_EXPORT KisCompressionRegistry
+{
+public:
+    KisCompressionRegistry();
+    ~KisCompressionRegistry();
+
+    void addFactory(const QString &id, const KisCompressionFactory &factory);
+
+    /**
+     * Creates a new compression object of type \p id. The caller
+     * takes the ownership of the object. If there is no such backend,
+     * returns null.
+     */
+    KisAbstractCompression* create(const QString &id) const;
+
+    bool contains(const QString &id) const;
+    QStringList keys() const;
+
+    /**
+     * The id of the backend that is guaranteed to be present
+     */
+    static QString fallbackId();
+
+    static KisCompressionRegistry* instance();
+
+private:
+    KisCompressionFactoryMap m_map;
+};
+
+#endif /* __KIS_COMPRESSION_REGISTRY_H */
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_mapped_file.h"
+
+#include "kis_debug.h"
+#include "kis_assert.h"
+
+
+KisMappedFile::KisMappedFile(const QString &fileName)
+    : m_file(fileName),
+      m_data(0)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        warnTiles << "Failed to open" << fileName << "for mapping";
+        return;
+    }
+
+    m_data = m_file.map(0, m_file.size());
+
+    if (!m_data) {
+        warnTiles << "Failed to map" << fileName << m_file.errorString();
+        m_file.close();
+    }
+}
+
+KisMappedFile::~KisMappedFile()
+{
+    if (m_data) {
+        m_file.unmap(m_data);
+    }
+}
+
+bool KisMappedFile::isValid() const
+{
+    return m_data;
+}
+
+QString KisMappedFile::fileName() const
+{
+    return m_file.fileName();
+}
+
+qint64 KisMappedFile::size() const
+{
+    return m_data ? m_file.size() : 0;
+}
+
+
+KisMappedFileDevice::KisMappedFileDevice(KisMappedFileSP file, qint64 offset, qint64 size)
+    : m_file(file),
+      m_offset(offset),
+      m_size(size)
+{
+    KIS_ASSERT_RECOVER(m_file->isValid() && m_offset + m_size <= m_file->size()) {
+        m_size = 0;
+    }
+}
+
+KisMappedFileSP KisMappedFileDevice::file() const
+{
+    return m_file;
+}
+
+qint64 KisMappedFileDevice::fileOffset() const
+{
+    return m_offset;
+}
+
+bool KisMappedFileDevice::isSequential() const
+{
+    return false;
+}
+
+qint64 KisMappedFileDevice::size() const
+{
+    return m_size;
+}
+
+qint64 KisMappedFileDevice::readData(char *data, qint64 maxSize)
+{
+    const qint64 bytesRead = qMin(maxSize, m_size - pos());
+    if (bytesRead <= 0) return 0;
+
+    memcpy(data, m_file->data(m_offset + pos()), bytesRead);
+    return bytesRead;
+}
+
+qint64 KisMappedFileDevice::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_MAPPED_FILE_H
+#define __KIS_MAPPED_FILE_H
+
+#include <QFile>
+#include <QIODevice>
+
+#include "kritaimage_export.h"
+#include "kis_shared.h"
+#include "kis_shared_ptr.h"
+
+
+/**
+ * A file mapped into memory read-only as a whole. The tile data
+ * loaded lazily from the file keep a shared pointer to it, so the
+ * mapping lives until the last of such tiles is either loaded or
+ * deleted.
+ */
+class KRITAIMAGE_EXPORT KisMappedFile : public KisShared
+{
+public:
+    KisMappedFile(const QString &fileName);
+    ~KisMappedFile();
+
+    /**
+     * False if the file could not be opened or mapped, e.g. when
+     * it doesn't fit into the address space
+     */
+    bool isValid() const;
+
+    QString fileName() const;
+    qint64 size() const;
+
+    inline const quint8* data(qint64 offset) const {
+        return m_data + offset;
+    }
+
+private:
+    QFile m_file;
+    quint8 *m_data;
+};
+
+typedef KisSharedPtr<KisMappedFile> KisMappedFileSP;
+
+
+/**
+ * A read-only random access device over a part of a mapped file.
+ * KisTiledDataManager::read() recognizes this device and, instead of
+ * decompressing the tiles, makes their data point to the file.
+ */
+class KRITAIMAGE_EXPORT KisMappedFileDevice : public QIODevice
+{
+public:
+    KisMappedFileDevice(KisMappedFileSP file, qint64 offset, qint64 size);
+
+    KisMappedFileSP file() const;
+
+    /**
+     * The offset of the beginning of the device in the file
+     */
+    qint64 fileOffset() const;
+
+    bool isSequential() const;
+    qint64 size() const;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *data, qint64 maxSize);
+
+private:
+    KisMappedFileSP m_file;
+    qint64 m_offset;
+    qint64 m_size;
+};
+
+#endif /* __KIS_MAPPED_FILE_H */
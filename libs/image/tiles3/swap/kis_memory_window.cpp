@@ -59,6 +59,21 @@ quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
     return m_writeWindowEx.calculatePointer(writeChunk);
 }
 
+void KisMemoryWindow::shrink(quint64 size)
+{
+    if (size >= (quint64)m_file.size()) return;
+
+    m_file.unmap(m_readWindowEx.window);
+    m_readWindowEx.window = 0;
+    m_readWindowEx.chunk.setChunk(0, 0);
+
+    m_file.unmap(m_writeWindowEx.window);
+    m_writeWindowEx.window = 0;
+    m_writeWindowEx.chunk.setChunk(0, 0);
+
+    m_file.resize(size);
+}
+
 void KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
                                    MappingWindow *adjustingWindow,
                                    MappingWindow *otherWindow)
@@ -46,6 +46,12 @@ public:
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
 
+    /**
+     * Truncates the swap file to \p size bytes if it is bigger.
+     * All the pointers returned by the window become invalid.
+     */
+    void shrink(quint64 size);
+
 private:
     struct MappingWindow {
         MappingWindow(quint64 _defaultSize)
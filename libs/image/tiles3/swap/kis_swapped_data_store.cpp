@@ -21,10 +21,51 @@
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
 
+#include <QRunnable>
+#include <QThreadPool>
+
 #include "kis_tile_compressor_2.h"
+#include "kis_debug.h"
 
 //#define COMPRESSOR_VERSION 2
 
+/**
+ * The compaction starts when more than a quarter of the swap
+ * file is occupied by holes and moves at most 4 MiB per step.
+ * The tiles being swapped in or forgotten create the holes, so
+ * these operations do a smaller step of compaction themselves.
+ */
+const qreal KisSwappedDataStore::MAX_FRAGMENTATION = 0.25;
+const quint64 KisSwappedDataStore::COMPACTION_STEP_SIZE = 4 * MiB;
+const quint64 KisSwappedDataStore::ONLINE_COMPACTION_STEP_SIZE = 256 * 1024;
+
+
+class KisSwappedDataStore::SwapOutJob : public QRunnable
+{
+public:
+    SwapOutJob(KisSwappedDataStore *store,
+               const QVector<KisTileData*> &tiles,
+               QAtomicInt *nextIndex)
+        : m_store(store),
+          m_tiles(tiles),
+          m_nextIndex(nextIndex)
+    {
+    }
+
+    void run() {
+        int index;
+        while ((index = m_nextIndex->fetchAndAddOrdered(1)) < m_tiles.size()) {
+            m_store->swapOutTileData(m_tiles[index]);
+        }
+    }
+
+private:
+    KisSwappedDataStore *m_store;
+    const QVector<KisTileData*> &m_tiles;
+    QAtomicInt *m_nextIndex;
+};
+
+
 KisSwappedDataStore::KisSwappedDataStore()
     : m_memoryMetric(0)
 {
@@ -36,13 +77,27 @@ KisSwappedDataStore::KisSwappedDataStore()
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
     m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    m_compressionId = config.swapCompression();
+
+    /**
+     * The thread calling swapOutTileData() takes part in the
+     * compression as well, so the pool needs one thread less
+     */
+    m_compressionPool = new QThreadPool();
+    m_compressionPool->setMaxThreadCount(config.swapCompressionThreads() - 1);
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
-    delete m_compressor;
+    m_compressionPool->waitForDone();
+    delete m_compressionPool;
+
+    CompressionContext *context;
+    while (m_freeContexts.pop(context)) {
+        delete context->compressor;
+        delete context;
+    }
+
     delete m_swapSpace;
     delete m_allocator;
 }
@@ -52,13 +107,28 @@ quint64 KisSwappedDataStore::numTiles() const
     // We are not acquiring the lock here...
     // Hope QLinkedList will ensure atomic access to it's size...
 
-    return m_allocator->numChunks();
+    return m_allocator->numChunks() + m_mappedChunks.size();
+}
+
+KisSwappedDataStore::CompressionContext* KisSwappedDataStore::acquireContext()
+{
+    CompressionContext *context = 0;
+
+    if (!m_freeContexts.pop(context)) {
+        context = new CompressionContext(new KisTileCompressor2(m_compressionId));
+    }
+
+    return context;
+}
+
+void KisSwappedDataStore::releaseContext(CompressionContext *context)
+{
+    m_freeContexts.push(context);
 }
 
 void KisSwappedDataStore::swapOutTileData(KisTileData *td)
 {
     Q_ASSERT(td->data());
-    QMutexLocker locker(&m_lock);
 
     /**
      * We are expecting that the lock of KisTileData
@@ -66,50 +136,202 @@ void KisSwappedDataStore::swapOutTileData(KisTileData *td)
      * So we can modify the tile data freely.
      */
 
-    const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
-    if(m_buffer.size() < expectedBufferSize)
-        m_buffer.resize(expectedBufferSize);
+    CompressionContext *context = acquireContext();
+
+    const qint32 expectedBufferSize = context->compressor->tileDataBufferSize(td);
+    if(context->buffer.size() < expectedBufferSize)
+        context->buffer.resize(expectedBufferSize);
 
     qint32 bytesWritten;
-    m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
+    context->compressor->compressTileData(td, (quint8*) context->buffer.data(), context->buffer.size(), bytesWritten);
+
+    KisChunk chunk;
+
+    {
+        QMutexLocker locker(&m_lock);
 
-    KisChunk chunk = m_allocator->getChunk(bytesWritten);
-    quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
-    memcpy(ptr, m_buffer.data(), bytesWritten);
+        chunk = m_allocator->getChunk(bytesWritten);
+        quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
+        memcpy(ptr, context->buffer.data(), bytesWritten);
+
+        m_memoryMetric += td->pixelSize();
+    }
+
+    releaseContext(context);
 
     td->releaseMemory();
     td->setSwapChunk(chunk);
+}
+
+void KisSwappedDataStore::swapOutTileData(const QVector<KisTileData*> &tiles)
+{
+    /**
+     * Only one batch at a time, otherwise two callers would
+     * both wait for the pool to drain the jobs of each other
+     */
+    QMutexLocker locker(&m_batchLock);
+
+    QAtomicInt nextIndex(0);
+    const int numPoolJobs = qMin(m_compressionPool->maxThreadCount(), tiles.size() - 1);
 
-    m_memoryMetric += td->pixelSize();
+    for (int i = 0; i < numPoolJobs; i++) {
+        m_compressionPool->start(new SwapOutJob(this, tiles, &nextIndex));
+    }
+
+    SwapOutJob(this, tiles, &nextIndex).run();
+
+    m_compressionPool->waitForDone();
 }
 
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
-    QMutexLocker locker(&m_lock);
+
+    {
+        QMutexLocker locker(&m_lock);
+
+        if (m_mappedChunks.contains(td)) {
+            const MappedChunk chunk = m_mappedChunks.take(td);
+            locker.unlock();
+
+            swapInMappedTileData(td, chunk);
+            return;
+        }
+    }
 
     // see comment in swapOutTileData()
 
+    CompressionContext *context = acquireContext();
+
     KisChunk chunk = td->swapChunk();
+    const qint32 chunkSize = chunk.size();
 
     td->allocateMemory();
     td->setSwapChunk(KisChunk());
 
-    quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
-    m_compressor->decompressTileData(ptr, chunk.size(), td);
-    m_allocator->freeChunk(chunk);
+    if(context->buffer.size() < chunkSize)
+        context->buffer.resize(chunkSize);
 
-    m_memoryMetric -= td->pixelSize();
+    {
+        QMutexLocker locker(&m_lock);
+
+        /**
+         * The memory window may be remapped by another thread as soon
+         * as we release the lock, so copy the chunk out of it first
+         */
+        quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
+        memcpy(context->buffer.data(), ptr, chunkSize);
+        m_allocator->freeChunk(chunk);
+
+        m_memoryMetric -= td->pixelSize();
+
+        compactImpl(ONLINE_COMPACTION_STEP_SIZE);
+    }
+
+    context->compressor->decompressTileData((quint8*) context->buffer.data(), chunkSize, td);
+
+    releaseContext(context);
+}
+
+void KisSwappedDataStore::mapTileData(KisTileData *td, KisMappedFileSP file,
+                                      qint64 offset, qint32 size,
+                                      const QString &compressionId)
+{
+    Q_ASSERT(!td->data());
+
+    MappedChunk chunk;
+    chunk.file = file;
+    chunk.offset = offset;
+    chunk.size = size;
+    chunk.compressionId = compressionId;
+
+    QMutexLocker locker(&m_lock);
+    m_mappedChunks.insert(td, chunk);
+}
+
+void KisSwappedDataStore::swapInMappedTileData(KisTileData *td, const MappedChunk &chunk)
+{
+    td->allocateMemory();
+
+    /**
+     * The chunk may have been written with a backend different from
+     * the one used for swapping, so the shared contexts don't fit
+     */
+    KisTileCompressor2 compressor(chunk.compressionId);
+
+    /**
+     * The decompression only reads the buffer, so it is safe to
+     * pass the read-only mapping there
+     */
+    quint8 *buffer = const_cast<quint8*>(chunk.file->data(chunk.offset));
+
+    if (!compressor.decompressTileData(buffer, chunk.size, td)) {
+        warnTiles << "Failed to load a tile from" << chunk.file->fileName()
+                  << "at offset" << chunk.offset;
+
+        memset(td->data(), 0, td->pixelSize() * KisTileData::WIDTH * KisTileData::HEIGHT);
+    }
 }
 
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
+    if (m_mappedChunks.remove(td)) return;
+
     m_allocator->freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
 
     m_memoryMetric -= td->pixelSize();
+
+    compactImpl(ONLINE_COMPACTION_STEP_SIZE);
+}
+
+void KisSwappedDataStore::moveChunkData(const KisChunkData &from, const KisChunkData &to)
+{
+    /**
+     * The source and destination may overlap, and they are mapped
+     * through different windows, so copy via an intermediate buffer
+     */
+    if(m_moveBuffer.size() < (int)from.size())
+        m_moveBuffer.resize(from.size());
+
+    memcpy(m_moveBuffer.data(), m_swapSpace->getReadChunkPtr(from), from.size());
+    memcpy(m_swapSpace->getWriteChunkPtr(to), m_moveBuffer.data(), to.size());
+}
+
+void KisSwappedDataStore::compact()
+{
+    QMutexLocker locker(&m_lock);
+    compactImpl(COMPACTION_STEP_SIZE);
+}
+
+void KisSwappedDataStore::compactImpl(quint64 maxBytesToMove)
+{
+    if(m_allocator->fragmentation() < MAX_FRAGMENTATION ||
+       m_allocator->freeSize() < m_allocator->slabSize()) {
+
+        return;
+    }
+
+    using namespace std::placeholders;
+    m_allocator->compact(std::bind(&KisSwappedDataStore::moveChunkData, this, _1, _2),
+                         maxBytesToMove);
+
+    m_swapSpace->shrink(m_allocator->storeSize());
+}
+
+KisSwappedDataStore::SwapStatistics KisSwappedDataStore::swapStatistics()
+{
+    QMutexLocker locker(&m_lock);
+
+    SwapStatistics stats;
+    stats.fileSize = m_allocator->storeSize();
+    stats.usedSize = m_allocator->usedSize();
+    stats.freeSize = m_allocator->freeSize();
+    stats.fragmentation = m_allocator->fragmentation();
+
+    return stats;
 }
 
 qint64 KisSwappedDataStore::totalMemoryMetric() const
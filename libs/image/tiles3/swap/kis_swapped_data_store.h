@@ -23,12 +23,18 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QHash>
+#include <QVector>
 
+#include "tiles3/kis_lockless_stack.h"
+#include "kis_mapped_file.h"
 
 class QMutex;
+class QThreadPool;
 class KisTileData;
 class KisAbstractTileCompressor;
 class KisChunkAllocator;
+class KisChunkData;
 class KisMemoryWindow;
 
 class KRITAIMAGE_EXPORT KisSwappedDataStore
@@ -50,6 +56,16 @@ public:
      */
     void swapOutTileData(KisTileData *td);
 
+    /**
+     * Swap out a batch of tile data objects. The tiles are
+     * compressed in parallel by swapCompressionThreads() threads
+     * (see KisImageConfig), only the allocation of the chunks
+     * in the swap file is serialized.
+     * LOCKING: the locks on all the tile data objects should
+     *          be taken by the caller before making a call.
+     */
+    void swapOutTileData(const QVector<KisTileData*> &tiles);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -58,6 +74,17 @@ public:
      */
     void swapInTileData(KisTileData *td);
 
+    /**
+     * Marks \a td, which has no memory allocated, as swapped out
+     * to \a size bytes of a mapped \a file. The bytes must be the
+     * data of a tile record written by KisTileCompressor2 with
+     * \a compressionId backend. They are decompressed by
+     * swapInTileData() on the first access to the tile data.
+     */
+    void mapTileData(KisTileData *td, KisMappedFileSP file,
+                     qint64 offset, qint32 size,
+                     const QString &compressionId);
+
     /**
      * Forget all the information linked with the tile data.
      * This should be done before deleting of the tile data,
@@ -71,19 +98,91 @@ public:
      */
     qint64 totalMemoryMetric() const;
 
+    /**
+     * Slides the swapped out chunks to fill in the holes left by
+     * the tiles loaded back into memory and truncates the swap
+     * file. Does nothing while the fragmentation is low. Only a
+     * few megabytes are relocated per call, so the swapper calls
+     * it periodically. Swapping in and forgetting the tiles also
+     * do a small step of compaction when the swap gets fragmented.
+     */
+    void compact();
+
+    struct SwapStatistics {
+        qint64 fileSize;
+        qint64 usedSize;
+        qint64 freeSize;
+        qreal fragmentation;
+    };
+
+    SwapStatistics swapStatistics();
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
 private:
-    QByteArray m_buffer;
-    KisAbstractTileCompressor *m_compressor;
+    static const qreal MAX_FRAGMENTATION;
+    static const quint64 COMPACTION_STEP_SIZE;
+    static const quint64 ONLINE_COMPACTION_STEP_SIZE;
+
+    class SwapOutJob;
+
+    /**
+     * Each of the threads compressing or decompressing the data
+     * needs its own compressor and buffer, because the compressors
+     * keep the intermediate results in their internal buffers.
+     */
+    struct CompressionContext {
+        CompressionContext(KisAbstractTileCompressor *_compressor)
+            : compressor(_compressor) {}
+
+        KisAbstractTileCompressor *compressor;
+        QByteArray buffer;
+    };
+
+    struct MappedChunk {
+        KisMappedFileSP file;
+        qint64 offset;
+        qint32 size;
+        QString compressionId;
+    };
+
+    void swapInMappedTileData(KisTileData *td, const MappedChunk &chunk);
+
+    void moveChunkData(const KisChunkData &from, const KisChunkData &to);
+
+    /**
+     * LOCKING: m_lock should be taken by the caller
+     */
+    void compactImpl(quint64 maxBytesToMove);
+
+    CompressionContext* acquireContext();
+    void releaseContext(CompressionContext *context);
+
+private:
+    QString m_compressionId;
+    KisLocklessStack<CompressionContext*> m_freeContexts;
+
+    QThreadPool *m_compressionPool;
+    QMutex m_batchLock;
 
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
+    /**
+     * Guards the chunk allocator and the memory window only,
+     * no compression should happen while holding it
+     */
     QMutex m_lock;
+    QByteArray m_moveBuffer;
+
+    /**
+     * The tile data that have never been loaded from the mapped
+     * files. They have no chunk in the swap file. Guarded by m_lock.
+     */
+    QHash<KisTileData*, MappedChunk> m_mappedChunks;
 
     qint64 m_memoryMetric;
 };
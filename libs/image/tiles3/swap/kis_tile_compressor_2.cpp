@@ -17,17 +17,24 @@
  */
 
 #include "kis_tile_compressor_2.h"
-#include "kis_lzf_compression.h"
+#include "kis_compression_registry.h"
+#include "kis_abstract_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(const QString &compressionId)
+    : m_compression(0)
 {
-    m_compression = new KisLzfCompression();
+    if (compressionId.isEmpty() || !switchCompression(compressionId)) {
+        if (!compressionId.isEmpty()) {
+            warnTiles << "Unknown tile compression" << compressionId
+                      << "falling back to" << KisCompressionRegistry::fallbackId();
+        }
+
+        switchCompression(KisCompressionRegistry::fallbackId());
+    }
 }
 
 KisTileCompressor2::~KisTileCompressor2()
@@ -75,7 +82,18 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        /**
+         * The tiles in one stream are usually compressed with the same
+         * backend, so the compression object is recreated only once
+         */
+        if (compressionName != m_compressionName &&
+            !switchCompression(compressionName)) {
+
+            warnFile << "Failed to load a tile: unknown compression" << compressionName;
+            stream->read(dataSize);
+            return false;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -92,6 +110,75 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
     return false;
 }
 
+bool KisTileCompressor2::readTileHeader(QIODevice *stream, KisTiledDataManager *dm, TileHeader &header)
+{
+    QByteArray line = stream->readLine(maxHeaderLength());
+
+    QList<QByteArray> headerItems = line.trimmed().split(',');
+    if (headerItems.size() == 4) {
+        qint32 x = headerItems.takeFirst().toInt();
+        qint32 y = headerItems.takeFirst().toInt();
+        header.compressionName = headerItems.takeFirst();
+        header.dataSize = headerItems.takeFirst().toInt();
+
+        Q_ASSERT(headerItems.isEmpty());
+
+        header.row = yToRow(dm, y);
+        header.col = xToCol(dm, x);
+        return true;
+    }
+    return false;
+}
+
+bool KisTileCompressor2::readTileRecord(QIODevice *stream, KisTiledDataManager *dm, TileRecord &record)
+{
+    TileHeader header;
+    if (!readTileHeader(stream, dm, header)) return false;
+
+    record.compressionName = header.compressionName;
+    record.data = stream->read(header.dataSize);
+    if (record.data.size() != header.dataSize) return false;
+
+    record.tile = dm->getTile(header.col, header.row, true);
+    return true;
+}
+
+bool KisTileCompressor2::checkTileDataSize(const quint8 *data, qint32 dataSize, qint32 pixelSize)
+{
+    if (dataSize <= 0) return false;
+
+    if (data[0] == RAW_DATA_FLAG && dataSize < TILE_DATA_SIZE(pixelSize) + 1) {
+        warnFile << "Failed to load a tile: the raw data is truncated";
+        return false;
+    }
+
+    return true;
+}
+
+bool KisTileCompressor2::decompressTileRecord(TileRecord &record)
+{
+    if (!record.tile ||
+        !checkTileDataSize((const quint8*)record.data.constData(),
+                           record.data.size(), record.tile->pixelSize())) {
+
+        return false;
+    }
+
+    if (record.compressionName != m_compressionName &&
+        !switchCompression(record.compressionName)) {
+
+        warnFile << "Failed to load a tile: unknown compression" << record.compressionName;
+        return false;
+    }
+
+    record.tile->lockForWrite();
+    bool res = decompressTileData((quint8*)record.data.data(), record.data.size(),
+                                  record.tile->tileData());
+    record.tile->unlock();
+
+    return res;
+}
+
 void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
 {
     /**
@@ -101,6 +188,20 @@ void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
     m_streamingBuffer.resize(tileDataSize + 1);
 }
 
+bool KisTileCompressor2::switchCompression(const QString &compressionId)
+{
+    KisAbstractCompression *compression =
+        KisCompressionRegistry::instance()->create(compressionId);
+
+    if (!compression) return false;
+
+    delete m_compression;
+    m_compression = compression;
+    m_compressionName = compressionId;
+
+    return true;
+}
+
 void KisTileCompressor2::prepareWorkBuffers(qint32 tileDataSize)
 {
     const qint32 bufferSize = m_compression->outputBufferSize(tileDataSize);
@@ -129,7 +230,7 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
         buffer[0] = COMPRESSED_DATA_FLAG;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
@@ -178,7 +279,11 @@ qint32 KisTileCompressor2::tileDataBufferSize(KisTileData *tileData)
 inline qint32 KisTileCompressor2::maxHeaderLength()
 {
     static const qint32 QINT32_LENGTH = 11;
-    static const qint32 COMPRESSION_NAME_LENGTH = 5;
+    /**
+     * The original LZF-only implementation reserved 5 characters here,
+     * the ids of the newer backends may be a bit longer
+     */
+    static const qint32 COMPRESSION_NAME_LENGTH = 16;
     static const qint32 SEPARATORS_LENGTH = 4;
 
     return 3 * QINT32_LENGTH + COMPRESSION_NAME_LENGTH + SEPARATORS_LENGTH;
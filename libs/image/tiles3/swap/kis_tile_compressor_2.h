@@ -23,15 +23,67 @@
 
 class KisAbstractCompression;
 
+/**
+ * Compresses tiles using one of the backends registered in
+ * KisCompressionRegistry. The id of the backend is stored in the
+ * header of every tile written into a file, so the tiles saved with
+ * any backend (including the tiles written by the older versions,
+ * which always used LZF) are read back correctly.
+ *
+ * The swap data is not kept between the sessions, so the swapper just
+ * uses the same backend for the whole lifetime of the compressor.
+ */
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    /**
+     * \param compressionId the id of the backend in KisCompressionRegistry.
+     * If the id is empty or unknown, LZF compression is used.
+     */
+    KisTileCompressor2(const QString &compressionId = QString());
     virtual ~KisTileCompressor2();
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store);
     bool readTile(QIODevice *io, KisTiledDataManager *dm);
 
+    /**
+     * A tile read from a stream, but not decompressed yet
+     */
+    struct TileRecord {
+        KisTileSP tile;
+        QString compressionName;
+        QByteArray data;
+    };
+
+    /**
+     * Splits readTile() into two steps: readTileRecord() only reads
+     * the header and the compressed data from the stream, and
+     * decompressTileRecord() unpacks the data into the tile. The
+     * records of one stream can be decompressed in parallel, each
+     * thread using its own compressor.
+     */
+    bool readTileRecord(QIODevice *stream, KisTiledDataManager *dm, TileRecord &record);
+    bool decompressTileRecord(TileRecord &record);
+
+    struct TileHeader {
+        qint32 col;
+        qint32 row;
+        QString compressionName;
+        qint32 dataSize;
+    };
+
+    /**
+     * Reads the header of a tile record only, the stream is left
+     * at the beginning of the data of the record
+     */
+    bool readTileHeader(QIODevice *stream, KisTiledDataManager *dm, TileHeader &header);
+
+    /**
+     * Checks that \p dataSize bytes of \p data are enough for
+     * decompressTileData() to read a tile of \p pixelSize
+     */
+    static bool checkTileDataSize(const quint8 *data, qint32 dataSize, qint32 pixelSize);
+
 
     void compressTileData(KisTileData *tileData,quint8 *buffer,
                           qint32 bufferSize, qint32 &bytesWritten);
@@ -49,6 +101,8 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    bool switchCompression(const QString &compressionId);
+
 private:
     static const qint8 RAW_DATA_FLAG = 0;
     static const qint8 COMPRESSED_DATA_FLAG = 1;
@@ -58,7 +112,7 @@ private:
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    QString m_compressionName;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
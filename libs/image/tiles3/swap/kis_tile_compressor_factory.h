@@ -25,13 +25,20 @@
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
-    static KisAbstractTileCompressorSP create(qint32 version) {
+    /**
+     * \param compressionId the backend used for compression of the
+     *        tiles (see KisCompressionRegistry). It affects writing
+     *        only, the tiles are read with the backend written into
+     *        their headers. Ignored by the legacy compressor.
+     */
+    static KisAbstractTileCompressorSP create(qint32 version,
+                                              const QString &compressionId = QString()) {
         switch(version) {
         case 1:
             return new KisLegacyTileCompressor();
             break;
         case 2:
-            return new KisTileCompressor2();
+            return new KisTileCompressor2(compressionId);
             break;
         default:
             qFatal("Unknown version of the tiles");
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tile_data_prefetcher.h"
+
+#include <QSemaphore>
+
+#include "tiles3/kis_tile.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/kis_lockless_stack.h"
+#include "tiles3/swap/kis_tile_data_swapper_p.h"
+
+/**
+ * 4096 tiles of an 8-bit RGBA image are 64 MiB of data. That is more
+ * than enough to cover a couple of viewports or a big stroke update.
+ */
+const qint32 KisTileDataPrefetcher::MAX_QUEUE_LENGTH = 4096;
+
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+    QSemaphore semaphore;
+    QAtomicInt shouldExitFlag;
+    KisTileDataStore *store;
+    KisStoreLimits limits;
+    KisLocklessStack<KisTileSP> queue;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->shouldExitFlag = 0;
+    m_d->store = store;
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    dropPendingRequests();
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::prefetch(const KisTileSP &tile)
+{
+    if (m_d->shouldExitFlag) return;
+    if (m_d->queue.size() >= MAX_QUEUE_LENGTH) return;
+
+    m_d->queue.push(tile);
+    m_d->semaphore.release();
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    unsigned long exitTimeout = 100;
+    do {
+        m_d->shouldExitFlag = true;
+        m_d->semaphore.release();
+    } while(!wait(exitTimeout));
+
+    dropPendingRequests();
+}
+
+void KisTileDataPrefetcher::testingRereadConfig()
+{
+    m_d->limits = KisStoreLimits();
+}
+
+bool KisTileDataPrefetcher::canLoadMoreTiles() const
+{
+    return m_d->store->memoryMetric() < m_d->limits.hardLimit();
+}
+
+void KisTileDataPrefetcher::dropPendingRequests()
+{
+    KisTileSP tile;
+    while (m_d->queue.pop(tile)) {
+        tile = 0;
+    }
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        m_d->semaphore.acquire();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        KisTileSP tile;
+        if (!m_d->queue.pop(tile)) continue;
+
+        /**
+         * The queue is a stack, so the most recent requests are
+         * served first. They are the most relevant ones, because
+         * the user has most probably already scrolled away from
+         * the older areas.
+         */
+        if (!canLoadMoreTiles()) {
+            continue;
+        }
+
+        /**
+         * Locking the tile forces its data to be loaded from the
+         * swap and resets its age, so the swapper will not
+         * push it back immediately.
+         */
+        tile->lockForRead();
+        tile->unlock();
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_TILE_DATA_PREFETCHER_H
+#define __KIS_TILE_DATA_PREFETCHER_H
+
+#include <QObject>
+#include <QThread>
+
+#include <kis_shared_ptr.h>
+#include "kritaimage_export.h"
+
+class KisTileDataStore;
+class KisTile;
+typedef KisSharedPtr<KisTile> KisTileSP;
+
+
+/**
+ * A background thread that loads swapped out tiles back into memory
+ * before anyone actually needs them. The scheduler and the canvas
+ * know in advance which areas of the image are going to be read, so
+ * they can queue the tiles of these areas here and the painting
+ * threads will not stall in KisTileDataStore::ensureTileDataLoaded().
+ *
+ * The prefetcher is just a hint: it never loads anything when the
+ * store is already close to the hard memory limit, otherwise it would
+ * fight with the swapper for the same memory.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    virtual ~KisTileDataPrefetcher();
+
+    /**
+     * Queues \p tile for loading. The tile is kept alive until
+     * the prefetcher processes it. If the queue is already full,
+     * the request is silently dropped.
+     */
+    void prefetch(const KisTileSP &tile);
+
+    void terminatePrefetcher();
+
+    void testingRereadConfig();
+
+private:
+    void run();
+
+    bool canLoadMoreTiles() const;
+    void dropPendingRequests();
+
+private:
+    static const qint32 MAX_QUEUE_LENGTH;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* __KIS_TILE_DATA_PREFETCHER_H */
@@ -29,6 +29,7 @@
 
 const qint32 KisTileDataSwapper::TIMEOUT = -1;
 const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
+const qint32 KisTileDataSwapper::BATCH_SIZE = 64;
 
 //#define DEBUG_SWAPPER
 
@@ -97,6 +98,7 @@ void KisTileDataSwapper::run()
         QThread::msleep(DELAY);
 
         doJob();
+        m_d->store->compactSwap();
     }
 }
 
@@ -197,6 +199,8 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 {
     qint64 freedMetric = 0;
     QList<KisTileData*> additionalCandidates;
+    QVector<KisTileData*> batch;
+    batch.reserve(BATCH_SIZE);
 
     typename strategy::iterator *iter =
         strategy::beginIteration(m_d->store);
@@ -212,8 +216,9 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
         if(!strategy::isInteresting(item)) continue;
 
         if(strategy::swapOutFirst(item)) {
-            if(iter->trySwapOut(item)) {
+            if(iter->tryBeginSwapOut(item)) {
                 freedMetric += item->pixelSize();
+                addToBatch(batch, item);
             }
         }
         else {
@@ -226,16 +231,36 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     Q_FOREACH (item, additionalCandidates) {
         if(freedMetric >= needToFreeMetric) break;
 
-        if(iter->trySwapOut(item)) {
+        if(iter->tryBeginSwapOut(item)) {
             freedMetric += item->pixelSize();
+            addToBatch(batch, item);
         }
     }
 
+    flushBatch(batch);
+
     strategy::endIteration(m_d->store, iter);
 
     return freedMetric;
 }
 
+void KisTileDataSwapper::addToBatch(QVector<KisTileData*> &batch, KisTileData *td)
+{
+    batch.append(td);
+
+    if(batch.size() >= BATCH_SIZE) {
+        flushBatch(batch);
+    }
+}
+
+void KisTileDataSwapper::flushBatch(QVector<KisTileData*> &batch)
+{
+    if(batch.isEmpty()) return;
+
+    m_d->store->finishSwapOut(batch);
+    batch.clear();
+}
+
 void KisTileDataSwapper::testingRereadConfig()
 {
     m_d->limits = KisStoreLimits();
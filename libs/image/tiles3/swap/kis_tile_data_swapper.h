@@ -20,6 +20,7 @@
 
 #include <QObject>
 #include <QThread>
+#include <QVector>
 
 #include "kritaimage_export.h"
 
@@ -49,10 +50,19 @@ private:
     void doJob();
     template<class strategy> qint64 pass(qint64 needToFreeMetric);
 
+    void addToBatch(QVector<KisTileData*> &batch, KisTileData *td);
+    void flushBatch(QVector<KisTileData*> &batch);
+
 private:
     static const qint32 TIMEOUT;
     static const qint32 DELAY;
 
+    /**
+     * The number of tiles collected before the swapper asks
+     * the swapped data store to compress them in parallel
+     */
+    static const qint32 BATCH_SIZE;
+
 private:
     struct Private;
     Private * const m_d;
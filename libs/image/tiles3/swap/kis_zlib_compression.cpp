@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_zlib_compression.h"
+
+#include <QByteArray>
+#include "kis_debug.h"
+
+
+KisZlibCompression::KisZlibCompression(int level)
+    : m_level(level)
+{
+}
+
+KisZlibCompression::~KisZlibCompression()
+{
+}
+
+qint32 KisZlibCompression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    const QByteArray result = qCompress(input, inputLength, m_level);
+
+    if (result.isEmpty() || result.size() > outputLength) {
+        warnTiles << "KisZlibCompression: the output buffer is too small" << ppVar(result.size()) << ppVar(outputLength);
+        return 0;
+    }
+
+    memcpy(output, result.constData(), result.size());
+    return result.size();
+}
+
+qint32 KisZlibCompression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    const QByteArray result = qUncompress(input, inputLength);
+
+    if (result.isEmpty() || result.size() > outputLength) {
+        return 0;
+    }
+
+    memcpy(output, result.constData(), result.size());
+    return result.size();
+}
+
+qint32 KisZlibCompression::outputBufferSize(qint32 dataSize)
+{
+    /**
+     * The bound reported by zlib's compressBound() plus
+     * four bytes of the size prefix added by qCompress()
+     */
+    return dataSize + (dataSize >> 12) + (dataSize >> 14) + (dataSize >> 25) + 13 + 4;
+}
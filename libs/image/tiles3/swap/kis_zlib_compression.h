@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_ZLIB_COMPRESSION_H
+#define __KIS_ZLIB_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+/**
+ * Deflate compression provided by the zlib bundled into QtCore.
+ * It is several times slower than LZF, but gives much better
+ * ratio, so it is supposed to be used for saving the tiles into
+ * a file rather than for swapping.
+ */
+class KRITAIMAGE_EXPORT KisZlibCompression : public KisAbstractCompression
+{
+public:
+    /**
+     * \param level zlib compression level (0-9), -1 for the zlib's default
+     */
+    KisZlibCompression(int level = -1);
+    virtual ~KisZlibCompression();
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength);
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength);
+
+    qint32 outputBufferSize(qint32 dataSize);
+
+private:
+    int m_level;
+};
+
+#endif /* __KIS_ZLIB_COMPRESSION_H */
@@ -39,9 +39,183 @@ void KisChunkAllocatorTest::testOperations()
 
     allocator.debugChunks();
     allocator.sanityCheck();
-    QVERIFY(qFuzzyCompare(allocator.debugFragmentation(), 1./6));
+    /**
+     * The freed gap fits the new chunk exactly, so it is reused
+     */
+    QCOMPARE(chunk3.begin(), quint64(25));
+    QCOMPARE(allocator.debugFragmentation(), 0.0);
+}
+
+void KisChunkAllocatorTest::testSizeClasses()
+{
+    KisChunkAllocator allocator;
+
+    KisChunk small = allocator.getChunk(100);
+    allocator.getChunk(100);
+    KisChunk big = allocator.getChunk(3000);
+    allocator.getChunk(100);
+
+    allocator.freeChunk(small);
+    allocator.freeChunk(big);
+    QCOMPARE(allocator.freeSize(), quint64(3100));
+
+    // doesn't fit into the first gap, but fits the second one
+    KisChunk chunk = allocator.getChunk(1000);
+    QCOMPARE(chunk.begin(), quint64(200));
+
+    // fits both, the first one is smaller
+    chunk = allocator.getChunk(50);
+    QCOMPARE(chunk.begin(), quint64(0));
+
+    QCOMPARE(allocator.freeSize(), quint64(2050));
+    allocator.sanityCheck();
 }
 
+void KisChunkAllocatorTest::testCompaction()
+{
+    const quint64 slabSize = 4096;
+    KisChunkAllocator allocator(slabSize, 1024 * slabSize);
+
+    QList<KisChunk> chunks;
+    for (int i = 0; i < 200; i++) {
+        chunks.append(allocator.getChunk(50 + i % 7 * 30));
+    }
+
+    QByteArray store(allocator.storeSize(), 0);
+    for (int i = 0; i < chunks.size(); i++) {
+        memset(store.data() + chunks[i].begin(), i, chunks[i].size());
+    }
+
+    QList<KisChunk> survivors;
+    QList<int> survivorColors;
+    for (int i = 0; i < chunks.size(); i++) {
+        if (i % 3) {
+            allocator.freeChunk(chunks[i]);
+        } else {
+            survivors.append(chunks[i]);
+            survivorColors.append(i);
+        }
+    }
+
+    const quint64 oldStoreSize = allocator.storeSize();
+    QVERIFY(allocator.fragmentation() > 0.5);
+
+    quint64 numSteps = 0;
+    auto moveFunc = [&store] (const KisChunkData &from, const KisChunkData &to) {
+        QCOMPARE(from.size(), to.size());
+        QVERIFY(to.m_begin < from.m_begin);
+        memmove(store.data() + to.m_begin, store.data() + from.m_begin, from.size());
+    };
+
+    while (!allocator.compact(moveFunc, 1024)) {
+        numSteps++;
+        allocator.sanityCheck();
+    }
+
+    QVERIFY(numSteps > 0);
+    QCOMPARE(allocator.freeSize(), quint64(0));
+    QCOMPARE(allocator.fragmentation(), 0.0);
+    QVERIFY(allocator.storeSize() < oldStoreSize);
+    QVERIFY(allocator.storeSize() >= allocator.usedSize());
+
+    quint64 expectedBegin = 0;
+    for (int i = 0; i < survivors.size(); i++) {
+        const KisChunk &chunk = survivors[i];
+        QCOMPARE(chunk.begin(), expectedBegin);
+
+        for (quint64 j = chunk.begin(); j <= chunk.end(); j++) {
+            QCOMPARE(int(quint8(store.at(int(j)))), survivorColors[i]);
+        }
+
+        expectedBegin = chunk.end() + 1;
+    }
+
+    allocator.sanityCheck();
+}
+
+
+void KisChunkAllocatorTest::testIncrementalCompaction()
+{
+    const quint64 slabSize = 4096;
+    KisChunkAllocator allocator(slabSize, 1024 * slabSize);
+
+    QList<KisChunk> chunks;
+    for (int i = 0; i < 300; i++) {
+        chunks.append(allocator.getChunk(50 + i % 5 * 40));
+    }
+
+    QByteArray store(allocator.storeSize(), 0);
+    auto fillChunk = [&store] (const KisChunk &chunk, int color) {
+        if (store.size() <= int(chunk.end())) {
+            store.resize(chunk.end() + 1);
+        }
+        memset(store.data() + chunk.begin(), color, chunk.size());
+    };
+
+    QList<KisChunk> survivors;
+    QList<int> survivorColors;
+    for (int i = 0; i < chunks.size(); i++) {
+        if (i % 2) {
+            allocator.freeChunk(chunks[i]);
+        } else {
+            fillChunk(chunks[i], i % 256);
+            survivors.append(chunks[i]);
+            survivorColors.append(i % 256);
+        }
+    }
+
+    quint64 lowestMovedPosition = 0;
+    bool cursorReset = false;
+    auto moveFunc = [&] (const KisChunkData &from, const KisChunkData &to) {
+        /**
+         * Unless a gap has been created before the place where the
+         * previous step stopped, the next step doesn't go back
+         */
+        if (!cursorReset) {
+            QVERIFY(from.m_begin >= lowestMovedPosition);
+        }
+        lowestMovedPosition = from.m_begin;
+        memmove(store.data() + to.m_begin, store.data() + from.m_begin, from.size());
+    };
+
+    int step = 0;
+    while (!allocator.compact(moveFunc, 512)) {
+        cursorReset = false;
+        allocator.sanityCheck();
+
+        /**
+         * Every few steps free a chunk at the beginning of the store
+         * and allocate a new one, like the swap does in the meantime
+         */
+        if (++step % 4 == 0 && survivors.size() > 10) {
+            allocator.freeChunk(survivors.takeFirst());
+            survivorColors.takeFirst();
+            cursorReset = true;
+            lowestMovedPosition = 0;
+
+            KisChunk chunk = allocator.getChunk(70);
+            fillChunk(chunk, 255 - step % 256);
+            survivors.append(chunk);
+            survivorColors.append(255 - step % 256);
+        }
+    }
+
+    QCOMPARE(allocator.freeSize(), quint64(0));
+
+    quint64 totalSize = 0;
+    for (int i = 0; i < survivors.size(); i++) {
+        const KisChunk &chunk = survivors[i];
+        totalSize += chunk.size();
+
+        for (quint64 j = chunk.begin(); j <= chunk.end(); j++) {
+            QCOMPARE(int(quint8(store.at(int(j)))), survivorColors[i]);
+        }
+    }
+
+    QCOMPARE(allocator.usedSize(), totalSize);
+
+    allocator.sanityCheck();
+}
 
 #define NUM_TRANSACTIONS 30
 #define NUM_CHUNKS_ALLOC 15000
@@ -31,6 +31,9 @@ qreal measureFragmentation(qint32 transactions, qint32 chunksAlloc,
 
 private Q_SLOTS:
     void testOperations();
+    void testSizeClasses();
+    void testCompaction();
+    void testIncrementalCompaction();
     void testFragmentation();
 };
 
@@ -23,6 +23,8 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_zlib_compression.h"
+#include "tiles3/swap/kis_compression_registry.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -261,6 +263,86 @@ void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
     benchmarkDecompressionTwoPass(compression);
     delete compression;
 }
+void KisCompressionTests::testZlibRoundTrip()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+
+    delete compression;
+}
+
+void KisCompressionTests::testZlibOverflow()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+    testOverflow(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkCompressionZlib()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionZlib()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+    benchmarkDecompressionTwoPass(compression);
+    delete compression;
+}
+
+/**
+ * LZ4 is an optional dependency, so we access it via the registry
+ */
+
+void KisCompressionTests::testLz4RoundTrip()
+{
+    KisAbstractCompression *compression = KisCompressionRegistry::instance()->create("LZ4");
+    if (!compression) {
+        QSKIP("Krita is built without LZ4 support");
+    }
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+
+    delete compression;
+}
+
+void KisCompressionTests::testLz4Overflow()
+{
+    KisAbstractCompression *compression = KisCompressionRegistry::instance()->create("LZ4");
+    if (!compression) {
+        QSKIP("Krita is built without LZ4 support");
+    }
+
+    testOverflow(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkCompressionLz4()
+{
+    KisAbstractCompression *compression = KisCompressionRegistry::instance()->create("LZ4");
+    if (!compression) {
+        QSKIP("Krita is built without LZ4 support");
+    }
+
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionLz4()
+{
+    KisAbstractCompression *compression = KisCompressionRegistry::instance()->create("LZ4");
+    if (!compression) {
+        QSKIP("Krita is built without LZ4 support");
+    }
+
+    benchmarkDecompressionTwoPass(compression);
+    delete compression;
+}
 
 QTEST_MAIN(KisCompressionTests)
 
@@ -48,6 +48,16 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void testZlibRoundTrip();
+    void testZlibOverflow();
+    void benchmarkCompressionZlib();
+    void benchmarkDecompressionZlib();
+
+    void testLz4RoundTrip();
+    void testLz4Overflow();
+    void benchmarkCompressionLz4();
+    void benchmarkDecompressionLz4();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
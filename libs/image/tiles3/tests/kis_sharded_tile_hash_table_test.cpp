@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_sharded_tile_hash_table_test.h"
+#include <QTest>
+
+#include <QThreadPool>
+#include <QRunnable>
+
+#include "tiles3/kis_tile.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/kis_sharded_tile_hash_table.h"
+
+typedef KisShardedTileHashTableTraits<KisTile> KisShardedTileHashTable;
+typedef KisShardedTileHashTableIteratorTraits<KisTile> KisShardedTileHashTableIterator;
+
+#define NUM_THREADS 16
+#define NUM_CYCLES 20000
+#define TILES_SIDE 40
+
+void initTable(KisShardedTileHashTable &table)
+{
+    quint8 defaultPixel = 0;
+    KisTileData *td = KisTileDataStore::instance()->createDefaultTileData(1, &defaultPixel);
+    table.setDefaultTileData(td);
+}
+
+qint32 countTiles(KisShardedTileHashTable &table)
+{
+    qint32 count = 0;
+
+    KisShardedTileHashTableIterator iter(&table);
+    while (!iter.isDone()) {
+        count++;
+        ++iter;
+    }
+
+    return count;
+}
+
+void KisShardedTileHashTableTest::testOperations()
+{
+    KisShardedTileHashTable table(0);
+    initTable(table);
+
+    QVERIFY(table.isEmpty());
+
+    bool newTile = false;
+    KisTileSP tile = table.getTileLazy(3, 5, newTile);
+    QVERIFY(newTile);
+    QCOMPARE(tile->col(), 3);
+    QCOMPARE(tile->row(), 5);
+
+    KisTileSP sameTile = table.getTileLazy(3, 5, newTile);
+    QVERIFY(!newTile);
+    QCOMPARE(sameTile.data(), tile.data());
+
+    /**
+     * (35, 5) lands into the same bucket as (3, 5)
+     */
+    table.getTileLazy(35, 5, newTile);
+    QVERIFY(newTile);
+
+    QCOMPARE(table.numTiles(), 2);
+    QVERIFY(table.tileExists(3, 5));
+    QVERIFY(table.tileExists(35, 5));
+    QVERIFY(!table.tileExists(4, 5));
+    QVERIFY(!table.getExistedTile(4, 5));
+
+    KisTileSP readOnlyTile = table.getReadOnlyTileLazy(4, 5);
+    QVERIFY(readOnlyTile);
+    QCOMPARE(readOnlyTile->tileData(), table.defaultTileData());
+    QVERIFY(!table.tileExists(4, 5));
+
+    table.deleteTile(3, 5);
+    QVERIFY(!table.tileExists(3, 5));
+    QVERIFY(table.tileExists(35, 5));
+    QCOMPARE(table.numTiles(), 1);
+
+    table.clear();
+    QVERIFY(table.isEmpty());
+    QCOMPARE(countTiles(table), 0);
+}
+
+void KisShardedTileHashTableTest::testIteratorDelete()
+{
+    KisShardedTileHashTable table(0);
+    initTable(table);
+
+    bool newTile = false;
+    for (qint32 row = 0; row < TILES_SIDE; row++) {
+        for (qint32 col = 0; col < TILES_SIDE; col++) {
+            table.getTileLazy(col, row, newTile);
+        }
+    }
+
+    QCOMPARE(table.numTiles(), TILES_SIDE * TILES_SIDE);
+    QCOMPARE(countTiles(table), TILES_SIDE * TILES_SIDE);
+
+    {
+        KisShardedTileHashTableIterator iter(&table);
+        while (!iter.isDone()) {
+            KisTileSP tile = iter.tile();
+
+            if ((tile->col() + tile->row()) % 2) {
+                iter.deleteCurrent();
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    QCOMPARE(table.numTiles(), TILES_SIDE * TILES_SIDE / 2);
+    QCOMPARE(countTiles(table), TILES_SIDE * TILES_SIDE / 2);
+
+    QVERIFY(table.tileExists(0, 0));
+    QVERIFY(!table.tileExists(1, 0));
+
+    KisShardedTileHashTable otherTable(0);
+    initTable(otherTable);
+
+    {
+        KisShardedTileHashTableIterator iter(&table);
+        while (!iter.isDone()) {
+            iter.moveCurrentToHashTable(&otherTable);
+        }
+    }
+
+    QVERIFY(table.isEmpty());
+    QCOMPARE(otherTable.numTiles(), TILES_SIDE * TILES_SIDE / 2);
+    QCOMPARE(countTiles(otherTable), TILES_SIDE * TILES_SIDE / 2);
+}
+
+void KisShardedTileHashTableTest::testCopy()
+{
+    KisShardedTileHashTable table(0);
+    initTable(table);
+
+    bool newTile = false;
+    for (qint32 row = 0; row < TILES_SIDE; row++) {
+        for (qint32 col = 0; col < TILES_SIDE; col++) {
+            table.getTileLazy(col, row, newTile);
+        }
+    }
+
+    KisShardedTileHashTable copy(table, 0);
+
+    QCOMPARE(copy.numTiles(), table.numTiles());
+    QCOMPARE(countTiles(copy), table.numTiles());
+    QCOMPARE(copy.defaultTileData(), table.defaultTileData());
+
+    for (qint32 row = 0; row < TILES_SIDE; row++) {
+        for (qint32 col = 0; col < TILES_SIDE; col++) {
+            KisTileSP srcTile = table.getExistedTile(col, row);
+            KisTileSP dstTile = copy.getExistedTile(col, row);
+
+            QVERIFY(dstTile);
+            QVERIFY(dstTile.data() != srcTile.data());
+            QCOMPARE(dstTile->tileData(), srcTile->tileData());
+        }
+    }
+}
+
+class KisShardedTableStressJob : public QRunnable
+{
+public:
+    KisShardedTableStressJob(KisShardedTileHashTable &table, qint32 seed)
+        : m_table(table), m_seed(seed)
+    {
+    }
+
+    void run() {
+        bool newTile = false;
+
+        for (qint32 i = 0; i < NUM_CYCLES; i++) {
+            const qint32 value = m_seed + i * 7;
+            const qint32 col = value % TILES_SIDE;
+            const qint32 row = (value / TILES_SIDE) % TILES_SIDE;
+
+            switch (i % 4) {
+            case 0:
+            case 1:
+                m_table.getTileLazy(col, row, newTile);
+                break;
+            case 2:
+                m_table.getReadOnlyTileLazy(col, row);
+                break;
+            case 3:
+                m_table.deleteTile(col, row);
+                break;
+            }
+        }
+    }
+
+private:
+    KisShardedTileHashTable &m_table;
+    qint32 m_seed;
+};
+
+void KisShardedTileHashTableTest::stressTestConcurrentAccess()
+{
+    KisShardedTileHashTable table(0);
+    initTable(table);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(NUM_THREADS);
+
+    for (qint32 i = 0; i < NUM_THREADS; i++) {
+        pool.start(new KisShardedTableStressJob(table, i * 13));
+    }
+
+    pool.waitForDone();
+
+    QCOMPARE(countTiles(table), table.numTiles());
+
+    for (qint32 row = 0; row < TILES_SIDE; row++) {
+        for (qint32 col = 0; col < TILES_SIDE; col++) {
+            KisTileSP tile = table.getExistedTile(col, row);
+            if (tile) {
+                QCOMPARE(tile->col(), col);
+                QCOMPARE(tile->row(), row);
+            }
+        }
+    }
+}
+
+QTEST_MAIN(KisShardedTileHashTableTest)
@@ -131,5 +131,53 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testBatchRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 10000;
+    const qint32 BATCH_SIZE = 64;
+
+    KisImageConfig config;
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setSwapCompressionThreads(4);
+
+
+    KisSwappedDataStore store;
+
+    QVector<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+        tileDataList.append(td);
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i += BATCH_SIZE) {
+        // FIXME: take locks of the tile data
+        store.swapOutTileData(tileDataList.mid(i, BATCH_SIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+    store.debugStatistics();
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(0));
+
+    config.setSwapCompressionThreads(config.swapCompressionThreads(true));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
 QTEST_MAIN(KisSwappedDataStoreTest)
 
@@ -25,8 +25,13 @@
 
 #include "tiles_test_utils.h"
 
-void KisTileCompressorsTest::doRoundTrip(KisAbstractTileCompressor *compressor)
+void KisTileCompressorsTest::doRoundTrip(KisAbstractTileCompressor *compressor,
+                                         KisAbstractTileCompressor *readCompressor)
 {
+    if (!readCompressor) {
+        readCompressor = compressor;
+    }
+
     quint8 defaultPixel = 0;
     KisTiledDataManager dm(1, &defaultPixel);
 
@@ -53,7 +58,7 @@ void KisTileCompressorsTest::doRoundTrip(KisAbstractTileCompressor *compressor)
     QVERIFY(memoryIsFilled(defaultPixel, tile11->data(), TILESIZE));
     tile11 = 0;
 
-    bool res = compressor->readTile(fakeStore.device(), &dm);
+    bool res = readCompressor->readTile(fakeStore.device(), &dm);
     Q_ASSERT(res);
     Q_UNUSED(res);
     tile11 = dm.getTile(1, 1, false);
@@ -178,7 +183,41 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     doLowLevelRoundTripIncompressible(compressor);
     delete compressor;
 }
+void KisTileCompressorsTest::testRoundTripZlib()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2("ZLIB");
+    doRoundTrip(compressor);
+    delete compressor;
+}
 
+void KisTileCompressorsTest::testLowLevelRoundTripZlib()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2("ZLIB");
+    doLowLevelRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testReadForeignCompression()
+{
+    /**
+     * The reader should pick the backend from the tile header,
+     * whatever backend it was created with
+     */
+    KisAbstractTileCompressor *writer = new KisTileCompressor2("ZLIB");
+    KisAbstractTileCompressor *reader = new KisTileCompressor2();
+    doRoundTrip(writer, reader);
+    delete writer;
+    delete reader;
+}
+
+void KisTileCompressorsTest::testUnknownCompressionFallback()
+{
+    KisAbstractTileCompressor *writer = new KisTileCompressor2("NOSUCH");
+    KisAbstractTileCompressor *reader = new KisTileCompressor2("LZF");
+    doRoundTrip(writer, reader);
+    delete writer;
+    delete reader;
+}
 
 QTEST_MAIN(KisTileCompressorsTest)
 
@@ -181,5 +181,62 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testPrefetching()
+{
+    KisImageConfig config;
+    config.setMemoryHardLimitPercent(50);
+    config.setMemorySoftLimitPercent(25);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+    store->testingRereadConfig();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 numColumns = 16;
+
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->tileData()->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlock();
+    }
+
+    store->debugSwapAll();
+    QVERIFY(store->hasSwappedTiles());
+
+    QList<KisTileSP> tiles;
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        QVERIFY(!tile->tileData()->data());
+        tiles.append(tile);
+    }
+
+    dm.prefetchTiles(QRect(0, 0, numColumns * KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    bool allLoaded = false;
+    for (int i = 0; i < 500 && !allLoaded; i++) {
+        allLoaded = true;
+        Q_FOREACH (KisTileSP tile, tiles) {
+            allLoaded &= bool(tile->tileData()->data());
+        }
+
+        if (!allLoaded) {
+            QTest::qSleep(10);
+        }
+    }
+
+    QVERIFY(allLoaded);
+
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = tiles[col];
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->tileData()->data(), TILESIZE));
+        tile->unlock();
+    }
+}
+
 QTEST_MAIN(KisTileDataStoreTest)
 
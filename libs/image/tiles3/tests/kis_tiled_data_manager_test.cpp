@@ -20,6 +20,11 @@
 #include <QTest>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_mapped_file.h"
+
+#include <QTemporaryFile>
+#include "kis_paint_device_writer.h"
 
 #include "tiles_test_utils.h"
 
@@ -349,6 +354,121 @@ void KisTiledDataManagerTest::testBitBltRough()
     delete[] buffer;
 }
 
+void KisTiledDataManagerTest::testDeduplication()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->setDeduplicationEnabled(true);
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm1(1, &defaultPixel);
+    KisTiledDataManager dm2(1, &defaultPixel);
+
+    QByteArray buffer(TILESIZE, 0);
+    for (int i = 0; i < buffer.size(); i++) {
+        buffer[i] = i % 251;
+    }
+    const quint8 *bytes = reinterpret_cast<const quint8*>(buffer.constData());
+
+    KisMementoSP memento1 = dm1.getMemento();
+    dm1.writeBytes(bytes, 0, 0, 64, 64);
+    dm1.commit();
+
+    KisMementoSP memento2 = dm2.getMemento();
+    dm2.writeBytes(bytes, 64, 0, 64, 64);
+    dm2.commit();
+
+    KisTileSP tile1 = dm1.getTile(0, 0, false);
+    KisTileSP tile2 = dm2.getTile(1, 0, false);
+    QCOMPARE(tile1->tileData(), tile2->tileData());
+
+    // writing into the shared data should clone it
+    quint8 oddPixel = 255;
+    dm2.clear(64, 0, 1, 1, &oddPixel);
+
+    tile2 = dm2.getTile(1, 0, false);
+    QVERIFY(tile1->tileData() != tile2->tileData());
+    QVERIFY(!memcmp(tile1->data(), bytes, TILESIZE));
+    QCOMPARE(*tile2->data(), oddPixel);
+
+    // undo of the second device should not touch the first one
+    dm2.rollback(memento2);
+    QVERIFY(!memcmp(dm1.getTile(0, 0, false)->data(), bytes, TILESIZE));
+
+    tile1 = tile2 = 0;
+
+    KisTileDataStore::MemoryStatistics stats = store->memoryStatistics();
+    QVERIFY(stats.deduplicatedTiles > 0);
+    QVERIFY(stats.deduplicationInsertions > 0);
+    QVERIFY(stats.deduplicationRatio > 0.0);
+    QVERIFY(stats.deduplicationRatio < 1.0);
+    QCOMPARE(stats.deduplicationRatio,
+             qreal(stats.deduplicatedTiles) /
+             (stats.deduplicationChecks + stats.deduplicationInsertions));
+
+    store->setDeduplicationEnabled(false);
+}
+
+class KisFileTileWriter : public KisPaintDeviceWriter {
+public:
+    KisFileTileWriter(QIODevice *file)
+        : m_file(file)
+    {
+    }
+
+    bool write(const QByteArray &data) {
+        return (m_file->write(data) == data.size());
+    }
+
+    bool write(const char* data, qint64 length) {
+        return (m_file->write(data, length) == length);
+    }
+
+    QIODevice *m_file;
+};
+
+void KisTiledDataManagerTest::testMappedRead()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    QByteArray buffer(2 * TILESIZE, 0);
+    for (int i = 0; i < buffer.size(); i++) {
+        buffer[i] = i % 251;
+    }
+    const quint8 *bytes = reinterpret_cast<const quint8*>(buffer.constData());
+    srcDM.writeBytes(bytes, 0, 0, 128, 64);
+
+    // the stream doesn't start at the beginning of the file
+    const QByteArray prefix("some other entry");
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(prefix);
+    KisFileTileWriter writer(&file);
+    QVERIFY(srcDM.write(writer));
+    file.close();
+
+    KisMappedFileSP mappedFile = new KisMappedFile(file.fileName());
+    QVERIFY(mappedFile->isValid());
+
+    KisMappedFileDevice device(mappedFile, prefix.size(), mappedFile->size() - prefix.size());
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    KisTiledDataManager dstDM(1, &defaultPixel);
+    QVERIFY(dstDM.read(&device));
+
+    // nothing is decompressed until the tile is accessed
+    KisTileSP tile = dstDM.getTile(1, 0, false);
+    QVERIFY(!tile->tileData()->data());
+    tile = 0;
+
+    QCOMPARE(dstDM.extent(), QRect(0, 0, 128, 64));
+
+    QByteArray result(2 * TILESIZE, 0);
+    dstDM.readBytes(reinterpret_cast<quint8*>(result.data()), 0, 0, 128, 64);
+    QCOMPARE(result, buffer);
+}
+
 void KisTiledDataManagerTest::testTransactions()
 {
     quint8 defaultPixel = 0;
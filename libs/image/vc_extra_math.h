@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __VC_EXTRA_MATH_H
+#define __VC_EXTRA_MATH_H
+
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
+#if defined HAVE_VC
+
+/**
+ * The math functions Vc doesn't have
+ */
+class VcExtraMath
+{
+public:
+    /**
+     * Approximation of erf() from Abramowitz and Stegun, formula
+     * 7.1.26. The maximum error is 1.5e-7, which is much less than
+     * the precision of the 8-bit mask.
+     */
+    static inline Vc::float_v erf(Vc::float_v x) {
+        const Vc::float_v a1(0.254829592f);
+        const Vc::float_v a2(-0.284496736f);
+        const Vc::float_v a3(1.421413741f);
+        const Vc::float_v a4(-1.453152027f);
+        const Vc::float_v a5(1.061405429f);
+        const Vc::float_v p(0.3275911f);
+        const Vc::float_v vOne(1.0f);
+        const Vc::float_v vZero(0.0f);
+
+        Vc::float_m negative = x < vZero;
+        x = Vc::abs(x);
+
+        Vc::float_v t = vOne / (vOne + p * x);
+        Vc::float_v poly = ((((a5 * t + a4) * t + a3) * t + a2) * t + a1) * t;
+        Vc::float_v y = vOne - poly * Vc::exp(-x * x);
+
+        y(negative) = -y;
+        return y;
+    }
+};
+
+#endif /* defined HAVE_VC */
+
+#endif /* __VC_EXTRA_MATH_H */
@@ -22,6 +22,7 @@
 #include <QHash>
 #include <QList>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QThreadStorage>
 
 #include <KoColorSpace.h>
@@ -40,7 +41,8 @@ struct KoColorConversionCacheKey {
     }
 
     bool operator==(const KoColorConversionCacheKey& rhs) const {
-        return (*src == *(rhs.src)) && (*dst == *(rhs.dst))
+        return (src == rhs.src || *src == *(rhs.src))
+                && (dst == rhs.dst || *dst == *(rhs.dst))
                 && (renderingIntent == rhs.renderingIntent)
                 && (conversionFlags == rhs.conversionFlags);
     }
@@ -67,22 +69,81 @@ struct KoColorConversionCache::CachedTransformation {
     }
 
     bool available() {
-        return use == 0;
+        return use.load() == 0;
     }
 
     KoColorConversionTransformation* transfo;
-    int use;
+
+    /**
+     * The references are released by the per-thread caches without
+     * holding the cache mutex, so the counter should be atomic
+     */
+    QAtomicInt use;
 };
 
 typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
 
+/**
+ * The number of transformations every thread keeps for itself. It is
+ * enough for an image having layers in a few different color spaces.
+ */
+static const int FAST_PATH_CACHE_SIZE = 8;
+
+/**
+ * The recently used transformations of a single thread, the most recent
+ * one goes first. The items hold a reference to their transformations,
+ * so the transformations cannot be given to any other thread and the
+ * lookups need no locking.
+ */
+struct FastPathCache {
+    FastPathCache(int _generation)
+        : generation(_generation)
+    {
+    }
+
+    ~FastPathCache() {
+        qDeleteAll(items);
+    }
+
+    int generation;
+    QList<FastPathCacheItem*> items;
+};
+
 struct KoColorConversionCache::Private {
     QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
     QMutex cacheMutex;
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+    /**
+     * The transformations of the destroyed color spaces, which are still
+     * referenced by the fast path caches of some threads
+     */
+    QList<CachedTransformation*> orphans;
+
+    /**
+     * Incremented every time a color space is destroyed. The threads
+     * drop their fast path caches when they notice the change, so that
+     * they never compare the keys with the dangling color spaces.
+     */
+    QAtomicInt generation;
+
+    QThreadStorage<FastPathCache*> fastStorage;
+
+    void deleteAvailableOrphans();
 };
 
+void KoColorConversionCache::Private::deleteAvailableOrphans()
+{
+    QList<CachedTransformation*>::iterator it = orphans.begin();
+    while (it != orphans.end()) {
+        if ((*it)->available()) {
+            delete *it;
+            it = orphans.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 
 KoColorConversionCache::KoColorConversionCache() : d(new Private)
 {
@@ -90,9 +151,12 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
+    d->fastStorage.setLocalData(0);
+
     Q_FOREACH (CachedTransformation* transfo, d->cache) {
         delete transfo;
     }
+    qDeleteAll(d->orphans);
     delete d;
 }
 
@@ -103,56 +167,92 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
 {
     KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    const int generation = d->generation.load();
+    FastPathCache *fastCache = d->fastStorage.localData();
+
+    if (fastCache && fastCache->generation != generation) {
+        d->fastStorage.setLocalData(0);
+        fastCache = 0;
+
+        QMutexLocker lock(&d->cacheMutex);
+        d->deleteAvailableOrphans();
+    }
+
+    if (!fastCache) {
+        fastCache = new FastPathCache(generation);
+        d->fastStorage.setLocalData(fastCache);
+    }
+
+    for (int i = 0; i < fastCache->items.size(); i++) {
+        FastPathCacheItem *item = fastCache->items[i];
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
+        if (item->first == key) {
+            if (i > 0) {
+                fastCache->items.move(i, 0);
+            }
+            return item->second;
         }
     }
 
-    cacheItem = 0;
+    FastPathCacheItem *cacheItem = 0;
 
-    QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
-    if (cachedTransfos.size() != 0) {
-        Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            if (ct->available()) {
-                ct->transfo->setSrcColorSpace(src);
-                ct->transfo->setDstColorSpace(dst);
-
-                cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
-                break;
+    {
+        QMutexLocker lock(&d->cacheMutex);
+        QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
+        if (cachedTransfos.size() != 0) {
+            Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
+                if (ct->available()) {
+                    ct->transfo->setSrcColorSpace(src);
+                    ct->transfo->setDstColorSpace(dst);
+
+                    cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+                    break;
+                }
             }
         }
+        if (!cacheItem) {
+            KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
+            CachedTransformation* ct = new CachedTransformation(transfo);
+            d->cache.insert(key, ct);
+            cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+        }
     }
-    if (!cacheItem) {
-        KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
-        d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
+
+    fastCache->items.prepend(cacheItem);
+
+    if (fastCache->items.size() > FAST_PATH_CACHE_SIZE) {
+        delete fastCache->items.takeLast();
     }
 
-    d->fastStorage.setLocalData(cacheItem);
     return cacheItem->second;
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
+    d->generation.ref();
     d->fastStorage.setLocalData(0);
 
     QMutexLocker lock(&d->cacheMutex);
     QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
     for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
         if (it.key().src == cs || it.key().dst == cs) {
-            Q_ASSERT(it.value()->available()); // That's terribely evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
+            /**
+             * The transformation may still be referenced by the fast
+             * path cache of another thread. It will be deleted when
+             * that thread notices the new generation and releases it.
+             */
+            if (it.value()->available()) {
+                delete it.value();
+            } else {
+                d->orphans.append(it.value());
+            }
             it = d->cache.erase(it);
         } else {
             ++it;
         }
     }
+
+    d->deleteAvailableOrphans();
 }
 
 //--------- KoCachedColorConversionTransformation ----------//
@@ -168,18 +268,24 @@ KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(KoC
     Q_ASSERT(transfo->available());
     d->cache = cache;
     d->transfo = transfo;
-    d->transfo->use++;
+    d->transfo->use.ref();
 }
 
 KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation& rhs) : d(new Private(*rhs.d))
 {
-    d->transfo->use++;
+    d->transfo->use.ref();
 }
 
 KoCachedColorConversionTransformation::~KoCachedColorConversionTransformation()
 {
-    d->transfo->use--;
-    Q_ASSERT(d->transfo->use >= 0);
+    /**
+     * An orphaned transformation may be deleted by another thread as soon
+     * as the counter drops to zero, so check the value we had instead
+     * of reading it back
+     */
+    const int oldUse = d->transfo->use.fetchAndAddOrdered(-1);
+    Q_ASSERT(oldUse > 0);
+    Q_UNUSED(oldUse);
     delete d;
 }
 
@@ -58,7 +58,8 @@ public:
         BlackpointCompensation  = 0x2000,
         NoWhiteOnWhiteFixup     = 0x0004,    // Don't fix scum dot
         HighQuality             = 0x0400,    // Use more memory to give better accurancy
-        LowQuality              = 0x0800    // Use less memory to minimize resouces
+        LowQuality              = 0x0800,    // Use less memory to minimize resouces
+        PrecomputedLut          = 0x20000000 // Krita-specific: bake the transformation into a 3D LUT, if the engine supports it
     };
     Q_DECLARE_FLAGS(ConversionFlags, ConversionFlag)
 
@@ -19,8 +19,11 @@
 #include "KoColorSpacesBenchmark.h"
 
 #include <QTest>
+#include <QThreadPool>
+#include <QRunnable>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
 
 #define NB_PIXELS 1000000
 
@@ -146,4 +149,75 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+/**
+ * Converts small batches of pixels between all the pairs of the color
+ * spaces, the way the updater threads do it when rendering an image with
+ * layers in different color spaces
+ */
+class ConversionRunnable : public QRunnable
+{
+public:
+    ConversionRunnable(const QList<const KoColorSpace*> &colorSpaces, int numIterations)
+        : m_colorSpaces(colorSpaces),
+          m_numIterations(numIterations)
+    {
+    }
+
+    void run() {
+        const int numPixels = 64;
+        const int maxPixelSize = 16;
+
+        QVector<quint8> src(numPixels * maxPixelSize, 0);
+        QVector<quint8> dst(numPixels * maxPixelSize, 0);
+
+        for (int i = 0; i < m_numIterations; i++) {
+            Q_FOREACH (const KoColorSpace *srcCs, m_colorSpaces) {
+                Q_FOREACH (const KoColorSpace *dstCs, m_colorSpaces) {
+                    srcCs->convertPixelsTo(src.constData(), dst.data(), dstCs, numPixels,
+                                           KoColorConversionTransformation::internalRenderingIntent(),
+                                           KoColorConversionTransformation::internalConversionFlags());
+                }
+            }
+        }
+    }
+
+private:
+    QList<const KoColorSpace*> m_colorSpaces;
+    int m_numIterations;
+};
+
+void KoColorSpacesBenchmark::benchmarkConversionCacheMultithreaded_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("4") << 4;
+    QTest::newRow("ideal") << QThread::idealThreadCount();
+}
+
+void KoColorSpacesBenchmark::benchmarkConversionCacheMultithreaded()
+{
+    QFETCH(int, numThreads);
+
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    QList<const KoColorSpace*> colorSpaces;
+    colorSpaces << registry->rgb8();
+    colorSpaces << registry->rgb16();
+    colorSpaces << registry->lab16();
+    colorSpaces << registry->colorSpace(CMYKAColorModelID.id(), Integer8BitsColorDepthID.id(), 0);
+    colorSpaces << registry->colorSpace(GrayAColorModelID.id(), Integer8BitsColorDepthID.id(), 0);
+    colorSpaces.removeAll(0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new ConversionRunnable(colorSpaces, 1000));
+        }
+        pool.waitForDone();
+    }
+}
+
 QTEST_MAIN(KoColorSpacesBenchmark)
@@ -39,6 +39,8 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkConversionCacheMultithreaded_data();
+    void benchmarkConversionCacheMultithreaded();
 };
 
 #endif
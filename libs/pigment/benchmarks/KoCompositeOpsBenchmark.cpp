@@ -20,6 +20,10 @@
 
 #include "../compositeops/KoCompositeOpAlphaDarken.h"
 #include "../compositeops/KoCompositeOpOver.h"
+#include "../compositeops/KoCompositeOpCopy2.h"
+#include "../compositeops/KoCompositeOpGeneric.h"
+#include "../compositeops/KoCompositeOpFunctions.h"
+#include <KoCompositeOpRegistry.h>
 #include <KoOptimizedCompositeOpFactory.h>
 
 #include <KoColorSpaceTraits.h>
@@ -38,6 +42,20 @@ const quint8 OPACITY_HALF = 128;
 const int TILES_IN_WIDTH = IMG_WIDTH / TILE_WIDTH;
 const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
 
+// the biggest pixel used in the benchmarks (RGBA F32)
+const int MAX_PIXEL_SIZE = KoRgbF32Traits::pixelSize;
+
+
+#define COMPOSITE_BENCHMARK_PIXEL_SIZE(pixelSize) \
+        for (int y = 0; y < TILES_IN_HEIGHT; y++){                                              \
+            for (int x = 0; x < TILES_IN_WIDTH; x++){                                           \
+                compositeOp->composite(m_dstBuffer, TILE_WIDTH * (pixelSize),                   \
+                                      m_srcBuffer, TILE_WIDTH * (pixelSize),                    \
+                                      0, 0,                                                     \
+                                      TILE_WIDTH, TILE_HEIGHT,                                  \
+                                      OPACITY_HALF);                                            \
+            }                                                                                   \
+        }
 
 #define COMPOSITE_BENCHMARK \
         for (int y = 0; y < TILES_IN_HEIGHT; y++){                                              \
@@ -52,15 +70,15 @@ const int TILES_IN_HEIGHT = IMG_HEIGHT / TILE_HEIGHT;
 
 void KoCompositeOpsBenchmark::initTestCase()
 {
-    m_dstBuffer = new quint8[ TILE_WIDTH * TILE_HEIGHT * KoBgrU16Traits::pixelSize ];
-    m_srcBuffer = new quint8[ TILE_WIDTH * TILE_HEIGHT * KoBgrU16Traits::pixelSize ];
+    m_dstBuffer = new quint8[ TILE_WIDTH * TILE_HEIGHT * MAX_PIXEL_SIZE ];
+    m_srcBuffer = new quint8[ TILE_WIDTH * TILE_HEIGHT * MAX_PIXEL_SIZE ];
 }
 
 // this is called before every benchmark
 void KoCompositeOpsBenchmark::init()
 {
-    memset(m_dstBuffer, 42 , TILE_WIDTH * TILE_HEIGHT * KoBgrU16Traits::pixelSize);
-    memset(m_srcBuffer, 42 , TILE_WIDTH * TILE_HEIGHT * KoBgrU16Traits::pixelSize);
+    memset(m_dstBuffer, 42 , TILE_WIDTH * TILE_HEIGHT * MAX_PIXEL_SIZE);
+    memset(m_srcBuffer, 42 , TILE_WIDTH * TILE_HEIGHT * MAX_PIXEL_SIZE);
 }
 
 
@@ -87,5 +105,207 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarken()
     }
 }
 
+void addScalarOptimizedRows()
+{
+    QTest::addColumn<bool>("optimized");
+
+    QTest::newRow("scalar") << false;
+    QTest::newRow("optimized") << true;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOver64_data()
+{
+    addScalarOptimizedRows();
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOver64()
+{
+    QFETCH(bool, optimized);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *compositeOp = optimized ?
+        KoOptimizedCompositeOpFactory::createOverOp64(cs) :
+        new KoCompositeOpOver<KoBgrU16Traits>(cs);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+
+    delete compositeOp;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarken64_data()
+{
+    addScalarOptimizedRows();
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarken64()
+{
+    QFETCH(bool, optimized);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *compositeOp = optimized ?
+        KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(cs) :
+        new KoCompositeOpAlphaDarken<KoBgrU16Traits>(cs);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+
+    delete compositeOp;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeCopy64_data()
+{
+    addScalarOptimizedRows();
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeCopy64()
+{
+    QFETCH(bool, optimized);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoCompositeOp *compositeOp = optimized ?
+        KoOptimizedCompositeOpFactory::createCopyOp64(cs) :
+        new KoCompositeOpCopy2<KoBgrU16Traits>(cs);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK
+    }
+
+    delete compositeOp;
+}
+
+template<class Traits>
+KoCompositeOp* createScalarGenericOp(const KoColorSpace *cs, const QString &id)
+{
+    typedef typename Traits::channels_type Arg;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<Traits, &cfMultiply<Arg> >(cs, id, id, KoCompositeOp::categoryArithmetic());
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfScreen<Arg> >(cs, id, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSC<Traits, &cfOverlay<Arg> >(cs, id, id, KoCompositeOp::categoryMix());
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoCompositeOpGenericSC<Traits, &cfSoftLight<Arg> >(cs, id, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoCompositeOpGenericSC<Traits, &cfColorDodge<Arg> >(cs, id, id, KoCompositeOp::categoryLight());
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<Traits, &cfDifference<Arg> >(cs, id, id, KoCompositeOp::categoryNegative());
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<Arg> >(cs, id, id, KoCompositeOp::categoryArithmetic());
+    }
+
+    return 0;
+}
+
+template<class Traits>
+void fillRandomPixels(quint8 *data, int numPixels)
+{
+    typedef typename Traits::channels_type channels_type;
+    typedef KoColorSpaceMathsTraits<channels_type> MathsTraits;
+
+    channels_type *p = reinterpret_cast<channels_type*>(data);
+
+    for (int i = 0; i < numPixels * int(Traits::channels_nb); i++) {
+        const qreal value = qreal(qrand()) / RAND_MAX;
+        p[i] = channels_type(value * MathsTraits::unitValue);
+    }
+}
+
+enum GenericOpDepth {
+    DEPTH_U8,
+    DEPTH_U16,
+    DEPTH_F32
+};
+
+Q_DECLARE_METATYPE(GenericOpDepth)
+
+void KoCompositeOpsBenchmark::benchmarkCompositeGeneric_data()
+{
+    QTest::addColumn<QString>("id");
+    QTest::addColumn<GenericOpDepth>("depth");
+    QTest::addColumn<bool>("optimized");
+
+    QStringList ids;
+    ids << COMPOSITE_MULT
+        << COMPOSITE_SCREEN
+        << COMPOSITE_OVERLAY
+        << COMPOSITE_SOFT_LIGHT_PHOTOSHOP
+        << COMPOSITE_DODGE
+        << COMPOSITE_DIFF
+        << COMPOSITE_ADD;
+
+    Q_FOREACH (const QString &id, ids) {
+        for (int optimized = 0; optimized <= 1; optimized++) {
+            const QString suffix = optimized ? "optimized" : "scalar";
+
+            QTest::newRow(QString("%1-u8-%2").arg(id).arg(suffix).toLatin1()) << id << DEPTH_U8 << bool(optimized);
+            QTest::newRow(QString("%1-u16-%2").arg(id).arg(suffix).toLatin1()) << id << DEPTH_U16 << bool(optimized);
+            QTest::newRow(QString("%1-f32-%2").arg(id).arg(suffix).toLatin1()) << id << DEPTH_F32 << bool(optimized);
+        }
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeGeneric()
+{
+    QFETCH(QString, id);
+    QFETCH(GenericOpDepth, depth);
+    QFETCH(bool, optimized);
+
+    /**
+     * The optimized version is created for the architecture selected
+     * in runtime, so to compare different archs the benchmark should
+     * be run on different CPUs
+     */
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const int numPixels = TILE_WIDTH * TILE_HEIGHT;
+
+    KoCompositeOp *compositeOp = 0;
+    int pixelSize = 0;
+
+    qsrand(1);
+
+    switch (depth) {
+    case DEPTH_U8:
+        compositeOp = createScalarGenericOp<KoBgrU8Traits>(cs, id);
+        if (optimized) {
+            compositeOp = KoOptimizedCompositeOpFactory::createGenericOp32(compositeOp);
+        }
+        fillRandomPixels<KoBgrU8Traits>(m_srcBuffer, numPixels);
+        fillRandomPixels<KoBgrU8Traits>(m_dstBuffer, numPixels);
+        pixelSize = KoBgrU8Traits::pixelSize;
+        break;
+    case DEPTH_U16:
+        compositeOp = createScalarGenericOp<KoBgrU16Traits>(cs, id);
+        if (optimized) {
+            compositeOp = KoOptimizedCompositeOpFactory::createGenericOp64(compositeOp);
+        }
+        fillRandomPixels<KoBgrU16Traits>(m_srcBuffer, numPixels);
+        fillRandomPixels<KoBgrU16Traits>(m_dstBuffer, numPixels);
+        pixelSize = KoBgrU16Traits::pixelSize;
+        break;
+    case DEPTH_F32:
+        compositeOp = createScalarGenericOp<KoRgbF32Traits>(cs, id);
+        if (optimized) {
+            compositeOp = KoOptimizedCompositeOpFactory::createGenericOp128(compositeOp);
+        }
+        fillRandomPixels<KoRgbF32Traits>(m_srcBuffer, numPixels);
+        fillRandomPixels<KoRgbF32Traits>(m_dstBuffer, numPixels);
+        pixelSize = KoRgbF32Traits::pixelSize;
+        break;
+    }
+
+    QVERIFY(compositeOp);
+
+    QBENCHMARK{
+        COMPOSITE_BENCHMARK_PIXEL_SIZE(pixelSize)
+    }
+
+    delete compositeOp;
+}
+
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
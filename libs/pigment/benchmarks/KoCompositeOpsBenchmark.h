@@ -33,6 +33,16 @@ private Q_SLOTS:
     void benchmarkCompositeOver();
     void benchmarkCompositeAlphaDarken();
 
+    void benchmarkCompositeOver64_data();
+    void benchmarkCompositeOver64();
+    void benchmarkCompositeAlphaDarken64_data();
+    void benchmarkCompositeAlphaDarken64();
+    void benchmarkCompositeCopy64_data();
+    void benchmarkCompositeCopy64();
+
+    void benchmarkCompositeGeneric_data();
+    void benchmarkCompositeGeneric();
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
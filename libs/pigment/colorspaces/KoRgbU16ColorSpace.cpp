@@ -30,6 +30,7 @@
 #include "KoChannelInfo.h"
 #include "KoID.h"
 #include "KoIntegerMaths.h"
+#include "compositeops/KoCompositeOps.h"
 
 #include "KoColorConversions.h"
 
@@ -39,6 +40,12 @@ KoRgbU16ColorSpace::KoRgbU16ColorSpace() :
                                            RGBAColorModelID,
                                            Integer16BitsColorDepthID)
 {
+    addChannel(new KoChannelInfo(i18n("Blue"),  0 * sizeof(quint16), 2, KoChannelInfo::COLOR, KoChannelInfo::UINT16, sizeof(quint16), QColor(0, 0, 255)));
+    addChannel(new KoChannelInfo(i18n("Green"), 1 * sizeof(quint16), 1, KoChannelInfo::COLOR, KoChannelInfo::UINT16, sizeof(quint16), QColor(0, 255, 0)));
+    addChannel(new KoChannelInfo(i18n("Red"),   2 * sizeof(quint16), 0, KoChannelInfo::COLOR, KoChannelInfo::UINT16, sizeof(quint16), QColor(255, 0, 0)));
+    addChannel(new KoChannelInfo(i18n("Alpha"), 3 * sizeof(quint16), 3, KoChannelInfo::ALPHA, KoChannelInfo::UINT16, sizeof(quint16)));
+
+    addStandardCompositeOps<KoBgrU16Traits>(this);
 }
 
 KoRgbU16ColorSpace::~KoRgbU16ColorSpace()
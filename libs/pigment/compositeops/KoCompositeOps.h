@@ -56,6 +56,12 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return new KoCompositeOpOver<Traits>(cs);
     }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return new KoCompositeOpCopy2<Traits>(cs);
+    }
+    static KoCompositeOp* createGenericOp(KoCompositeOp *op) {
+        return op;
+    }
 };
 
 template<>
@@ -67,6 +73,12 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createOverOp32(cs);
     }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return new KoCompositeOpCopy2<KoBgrU8Traits>(cs);
+    }
+    static KoCompositeOp* createGenericOp(KoCompositeOp *op) {
+        return KoOptimizedCompositeOpFactory::createGenericOp32(op);
+    }
 };
 
 template<>
@@ -78,6 +90,12 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createOverOp32(cs);
     }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return new KoCompositeOpCopy2<KoLabU8Traits>(cs);
+    }
+    static KoCompositeOp* createGenericOp(KoCompositeOp *op) {
+        return KoOptimizedCompositeOpFactory::createGenericOp32(op);
+    }
 };
 
 template<>
@@ -89,6 +107,29 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createOverOp128(cs);
     }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return new KoCompositeOpCopy2<KoRgbF32Traits>(cs);
+    }
+    static KoCompositeOp* createGenericOp(KoCompositeOp *op) {
+        return KoOptimizedCompositeOpFactory::createGenericOp128(op);
+    }
+};
+
+template<>
+struct OptimizedOpsSelector<KoBgrU16Traits>
+{
+    static KoCompositeOp* createAlphaDarkenOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(cs);
+    }
+    static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createCopyOp64(cs);
+    }
+    static KoCompositeOp* createGenericOp(KoCompositeOp *op) {
+        return KoOptimizedCompositeOpFactory::createGenericOp64(op);
+    }
 };
 
 template<class Traits>
@@ -100,13 +141,14 @@ struct AddGeneralOps<Traits, true>
 
      template<CompositeFunc func>
      static void add(KoColorSpace* cs, const QString& id, const QString& description, const QString& category) {
-         cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func>(cs, id, description, category));
+         KoCompositeOp *op = new KoCompositeOpGenericSC<Traits, func>(cs, id, description, category);
+         cs->addCompositeOp(OptimizedOpsSelector<Traits>::createGenericOp(op));
      }
 
      static void add(KoColorSpace* cs) {
          cs->addCompositeOp(OptimizedOpsSelector<Traits>::createOverOp(cs));
          cs->addCompositeOp(OptimizedOpsSelector<Traits>::createAlphaDarkenOp(cs));
-         cs->addCompositeOp(new KoCompositeOpCopy2<Traits>(cs));
+         cs->addCompositeOp(OptimizedOpsSelector<Traits>::createCopyOp(cs));
          cs->addCompositeOp(new KoCompositeOpErase<Traits>(cs));
          cs->addCompositeOp(new KoCompositeOpBehind<Traits>(cs));
          cs->addCompositeOp(new KoCompositeOpGreater<Traits>(cs));
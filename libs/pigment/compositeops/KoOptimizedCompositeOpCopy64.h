@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPCOPY64_H_
+#define KOOPTIMIZEDCOMPOSITEOPCOPY64_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+
+/**
+ * A vectorized version of KoCompositeOpCopy2. The colors are blended
+ * in premultiplied form only when the mask (or opacity) is not opaque
+ * and the destination is not transparent, otherwise the source
+ * channels are copied as they are.
+ */
+template<typename channels_type, typename pixel_type, bool alphaLocked, bool allChannelsFlag>
+struct CopyCompositor64 {
+    struct OptionalParams {
+        OptionalParams(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    /**
+     * The color channels are processed in their native range, only
+     * the alpha values are normalized to the [0.0, 1.0] range
+     *
+     * \see docs in AlphaDarkenCompositor32
+     */
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const Vc::float_v unitValue(KoColorSpaceMathsTraits<channels_type>::unitValue);
+        const Vc::float_v unitValueRec1(1.0f / KoColorSpaceMathsTraits<channels_type>::unitValue);
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+
+        Vc::float_v opacity_vec(opacity);
+
+        if (haveMask) {
+            const Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            opacity_vec *= mask_vec * uint8MaxRec1;
+        }
+
+        // Nothing is copied with zero opacity
+        if ((opacity_vec == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v src_alpha;
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        KoStreamedMath<_impl>::fetch_all_64(src, src_alpha, src_c1, src_c2, src_c3);
+        src_alpha *= unitValueRec1;
+
+        if (!haveMask && (opacity_vec == oneValue).isFull()) {
+            KoStreamedMath<_impl>::write_channels_64(dst, src_alpha * unitValue, src_c1, src_c2, src_c3);
+            return;
+        }
+
+        Vc::float_v dst_alpha;
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        KoStreamedMath<_impl>::fetch_all_64(dst, dst_alpha, dst_c1, dst_c2, dst_c3);
+        dst_alpha *= unitValueRec1;
+
+        const Vc::float_v new_alpha = (src_alpha - dst_alpha) * opacity_vec + dst_alpha;
+
+        const Vc::float_m copy_mask = (dst_alpha == zeroValue) || (opacity_vec == oneValue);
+        const Vc::float_m blend_mask = !copy_mask && (opacity_vec != zeroValue) && (new_alpha != zeroValue);
+
+        if (!blend_mask.isEmpty()) {
+            /**
+             * The value of new_alpha can have *some* zero values,
+             * which will result in NaN values while division. These
+             * lanes are not written by the masked assignment.
+             */
+            const Vc::float_v new_alpha_rec = oneValue / new_alpha;
+
+            Vc::float_v dst_mult;
+            Vc::float_v src_mult;
+
+            dst_mult = dst_c1 * dst_alpha;
+            src_mult = src_c1 * src_alpha;
+            dst_c1(blend_mask) = Vc::min(((src_mult - dst_mult) * opacity_vec + dst_mult) * new_alpha_rec, unitValue);
+
+            dst_mult = dst_c2 * dst_alpha;
+            src_mult = src_c2 * src_alpha;
+            dst_c2(blend_mask) = Vc::min(((src_mult - dst_mult) * opacity_vec + dst_mult) * new_alpha_rec, unitValue);
+
+            dst_mult = dst_c3 * dst_alpha;
+            src_mult = src_c3 * src_alpha;
+            dst_c3(blend_mask) = Vc::min(((src_mult - dst_mult) * opacity_vec + dst_mult) * new_alpha_rec, unitValue);
+        }
+
+        dst_c1(copy_mask) = src_c1;
+        dst_c2(copy_mask) = src_c2;
+        dst_c3(copy_mask) = src_c3;
+
+        KoStreamedMath<_impl>::write_channels_64(dst, new_alpha * unitValue, dst_c1, dst_c2, dst_c3);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const channels_type *s = reinterpret_cast<const channels_type*>(src);
+        channels_type *d = reinterpret_cast<channels_type*>(dst);
+
+        const float unitValue = KoColorSpaceMathsTraits<channels_type>::unitValue;
+        const float unitValueRec1 = 1.0f / unitValue;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0 / 255.0;
+            opacity *= float(*mask) * uint8Rec1;
+        }
+
+        const float srcAlpha = s[alpha_pos] * unitValueRec1;
+        const float dstAlpha = d[alpha_pos] * unitValueRec1;
+
+        if (!allChannelsFlag && dstAlpha == 0.0) {
+            KoStreamedMathFunctions::clearPixel<8>(dst);
+        }
+
+        const QBitArray &channelFlags = oparams.channelFlags;
+        float newAlpha = dstAlpha;
+
+        if (dstAlpha == 0.0 || opacity == 1.0) {
+            newAlpha = lerp(dstAlpha, srcAlpha, opacity);
+
+            for (int i = 0; i < alpha_pos; i++) {
+                if (allChannelsFlag || channelFlags.at(i)) {
+                    d[i] = s[i];
+                }
+            }
+        } else if (opacity != 0.0) {
+            newAlpha = lerp(dstAlpha, srcAlpha, opacity);
+
+            if (newAlpha != 0.0) {
+                for (int i = 0; i < alpha_pos; i++) {
+                    if (allChannelsFlag || channelFlags.at(i)) {
+                        const float dstMult = d[i] * dstAlpha;
+                        const float srcMult = s[i] * srcAlpha;
+                        const float value = lerp(dstMult, srcMult, opacity) / newAlpha;
+
+                        d[i] = channels_type(qMin(value, unitValue) + 0.5f);
+                    }
+                }
+            }
+        }
+
+        if (!alphaLocked) {
+            d[alpha_pos] = channels_type(newAlpha * unitValue + 0.5f);
+        }
+    }
+};
+
+/**
+ * An optimized version of a composite op for the use in 8 byte
+ * colorspaces with alpha channel placed at the last channel of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpCopy64 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpCopy64(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_COPY, i18n("Copy"), KoCompositeOp::categoryMisc()) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, CopyCompositor64<quint16, quint64, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, CopyCompositor64<quint16, quint64, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, CopyCompositor64<quint16, quint64, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, CopyCompositor64<quint16, quint64, true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPCOPY64_H_
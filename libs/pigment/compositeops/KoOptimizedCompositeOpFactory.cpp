@@ -42,6 +42,21 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp32(const KoColorSpace
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32> >(cs);
 }
 
+KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64> >(cs);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOp64(const KoColorSpace *cs)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy64> >(cs);
+}
+
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOp128(const KoColorSpace *cs)
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken128> >(cs);
@@ -51,3 +66,18 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createOverOp128(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp32(KoCompositeOp *op)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric32> >(op);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp64(KoCompositeOp *op)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric64> >(op);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp128(KoCompositeOp *op)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric128> >(op);
+}
@@ -42,8 +42,21 @@ class KRITAPIGMENT_EXPORT KoOptimizedCompositeOpFactory
 public:
     static KoCompositeOp* createAlphaDarkenOp32(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp32(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOp64(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOp64(const KoColorSpace *cs);
+    static KoCompositeOp* createCopyOp64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOp128(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp128(const KoColorSpace *cs);
+
+    /**
+     * Create a vectorized version of a generic separable blending
+     * op of a 4-channel colorspace with 8-bit, 16-bit or 32-bit float
+     * channels. The factory takes the ownership of \p op. If there is
+     * no vectorized version of the op, \p op itself is returned.
+     */
+    static KoCompositeOp* createGenericOp32(KoCompositeOp *op);
+    static KoCompositeOp* createGenericOp64(KoCompositeOp *op);
+    static KoCompositeOp* createGenericOp128(KoCompositeOp *op);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -23,9 +23,13 @@
 
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpAlphaDarken32.h"
+#include "KoOptimizedCompositeOpAlphaDarken64.h"
 #include "KoOptimizedCompositeOpAlphaDarken128.h"
 #include "KoOptimizedCompositeOpOver32.h"
+#include "KoOptimizedCompositeOpOver64.h"
 #include "KoOptimizedCompositeOpOver128.h"
+#include "KoOptimizedCompositeOpCopy64.h"
+#include "KoOptimizedCompositeOpGeneric.h"
 
 #include <QString>
 #include "DebugPigment.h"
@@ -52,6 +56,30 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>::create<VC_IM
     return new KoOptimizedCompositeOpOver32<VC_IMPL>(param);
 }
 
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::create<VC_IMPL>(ParamType param)
+{
+    return new KoOptimizedCompositeOpAlphaDarken64<VC_IMPL>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::create<VC_IMPL>(ParamType param)
+{
+    return new KoOptimizedCompositeOpOver64<VC_IMPL>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy64>::create<VC_IMPL>(ParamType param)
+{
+    return new KoOptimizedCompositeOpCopy64<VC_IMPL>(param);
+}
+
 template<>
 template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken128>::ReturnType
@@ -68,6 +96,33 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<VC_I
     return new KoOptimizedCompositeOpOver128<VC_IMPL>(param);
 }
 
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric32>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric32>::create<VC_IMPL>(ParamType param)
+{
+    return KoOptimizedCompositeOpGeneric32<VC_IMPL>::isSupported(param->id()) ?
+        new KoOptimizedCompositeOpGeneric32<VC_IMPL>(param) : param;
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric64>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric64>::create<VC_IMPL>(ParamType param)
+{
+    return KoOptimizedCompositeOpGeneric64<VC_IMPL>::isSupported(param->id()) ?
+        new KoOptimizedCompositeOpGeneric64<VC_IMPL>(param) : param;
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric128>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric128>::create<VC_IMPL>(ParamType param)
+{
+    return KoOptimizedCompositeOpGeneric128<VC_IMPL>::isSupported(param->id()) ?
+        new KoOptimizedCompositeOpGeneric128<VC_IMPL>(param) : param;
+}
+
 #define __stringify(_s) #_s
 #define stringify(_s) __stringify(_s)
 
@@ -34,12 +34,30 @@ class KoOptimizedCompositeOpAlphaDarken32;
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpOver32;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarken64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpCopy64;
+
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpAlphaDarken128;
 
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpOver128;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpGeneric32;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpGeneric64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpGeneric128;
+
 template<template<Vc::Implementation I> class CompositeOp>
 struct KoOptimizedCompositeOpFactoryPerArch
 {
@@ -50,6 +68,22 @@ struct KoOptimizedCompositeOpFactoryPerArch
     static ReturnType create(ParamType param);
 };
 
+/**
+ * Wraps a scalar KoCompositeOpGenericSC-based op into its vectorized
+ * version. The factory takes the ownership of the passed op. If the
+ * blending function of the op has no vectorized implementation, the
+ * op is returned as it is.
+ */
+template<template<Vc::Implementation I> class CompositeOp>
+struct KoOptimizedCompositeOpGenericFactoryPerArch
+{
+    typedef KoCompositeOp* ParamType;
+    typedef KoCompositeOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static ReturnType create(ParamType param);
+};
+
 struct KoReportCurrentArch
 {
     typedef void* ParamType;
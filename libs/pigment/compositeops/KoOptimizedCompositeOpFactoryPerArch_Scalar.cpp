@@ -22,6 +22,7 @@
 #include "KoColorSpaceTraits.h"
 #include "KoCompositeOpAlphaDarken.h"
 #include "KoCompositeOpOver.h"
+#include "KoCompositeOpCopy2.h"
 
 
 template<>
@@ -40,6 +41,30 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver32>::create<Vc::S
     return new KoCompositeOpOver<KoBgrU8Traits>(param);
 }
 
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpAlphaDarken<KoBgrU16Traits>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpOver<KoBgrU16Traits>(param);
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy64>::ReturnType
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopy64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return new KoCompositeOpCopy2<KoBgrU16Traits>(param);
+}
+
 template<>
 template<>
 KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarken128>::ReturnType
@@ -56,6 +81,30 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOver128>::create<Vc::
     return new KoCompositeOpOver<KoRgbF32Traits>(param);
 }
 
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric32>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric32>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return param;
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric64>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric64>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return param;
+}
+
+template<>
+template<>
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric128>::ReturnType
+KoOptimizedCompositeOpGenericFactoryPerArch<KoOptimizedCompositeOpGeneric128>::create<Vc::ScalarImpl>(ParamType param)
+{
+    return param;
+}
+
 template<>
 KoReportCurrentArch::ReturnType
 KoReportCurrentArch::create<Vc::ScalarImpl>(ParamType)
@@ -0,0 +1,388 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
+
+#include <QBitArray>
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoColorSpaceMaths.h"
+#include "KoStreamedMath.h"
+#include "KoStreamedBlendFunctions.h"
+
+
+/**
+ * A vectorized version of KoCompositeOpGenericSC for RGBA colorspaces
+ * with the alpha channel placed at the last position of the pixel:
+ * C1_C2_C3_A. The channels are processed in floating point, \p
+ * channels_type defines the storage of the pixels only.
+ *
+ * The op wraps the scalar op it is created from and takes the ownership
+ * of it. The scalar op is used for the cases the vectorized version
+ * does not support (custom channel flags except locked alpha).
+ *
+ * The blending function is chosen by the id of the wrapped op,
+ * use isSupported() to check if there is a vectorized version of
+ * the function.
+ */
+template<Vc::Implementation _impl, typename channels_type>
+class KoOptimizedCompositeOpGenericSC : public KoCompositeOp
+{
+    typedef KoOptimizedCompositeOpGenericSC<_impl, channels_type> this_type;
+    typedef KoStreamedBlendValues<_impl> BlendValues;
+    typedef void (this_type::*CompositeFunction)(const KoCompositeOp::ParameterInfo&, bool) const;
+
+    static const int channels_nb = 4;
+    static const int alpha_pos = 3;
+    static const int pixel_size = channels_nb * sizeof(channels_type);
+
+    struct CompositeFunctions {
+        CompositeFunctions() : withMask(0), withoutMask(0) {}
+
+        CompositeFunction withMask;
+        CompositeFunction withoutMask;
+    };
+
+public:
+    KoOptimizedCompositeOpGenericSC(KoCompositeOp *fallbackOp)
+        : KoCompositeOp(fallbackOp->colorSpace(), fallbackOp->id(), fallbackOp->description(), fallbackOp->category()),
+          m_fallbackOp(fallbackOp),
+          m_functions(functionsForId(fallbackOp->id()))
+    {
+    }
+
+    ~KoOptimizedCompositeOpGenericSC()
+    {
+        delete m_fallbackOp;
+    }
+
+    static bool isSupported(const QString &id)
+    {
+        return functionsForId(id).withMask;
+    }
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        const QBitArray &flags = params.channelFlags;
+
+        const bool allChannelFlags =
+            flags.isEmpty() || flags == QBitArray(channels_nb, true);
+
+        const bool alphaLocked =
+            !allChannelFlags &&
+            flags.size() == channels_nb &&
+            flags.at(0) && flags.at(1) && flags.at(2) && !flags.at(alpha_pos);
+
+        if (!allChannelFlags && !alphaLocked) {
+            m_fallbackOp->composite(params);
+            return;
+        }
+
+        if (params.maskRowStart) {
+            (this->*m_functions.withMask)(params, alphaLocked);
+        } else {
+            (this->*m_functions.withoutMask)(params, alphaLocked);
+        }
+    }
+
+private:
+    template<class BlendFunction>
+    static CompositeFunctions makeFunctions()
+    {
+        CompositeFunctions functions;
+        functions.withMask = &this_type::template compositeImpl<true, BlendFunction>;
+        functions.withoutMask = &this_type::template compositeImpl<false, BlendFunction>;
+        return functions;
+    }
+
+    static CompositeFunctions functionsForId(const QString &id)
+    {
+        if (id == COMPOSITE_MULT) {
+            return makeFunctions<KoStreamedBlendMultiply<_impl> >();
+        } else if (id == COMPOSITE_SCREEN) {
+            return makeFunctions<KoStreamedBlendScreen<_impl> >();
+        } else if (id == COMPOSITE_OVERLAY) {
+            return makeFunctions<KoStreamedBlendOverlay<_impl> >();
+        } else if (id == COMPOSITE_HARD_LIGHT) {
+            return makeFunctions<KoStreamedBlendHardLight<_impl> >();
+        } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+            return makeFunctions<KoStreamedBlendSoftLight<_impl> >();
+        } else if (id == COMPOSITE_SOFT_LIGHT_SVG) {
+            return makeFunctions<KoStreamedBlendSoftLightSvg<_impl> >();
+        } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+            return makeFunctions<KoStreamedBlendAddition<_impl> >();
+        } else if (id == COMPOSITE_SUBTRACT) {
+            return makeFunctions<KoStreamedBlendSubtract<_impl> >();
+        } else if (id == COMPOSITE_INVERSE_SUBTRACT) {
+            return makeFunctions<KoStreamedBlendInverseSubtract<_impl> >();
+        } else if (id == COMPOSITE_DARKEN) {
+            return makeFunctions<KoStreamedBlendDarkenOnly<_impl> >();
+        } else if (id == COMPOSITE_LIGHTEN) {
+            return makeFunctions<KoStreamedBlendLightenOnly<_impl> >();
+        } else if (id == COMPOSITE_DIFF) {
+            return makeFunctions<KoStreamedBlendDifference<_impl> >();
+        } else if (id == COMPOSITE_EQUIVALENCE) {
+            return makeFunctions<KoStreamedBlendEquivalence<_impl> >();
+        } else if (id == COMPOSITE_EXCLUSION) {
+            return makeFunctions<KoStreamedBlendExclusion<_impl> >();
+        } else if (id == COMPOSITE_LINEAR_BURN) {
+            return makeFunctions<KoStreamedBlendLinearBurn<_impl> >();
+        } else if (id == COMPOSITE_LINEAR_LIGHT) {
+            return makeFunctions<KoStreamedBlendLinearLight<_impl> >();
+        } else if (id == COMPOSITE_GRAIN_MERGE) {
+            return makeFunctions<KoStreamedBlendGrainMerge<_impl> >();
+        } else if (id == COMPOSITE_GRAIN_EXTRACT) {
+            return makeFunctions<KoStreamedBlendGrainExtract<_impl> >();
+        } else if (id == COMPOSITE_ALLANON) {
+            return makeFunctions<KoStreamedBlendAllanon<_impl> >();
+        } else if (id == COMPOSITE_PIN_LIGHT) {
+            return makeFunctions<KoStreamedBlendPinLight<_impl> >();
+        } else if (id == COMPOSITE_DODGE) {
+            return makeFunctions<KoStreamedBlendColorDodge<_impl> >();
+        } else if (id == COMPOSITE_BURN) {
+            return makeFunctions<KoStreamedBlendColorBurn<_impl> >();
+        } else if (id == COMPOSITE_HARD_MIX) {
+            return makeFunctions<KoStreamedBlendHardMix<_impl> >();
+        } else if (id == COMPOSITE_DIVIDE) {
+            return makeFunctions<KoStreamedBlendDivide<_impl> >();
+        } else if (id == COMPOSITE_GEOMETRIC_MEAN) {
+            return makeFunctions<KoStreamedBlendGeometricMean<_impl> >();
+        } else if (id == COMPOSITE_ADDITIVE_SUBTRACTIVE) {
+            return makeFunctions<KoStreamedBlendAdditiveSubtractive<_impl> >();
+        }
+
+        return CompositeFunctions();
+    }
+
+    static BlendValues blendValues()
+    {
+        typedef KoColorSpaceMathsTraits<channels_type> traits;
+
+        /**
+         * The values are normalized exactly like the channels in
+         * compositeBlock(), so that e.g. the comparisons with the half
+         * value give the same results as in the integer scalar ops
+         */
+        const float unitRec = 1.0f / float(traits::unitValue);
+
+        return BlendValues(float(traits::halfValue) * unitRec,
+                           float(traits::min) * unitRec,
+                           float(traits::max) * unitRec);
+    }
+
+    template<bool useMask, class BlendFunction>
+    static ALWAYS_INLINE void compositeBlock(const quint8 *src, quint8 *dst, const quint8 *mask,
+                                             int numPixels, bool alphaLocked,
+                                             Vc::float_v::AsArg opacity,
+                                             const BlendValues &v)
+    {
+        typedef KoStreamedMath<_impl> Math;
+
+        const bool isInteger = std::numeric_limits<channels_type>::is_integer;
+        const Vc::float_v unitValue(float(KoColorSpaceMathsTraits<channels_type>::unitValue));
+        const Vc::float_v unitValueRec(1.0f / float(KoColorSpaceMathsTraits<channels_type>::unitValue));
+
+        Vc::float_v src_c[3];
+        Vc::float_v src_alpha;
+
+        Math::template fetch_channels_rgba<channels_type>(src, numPixels, src_c[0], src_c[1], src_c[2], src_alpha);
+
+        if (isInteger) {
+            src_alpha *= unitValueRec;
+        }
+        src_alpha *= opacity;
+
+        if (useMask) {
+            const Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+            Vc::float_v mask_vec;
+
+            if (numPixels == int(Vc::float_v::Size)) {
+                mask_vec = Math::fetch_mask_8(mask);
+            } else {
+                quint8 maskBuf[Vc::float_v::Size] = {0};
+                memcpy(maskBuf, mask, numPixels);
+                mask_vec = Math::fetch_mask_8(maskBuf);
+            }
+
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        /**
+         * The source cannot change the colors in the destination,
+         * since its fully transparent. In alpha locked mode we still
+         * have to clear the colors of the transparent destination
+         * pixels (see below).
+         */
+        if (!alphaLocked && (src_alpha == v.zero).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_c[3];
+        Vc::float_v dst_alpha;
+
+        Math::template fetch_channels_rgba<channels_type>(dst, numPixels, dst_c[0], dst_c[1], dst_c[2], dst_alpha);
+
+        if (isInteger) {
+            for (int i = 0; i < 3; i++) {
+                src_c[i] *= unitValueRec;
+                dst_c[i] *= unitValueRec;
+            }
+            dst_alpha *= unitValueRec;
+        }
+
+        if (alphaLocked) {
+            /**
+             * The scalar op clears the color of fully transparent
+             * pixels when the channel flags are in use, we should
+             * do the same
+             */
+            const Vc::float_m dstIsTransparent = dst_alpha == v.zero;
+
+            for (int i = 0; i < 3; i++) {
+                Vc::float_v result = BlendFunction::apply(src_c[i], dst_c[i], v);
+                dst_c[i] += (result - dst_c[i]) * src_alpha;
+                dst_c[i](dstIsTransparent) = v.zero;
+            }
+        } else {
+            const Vc::float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+
+            /**
+             * The value of new_alpha can have *some* zero values,
+             * which will result in NaN values while division. The
+             * colors of these pixels are left untouched.
+             */
+            const Vc::float_m newAlphaIsValid = new_alpha != v.zero;
+            const Vc::float_v newAlphaRec = v.unit / new_alpha;
+
+            const Vc::float_v dstWeight = (v.unit - src_alpha) * dst_alpha;
+            const Vc::float_v srcWeight = (v.unit - dst_alpha) * src_alpha;
+            const Vc::float_v blendWeight = src_alpha * dst_alpha;
+
+            for (int i = 0; i < 3; i++) {
+                Vc::float_v result = BlendFunction::apply(src_c[i], dst_c[i], v);
+                result = dstWeight * dst_c[i] + srcWeight * src_c[i] + blendWeight * result;
+                dst_c[i](newAlphaIsValid) = result * newAlphaRec;
+            }
+
+            dst_alpha = new_alpha;
+        }
+
+        if (isInteger) {
+            for (int i = 0; i < 3; i++) {
+                dst_c[i] = Vc::min(Vc::max(dst_c[i], v.zero), v.unit) * unitValue;
+            }
+            dst_alpha = Vc::min(Vc::max(dst_alpha, v.zero), v.unit) * unitValue;
+        }
+
+        Math::template write_channels_rgba<channels_type>(dst, numPixels, dst_c[0], dst_c[1], dst_c[2], dst_alpha);
+    }
+
+    template<bool useMask, class BlendFunction>
+    void compositeImpl(const KoCompositeOp::ParameterInfo& params, bool alphaLocked) const
+    {
+        const int vectorSize = Vc::float_v::Size;
+        const qint32 vectorInc = pixel_size * vectorSize;
+        qint32 srcVectorInc = vectorInc;
+
+        const BlendValues v = blendValues();
+        const Vc::float_v opacity(params.opacity);
+
+        const quint8 *srcRowStart = params.srcRowStart;
+
+        /**
+         * A constant source color is expanded into a full vector
+         * of pixels, so that the blocks could be fetched as usual
+         */
+        quint8 srcBuffer[pixel_size * Vc::float_v::Size];
+        if (!params.srcRowStride) {
+            for (int i = 0; i < vectorSize; i++) {
+                memcpy(srcBuffer + i * pixel_size, params.srcRowStart, pixel_size);
+            }
+            srcRowStart = srcBuffer;
+            srcVectorInc = 0;
+        }
+
+        quint8 *dstRowStart = params.dstRowStart;
+        const quint8 *maskRowStart = params.maskRowStart;
+
+        for (qint32 r = params.rows; r > 0; --r) {
+            const quint8 *src = srcRowStart;
+            quint8 *dst = dstRowStart;
+            const quint8 *mask = maskRowStart;
+
+            int cols = params.cols;
+
+            for (; cols >= vectorSize; cols -= vectorSize) {
+                compositeBlock<useMask, BlendFunction>(src, dst, mask, vectorSize, alphaLocked, opacity, v);
+
+                src += srcVectorInc;
+                dst += vectorInc;
+
+                if (useMask) {
+                    mask += vectorSize;
+                }
+            }
+
+            if (cols > 0) {
+                compositeBlock<useMask, BlendFunction>(src, dst, mask, cols, alphaLocked, opacity, v);
+            }
+
+            srcRowStart += params.srcRowStride;
+            dstRowStart += params.dstRowStride;
+
+            if (useMask) {
+                maskRowStart += params.maskRowStride;
+            }
+        }
+    }
+
+private:
+    KoCompositeOp *m_fallbackOp;
+    const CompositeFunctions m_functions;
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpGeneric32 : public KoOptimizedCompositeOpGenericSC<_impl, quint8>
+{
+public:
+    KoOptimizedCompositeOpGeneric32(KoCompositeOp *fallbackOp)
+        : KoOptimizedCompositeOpGenericSC<_impl, quint8>(fallbackOp) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpGeneric64 : public KoOptimizedCompositeOpGenericSC<_impl, quint16>
+{
+public:
+    KoOptimizedCompositeOpGeneric64(KoCompositeOp *fallbackOp)
+        : KoOptimizedCompositeOpGenericSC<_impl, quint16>(fallbackOp) {}
+};
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpGeneric128 : public KoOptimizedCompositeOpGenericSC<_impl, float>
+{
+public:
+    KoOptimizedCompositeOpGeneric128(KoCompositeOp *fallbackOp)
+        : KoOptimizedCompositeOpGenericSC<_impl, float>(fallbackOp) {}
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
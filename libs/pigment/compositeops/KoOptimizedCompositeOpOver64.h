@@ -0,0 +1,243 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+#define KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+
+template<typename channels_type, typename pixel_type, bool alphaLocked, bool allChannelsFlag>
+struct OverCompositor64 {
+    struct OptionalParams {
+        OptionalParams(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    /**
+     * The color channels are processed in their native range, only
+     * the alpha values are normalized to the [0.0, 1.0] range
+     *
+     * \see docs in AlphaDarkenCompositor32
+     */
+    template<bool haveMask, bool src_aligned, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const Vc::float_v unitValue(KoColorSpaceMathsTraits<channels_type>::unitValue);
+        const Vc::float_v unitValueRec1(1.0f / KoColorSpaceMathsTraits<channels_type>::unitValue);
+        const Vc::float_v zeroValue(Vc::Zero);
+        const Vc::float_v oneValue(Vc::One);
+
+        Vc::float_v src_alpha;
+        Vc::float_v src_c1;
+        Vc::float_v src_c2;
+        Vc::float_v src_c3;
+
+        KoStreamedMath<_impl>::fetch_all_64(src, src_alpha, src_c1, src_c2, src_c3);
+
+        src_alpha *= Vc::float_v(opacity) * unitValueRec1;
+
+        if (haveMask) {
+            const Vc::float_v uint8MaxRec1((float)1.0 / 255.0);
+            Vc::float_v mask_vec = KoStreamedMath<_impl>::fetch_mask_8(mask);
+            src_alpha *= mask_vec * uint8MaxRec1;
+        }
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if ((src_alpha == zeroValue).isFull()) {
+            return;
+        }
+
+        Vc::float_v dst_alpha;
+        Vc::float_v dst_c1;
+        Vc::float_v dst_c2;
+        Vc::float_v dst_c3;
+
+        KoStreamedMath<_impl>::fetch_all_64(dst, dst_alpha, dst_c1, dst_c2, dst_c3);
+        dst_alpha *= unitValueRec1;
+
+        Vc::float_v src_blend;
+        Vc::float_v new_alpha;
+
+        if ((dst_alpha == oneValue).isFull()) {
+            new_alpha = dst_alpha;
+            src_blend = src_alpha;
+        } else if ((dst_alpha == zeroValue).isFull()) {
+            new_alpha = src_alpha;
+            src_blend = oneValue;
+        } else {
+            /**
+             * The value of new_alpha can have *some* zero values,
+             * which will result in NaN values while division.
+             */
+            new_alpha = dst_alpha + (oneValue - dst_alpha) * src_alpha;
+            Vc::float_m mask = (new_alpha == zeroValue);
+            src_blend = src_alpha / new_alpha;
+            src_blend.setZero(mask);
+        }
+
+        if (!(src_blend == oneValue).isFull()) {
+            dst_c1 = src_blend * (src_c1 - dst_c1) + dst_c1;
+            dst_c2 = src_blend * (src_c2 - dst_c2) + dst_c2;
+            dst_c3 = src_blend * (src_c3 - dst_c3) + dst_c3;
+        } else {
+            dst_c1 = src_c1;
+            dst_c2 = src_c2;
+            dst_c3 = src_c3;
+        }
+
+        KoStreamedMath<_impl>::write_channels_64(dst, new_alpha * unitValue, dst_c1, dst_c2, dst_c3);
+    }
+
+    template <bool haveMask, Vc::Implementation _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const OptionalParams &oparams)
+    {
+        using namespace Arithmetic;
+        const qint32 alpha_pos = 3;
+
+        const channels_type *s = reinterpret_cast<const channels_type*>(src);
+        channels_type *d = reinterpret_cast<channels_type*>(dst);
+
+        const float unitValue = KoColorSpaceMathsTraits<channels_type>::unitValue;
+        const float unitValueRec1 = 1.0f / unitValue;
+
+        float srcAlpha = s[alpha_pos] * unitValueRec1;
+        srcAlpha *= opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0 / 255.0;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha != 0.0) {
+
+            float dstAlpha = d[alpha_pos] * unitValueRec1;
+            float srcBlendNorm;
+
+            if (dstAlpha == 1.0) {
+                srcBlendNorm = srcAlpha;
+            } else if (dstAlpha == 0.0) {
+                dstAlpha = srcAlpha;
+                srcBlendNorm = 1.0;
+
+                if (!allChannelsFlag) {
+                    KoStreamedMathFunctions::clearPixel<8>(dst);
+                }
+            } else {
+                dstAlpha += (1.0 - dstAlpha) * srcAlpha;
+                srcBlendNorm = srcAlpha / dstAlpha;
+            }
+
+            if (allChannelsFlag) {
+                if (srcBlendNorm == 1.0) {
+                    if (!alphaLocked) {
+                        KoStreamedMathFunctions::copyPixel<8>(src, dst);
+                    } else {
+                        d[0] = s[0];
+                        d[1] = s[1];
+                        d[2] = s[2];
+                    }
+                } else if (srcBlendNorm != 0.0){
+                    d[0] = lerpChannel(d[0], s[0], srcBlendNorm);
+                    d[1] = lerpChannel(d[1], s[1], srcBlendNorm);
+                    d[2] = lerpChannel(d[2], s[2], srcBlendNorm);
+                }
+            } else {
+                const QBitArray &channelFlags = oparams.channelFlags;
+
+                if (srcBlendNorm == 1.0) {
+                    if(channelFlags.at(0)) d[0] = s[0];
+                    if(channelFlags.at(1)) d[1] = s[1];
+                    if(channelFlags.at(2)) d[2] = s[2];
+                } else if (srcBlendNorm != 0.0) {
+                    if(channelFlags.at(0)) d[0] = lerpChannel(d[0], s[0], srcBlendNorm);
+                    if(channelFlags.at(1)) d[1] = lerpChannel(d[1], s[1], srcBlendNorm);
+                    if(channelFlags.at(2)) d[2] = lerpChannel(d[2], s[2], srcBlendNorm);
+                }
+            }
+
+            if (!alphaLocked) {
+                d[alpha_pos] = channels_type(dstAlpha * unitValue + 0.5f);
+            }
+        }
+    }
+
+    static inline channels_type lerpChannel(channels_type a, channels_type b, float alpha) {
+        return channels_type((float(b) - float(a)) * alpha + float(a) + 0.5f);
+    }
+};
+
+/**
+ * An optimized version of a composite op for the use in 8 byte
+ * colorspaces with alpha channel placed at the last channel of
+ * the pixel: C1_C2_C3_A.
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpOver64(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, i18n("Normal"), KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    virtual void composite(const KoCompositeOp::ParameterInfo& params) const
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor64<quint16, quint64, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor64<quint16, quint64, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor64<quint16, quint64, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor64<quint16, quint64, true, false> >(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPOVER64_H_
@@ -0,0 +1,264 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KOSTREAMED_BLEND_FUNCTIONS_H
+#define __KOSTREAMED_BLEND_FUNCTIONS_H
+
+#include "KoStreamedMath.h"
+
+/**
+ * Vectorized versions of the separable blending functions from
+ * KoCompositeOpFunctions.h
+ *
+ * All the functions work with the channel values normalized to the
+ * unit range, that is 1.0 corresponds to unitValue of the channel type.
+ * The behavior of the functions (including clamping and the special
+ * cases) follows their scalar counterparts, so the results differ
+ * only in rounding.
+ *
+ * Everything is templated by the Vc implementation to avoid mixing up
+ * the code generated for different architectures by the linker.
+ */
+
+/**
+ * Constants of the channel type the blending is done for
+ */
+template<Vc::Implementation _impl>
+struct KoStreamedBlendValues
+{
+    KoStreamedBlendValues(float halfValue, float minValue, float maxValue)
+        : zero(Vc::Zero),
+          unit(Vc::One),
+          half(halfValue),
+          min(minValue),
+          max(maxValue)
+    {
+    }
+
+    /**
+     * Clamps the value into the range of the channel type, the same
+     * way as Arithmetic::clamp() does
+     */
+    inline Vc::float_v clamp(Vc::float_v::AsArg x) const {
+        return Vc::min(Vc::max(x, min), max);
+    }
+
+    const Vc::float_v zero;
+    const Vc::float_v unit;
+    const Vc::float_v half;
+    const Vc::float_v min;
+    const Vc::float_v max;
+};
+
+#define DECLARE_STREAMED_BLEND_FUNCTION(name)                                     \
+    template<Vc::Implementation _impl>                                            \
+    struct name {                                                                 \
+        static ALWAYS_INLINE Vc::float_v apply(Vc::float_v::AsArg src,            \
+                                               Vc::float_v::AsArg dst,            \
+                                               const KoStreamedBlendValues<_impl> &v); \
+    };                                                                            \
+    template<Vc::Implementation _impl>                                            \
+    Vc::float_v name<_impl>::apply(Vc::float_v::AsArg src,                        \
+                                   Vc::float_v::AsArg dst,                        \
+                                   const KoStreamedBlendValues<_impl> &v)
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendMultiply)
+{
+    Q_UNUSED(v);
+    return src * dst;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendScreen)
+{
+    Q_UNUSED(v);
+    return src + dst - src * dst;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendDarkenOnly)
+{
+    Q_UNUSED(v);
+    return Vc::min(src, dst);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendLightenOnly)
+{
+    Q_UNUSED(v);
+    return Vc::max(src, dst);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendAddition)
+{
+    return v.clamp(src + dst);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendSubtract)
+{
+    return v.clamp(dst - src);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendInverseSubtract)
+{
+    return v.clamp(dst - (v.unit - src));
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendDifference)
+{
+    Q_UNUSED(v);
+    return Vc::abs(src - dst);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendEquivalence)
+{
+    Q_UNUSED(v);
+    return Vc::abs(dst - src);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendExclusion)
+{
+    Vc::float_v x = src * dst;
+    return v.clamp(dst + src - (x + x));
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendLinearBurn)
+{
+    return v.clamp(src + dst - v.unit);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendLinearLight)
+{
+    return v.clamp(src + src + dst - v.unit);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendGrainMerge)
+{
+    return v.clamp(dst + src - v.half);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendGrainExtract)
+{
+    return v.clamp(dst - src + v.half);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendAllanon)
+{
+    return (src + dst) * v.half;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendPinLight)
+{
+    Vc::float_v src2 = src + src;
+    Vc::float_v a = Vc::min(dst, src2);
+    return Vc::max(src2 - v.unit, a);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendHardLight)
+{
+    Vc::float_v src2 = src + src;
+
+    // multiply(src*2.0, dst)
+    Vc::float_v result = v.clamp(src2 * dst);
+
+    // screen(src*2.0 - 1.0, dst)
+    src2 -= v.unit;
+    result(src > v.half) = (src2 + dst) - src2 * dst;
+
+    return result;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendOverlay)
+{
+    return KoStreamedBlendHardLight<_impl>::apply(dst, src, v);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendColorDodge)
+{
+    Vc::float_v invSrc = v.unit - src;
+    Vc::float_v result = v.clamp(dst / invSrc);
+
+    result(invSrc < dst) = v.unit;
+    result(dst == v.zero) = v.zero;
+
+    return result;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendColorBurn)
+{
+    Vc::float_v invDst = v.unit - dst;
+    Vc::float_v result = v.unit - v.clamp(invDst / src);
+
+    result(src < invDst) = v.zero;
+    result(dst == v.unit) = v.unit;
+
+    return result;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendHardMix)
+{
+    Vc::float_v result = KoStreamedBlendColorBurn<_impl>::apply(src, dst, v);
+    result(dst > v.half) = KoStreamedBlendColorDodge<_impl>::apply(src, dst, v);
+    return result;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendDivide)
+{
+    Vc::float_v result = v.clamp(dst / src);
+
+    const Vc::float_m srcIsZero = src == v.zero;
+    result(srcIsZero) = v.zero;
+    result(srcIsZero && dst != v.zero) = v.unit;
+
+    return result;
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendSoftLight)
+{
+    const Vc::float_v src2 = src + src;
+
+    Vc::float_v result = dst - (v.unit - src2) * dst * (v.unit - dst);
+    result(src > Vc::float_v(0.5f)) = dst + (src2 - v.unit) * (Vc::sqrt(dst) - dst);
+
+    return v.clamp(result);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendSoftLightSvg)
+{
+    const Vc::float_v src2 = src + src;
+
+    Vc::float_v D = Vc::sqrt(dst);
+    D(dst <= Vc::float_v(0.25f)) = ((Vc::float_v(16.0f) * dst - Vc::float_v(12.0f)) * dst + Vc::float_v(4.0f)) * dst;
+
+    Vc::float_v result = dst - (v.unit - src2) * dst * (v.unit - dst);
+    result(src > Vc::float_v(0.5f)) = dst + (src2 - v.unit) * (D - dst);
+
+    return v.clamp(result);
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendGeometricMean)
+{
+    return v.clamp(Vc::sqrt(dst * src));
+}
+
+DECLARE_STREAMED_BLEND_FUNCTION(KoStreamedBlendAdditiveSubtractive)
+{
+    return v.clamp(Vc::abs(Vc::sqrt(dst) - Vc::sqrt(src)));
+}
+
+#undef DECLARE_STREAMED_BLEND_FUNCTION
+
+#endif /* __KOSTREAMED_BLEND_FUNCTIONS_H */
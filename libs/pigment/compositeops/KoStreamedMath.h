@@ -33,6 +33,7 @@
 #endif
 
 #include <stdint.h>
+#include <limits>
 #include <KoAlwaysInline.h>
 #include <iostream>
 
@@ -93,6 +94,12 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite_novector<useMask, useFlow, Compositor, 4>(params);
 }
 
+template<bool useMask, bool useFlow, class Compositor>
+    static void genericComposite64_novector(const KoCompositeOp::ParameterInfo& params)
+{
+    genericComposite_novector<useMask, useFlow, Compositor, 8>(params);
+}
+
 template<bool useMask, bool useFlow, class Compositor>
     static void genericComposite128_novector(const KoCompositeOp::ParameterInfo& params)
 {
@@ -248,6 +255,170 @@ static inline void write_channels_32(quint8 *data,
     *((Vc::uint_v*)data) = v1 | v3;
 }
 
+/**
+ * Get all the channels from Vc::float_v::Size pixels 64-bit each
+ * (4 channels, 16 bit per channel). The alpha value is considered to
+ * be stored in the last channel of the pixel. The order of the color
+ * channels follows fetch_all_32(): \p c1 is fetched from the third
+ * channel, \p c3 from the first one.
+ *
+ * The pixels are gathered with 32-bit granularity, so \p data
+ * needs no alignment except on the pixel borders.
+ */
+static inline void fetch_all_64(const quint8 *data,
+                                Vc::float_v &alpha,
+                                Vc::float_v &c1,
+                                Vc::float_v &c2,
+                                Vc::float_v &c3) {
+
+    const quint32 *words = reinterpret_cast<const quint32*>(data);
+    const Vc::uint_v::IndexType indexes(Vc::IndexesFromZero);
+
+    // every pixel consists of two words: (c3 | c2 << 16) and (c1 | alpha << 16)
+    Vc::uint_v low(words, indexes * 2);
+    Vc::uint_v high(words, indexes * 2 + 1);
+
+    const quint32 lowWordMask = 0xFFFF;
+    Vc::uint_v mask(lowWordMask);
+
+    alpha = Vc::float_v(Vc::int_v(high >> 16));
+    c1 = Vc::float_v(Vc::int_v(high & mask));
+    c2 = Vc::float_v(Vc::int_v(low >> 16));
+    c3 = Vc::float_v(Vc::int_v(low & mask));
+}
+
+/**
+ * Pack color and alpha values to Vc::float_v::Size pixels 64-bit each
+ * (4 channels, 16 bit per channel). The layout of the channels is the
+ * same as in fetch_all_64(). The values are rounded to the nearest
+ * integer.
+ */
+static inline void write_channels_64(quint8 *data,
+                                     Vc::float_v::AsArg alpha,
+                                     Vc::float_v::AsArg c1,
+                                     Vc::float_v::AsArg c2,
+                                     Vc::float_v::AsArg c3) {
+
+    quint32 *words = reinterpret_cast<quint32*>(data);
+    const Vc::uint_v::IndexType indexes(Vc::IndexesFromZero);
+
+    const quint32 lowWordMask = 0xFFFF;
+    Vc::uint_v mask(lowWordMask);
+
+    Vc::uint_v high = (Vc::uint_v(Vc::int_v(Vc::round(alpha))) << 16) |
+        (Vc::uint_v(Vc::int_v(Vc::round(c1))) & mask);
+
+    Vc::uint_v low = (Vc::uint_v(Vc::int_v(Vc::round(c2))) << 16) |
+        (Vc::uint_v(Vc::int_v(Vc::round(c3))) & mask);
+
+    low.scatter(words, indexes * 2);
+    high.scatter(words, indexes * 2 + 1);
+}
+
+/**
+ * Fetches \p numPixels RGBA pixels with channels of type \p channels_type
+ * and splits them into per-channel vectors. The channels are returned
+ * in the order they are stored in the pixel, the values are not
+ * normalized. The lanes beyond \p numPixels are filled with zeroes.
+ *
+ * The data is fetched with unaligned instructions, so \p data only
+ * needs to be aligned on the channel size.
+ */
+template <typename channels_type>
+static inline void fetch_channels_rgba(const quint8 *data, int numPixels,
+                                       Vc::float_v &c0,
+                                       Vc::float_v &c1,
+                                       Vc::float_v &c2,
+                                       Vc::float_v &alpha) {
+
+    const int vectorSize = Vc::float_v::Size;
+
+    if (sizeof(channels_type) == 1 && numPixels == vectorSize) {
+        Vc::uint_v data_i;
+        data_i.load((const quint32*)data, Vc::Unaligned);
+
+        const quint32 lowByteMask = 0xFF;
+        Vc::uint_v mask(lowByteMask);
+
+        c0 = Vc::float_v(Vc::int_v( data_i        & mask));
+        c1 = Vc::float_v(Vc::int_v((data_i >> 8)  & mask));
+        c2 = Vc::float_v(Vc::int_v((data_i >> 16) & mask));
+        alpha = Vc::float_v(Vc::int_v(data_i >> 24));
+        return;
+    }
+
+    const channels_type *p = reinterpret_cast<const channels_type*>(data);
+    float buf[4][vectorSize];
+
+    for (int i = 0; i < vectorSize; i++) {
+        const bool valid = i < numPixels;
+
+        buf[0][i] = valid ? float(p[0]) : 0.0f;
+        buf[1][i] = valid ? float(p[1]) : 0.0f;
+        buf[2][i] = valid ? float(p[2]) : 0.0f;
+        buf[3][i] = valid ? float(p[3]) : 0.0f;
+
+        if (valid) {
+            p += 4;
+        }
+    }
+
+    c0.load(buf[0], Vc::Unaligned);
+    c1.load(buf[1], Vc::Unaligned);
+    c2.load(buf[2], Vc::Unaligned);
+    alpha.load(buf[3], Vc::Unaligned);
+}
+
+/**
+ * Writes \p numPixels RGBA pixels with channels of type \p channels_type.
+ * The channel values must be in the native range of \p channels_type,
+ * integer values are rounded to the nearest integer.
+ *
+ * The data is stored with unaligned instructions, so \p data only
+ * needs to be aligned on the channel size.
+ */
+template <typename channels_type>
+static inline void write_channels_rgba(quint8 *data, int numPixels,
+                                       Vc::float_v::AsArg c0,
+                                       Vc::float_v::AsArg c1,
+                                       Vc::float_v::AsArg c2,
+                                       Vc::float_v::AsArg alpha) {
+
+    const int vectorSize = Vc::float_v::Size;
+
+    if (sizeof(channels_type) == 1 && numPixels == vectorSize) {
+        const quint32 lowByteMask = 0xFF;
+        Vc::uint_v mask(lowByteMask);
+
+        Vc::uint_v v1 = Vc::uint_v(Vc::int_v(Vc::round(alpha))) << 24;
+        Vc::uint_v v2 = (Vc::uint_v(Vc::int_v(Vc::round(c2))) & mask) << 16;
+        Vc::uint_v v3 = (Vc::uint_v(Vc::int_v(Vc::round(c1))) & mask) <<  8;
+        v1 = v1 | v2;
+        Vc::uint_v v4 = Vc::uint_v(Vc::int_v(Vc::round(c0))) & mask;
+        v3 = v3 | v4;
+
+        (v1 | v3).store((quint32*)data, Vc::Unaligned);
+        return;
+    }
+
+    float buf[4][vectorSize];
+    c0.store(buf[0], Vc::Unaligned);
+    c1.store(buf[1], Vc::Unaligned);
+    c2.store(buf[2], Vc::Unaligned);
+    alpha.store(buf[3], Vc::Unaligned);
+
+    const float rounding = std::numeric_limits<channels_type>::is_integer ? 0.5f : 0.0f;
+    channels_type *p = reinterpret_cast<channels_type*>(data);
+
+    for (int i = 0; i < numPixels; i++) {
+        p[0] = channels_type(buf[0][i] + rounding);
+        p[1] = channels_type(buf[1][i] + rounding);
+        p[2] = channels_type(buf[2][i] + rounding);
+        p[3] = channels_type(buf[3][i] + rounding);
+        p += 4;
+    }
+}
+
 /**
  * Composes src pixels into dst pixles. Is optimized for 32-bit-per-pixel
  * colorspaces. Uses \p Compositor strategy parameter for doing actual
@@ -415,6 +586,12 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite<useMask, useFlow, Compositor, 4>(params);
 }
 
+template<bool useMask, bool useFlow, class Compositor>
+    static void genericComposite64(const KoCompositeOp::ParameterInfo& params)
+{
+    genericComposite<useMask, useFlow, Compositor, 8>(params);
+}
+
 template<bool useMask, bool useFlow, class Compositor>
     static void genericComposite128(const KoCompositeOp::ParameterInfo& params)
 {
@@ -438,6 +615,13 @@ ALWAYS_INLINE void clearPixel<4>(quint8* dst)
     *d = 0;
 }
 
+template<>
+ALWAYS_INLINE void clearPixel<8>(quint8* dst)
+{
+    quint64 *d = reinterpret_cast<quint64*>(dst);
+    *d = 0;
+}
+
 template<>
 ALWAYS_INLINE void clearPixel<16>(quint8* dst)
 {
@@ -460,6 +644,14 @@ ALWAYS_INLINE void copyPixel<4>(const quint8 *src, quint8* dst)
     *d = *s;
 }
 
+template<>
+ALWAYS_INLINE void copyPixel<8>(const quint8 *src, quint8* dst)
+{
+    const quint64 *s = reinterpret_cast<const quint64*>(src);
+    quint64 *d = reinterpret_cast<quint64*>(dst);
+    *d = *s;
+}
+
 template<>
 ALWAYS_INLINE void copyPixel<16>(const quint8 *src, quint8* dst)
 {
@@ -0,0 +1,349 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "TestKoOptimizedCompositeOps.h"
+
+#include <QTest>
+
+#include <KoColorSpaceTraits.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
+#include <KoOptimizedCompositeOpFactory.h>
+
+#include "compositeops/KoCompositeOpGeneric.h"
+#include "compositeops/KoCompositeOpOver.h"
+#include "compositeops/KoCompositeOpAlphaDarken.h"
+#include "compositeops/KoCompositeOpCopy2.h"
+#include "compositeops/KoCompositeOpFunctions.h"
+
+
+template<class Traits>
+KoCompositeOp* createScalarGenericOp(const KoColorSpace *cs, const QString &id)
+{
+    typedef typename Traits::channels_type Arg;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<Traits, &cfMultiply<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfScreen<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSC<Traits, &cfOverlay<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfSubtract<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<Traits, &cfDifference<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_EXCLUSION) {
+        return new KoCompositeOpGenericSC<Traits, &cfExclusion<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_GRAIN_MERGE) {
+        return new KoCompositeOpGenericSC<Traits, &cfGrainMerge<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_LINEAR_LIGHT) {
+        return new KoCompositeOpGenericSC<Traits, &cfLinearLight<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoCompositeOpGenericSC<Traits, &cfColorDodge<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_BURN) {
+        return new KoCompositeOpGenericSC<Traits, &cfColorBurn<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_HARD_MIX) {
+        return new KoCompositeOpGenericSC<Traits, &cfHardMix<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_DIVIDE) {
+        return new KoCompositeOpGenericSC<Traits, &cfDivide<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoCompositeOpGenericSC<Traits, &cfSoftLight<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_SOFT_LIGHT_SVG) {
+        return new KoCompositeOpGenericSC<Traits, &cfSoftLightSvg<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_PIN_LIGHT) {
+        return new KoCompositeOpGenericSC<Traits, &cfPinLight<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_GEOMETRIC_MEAN) {
+        return new KoCompositeOpGenericSC<Traits, &cfGeometricMean<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_ADDITIVE_SUBTRACTIVE) {
+        return new KoCompositeOpGenericSC<Traits, &cfAdditiveSubtractive<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_INVERSE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfInverseSubtract<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_EQUIVALENCE) {
+        return new KoCompositeOpGenericSC<Traits, &cfEquivalence<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_LINEAR_BURN) {
+        return new KoCompositeOpGenericSC<Traits, &cfLinearBurn<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_GRAIN_EXTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfGrainExtract<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoCompositeOpGenericSC<Traits, &cfHardLight<Arg> >(cs, id, id, QString());
+    } else if (id == COMPOSITE_ALLANON) {
+        return new KoCompositeOpGenericSC<Traits, &cfAllanon<Arg> >(cs, id, id, QString());
+    }
+
+    return 0;
+}
+
+void addGenericOpsRows()
+{
+    QTest::addColumn<QString>("id");
+    QTest::addColumn<bool>("useMask");
+    QTest::addColumn<bool>("alphaLocked");
+    QTest::addColumn<bool>("constantSource");
+
+    QStringList ids;
+    ids << COMPOSITE_MULT
+        << COMPOSITE_SCREEN
+        << COMPOSITE_OVERLAY
+        << COMPOSITE_ADD
+        << COMPOSITE_SUBTRACT
+        << COMPOSITE_DIFF
+        << COMPOSITE_DARKEN
+        << COMPOSITE_LIGHTEN
+        << COMPOSITE_EXCLUSION
+        << COMPOSITE_GRAIN_MERGE
+        << COMPOSITE_LINEAR_LIGHT
+        << COMPOSITE_DODGE
+        << COMPOSITE_BURN
+        << COMPOSITE_HARD_MIX
+        << COMPOSITE_DIVIDE
+        << COMPOSITE_SOFT_LIGHT_PHOTOSHOP
+        << COMPOSITE_SOFT_LIGHT_SVG
+        << COMPOSITE_PIN_LIGHT
+        << COMPOSITE_GEOMETRIC_MEAN
+        << COMPOSITE_ADDITIVE_SUBTRACTIVE
+        << COMPOSITE_INVERSE_SUBTRACT
+        << COMPOSITE_EQUIVALENCE
+        << COMPOSITE_LINEAR_BURN
+        << COMPOSITE_GRAIN_EXTRACT
+        << COMPOSITE_HARD_LIGHT
+        << COMPOSITE_ALLANON;
+
+    Q_FOREACH (const QString &id, ids) {
+        QTest::newRow(QString("%1").arg(id).toLatin1()) << id << false << false << false;
+        QTest::newRow(QString("%1-mask").arg(id).toLatin1()) << id << true << false << false;
+        QTest::newRow(QString("%1-locked").arg(id).toLatin1()) << id << true << true << false;
+        QTest::newRow(QString("%1-const").arg(id).toLatin1()) << id << false << false << true;
+    }
+}
+
+/**
+ * Composites the same random data with the scalar op and with its
+ * vectorized version and checks that the results differ only in
+ * rounding. The number of columns is not a multiple of the vector
+ * size to cover the processing of the row tails.
+ *
+ * The \p tolerance (a fraction of the unit value) is applied to the
+ * alpha channel and to the colors premultiplied by the resulting
+ * alpha. The integer scalar ops divide the blended color by the new
+ * alpha, which scales their rounding error by 1 / alpha, so a fixed
+ * tolerance would fail for the almost transparent pixels only.
+ */
+template<class Traits>
+void compareOps(const KoCompositeOp *scalarOp, const KoCompositeOp *optimizedOp,
+                bool useMask, bool alphaLocked, bool constantSource,
+                qreal tolerance)
+{
+    typedef typename Traits::channels_type channels_type;
+    typedef KoColorSpaceMathsTraits<channels_type> MathsTraits;
+
+    QVERIFY(scalarOp);
+    QVERIFY(optimizedOp);
+
+    const int rows = 7;
+    const int cols = 67;
+    const int numChannels = rows * cols * Traits::channels_nb;
+
+    QVector<channels_type> src(numChannels);
+    QVector<channels_type> dst(numChannels);
+    QVector<quint8> mask(rows * cols);
+
+    qsrand(1);
+
+    for (int i = 0; i < numChannels; i++) {
+        src[i] = channels_type(qreal(qrand()) / RAND_MAX * MathsTraits::unitValue);
+        dst[i] = channels_type(qreal(qrand()) / RAND_MAX * MathsTraits::unitValue);
+    }
+
+    for (int i = 0; i < mask.size(); i++) {
+        mask[i] = qrand() % 256;
+    }
+
+    // check the special values of alpha and mask as well
+    for (int i = 0; i < cols; i += 5) {
+        dst[i * Traits::channels_nb + Traits::alpha_pos] = MathsTraits::zeroValue;
+        src[(i + 1) * Traits::channels_nb + Traits::alpha_pos] = MathsTraits::zeroValue;
+        dst[(i + 2) * Traits::channels_nb + Traits::alpha_pos] = MathsTraits::unitValue;
+        mask[i + 3] = 255;
+    }
+
+    QVector<channels_type> scalarDst = dst;
+    QVector<channels_type> optimizedDst = dst;
+
+    KoCompositeOp::ParameterInfo params;
+    params.srcRowStart = reinterpret_cast<const quint8*>(src.constData());
+    params.srcRowStride = constantSource ? 0 : cols * Traits::pixelSize;
+    params.dstRowStride = cols * Traits::pixelSize;
+    params.maskRowStart = useMask ? mask.constData() : 0;
+    params.maskRowStride = useMask ? cols : 0;
+    params.rows = rows;
+    params.cols = cols;
+    params.opacity = 0.7f;
+
+    if (alphaLocked) {
+        QBitArray flags(Traits::channels_nb, true);
+        flags.clearBit(Traits::alpha_pos);
+        params.channelFlags = flags;
+    }
+
+    params.dstRowStart = reinterpret_cast<quint8*>(scalarDst.data());
+    scalarOp->composite(params);
+
+    params.dstRowStart = reinterpret_cast<quint8*>(optimizedDst.data());
+    optimizedOp->composite(params);
+
+    for (int i = 0; i < numChannels; i++) {
+        const int alphaIndex = i - i % Traits::channels_nb + Traits::alpha_pos;
+        const qreal alpha = qreal(scalarDst[alphaIndex]) / MathsTraits::unitValue;
+
+        qreal maxDifference = tolerance * MathsTraits::unitValue;
+        if (i != alphaIndex && !alphaLocked) {
+            maxDifference /= qMax(alpha, tolerance);
+        }
+
+        const qreal difference = qAbs(qreal(scalarDst[i]) - qreal(optimizedDst[i]));
+
+        if (difference > maxDifference) {
+            qDebug() << "Channel:" << i << "src:" << src[i] << "dst:" << dst[i]
+                     << "scalar:" << scalarDst[i] << "optimized:" << optimizedDst[i];
+            QFAIL("The results of the scalar and the optimized ops differ");
+        }
+    }
+}
+
+template<class Traits>
+void testGenericOp(qreal tolerance)
+{
+    QFETCH(QString, id);
+    QFETCH(bool, useMask);
+    QFETCH(bool, alphaLocked);
+    QFETCH(bool, constantSource);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KoCompositeOp *scalarOp = createScalarGenericOp<Traits>(cs, id);
+    KoCompositeOp *optimizedOp = 0;
+
+    switch (Traits::pixelSize) {
+    case 4:
+        optimizedOp = KoOptimizedCompositeOpFactory::createGenericOp32(createScalarGenericOp<Traits>(cs, id));
+        break;
+    case 8:
+        optimizedOp = KoOptimizedCompositeOpFactory::createGenericOp64(createScalarGenericOp<Traits>(cs, id));
+        break;
+    case 16:
+        optimizedOp = KoOptimizedCompositeOpFactory::createGenericOp128(createScalarGenericOp<Traits>(cs, id));
+        break;
+    }
+
+    compareOps<Traits>(scalarOp, optimizedOp, useMask, alphaLocked, constantSource, tolerance);
+
+    delete scalarOp;
+    delete optimizedOp;
+}
+
+void TestKoOptimizedCompositeOps::testGenericU8_data()
+{
+    addGenericOpsRows();
+}
+
+void TestKoOptimizedCompositeOps::testGenericU8()
+{
+    testGenericOp<KoBgrU8Traits>(2.0 / 255.0);
+}
+
+void TestKoOptimizedCompositeOps::testGenericU16_data()
+{
+    addGenericOpsRows();
+}
+
+void TestKoOptimizedCompositeOps::testGenericU16()
+{
+    testGenericOp<KoBgrU16Traits>(4.0 / 65535.0);
+}
+
+void TestKoOptimizedCompositeOps::testGenericF32_data()
+{
+    addGenericOpsRows();
+}
+
+void TestKoOptimizedCompositeOps::testGenericF32()
+{
+    testGenericOp<KoRgbF32Traits>(1e-4);
+}
+
+void TestKoOptimizedCompositeOps::testU16Ops_data()
+{
+    QTest::addColumn<QString>("id");
+    QTest::addColumn<bool>("useMask");
+    QTest::addColumn<bool>("alphaLocked");
+    QTest::addColumn<bool>("constantSource");
+
+    QStringList ids;
+    ids << COMPOSITE_OVER
+        << COMPOSITE_ALPHA_DARKEN
+        << COMPOSITE_COPY;
+
+    Q_FOREACH (const QString &id, ids) {
+        QTest::newRow(QString("%1").arg(id).toLatin1()) << id << false << false << false;
+        QTest::newRow(QString("%1-mask").arg(id).toLatin1()) << id << true << false << false;
+        QTest::newRow(QString("%1-const").arg(id).toLatin1()) << id << true << false << true;
+
+        // alpha darken ignores the channel flags
+        if (id != COMPOSITE_ALPHA_DARKEN) {
+            QTest::newRow(QString("%1-locked").arg(id).toLatin1()) << id << true << true << false;
+        }
+    }
+}
+
+void TestKoOptimizedCompositeOps::testU16Ops()
+{
+    QFETCH(QString, id);
+    QFETCH(bool, useMask);
+    QFETCH(bool, alphaLocked);
+    QFETCH(bool, constantSource);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+
+    KoCompositeOp *scalarOp = 0;
+    KoCompositeOp *optimizedOp = 0;
+
+    if (id == COMPOSITE_OVER) {
+        scalarOp = new KoCompositeOpOver<KoBgrU16Traits>(cs);
+        optimizedOp = KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    } else if (id == COMPOSITE_ALPHA_DARKEN) {
+        scalarOp = new KoCompositeOpAlphaDarken<KoBgrU16Traits>(cs);
+        optimizedOp = KoOptimizedCompositeOpFactory::createAlphaDarkenOp64(cs);
+    } else if (id == COMPOSITE_COPY) {
+        scalarOp = new KoCompositeOpCopy2<KoBgrU16Traits>(cs);
+        optimizedOp = KoOptimizedCompositeOpFactory::createCopyOp64(cs);
+    }
+
+    compareOps<KoBgrU16Traits>(scalarOp, optimizedOp, useMask, alphaLocked, constantSource, 4.0 / 65535.0);
+
+    delete scalarOp;
+    delete optimizedOp;
+}
+
+QTEST_GUILESS_MAIN(TestKoOptimizedCompositeOps)
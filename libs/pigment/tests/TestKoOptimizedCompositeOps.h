@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TEST_KO_OPTIMIZED_COMPOSITE_OPS_H
+#define __TEST_KO_OPTIMIZED_COMPOSITE_OPS_H
+
+#include <QObject>
+
+class TestKoOptimizedCompositeOps : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testGenericU8_data();
+    void testGenericU8();
+
+    void testGenericU16_data();
+    void testGenericU16();
+
+    void testGenericF32_data();
+    void testGenericF32();
+
+    void testU16Ops_data();
+    void testU16Ops();
+};
+
+#endif /* __TEST_KO_OPTIMIZED_COMPOSITE_OPS_H */
@@ -150,6 +150,7 @@ bool KoStore::open(const QString & _name)
             return false;
     } else if (d->mode == Read) {
         debugStore << "Opening for reading" << d->fileName;
+        d->rawDataOffset = -1;
         if (!openRead(d->fileName))
             return false;
     } else
@@ -265,6 +266,22 @@ qint64 KoStore::size() const
     return d->size;
 }
 
+qint64 KoStore::rawDataOffset() const
+{
+    Q_D(const KoStore);
+    if (!d->isOpen) {
+        warnStore << "You must open before asking for a raw data offset";
+        return static_cast<qint64>(-1);
+    }
+    return d->rawDataOffset;
+}
+
+QString KoStore::localFileName() const
+{
+    Q_D(const KoStore);
+    return d->localFileName;
+}
+
 bool KoStore::enterDirectory(const QString &directory)
 {
     Q_D(KoStore);
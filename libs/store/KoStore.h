@@ -164,6 +164,22 @@ public:
      */
     qint64 size() const;
 
+    /**
+     * @return the offset of the currently opened file inside the
+     * local file of the store, if the file is kept there as is, i.e.
+     * stored without compression. Returns -1 otherwise. Only the ZIP
+     * backend opened on a local file in Read mode supports it.
+     *
+     * @see localFileName()
+     */
+    qint64 rawDataOffset() const;
+
+    /**
+     * @return the name of the local file the store works on. Empty
+     * if the store has been created on a device.
+     */
+    QString localFileName() const;
+
     /**
      * @return true if an error occurred
      */
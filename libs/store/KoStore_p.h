@@ -38,6 +38,7 @@ public:
         window(0),
         mode(_mode),
         size(0),
+        rawDataOffset(-1),
         stream(0),
         isOpen(false),
         good(false),
@@ -90,6 +91,8 @@ public:
     QString fileName;
     /// Current size of the file named m_sName
     qint64 size;
+    /// The offset of the current file in localFileName, if stored uncompressed
+    qint64 rawDataOffset;
 
     /// The stream for the current read or write operation
     QIODevice *stream;
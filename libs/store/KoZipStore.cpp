@@ -162,6 +162,15 @@ bool KoZipStore::openRead(const QString& name)
     delete d->stream;
     d->stream = f->createDevice();
     d->size = f->size();
+
+    /**
+     * The data of the stored entries can be read directly from
+     * the file, e.g. by mapping it into memory
+     */
+    if (f->encoding() == 0 && !d->localFileName.isEmpty()) {
+        d->rawDataOffset = f->position();
+    }
+
     return true;
 }
 
@@ -69,6 +69,8 @@
 #include <QSize>
 #include <QStringList>
 #include <QtGlobal>
+#include <QtConcurrent>
+#include <QFutureWatcher>
 #include <QTimer>
 #include <QWidget>
 
@@ -268,7 +270,9 @@ public:
         imageIdleWatcher(2000 /*ms*/),
         kraLoader(0),
         suppressProgress(false),
-        fileProgressProxy(0)
+        fileProgressProxy(0),
+        backgroundSaveDocument(0),
+        isSaveSnapshot(false)
     {
         if (QLocale().measurementSystem() == QLocale::ImperialSystem) {
             unit = KoUnit::Inch;
@@ -363,6 +367,22 @@ public:
     QList<KisPaintingAssistantSP> assistants;
     KisGridConfig gridConfig;
 
+    /**
+     * The snapshot document being autosaved in background and the
+     * watcher of the saving thread
+     */
+    KisDocument *backgroundSaveDocument;
+    QFutureWatcher<bool> backgroundSaveWatcher;
+    QMetaObject::Connection backgroundSaveProgressConnection;
+
+    /**
+     * True for the snapshot documents created for background saving.
+     * They have no views, so the active nodes are copied from the
+     * original document
+     */
+    bool isSaveSnapshot;
+    vKisNodeSP snapshotActiveNodes;
+
     bool openFile() {
         document->setFileProgressProxy();
         document->setUrl(m_url);
@@ -501,6 +521,8 @@ KisDocument::KisDocument()
     connect(&d->autoSaveTimer, SIGNAL(timeout()), this, SLOT(slotAutoSave()));
     setAutoSave(defaultAutoSave());
 
+    connect(&d->backgroundSaveWatcher, SIGNAL(finished()), this, SLOT(slotBackgroundAutoSaveFinished()));
+
     setObjectName(newObjectName());
 
     d->docInfo = new KoDocumentInfo(this);
@@ -540,6 +562,12 @@ KisDocument::~KisDocument()
     d->autoSaveTimer.disconnect(this);
     d->autoSaveTimer.stop();
 
+    if (d->backgroundSaveDocument) {
+        d->backgroundSaveWatcher.waitForFinished();
+        delete d->backgroundSaveDocument;
+        d->backgroundSaveDocument = 0;
+    }
+
     delete d->filterManager;
 
     // Despite being QObject they needs to be deleted before the image
@@ -828,6 +856,8 @@ void KisDocument::slotAutoSave()
         if (d->specialOutputFlag == SaveEncrypted && d->password.isNull()) {
             // That advice should also fix this error from occurring again
             emit statusBarMessage(i18n("The password of this encrypted document is not known. Autosave aborted! Please save your work manually."));
+        } else if (KisConfig().backgroundAutoSave()) {
+            startBackgroundAutoSave();
         } else {
             connect(this, SIGNAL(sigProgress(int)), KisPart::instance()->currentMainwindow(), SLOT(slotProgress(int)));
             emit statusBarMessage(i18n("Autosaving..."));
@@ -848,6 +878,151 @@ void KisDocument::slotAutoSave()
     }
 }
 
+inline void collectNodes(KisNodeSP node, vKisNodeSP &nodes)
+{
+    nodes.append(node);
+
+    node = node->firstChild();
+    while (node) {
+        collectNodes(node, nodes);
+        node = node->nextSibling();
+    }
+}
+
+KisDocument* KisDocument::cloneForBackgroundSaving() const
+{
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setAutoSave(0);
+    doc->setFileBatchMode(true);
+    doc->setOutputMimeType(d->outputMimeType, d->specialOutputFlag);
+    doc->setUrl(url());
+
+    doc->d->password = d->password;
+    doc->d->isAutosaving = true;
+    doc->d->isSaveSnapshot = true;
+
+    /**
+     * We don't use setCurrentImage() here, because the snapshot is
+     * not going to be shown: it needs neither the projection refresh
+     * nor the idle watcher
+     */
+    doc->d->image = d->image->clone();
+
+    /**
+     * The assistants can be edited by the user while the snapshot is
+     * being saved, so the saving thread should get its own copies
+     */
+    QMap<KisPaintingAssistantHandleSP, KisPaintingAssistantHandleSP> handleMap;
+    Q_FOREACH (KisPaintingAssistantSP assistant, d->assistants) {
+        KisPaintingAssistantSP copy = assistant->clone(handleMap);
+        if (copy) {
+            doc->d->assistants.append(copy);
+        }
+    }
+
+    doc->d->gridConfig = d->gridConfig;
+    doc->d->guidesConfig = d->guidesConfig;
+
+    QDomDocument info = createDomDocument("document-info", "document-info", "1.1");
+    doc->d->docInfo->load(d->docInfo->save(info));
+
+    doc->d->snapshotActiveNodes =
+        findClonedNodes(d->image->root(), doc->d->image->root(), activeNodes());
+
+    return doc;
+}
+
+vKisNodeSP KisDocument::findClonedNodes(KisNodeSP srcRoot, KisNodeSP dstRoot,
+                                        const vKisNodeSP &nodes)
+{
+    vKisNodeSP srcNodes;
+    vKisNodeSP dstNodes;
+    collectNodes(srcRoot, srcNodes);
+    collectNodes(dstRoot, dstNodes);
+
+    vKisNodeSP result;
+    KIS_ASSERT_RECOVER_RETURN_VALUE(srcNodes.size() == dstNodes.size(), result);
+
+    Q_FOREACH (KisNodeSP node, nodes) {
+        const int index = srcNodes.indexOf(node);
+        if (index >= 0) {
+            result.append(dstNodes[index]);
+        }
+    }
+
+    return result;
+}
+
+void KisDocument::startBackgroundAutoSave()
+{
+    // the previous autosave is still being written, try next time
+    if (d->backgroundSaveDocument) return;
+
+    {
+        /**
+         * The image is locked only while the snapshot is created. The
+         * locker handles the busy image the same way as the blocking
+         * autosave does: it retries in a few seconds.
+         */
+        d->isAutosaving = true;
+        Private::SafeSavingLocker locker(d);
+        d->isAutosaving = false;
+
+        if (!locker.successfullyLocked()) return;
+
+        d->backgroundSaveDocument = cloneForBackgroundSaving();
+    }
+
+    KisDocument *doc = d->backgroundSaveDocument;
+    KisMainWindow *mainWindow = KisPart::instance()->currentMainwindow();
+
+    connect(doc, SIGNAL(sigProgress(int)), this, SIGNAL(sigProgress(int)));
+    if (mainWindow) {
+        d->backgroundSaveProgressConnection =
+            connect(this, SIGNAL(sigProgress(int)), mainWindow, SLOT(slotProgress(int)));
+    }
+
+    emit statusBarMessage(i18n("Autosaving..."));
+
+    /**
+     * All the changes made after this moment will be saved by the
+     * next autosave, the timer will be restarted by setModified()
+     */
+    d->modifiedAfterAutosave = false;
+    d->autoSaveTimer.stop();
+
+    d->backgroundSaveWatcher.setFuture(
+        QtConcurrent::run(std::bind(&KisDocument::saveNativeFormatImpl, doc,
+                                    autoSaveFile(localFilePath()))));
+}
+
+void KisDocument::slotBackgroundAutoSaveFinished()
+{
+    KisDocument *doc = d->backgroundSaveDocument;
+    KIS_ASSERT_RECOVER_RETURN(doc);
+
+    d->backgroundSaveDocument = 0;
+
+    const bool ret = d->backgroundSaveWatcher.result();
+
+    emit sigProgress(100);
+    disconnect(d->backgroundSaveProgressConnection);
+    emit clearStatusBarMessage();
+
+    if (!ret) {
+        errKrita << "Background autosave failed:" << doc->errorMessage();
+
+        d->modifiedAfterAutosave = true;
+        setAutoSave(d->autoSaveDelay);
+
+        if (!d->disregardAutosaveFailure) {
+            emit statusBarMessage(i18n("Error during autosave! Partition full?"));
+        }
+    }
+
+    delete doc;
+}
+
 void KisDocument::setReadWrite(bool readwrite)
 {
     d->readwrite = readwrite;
@@ -883,6 +1058,11 @@ bool KisDocument::saveNativeFormat(const QString & file)
     Private::SafeSavingLocker locker(d);
     if (!locker.successfullyLocked()) return false;
 
+    return saveNativeFormatImpl(file);
+}
+
+bool KisDocument::saveNativeFormatImpl(const QString & file)
+{
     d->lastErrorMessage.clear();
     //dbgUI <<"Saving to store";
 
@@ -955,6 +1135,15 @@ bool KisDocument::saveNativeFormatCalligra(KoStore *store)
         (void)store->close();
     }
 
+    /**
+     * The snapshots are saved in background, so their progress is
+     * reported to the status bar. Writing the layers takes the most
+     * of the time.
+     */
+    if (d->isSaveSnapshot) {
+        emit sigProgress(10);
+    }
+
     if (!d->isAutosaving) {
         if (store->open("preview.png")) {
             // ### TODO: missing error checking (The partition could be full!)
@@ -967,6 +1156,11 @@ bool KisDocument::saveNativeFormatCalligra(KoStore *store)
         delete store;
         return false;
     }
+
+    if (d->isSaveSnapshot) {
+        emit sigProgress(90);
+    }
+
     dbgUI << "Saving done of url:" << url().url();
     if (!store->finalize()) {
         delete store;
@@ -2316,6 +2510,10 @@ KoShapeLayer* KisDocument::shapeForNode(KisNodeSP layer) const
 
 vKisNodeSP KisDocument::activeNodes() const
 {
+    if (d->isSaveSnapshot) {
+        return d->snapshotActiveNodes;
+    }
+
     vKisNodeSP nodes;
     Q_FOREACH (KisView *v, KisPart::instance()->views()) {
         if (v->document() == this && v->viewManager()) {
@@ -605,6 +605,7 @@ private:
 
     friend class KisPart;
     friend class SafeSavingLocker;
+    friend class KisKraSaverTest;
 
     /**
      * Generate a name for the document.
@@ -710,6 +711,8 @@ private Q_SLOTS:
 
     void slotAutoSave();
 
+    void slotBackgroundAutoSaveFinished();
+
     /// Called by the undo stack when undo or redo is called
     void slotUndoStackIndexChanged(int idx);
 
@@ -804,6 +807,29 @@ private:
 
     bool saveToStream(QIODevice *dev);
 
+    bool saveNativeFormatImpl(const QString & file);
+
+    /**
+     * Creates a document with a copy-on-write clone of the image for
+     * saving it in a background thread. The image should be locked.
+     */
+    KisDocument* cloneForBackgroundSaving() const;
+
+    /**
+     * Finds the counterparts of \p nodes in the graph \p dstRoot,
+     * cloned from \p srcRoot. The cloned graph has exactly the same
+     * structure as the original one, so the nodes are matched by their
+     * position in it.
+     */
+    static vKisNodeSP findClonedNodes(KisNodeSP srcRoot, KisNodeSP dstRoot,
+                                      const vKisNodeSP &nodes);
+
+    /**
+     * Autosaves a snapshot of the document in a background thread,
+     * the image is blocked only while the snapshot is taken
+     */
+    void startBackgroundAutoSave();
+
     bool loadNativeFormatFromStoreInternal(KoStore *store);
 
     bool savePreview(KoStore *store);
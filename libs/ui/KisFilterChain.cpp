@@ -199,6 +199,13 @@ void KisFilterChain::prependChainLink(KisFilterEntrySP filterEntry, const QByteA
     m_chainLinks.prepend(new ChainLink(this, filterEntry, from, to));
 }
 
+void KisFilterChain::createFilters()
+{
+    for (ChainLink *link = m_chainLinks.first(); link; link = m_chainLinks.next()) {
+        link->createFilter();
+    }
+}
+
 QString KisFilterChain::filterManagerImportFile() const
 {
     return m_manager->importFile();
@@ -128,6 +128,10 @@ private:
 
     void prependChainLink(KisFilterEntrySP filterEntry, const QByteArray& from, const QByteArray& to);
 
+    // Creates the filters of all the links in advance, used by
+    // KisImportExportManager::prepareExport()
+    void createFilters();
+
     // These methods are friends of KisFilterManager and provide access
     // to a private part of its API. As I don't want to include
     // koFilterManager.h in this header the direction is "int" here.
@@ -62,6 +62,14 @@ namespace CalligraFilter {
     }
 
     ChainLink::~ChainLink() {
+        delete m_filter;
+    }
+
+    void ChainLink::createFilter()
+    {
+        if (m_filter || !m_filterEntry) return;
+
+        m_filter = m_filterEntry->createFilter(m_chain);
     }
 
     KisImportExportFilter::ConversionStatus ChainLink::invokeFilter()
@@ -71,7 +79,10 @@ namespace CalligraFilter {
             return KisImportExportFilter::FilterEntryNull;
         }
 
-        m_filter = m_filterEntry->createFilter(m_chain);
+        const bool temporaryFilter = !m_filter;
+        if (temporaryFilter) {
+            m_filter = m_filterEntry->createFilter(m_chain);
+        }
 
         if (!m_filter) {
             errFile << "Couldn't create the filter." << endl;
@@ -85,8 +96,10 @@ namespace CalligraFilter {
         }
 
         KisImportExportFilter::ConversionStatus status = m_filter->convert(m_from, m_to);
-        delete m_filter;
-        m_filter = 0;
+        if (temporaryFilter) {
+            delete m_filter;
+            m_filter = 0;
+        }
         if (m_updater) {
             m_updater->setProgress(100);
         }
@@ -39,6 +39,13 @@ public:
 
     ~ChainLink();
 
+    /**
+     * Creates the filter of the link in advance. The filter is then
+     * reused by all the following calls to invokeFilter() and deleted
+     * together with the link.
+     */
+    void createFilter();
+
     KisImportExportFilter::ConversionStatus invokeFilter();
 
     QByteArray from() const {
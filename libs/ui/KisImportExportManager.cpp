@@ -58,6 +58,9 @@ public:
     QByteArray importMimeType;
     QWeakPointer<KoProgressUpdater> progressUpdater;
 
+    KisFilterChainSP preparedExportChain;
+    QByteArray preparedExportMimeType;
+
     Private(KoProgressUpdater *progressUpdater_ = 0)
         : progressUpdater(progressUpdater_)
     {
@@ -164,13 +167,42 @@ QString KisImportExportManager::importDocument(const QString& location,
 
 KisImportExportFilter::ConversionStatus KisImportExportManager::exportDocument(const QString& location, QByteArray& mimeType)
 {
-    bool userCancelled = false;
-
     // The import url should already be set correctly (null if we have a KisDocument
     // file manager and to the correct URL if we have an embedded manager)
     m_direction = Export; // vital information!
     m_exportFileName = location;
 
+    if (d->preparedExportChain && mimeType == d->preparedExportMimeType) {
+        return d->preparedExportChain->invokeChain();
+    }
+
+    KisImportExportFilter::ConversionStatus status = KisImportExportFilter::OK;
+    KisFilterChainSP chain = createExportChain(mimeType, status);
+
+    return chain ? chain->invokeChain() : status;
+}
+
+KisImportExportFilter::ConversionStatus KisImportExportManager::prepareExport(QByteArray& mimeType)
+{
+    m_direction = Export;
+
+    KisImportExportFilter::ConversionStatus status = KisImportExportFilter::OK;
+    KisFilterChainSP chain = createExportChain(mimeType, status);
+
+    if (chain) {
+        chain->createFilters();
+    }
+
+    d->preparedExportChain = chain;
+    d->preparedExportMimeType = mimeType;
+
+    return status;
+}
+
+KisFilterChainSP KisImportExportManager::createExportChain(QByteArray& mimeType, KisImportExportFilter::ConversionStatus& status)
+{
+    bool userCancelled = false;
+
     KisFilterChainSP chain;
 
     if (m_document) {
@@ -197,7 +229,8 @@ KisImportExportFilter::ConversionStatus KisImportExportManager::exportDocument(c
         if (!d->batch && !userCancelled) {
             QMessageBox::critical(0, i18nc("@title:window", "Krita"), i18n("Could not export file: the export filter is missing."));
         }
-        return KisImportExportFilter::BadConversionGraph;
+        status = KisImportExportFilter::BadConversionGraph;
+        return KisFilterChainSP();
     }
 
     if (!chain)  {  // already set when coming from the m_document case
@@ -210,10 +243,11 @@ KisImportExportFilter::ConversionStatus KisImportExportManager::exportDocument(c
             QMessageBox::critical(0, i18nc("@title:window", "Krita"), i18n("Could not export file: the export filter is missing."));
         }
         QApplication::restoreOverrideCursor();
-        return KisImportExportFilter::BadConversionGraph;
+        status = KisImportExportFilter::BadConversionGraph;
+        return KisFilterChainSP();
     }
 
-    return chain->invokeChain();
+    return chain;
 }
 
 // The static method to figure out to which parts of the
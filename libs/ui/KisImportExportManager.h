@@ -102,6 +102,17 @@ public:
      */
     KisImportExportFilter::ConversionStatus exportDocument(const QString& location, QByteArray& mimeType);
 
+    /**
+     * Builds the filter chain for exporting the document to @p mimeType
+     * and creates its filters. All the following calls to exportDocument()
+     * with the same mime type reuse them, so they don't touch the plugin
+     * loaders and the GUI and can be done from a worker thread, as long
+     * as nobody else uses the document meanwhile.
+     *
+     * Must be called from the GUI thread.
+     */
+    KisImportExportFilter::ConversionStatus prepareExport(QByteArray& mimeType);
+
     ///@name Static API
     //@{
     /**
@@ -163,6 +174,8 @@ private:
 
     void importErrorHelper(const QString& mimeType, const bool suppressDialog = false);
 
+    KisFilterChainSP createExportChain(QByteArray& mimeType, KisImportExportFilter::ConversionStatus& status);
+
     KisDocument *m_document;
     QString m_importFileName;
     QString m_exportFileName;
@@ -94,7 +94,14 @@ public:
 
     KisSignalCompressor playbackStatisticsCompressor;
 
+    /**
+     * The number of frames ahead of the playhead the frame cache
+     * prepares in the background
+     */
+    static const int PREFETCH_FRAMES = 8;
+
     void stopImpl(bool doUpdates);
+    void prefetchFrames(int frame);
 
     int incFrame(int frame, int inc) {
         frame += inc;
@@ -206,6 +213,20 @@ void KisAnimationPlayer::play()
     connectCancelSignals();
 }
 
+void KisAnimationPlayer::Private::prefetchFrames(int frame)
+{
+    if (!canvas->frameCache()) return;
+
+    QVector<int> times;
+
+    for (int i = 0; i < PREFETCH_FRAMES; i++) {
+        frame = incFrame(frame, 1);
+        times.append(frame);
+    }
+
+    canvas->frameCache()->prefetchFrames(times);
+}
+
 void KisAnimationPlayer::Private::stopImpl(bool doUpdates)
 {
     q->disconnectCancelSignals();
@@ -213,6 +234,11 @@ void KisAnimationPlayer::Private::stopImpl(bool doUpdates)
     timer->stop();
     playing = false;
 
+    if (canvas->frameCache()) {
+        // let the cache compress the prefetched frames back
+        canvas->frameCache()->prefetchFrames(QVector<int>());
+    }
+
     if (doUpdates) {
         canvas->refetchDataFromImage();
     }
@@ -282,6 +308,10 @@ void KisAnimationPlayer::uploadFrame(int frame)
     if (m_d->canvas->frameCache() && m_d->canvas->frameCache()->uploadFrame(frame)) {
         m_d->canvas->updateCanvas();
 
+        if (m_d->playing) {
+            m_d->prefetchFrames(frame);
+        }
+
         m_d->useFastFrameUpload = true;
         emit sigFrameChanged();
     } else {
@@ -348,6 +348,7 @@ KisDisplayColorConverter::conversionFlags()
 
     if (cfg.useBlackPointCompensation()) conversionFlags |= KoColorConversionTransformation::BlackpointCompensation;
     if (!cfg.allowLCMSOptimization()) conversionFlags |= KoColorConversionTransformation::NoOptimization;
+    if (cfg.useLutDisplayConversion()) conversionFlags |= KoColorConversionTransformation::PrecomputedLut;
 
     return conversionFlags;
 }
@@ -493,6 +493,21 @@ void KisImagePyramid::alignSourceRect(QRect& rect, qreal scale)
     dbgRender << "After alignment:\t" << rect;
 }
 
+void KisImagePyramid::prefetchRect(const QRect &imageRect, qreal scale)
+{
+    if (m_pyramid.isEmpty() || imageRect.isEmpty()) return;
+
+    qint32 index = findFirstGoodPlaneIndex(scale, imageRect.size());
+    qreal planeScale = SCALE_FROM_INDEX(index);
+
+    QRect planeRect =
+        QRectF(imageRect.x() * planeScale, imageRect.y() * planeScale,
+               imageRect.width() * planeScale, imageRect.height() * planeScale)
+        .toAlignedRect();
+
+    m_pyramid[index]->dataManager()->prefetchTiles(planeRect);
+}
+
 KisImagePatch KisImagePyramid::getNearestPatch(KisPPUpdateInfoSP info)
 {
     qint32 index = findFirstGoodPlaneIndex(qMax(info->scaleX, info->scaleY),
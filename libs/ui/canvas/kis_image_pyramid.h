@@ -72,6 +72,7 @@ public:
                    const QRect& unscaledSourceRect);
 
     void alignSourceRect(QRect& rect, qreal scale);
+    void prefetchRect(const QRect &imageRect, qreal scale);
 
 private:
 
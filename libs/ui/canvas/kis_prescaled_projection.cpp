@@ -189,6 +189,27 @@ void KisPrescaledProjection::viewportMoved(const QPointF &offset)
     }
 
     m_d->prescaledQImage = newImage;
+
+    /**
+     * The user will most probably continue scrolling in the same
+     * direction, so ask the backend to prepare the data that will
+     * be exposed on the next move
+     */
+    if (!m_d->image) return;
+
+    qreal scaleX, scaleY;
+    m_d->coordinatesConverter->imageScale(&scaleX, &scaleY);
+
+    QRegion nextRegion = newViewportRect.translated(-alignedOffset);
+    nextRegion -= newViewportRect;
+
+    Q_FOREACH (const QRect &rect, nextRegion.rects()) {
+        QRect imageRect =
+            m_d->coordinatesConverter->viewportToImage(rect).toAlignedRect();
+        imageRect &= m_d->image->bounds();
+
+        m_d->projectionBackend->prefetchRect(imageRect, qMax(scaleX, scaleY));
+    }
 }
 
 void KisPrescaledProjection::slotImageSizeChanged(qint32 w, qint32 h)
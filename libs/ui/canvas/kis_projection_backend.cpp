@@ -27,3 +27,9 @@ void KisProjectionBackend::alignSourceRect(QRect& rect, qreal scale)
     Q_UNUSED(rect);
     Q_UNUSED(scale);
 }
+
+void KisProjectionBackend::prefetchRect(const QRect &imageRect, qreal scale)
+{
+    Q_UNUSED(imageRect);
+    Q_UNUSED(scale);
+}
@@ -70,6 +70,15 @@ public:
      */
     virtual void alignSourceRect(QRect& rect, qreal scale);
 
+    /**
+     * Hints the backend that the area \p imageRect will most
+     * probably be requested with \p scale soon (e.g. the user is
+     * scrolling the canvas in this direction). The backend may
+     * start loading the corresponding data in background.
+     * The default implementation does nothing.
+     */
+    virtual void prefetchRect(const QRect &imageRect, qreal scale);
+
     /**
      * Gets a patch from a backend that can draw a info.imageRect on some
      * QPainter in future. info.scaleX and info.scaleY are the scales
@@ -17,6 +17,8 @@
  */
 #include "kis_update_info.h"
 
+#include "tiles3/swap/kis_compression_registry.h"
+
 /**
  * The connection in KisCanvas2 uses queued signals
  * with an argument of KisNodeSP type, so we should
@@ -100,3 +102,66 @@ int KisOpenGLUpdateInfo::levelOfDetail() const
 {
     return m_levelOfDetail;
 }
+
+void KisOpenGLUpdateInfo::compressData(const QString &compressionId)
+{
+    QMutexLocker l(&m_dataMutex);
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionRegistry::instance()->create(compressionId));
+
+    KIS_ASSERT_RECOVER_RETURN(compression);
+
+    m_compressionId = compressionId;
+
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, tileList) {
+        tileInfo->compressData(compression.data());
+    }
+}
+
+void KisOpenGLUpdateInfo::decompressData()
+{
+    QMutexLocker l(&m_dataMutex);
+
+    if (m_compressionId.isEmpty()) return;
+
+    QScopedPointer<KisAbstractCompression> compression(
+        KisCompressionRegistry::instance()->create(m_compressionId));
+
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, tileList) {
+        tileInfo->decompressData(compression.data());
+    }
+}
+
+void KisOpenGLUpdateInfo::releaseDecompressedData()
+{
+    QMutexLocker l(&m_dataMutex);
+
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, tileList) {
+        tileInfo->releaseDecompressedData();
+    }
+}
+
+bool KisOpenGLUpdateInfo::isDecompressed() const
+{
+    QMutexLocker l(&m_dataMutex);
+
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, tileList) {
+        if (tileInfo->valid() && !tileInfo->isDecompressed()) return false;
+    }
+
+    return true;
+}
+
+qint64 KisOpenGLUpdateInfo::memoryUsage() const
+{
+    QMutexLocker l(&m_dataMutex);
+
+    qint64 size = 0;
+
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, tileList) {
+        size += tileInfo->memoryUsage();
+    }
+
+    return size;
+}
@@ -20,6 +20,7 @@
 #define KIS_UPDATE_INFO_H_
 
 #include <QPainter>
+#include <QMutex>
 
 #include "kis_image_patch.h"
 #include "kis_shared.h"
@@ -82,10 +83,30 @@ public:
 
     int levelOfDetail() const;
 
+    /**
+     * Compresses the pixel data of all the tiles with the backend \p
+     * compressionId of KisCompressionRegistry. Before the info can be
+     * uploaded to the textures the data should be decompressed with
+     * decompressData(). The methods are thread-safe.
+     */
+    void compressData(const QString &compressionId);
+    void decompressData();
+    void releaseDecompressedData();
+    bool isDecompressed() const;
+
+    /**
+     * The number of bytes occupied by the pixel data of the tiles,
+     * both compressed and decompressed
+     */
+    qint64 memoryUsage() const;
+
 private:
     QRect m_dirtyImageRect;
     ConversionOptions m_options;
     int m_levelOfDetail;
+
+    QString m_compressionId;
+    mutable QMutex m_dataMutex;
 };
 
 
@@ -60,8 +60,16 @@ struct KisAnimationCachePopulator::Private
     KisOpenGLUpdateInfoSP requestInfo;
     KisSignalAutoConnectionsStore imageRequestConnections;
 
-    QFutureWatcher<void> infoConversionWatcher;
+    /**
+     * The conversion of a received frame is pipelined with the
+     * regeneration of the next one, so the frame being converted is
+     * stored separately from the requested one
+     */
+    int convertedFrame;
+    KisAnimationFrameCacheSP convertedCache;
+    KisOpenGLUpdateInfoSP convertedInfo;
 
+    QFutureWatcher<void> infoConversionWatcher;
 
 
     enum State {
@@ -80,16 +88,21 @@ struct KisAnimationCachePopulator::Private
           part(_part),
           idleCounter(0),
           requestedFrame(-1),
+          convertedFrame(-1),
           state(WaitingForIdle)
     {
         timer.setSingleShot(true);
         connect(&infoConversionWatcher, SIGNAL(finished()), q, SLOT(slotInfoConverted()));
     }
 
-    static void processFrameInfo(KisOpenGLUpdateInfoSP info) {
+    static void processFrameInfo(KisOpenGLUpdateInfoSP info, const QString &compressionId) {
         if (info->needsConversion()) {
             info->convertColorSpace();
         }
+
+        if (!compressionId.isEmpty()) {
+            info->compressData(compressionId);
+        }
     }
 
     void frameReceived(int frame)
@@ -108,18 +121,52 @@ struct KisAnimationCachePopulator::Private
         emit q->sigPrivateStartWaitingForConvertedFrame();
     }
 
+    bool isConversionRunning() const {
+        return convertedInfo.data();
+    }
+
+    void startConversion() {
+        KIS_ASSERT_RECOVER_RETURN(requestInfo && requestCache);
+        KIS_ASSERT_RECOVER_RETURN(!isConversionRunning());
+
+        convertedFrame = requestedFrame;
+        convertedCache = requestCache;
+        convertedInfo = requestInfo;
+
+        requestedFrame = -1;
+        requestCache = 0;
+        requestInfo = 0;
+
+        QFuture<void> requestFuture =
+            QtConcurrent::run(
+                std::bind(&KisAnimationCachePopulator::Private::processFrameInfo,
+                          convertedInfo,
+                          convertedCache->compressionId()));
+
+        infoConversionWatcher.setFuture(requestFuture);
+
+        /**
+         * The next frame can be regenerated while this one is being
+         * converted
+         */
+        enterState(BetweenFrames);
+    }
+
     void infoConverted() {
-        KIS_ASSERT_RECOVER(requestInfo && requestCache) {
+        KIS_ASSERT_RECOVER(convertedInfo && convertedCache) {
             enterState(WaitingForIdle);
             return;
         }
 
-        requestCache->addConvertedFrameData(requestInfo, requestedFrame);
+        convertedCache->addConvertedFrameData(convertedInfo, convertedFrame);
 
-        requestedFrame = 0;
-        requestCache = 0;
-        requestInfo = 0;
-        enterState(BetweenFrames);
+        convertedFrame = -1;
+        convertedCache = 0;
+        convertedInfo = 0;
+
+        if (state == WaitingForConvertedFrame) {
+            startConversion();
+        }
     }
 
     void timerTimeout() {
@@ -224,6 +271,12 @@ struct KisAnimationCachePopulator::Private
 
         if (!animation->hasAnimation()) return false;
 
+        /**
+         * Every new frame would evict some other one, so the
+         * populator would never stop
+         */
+        if (cache->memoryLimitReached()) return false;
+
         if (currentRange.isValid()) {
             Q_ASSERT(!currentRange.isInfinite());
 
@@ -239,6 +292,10 @@ struct KisAnimationCachePopulator::Private
                     }
                 }
 
+                if (cache == convertedCache && frame == convertedFrame) {
+                    continue;
+                }
+
                 if (cache->frameStatus(frame) != KisAnimationFrameCache::Cached) {
                     return regenerate(cache, frame);
                 }
@@ -392,12 +449,13 @@ void KisAnimationCachePopulator::slotPrivateStartWaitingForConvertedFrame()
 {
     KIS_ASSERT_RECOVER_RETURN(m_d->requestInfo);
 
-    m_d->enterState(Private::WaitingForConvertedFrame);
-
-    QFuture<void> requestFuture =
-        QtConcurrent::run(
-            std::bind(&KisAnimationCachePopulator::Private::processFrameInfo,
-                        m_d->requestInfo));
-
-    m_d->infoConversionWatcher.setFuture(requestFuture);
+    if (m_d->isConversionRunning()) {
+        /**
+         * The previous frame is still being converted, the new one
+         * will be picked up by infoConverted()
+         */
+        m_d->enterState(Private::WaitingForConvertedFrame);
+    } else {
+        m_d->startConversion();
+    }
 }
@@ -19,10 +19,15 @@
 #include "kis_animation_exporter.h"
 
 #include <QDesktopServices>
-#include <QWaitCondition>
+#include <QMutex>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QtConcurrent>
 #include <KisMimeDatabase.h>
 #include <QEventLoop>
 
+#include <functional>
+
 #include "KoFileDialog.h"
 #include "KisDocument.h"
 #include "kis_image.h"
@@ -33,6 +38,9 @@
 #include "kis_group_layer.h"
 #include "kis_time_range.h"
 #include "kis_painter.h"
+#include "kis_paint_device.h"
+#include "kis_config.h"
+#include "kis_debug.h"
 
 struct KisAnimationExporterUI::Private
 {
@@ -79,56 +87,314 @@ KisImportExportFilter::ConversionStatus KisAnimationExporterUI::exportSequence(K
 
 struct KisAnimationExporter::Private
 {
+    /**
+     * Every renderer regenerates frames in its own copy of the image,
+     * so several frames are rendered simultaneously. The copies share
+     * the pixel data of the layers with the original image, so only
+     * the projections take extra memory.
+     */
+    struct FrameRenderer {
+        FrameRenderer() : time(-1) {}
+
+        KisImageSP image;
+        KisPaintDeviceSP buffer; // the rendered frame goes here, null when idle
+        int time;
+        QElapsedTimer renderTimer;
+        QElapsedTimer idleTimer;
+    };
+
+    /**
+     * Every encoder owns a document with a single layer, the frame is
+     * copied into it and saved by a separate filter chain in a worker
+     * thread. The chain and its filters are created in the GUI thread
+     * once per export and reused for all the frames.
+     */
+    struct FrameEncoder {
+        FrameEncoder() : document(0), manager(0), busy(false) {}
+
+        KisDocument *document;
+        KisImportExportManager *manager;
+        KisPaintDeviceSP device;
+        bool busy;
+        QFuture<void> future;
+    };
+
+    struct QueuedFrame {
+        int time;
+        KisPaintDeviceSP buffer;
+        QElapsedTimer queueTimer;
+    };
+
+    KisAnimationExporter *q;
     KisDocument *document;
     KisImageWSP image;
 
     QString filenamePrefix;
     QString filenameSuffix;
+    QByteArray outputMimeType;
 
     int firstFrame;
-    int currentFrame;
+    int nextFrame;
     int lastFrame;
+    int savedFrames;
+
+    QVector<FrameRenderer> renderers;
+    QVector<FrameEncoder> encoders;
 
-    QScopedPointer<KisDocument> tmpDoc;
-    KisImageWSP tmpImage;
-    KisPaintDeviceSP tmpDevice;
+    /**
+     * The frame buffers are allocated once and recycled, a renderer can
+     * start a new frame only when there is a free buffer for it. That
+     * keeps the memory consumption constant when the encoders are slower
+     * than the renderers.
+     */
+    QList<KisPaintDeviceSP> freeBuffers;
+    QQueue<QueuedFrame> encodingQueue;
 
     bool exporting;
     bool batchMode;
     KisImportExportFilter::ConversionStatus status;
 
+    QElapsedTimer totalTimer;
+    qint64 renderingTime;
+    qint64 stallingTime;
+    qint64 queueingTime;
+    qint64 encodingTime;
+
+    /**
+     * Protects everything accessed from the image worker threads in
+     * frameReadyToCopy() and from the encoder threads
+     */
     QMutex mutex;
-    QWaitCondition exportFinished;
 
-    Private(KisDocument *document, int fromTime, int toTime)
-        : document(document),
+    Private(KisAnimationExporter *_q, KisDocument *document, int fromTime, int toTime)
+        : q(_q),
+          document(document),
           image(document->image()),
           firstFrame(fromTime),
+          nextFrame(fromTime),
           lastFrame(toTime),
-          tmpDoc(KisPart::instance()->createDocument()),
+          savedFrames(0),
           exporting(false),
-          batchMode(false)
+          batchMode(false),
+          status(KisImportExportFilter::OK),
+          renderingTime(0),
+          stallingTime(0),
+          queueingTime(0),
+          encodingTime(0)
     {
-        tmpDoc->setAutoSave(0);
+    }
+
+    ~Private() {
+        destroyEncoders();
+    }
+
+    int numFrames() const {
+        return lastFrame - firstFrame + 1;
+    }
+
+    void createRenderers(int numRenderers) {
+        QVector<FrameRenderer> newRenderers(numRenderers);
+
+        KisImageSP sourceImage = image;
+        sourceImage->barrierLock();
+
+        for (int i = 0; i < numRenderers; i++) {
+            newRenderers[i].image = sourceImage->clone();
+            newRenderers[i].idleTimer.start();
+        }
+
+        sourceImage->unlock();
+
+        QMutexLocker l(&mutex);
+        renderers = newRenderers;
+    }
+
+    QVector<FrameRenderer> takeRenderers() {
+        QMutexLocker l(&mutex);
+
+        QVector<FrameRenderer> oldRenderers;
+        oldRenderers.swap(renderers);
+        return oldRenderers;
+    }
+
+    KisImportExportFilter::ConversionStatus createEncoders(int numEncoders) {
+        KisImageSP sourceImage = image;
+
+        destroyEncoders();
+        encoders.resize(numEncoders);
+
+        for (int i = 0; i < numEncoders; i++) {
+            KisDocument *doc = KisPart::instance()->createDocument();
+            doc->setAutoSave(0);
+            doc->setFileBatchMode(true);
+            doc->setOutputMimeType(outputMimeType);
+
+            KisImageSP tmpImage = new KisImage(doc->createUndoStore(),
+                                               sourceImage->bounds().width(),
+                                               sourceImage->bounds().height(),
+                                               sourceImage->colorSpace(),
+                                               QString());
+
+            tmpImage->setResolution(sourceImage->xRes(), sourceImage->yRes());
+            doc->setCurrentImage(tmpImage);
+
+            KisPaintLayer* paintLayer = new KisPaintLayer(tmpImage, "paint device", 255);
+            tmpImage->addNode(paintLayer, tmpImage->rootLayer(), KisLayerSP(0));
+
+            encoders[i].document = doc;
+            encoders[i].device = paintLayer->paintDevice();
+
+            /**
+             * Creating the filters touches the plugin loaders and may
+             * show error messages, so it is done here, in the GUI thread
+             */
+            KisImportExportManager *manager = new KisImportExportManager(doc);
+            manager->setBatchMode(true);
+            encoders[i].manager = manager;
+
+            QByteArray mimeType = outputMimeType;
+            KisImportExportFilter::ConversionStatus result = manager->prepareExport(mimeType);
+            if (result != KisImportExportFilter::OK) {
+                return result;
+            }
+        }
+
+        return KisImportExportFilter::OK;
+    }
+
+    void destroyEncoders() {
+        waitForEncoders();
+
+        Q_FOREACH (const FrameEncoder &encoder, encoders) {
+            delete encoder.manager;
+            delete encoder.document;
+        }
+        encoders.clear();
+    }
+
+    void waitForEncoders() {
+        for (int i = 0; i < encoders.size(); i++) {
+            encoders[i].future.waitForFinished();
+        }
+    }
+
+    void createBuffers(int numBuffers) {
+        KisImageSP sourceImage = image;
+
+        QMutexLocker l(&mutex);
+        for (int i = 0; i < numBuffers; i++) {
+            freeBuffers << new KisPaintDevice(sourceImage->colorSpace());
+        }
+    }
+
+    /**
+     * Starts regeneration of the next frames in all the idle renderers
+     * that can get a free buffer
+     */
+    void scheduleRendering() {
+        QVector<QPair<KisImageSP, int> > requests;
+
+        {
+            QMutexLocker l(&mutex);
+
+            for (int i = 0; i < renderers.size(); i++) {
+                FrameRenderer &renderer = renderers[i];
+                if (renderer.buffer) continue;
+                if (nextFrame > lastFrame || freeBuffers.isEmpty()) break;
+
+                stallingTime += renderer.idleTimer.elapsed();
+
+                renderer.buffer = freeBuffers.takeFirst();
+                renderer.time = nextFrame++;
+                renderer.renderTimer.start();
+
+                requests << qMakePair(renderer.image, renderer.time);
+            }
+        }
+
+        for (int i = 0; i < requests.size(); i++) {
+            KisImageSP rendererImage = requests[i].first;
+            rendererImage->animationInterface()->requestFrameRegeneration(requests[i].second, rendererImage->bounds());
+        }
+    }
+
+    /**
+     * Passes the queued frames to the idle encoders
+     */
+    void scheduleEncoding() {
+        for (int i = 0; i < encoders.size(); i++) {
+            int time = -1;
+
+            {
+                QMutexLocker l(&mutex);
+
+                FrameEncoder &encoder = encoders[i];
+                if (encoder.busy) continue;
+                if (encodingQueue.isEmpty()) break;
+
+                QueuedFrame frame = encodingQueue.dequeue();
+                queueingTime += frame.queueTimer.elapsed();
+
+                const QRect rc = image->bounds();
+                KisPainter::copyAreaOptimized(rc.topLeft(), frame.buffer, encoder.device, rc);
+                freeBuffers << frame.buffer;
+
+                encoder.busy = true;
+                time = frame.time;
+            }
 
-        tmpImage = new KisImage(tmpDoc->createUndoStore(),
-            image->bounds().width(),
-            image->bounds().height(),
-            image->colorSpace(),
-            QString());
+            encoders[i].future =
+                QtConcurrent::run(std::bind(&Private::encodeFrame, this, i, time));
+        }
+    }
+
+    QString frameFilename(int time) const {
+        QString frameNumber = QString("%1").arg(time, 4, 10, QChar('0'));
+        return filenamePrefix + frameNumber + filenameSuffix;
+    }
 
-        tmpImage->setResolution(image->xRes(), image->yRes());
-        tmpDoc->setCurrentImage(tmpImage);
+    /**
+     * Called from a worker thread. The document and the filter chain of
+     * the encoder are not touched by anyone else while the encoder is busy.
+     */
+    void encodeFrame(int index, int time) {
+        QElapsedTimer timer;
+        timer.start();
 
-        KisPaintLayer* paintLayer = new KisPaintLayer(tmpImage, "paint device", 255);
-        tmpImage->addNode(paintLayer, tmpImage->rootLayer(), KisLayerSP(0));
+        QByteArray mimeType = outputMimeType;
+        KisImportExportFilter::ConversionStatus result =
+            encoders[index].manager->exportDocument(frameFilename(time), mimeType);
 
-        tmpDevice = paintLayer->paintDevice();
+        {
+            QMutexLocker l(&mutex);
+
+            encodingTime += timer.elapsed();
+            encoders[index].busy = false;
+
+            if (result == KisImportExportFilter::OK) {
+                savedFrames++;
+            } else if (status == KisImportExportFilter::OK) {
+                status = KisImportExportFilter::InternalError;
+            }
+        }
+
+        emit q->sigFrameEncoded();
+    }
+
+    void dumpTimings(int numRenderers) const {
+        const int frames = qMax(1, savedFrames);
+
+        dbgFile << "Exported" << savedFrames << "frames in" << totalTimer.elapsed() << "ms";
+        dbgFile << "    renderers:" << numRenderers << "encoders:" << encoders.size();
+        dbgFile << "    rendering:" << renderingTime / frames << "ms per frame";
+        dbgFile << "    renderers waiting for buffers:" << stallingTime << "ms total";
+        dbgFile << "    waiting in the queue:" << queueingTime / frames << "ms per frame";
+        dbgFile << "    encoding:" << encodingTime / frames << "ms per frame";
     }
 };
 
 KisAnimationExporter::KisAnimationExporter(KisDocument *document, const QString &baseFilename, int fromTime, int toTime)
-    : m_d(new Private(document, fromTime, toTime))
+    : m_d(new Private(this, document, fromTime, toTime))
 {
     int baseLength = baseFilename.lastIndexOf(".");
     if (baseLength > -1) {
@@ -140,10 +406,10 @@ KisAnimationExporter::KisAnimationExporter(KisDocument *document, const QString
     m_d->batchMode = document->fileBatchMode();
 
     QString mimefilter = KisMimeDatabase::mimeTypeForFile(baseFilename);
-    m_d->tmpDoc->setOutputMimeType(mimefilter.toLatin1());
-    m_d->tmpDoc->setFileBatchMode(true);
+    m_d->outputMimeType = mimefilter.toLatin1();
 
     connect(this, SIGNAL(sigFrameReadyToSave()), this, SLOT(frameReadyToSave()), Qt::QueuedConnection);
+    connect(this, SIGNAL(sigFrameEncoded()), this, SLOT(frameEncoded()), Qt::QueuedConnection);
 }
 
 KisAnimationExporter::~KisAnimationExporter()
@@ -160,9 +426,40 @@ KisImportExportFilter::ConversionStatus KisAnimationExporter::exportAnimation()
     }
     m_d->status = KisImportExportFilter::OK;
     m_d->exporting = true;
-    m_d->currentFrame = m_d->firstFrame;
-    connect(m_d->image->animationInterface(), SIGNAL(sigFrameReady(int)), this, SLOT(frameReadyToCopy(int)), Qt::DirectConnection);
-    m_d->image->animationInterface()->requestFrameRegeneration(m_d->currentFrame, m_d->image->bounds());
+    m_d->nextFrame = m_d->firstFrame;
+    m_d->savedFrames = 0;
+    m_d->totalTimer.start();
+
+    if (m_d->numFrames() <= 0) {
+        stopExport();
+        return m_d->status;
+    }
+
+    KisConfig cfg;
+    const int numRenderers = qBound(1, cfg.animationRenderingClones(), m_d->numFrames());
+    const int numEncoders = qBound(1, cfg.animationExportEncoders(), m_d->numFrames());
+
+    KisImportExportFilter::ConversionStatus result = m_d->createEncoders(numEncoders);
+    if (result != KisImportExportFilter::OK) {
+        m_d->status = result;
+        stopExport();
+        return m_d->status;
+    }
+
+    m_d->createRenderers(numRenderers);
+
+    /**
+     * One buffer per renderer and one per encoder is enough to keep
+     * both the stages busy
+     */
+    m_d->createBuffers(numRenderers + numEncoders);
+
+    for (int i = 0; i < numRenderers; i++) {
+        connect(m_d->renderers[i].image->animationInterface(), SIGNAL(sigFrameReady(int)),
+                this, SLOT(frameReadyToCopy(int)), Qt::DirectConnection);
+    }
+
+    m_d->scheduleRendering();
 
     QEventLoop loop;
     loop.connect(this, SIGNAL(sigFinished()), SLOT(quit()));
@@ -177,7 +474,30 @@ void KisAnimationExporter::stopExport()
 
     m_d->exporting = false;
 
-    disconnect(m_d->image->animationInterface(), 0, this, 0);
+    QVector<Private::FrameRenderer> renderers = m_d->takeRenderers();
+    const int numRenderers = renderers.size();
+
+    Q_FOREACH (const Private::FrameRenderer &renderer, renderers) {
+        disconnect(renderer.image->animationInterface(), 0, this, 0);
+    }
+
+    /**
+     * The copies of the image will wait for their frames to be
+     * regenerated when destroyed. It should happen without holding the
+     * mutex, because frameReadyToCopy() takes it from the worker
+     * threads.
+     */
+    renderers.clear();
+
+    m_d->waitForEncoders();
+
+    {
+        QMutexLocker l(&m_d->mutex);
+        m_d->encodingQueue.clear();
+        m_d->freeBuffers.clear();
+    }
+
+    m_d->dumpTimings(numRenderers);
 
     if (!m_d->batchMode) {
         disconnect(m_d->document, SIGNAL(sigProgressCanceled()), this, SLOT(cancel()));
@@ -195,33 +515,63 @@ void KisAnimationExporter::cancel()
 
 void KisAnimationExporter::frameReadyToCopy(int time)
 {
-    if (time != m_d->currentFrame) return;
+    QMutexLocker l(&m_d->mutex);
+
+    for (int i = 0; i < m_d->renderers.size(); i++) {
+        Private::FrameRenderer &renderer = m_d->renderers[i];
+        if (renderer.time != time || !renderer.buffer) continue;
+
+        QRect rc = renderer.image->bounds();
+        KisPainter::copyAreaOptimized(rc.topLeft(), renderer.image->projection(), renderer.buffer, rc);
+
+        Private::QueuedFrame frame;
+        frame.time = time;
+        frame.buffer = renderer.buffer;
+        frame.queueTimer.start();
+        m_d->encodingQueue.enqueue(frame);
 
-    QRect rc = m_d->image->bounds();
-    KisPainter::copyAreaOptimized(rc.topLeft(), m_d->image->projection(), m_d->tmpDevice, rc);
+        m_d->renderingTime += renderer.renderTimer.elapsed();
+        renderer.idleTimer.start();
+        renderer.buffer = 0;
+        renderer.time = -1;
 
-    emit sigFrameReadyToSave();
+        emit sigFrameReadyToSave();
+        break;
+    }
 }
 
 void KisAnimationExporter::frameReadyToSave()
 {
-    QString frameNumber = QString("%1").arg(m_d->currentFrame, 4, 10, QChar('0'));
-    QString filename = m_d->filenamePrefix + frameNumber + m_d->filenameSuffix;
+    if (!m_d->exporting) return;
 
-    if (m_d->tmpDoc->exportDocument(QUrl::fromLocalFile(filename))) {
+    m_d->scheduleEncoding();
+    m_d->scheduleRendering();
+}
 
-        if (m_d->exporting && m_d->currentFrame < m_d->lastFrame) {
-            if (!m_d->batchMode) {
-                emit m_d->document->sigProgress((m_d->currentFrame - m_d->firstFrame) * 100 /
-                                                (m_d->lastFrame - m_d->firstFrame));
-            }
-            m_d->currentFrame++;
-            m_d->image->animationInterface()->requestFrameRegeneration(m_d->currentFrame, m_d->image->bounds());
-            return; //continue
-        }
-    } else {
-        //error
-        m_d->status = KisImportExportFilter::InternalError;
+void KisAnimationExporter::frameEncoded()
+{
+    if (!m_d->exporting) return;
+
+    int savedFrames = 0;
+    KisImportExportFilter::ConversionStatus status;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+        savedFrames = m_d->savedFrames;
+        status = m_d->status;
     }
-    stopExport(); //finish
+
+    if (status != KisImportExportFilter::OK ||
+        savedFrames >= m_d->numFrames()) {
+
+        stopExport(); //finish
+        return;
+    }
+
+    if (!m_d->batchMode) {
+        emit m_d->document->sigProgress(savedFrames * 100 / m_d->numFrames());
+    }
+
+    m_d->scheduleEncoding();
+    m_d->scheduleRendering();
 }
@@ -54,11 +54,13 @@ public:
 Q_SIGNALS:
     // Internal, used for getting back to main thread
     void sigFrameReadyToSave();
+    void sigFrameEncoded();
     void sigFinished();
 
 private Q_SLOTS:
     void frameReadyToCopy(int time);
     void frameReadyToSave();
+    void frameEncoded();
     void cancel();
 
 private:
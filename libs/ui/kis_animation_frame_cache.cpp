@@ -19,8 +19,12 @@
 #include "kis_animation_frame_cache.h"
 
 #include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QtConcurrent>
 
 #include "kis_debug.h"
+#include "kis_config.h"
 
 #include "kis_image.h"
 #include "kis_image_animation_interface.h"
@@ -29,18 +33,35 @@
 #include "kis_animation_cache_populator.h"
 
 #include "opengl/kis_opengl_image_textures.h"
+#include "kis_update_info.h"
+#include "kis_image_config.h"
+#include "tiles3/swap/kis_compression_registry.h"
 
 
 struct KisAnimationFrameCache::Private
 {
     Private(KisOpenGLImageTexturesSP _textures)
-        : textures(_textures)
+        : textures(_textures),
+          useCounter(0)
     {
         image = textures->image();
+
+        KisConfig cfg;
+        memoryLimit = qint64(cfg.animationCacheMemoryLimit()) * 1024 * 1024;
+
+        if (cfg.animationCacheCompression()) {
+            KisImageConfig imageCfg;
+            compressionId = imageCfg.swapCompression();
+
+            if (!KisCompressionRegistry::instance()->contains(compressionId)) {
+                compressionId = KisCompressionRegistry::fallbackId();
+            }
+        }
     }
 
     ~Private()
     {
+        prefetchFuture.waitForFinished();
         qDeleteAll(frames);
     }
 
@@ -52,13 +73,115 @@ struct KisAnimationFrameCache::Private
         KisOpenGLUpdateInfoSP openGlFrame;
         int length;
 
-        Frame(KisOpenGLUpdateInfoSP info, int length)
-            : openGlFrame(info), length(length)
+        /**
+         * The value of the use counter when the frame was shown or
+         * added the last time. The least recently used frames are
+         * evicted first.
+         */
+        quint64 lastUsed;
+
+        Frame(KisOpenGLUpdateInfoSP info, int length, quint64 lastUsed)
+            : openGlFrame(info), length(length), lastUsed(lastUsed)
         {}
     };
 
     QMap<int, Frame*> frames;
 
+    qint64 memoryLimit;
+    QString compressionId;
+    quint64 useCounter;
+
+    KisOpenGLUpdateInfoSP lastUploadedFrame;
+    QFuture<void> prefetchFuture;
+
+    /**
+     * Several frames may share the same info after a part of the
+     * range has been invalidated, so the memory and the last usage
+     * are calculated per info
+     */
+    QHash<KisOpenGLUpdateInfo*, quint64> lastUsedInfos() const
+    {
+        QHash<KisOpenGLUpdateInfo*, quint64> infos;
+
+        Q_FOREACH (Frame *frame, frames) {
+            quint64 &lastUsed = infos[frame->openGlFrame.data()];
+            lastUsed = qMax(lastUsed, frame->lastUsed);
+        }
+
+        return infos;
+    }
+
+    qint64 memoryUsage() const
+    {
+        qint64 usage = 0;
+
+        QHash<KisOpenGLUpdateInfo*, quint64> infos = lastUsedInfos();
+        for (auto it = infos.constBegin(); it != infos.constEnd(); ++it) {
+            usage += it.key()->memoryUsage();
+        }
+
+        return usage;
+    }
+
+    void removeInfo(KisOpenGLUpdateInfo *info)
+    {
+        QMap<int, Frame*>::iterator it = frames.begin();
+
+        while (it != frames.end()) {
+            if (it.value()->openGlFrame.data() == info) {
+                delete it.value();
+                it = frames.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Evicts the least recently used frames until the cache fits into
+     * the memory limit. The frame being shown and \p protectedInfo are
+     * never evicted.
+     *
+     * \return true if any frames were evicted
+     */
+    bool enforceMemoryLimit(KisOpenGLUpdateInfo *protectedInfo)
+    {
+        if (memoryLimit <= 0) return false;
+
+        QHash<KisOpenGLUpdateInfo*, quint64> infos = lastUsedInfos();
+
+        qint64 usage = 0;
+        for (auto it = infos.constBegin(); it != infos.constEnd(); ++it) {
+            usage += it.key()->memoryUsage();
+        }
+
+        bool cacheChanged = false;
+
+        while (usage > memoryLimit) {
+            KisOpenGLUpdateInfo *victim = 0;
+            quint64 victimLastUsed = 0;
+
+            for (auto it = infos.constBegin(); it != infos.constEnd(); ++it) {
+                if (it.key() == protectedInfo || it.key() == lastUploadedFrame.data()) continue;
+
+                if (!victim || it.value() < victimLastUsed) {
+                    victim = it.key();
+                    victimLastUsed = it.value();
+                }
+            }
+
+            if (!victim) break;
+
+            usage -= victim->memoryUsage();
+            infos.remove(victim);
+            removeInfo(victim);
+
+            cacheChanged = true;
+        }
+
+        return cacheChanged;
+    }
+
     Frame *getFrame(int time)
     {
         if (frames.isEmpty()) return 0;
@@ -86,7 +209,7 @@ struct KisAnimationFrameCache::Private
         invalidate(range);
 
         int length = range.isInfinite() ? -1 : range.end() - range.start() + 1;
-        Frame *frame = new Frame(info, length);
+        Frame *frame = new Frame(info, length, ++useCounter);
 
         frames.insert(range.start(), frame);
     }
@@ -121,7 +244,7 @@ struct KisAnimationFrameCache::Private
                     // Reinsert with a later start
                     int newStart = range.end() + 1;
                     int newLength = frameIsInfinite ? -1 : (end - newStart + 1);
-                    frames.insert(newStart, new Frame(frame->openGlFrame, newLength));
+                    frames.insert(newStart, new Frame(frame->openGlFrame, newLength, frame->lastUsed));
                 }
 
                 it = frames.erase(it);
@@ -188,12 +311,97 @@ bool KisAnimationFrameCache::uploadFrame(int time)
     if (!frame) {
         KisPart::instance()->cachePopulator()->regenerate(this, time);
     } else {
-        m_d->textures->recalculateCache(frame->openGlFrame);
+        KisOpenGLUpdateInfoSP info = frame->openGlFrame;
+
+        // usually done by prefetchFrames() beforehand
+        info->decompressData();
+
+        m_d->textures->recalculateCache(info);
+
+        frame->lastUsed = ++m_d->useCounter;
+
+        if (m_d->lastUploadedFrame && m_d->lastUploadedFrame != info) {
+            m_d->lastUploadedFrame->releaseDecompressedData();
+        }
+        m_d->lastUploadedFrame = info;
     }
 
     return frame != 0;
 }
 
+void KisAnimationFrameCache::prefetchFrames(const QVector<int> &times)
+{
+    if (m_d->compressionId.isEmpty()) return;
+
+    QSet<KisOpenGLUpdateInfo*> window;
+    QVector<KisOpenGLUpdateInfoSP> infosToDecompress;
+
+    Q_FOREACH (int time, times) {
+        Private::Frame *frame = m_d->getFrame(time);
+        if (!frame || window.contains(frame->openGlFrame.data())) continue;
+
+        window.insert(frame->openGlFrame.data());
+
+        if (!frame->openGlFrame->isDecompressed()) {
+            infosToDecompress.append(frame->openGlFrame);
+        }
+    }
+
+    /**
+     * Only the frames in the window are kept decompressed, all the
+     * other frames occupy only their compressed size
+     */
+    Q_FOREACH (KisOpenGLUpdateInfo *info, m_d->lastUsedInfos().keys()) {
+        if (!window.contains(info) && info != m_d->lastUploadedFrame.data()) {
+            info->releaseDecompressedData();
+        }
+    }
+
+    /**
+     * If the previous batch is still running, the rest of the frames
+     * will be requested on the next call
+     */
+    if (!infosToDecompress.isEmpty() && m_d->prefetchFuture.isFinished()) {
+        m_d->prefetchFuture =
+            QtConcurrent::run([infosToDecompress] () {
+                Q_FOREACH (KisOpenGLUpdateInfoSP info, infosToDecompress) {
+                    info->decompressData();
+                }
+            });
+    }
+}
+
+QString KisAnimationFrameCache::compressionId() const
+{
+    return m_d->compressionId;
+}
+
+qint64 KisAnimationFrameCache::memoryUsage() const
+{
+    return m_d->memoryUsage();
+}
+
+bool KisAnimationFrameCache::memoryLimitReached() const
+{
+    if (m_d->memoryLimit <= 0) return false;
+
+    const int numFrames = m_d->lastUsedInfos().size();
+    if (!numFrames) return false;
+
+    // there should be enough space for one more frame of average size
+    const qint64 usage = m_d->memoryUsage();
+    return usage + usage / numFrames > m_d->memoryLimit;
+}
+
+void KisAnimationFrameCache::setMemoryLimit(qint64 bytes)
+{
+    m_d->memoryLimit = bytes;
+
+    if (m_d->enforceMemoryLimit(0)) {
+        emit changed();
+    }
+}
+
 KisAnimationFrameCache::CacheStatus KisAnimationFrameCache::frameStatus(int time) const
 {
     Private::Frame *frame = m_d->getFrame(time);
@@ -234,6 +442,7 @@ void KisAnimationFrameCache::addConvertedFrameData(KisOpenGLUpdateInfoSP info, i
     KisTimeRange::calculateTimeRangeRecursive(m_d->image->root(), time, identicalRange, true);
 
     m_d->addFrame(info, identicalRange);
+    m_d->enforceMemoryLimit(info.data());
 
     emit changed();
 }
@@ -21,6 +21,7 @@
 
 #include <QImage>
 #include <QObject>
+#include <QVector>
 
 #include "kritaui_export.h"
 #include "kis_types.h"
@@ -63,6 +64,34 @@ public:
     KisOpenGLUpdateInfoSP fetchFrameData(int time) const;
     void addConvertedFrameData(KisOpenGLUpdateInfoSP info, int time);
 
+    /**
+     * Decompresses the frames at \p times in a background thread, so
+     * that they are ready when the playhead reaches them. The frames not
+     * in the list are compressed back.
+     */
+    void prefetchFrames(const QVector<int> &times);
+
+    /**
+     * The id of the compression backend the frame data should be
+     * compressed with before adding to the cache, or an empty string
+     * if the frames are cached uncompressed
+     */
+    QString compressionId() const;
+
+    qint64 memoryUsage() const;
+
+    /**
+     * True if there is no space for one more frame without evicting
+     * the others. The cache populator stops at this point.
+     */
+    bool memoryLimitReached() const;
+
+    /**
+     * Sets the maximum size of the cache in bytes, zero means no limit.
+     * The default value is taken from KisConfig.
+     */
+    void setMemoryLimit(qint64 bytes);
+
 Q_SIGNALS:
     void changed();
 
@@ -532,6 +532,16 @@ void KisConfig::setAllowLCMSOptimization(bool allowLCMSOptimization)
     m_cfg.writeEntry("allowLCMSOptimization", allowLCMSOptimization);
 }
 
+bool KisConfig::useLutDisplayConversion(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("useLutDisplayConversion", false));
+}
+
+void KisConfig::setUseLutDisplayConversion(bool value)
+{
+    m_cfg.writeEntry("useLutDisplayConversion", value);
+}
+
 
 bool KisConfig::showRulers(bool defaultValue) const
 {
@@ -914,6 +924,16 @@ void KisConfig::setAutoSaveInterval(int seconds)  const
     return m_cfg.writeEntry("AutoSaveInterval", seconds);
 }
 
+bool KisConfig::backgroundAutoSave(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("BackgroundAutoSave", true));
+}
+
+void KisConfig::setBackgroundAutoSave(bool value) const
+{
+    m_cfg.writeEntry("BackgroundAutoSave", value);
+}
+
 bool KisConfig::backupFile(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("CreateBackupFile", true));
@@ -1625,6 +1645,48 @@ bool KisConfig::animationDropFrames(bool defaultValue) const
     return (defaultValue ? true : m_cfg.readEntry("animationDropFrames", true));
 }
 
+int KisConfig::animationCacheMemoryLimit(bool defaultValue) const
+{
+    return (defaultValue ? 2048 : m_cfg.readEntry("animationCacheMemoryLimit", 2048));
+}
+
+void KisConfig::setAnimationCacheMemoryLimit(int value)
+{
+    m_cfg.writeEntry("animationCacheMemoryLimit", value);
+}
+
+bool KisConfig::animationCacheCompression(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("animationCacheCompression", true));
+}
+
+void KisConfig::setAnimationCacheCompression(bool value)
+{
+    m_cfg.writeEntry("animationCacheCompression", value);
+}
+
+int KisConfig::animationRenderingClones(bool defaultValue) const
+{
+    const int defaultClones = qBound(1, QThread::idealThreadCount() / 2, 4);
+    return (defaultValue ? defaultClones : m_cfg.readEntry("animationRenderingClones", defaultClones));
+}
+
+void KisConfig::setAnimationRenderingClones(int value)
+{
+    m_cfg.writeEntry("animationRenderingClones", value);
+}
+
+int KisConfig::animationExportEncoders(bool defaultValue) const
+{
+    const int defaultEncoders = qBound(1, QThread::idealThreadCount() / 2, 4);
+    return (defaultValue ? defaultEncoders : m_cfg.readEntry("animationExportEncoders", defaultEncoders));
+}
+
+void KisConfig::setAnimationExportEncoders(int value)
+{
+    m_cfg.writeEntry("animationExportEncoders", value);
+}
+
 int KisConfig::scribbingUpdatesDelay(bool defaultValue) const
 {
     return (defaultValue ? 30 : m_cfg.readEntry("scribbingUpdatesDelay", 30));
@@ -139,6 +139,9 @@ public:
     bool allowLCMSOptimization(bool defaultValue = false) const;
     void setAllowLCMSOptimization(bool allowLCMSOptimization);
 
+    bool useLutDisplayConversion(bool defaultValue = false) const;
+    void setUseLutDisplayConversion(bool value);
+
     bool showRulers(bool defaultValue = false) const;
     void setShowRulers(bool rulers) const;
 
@@ -239,6 +242,13 @@ public:
     int autoSaveInterval(bool defaultValue = false) const;
     void setAutoSaveInterval(int seconds) const;
 
+    /**
+     * Autosave writes a copy-on-write snapshot of the image in a
+     * background thread instead of blocking the image while saving
+     */
+    bool backgroundAutoSave(bool defaultValue = false) const;
+    void setBackgroundAutoSave(bool value) const;
+
     bool backupFile(bool defaultValue = false) const;
     void setBackupFile(bool backupFile) const;
 
@@ -461,6 +471,31 @@ public:
     bool animationDropFrames(bool defaultValue = false) const;
     void setAnimationDropFrames(bool value);
 
+    /**
+     * The maximum amount of memory used by the animation frame cache
+     * of a single canvas, in MiB
+     */
+    int animationCacheMemoryLimit(bool defaultValue = false) const;
+    void setAnimationCacheMemoryLimit(int value);
+
+    bool animationCacheCompression(bool defaultValue = false) const;
+    void setAnimationCacheCompression(bool value);
+
+    /**
+     * The number of animation frames rendered simultaneously when
+     * exporting an animation. Every frame but the first one is rendered
+     * in a separate copy of the image.
+     */
+    int animationRenderingClones(bool defaultValue = false) const;
+    void setAnimationRenderingClones(int value);
+
+    /**
+     * The number of threads saving the frames of an exported
+     * animation to disk
+     */
+    int animationExportEncoders(bool defaultValue = false) const;
+    void setAnimationExportEncoders(int value);
+
     int scribbingUpdatesDelay(bool defaultValue = false) const;
     void setScribbingUpdatesDelay(int value);
 
@@ -23,6 +23,7 @@
 #include "kis_painting_assistant.h"
 #include "kis_coordinates_converter.h"
 #include "kis_debug.h"
+#include <kis_global.h>
 #include <kis_canvas2.h>
 
 #include <KoStore.h>
@@ -436,6 +437,24 @@ void KisPaintingAssistant::saveXmlList(QDomDocument& doc, QDomElement& assistant
     }
 }
 
+KisPaintingAssistantSP KisPaintingAssistant::clone(QMap<KisPaintingAssistantHandleSP, KisPaintingAssistantHandleSP> &handleMap) const
+{
+    const KisPaintingAssistantFactory *factory =
+        KisPaintingAssistantFactoryRegistry::instance()->get(d->id);
+    KIS_ASSERT_RECOVER_RETURN_VALUE(factory, KisPaintingAssistantSP());
+
+    KisPaintingAssistant *assistant = factory->createPaintingAssistant();
+
+    Q_FOREACH (const KisPaintingAssistantHandleSP handle, d->handles) {
+        if (!handleMap.contains(handle)) {
+            handleMap.insert(handle, new KisPaintingAssistantHandle(*handle));
+        }
+        assistant->addHandle(handleMap.value(handle));
+    }
+
+    return toQShared(assistant);
+}
+
 void KisPaintingAssistant::findHandleLocation() {
     QList<KisPaintingAssistantHandleSP> hHandlesList;
     QList<KisPaintingAssistantHandleSP> vHandlesList;
@@ -38,6 +38,7 @@ class QDomDocument;
 class QDomElement;
 
 #include <kis_shared_ptr.h>
+#include <kis_types.h>
 #include <KoGenericRegistry.h>
 
 class KisPaintingAssistantHandle;
@@ -108,6 +109,15 @@ public:
     QByteArray saveXml( QMap<KisPaintingAssistantHandleSP, int> &handleMap);
     void loadXml(KoStore *store, QMap<int, KisPaintingAssistantHandleSP> &handleMap, QString path);
     void saveXmlList(QDomDocument& doc, QDomElement& ssistantsElement, int count);
+
+    /**
+     * Creates a copy of the assistant with its own handles, e.g. for
+     * saving it in a background thread. Only the type and the handles
+     * are copied, so the copy is good for saving, not for painting.
+     * The handles shared by several assistants stay shared between
+     * their copies via \p handleMap.
+     */
+    KisPaintingAssistantSP clone(QMap<KisPaintingAssistantHandleSP, KisPaintingAssistantHandleSP> &handleMap) const;
     void findHandleLocation();
     KisPaintingAssistantHandleSP oppHandleOne();
 
@@ -17,6 +17,8 @@
 
 #include "kis_selection_decoration.h"
 
+#include <cmath>
+
 #include <QPainter>
 #include <QVarLengthArray>
 
@@ -42,11 +44,29 @@ static const unsigned int ANT_LENGTH = 4;
 static const unsigned int ANT_SPACE = 4;
 static const unsigned int ANT_ADVANCE_WIDTH = ANT_LENGTH + ANT_SPACE;
 
+/**
+ * The coarsest grid the outline preview is traced on, in powers of two
+ */
+static const int MAX_OUTLINE_LEVEL_OF_DETAIL = 4;
+
+/**
+ * Picks the level of detail of the outline so that the cells of its
+ * grid are not bigger than a screen pixel
+ */
+static int outlineLevelOfDetailForZoom(qreal zoom)
+{
+    if (zoom <= 0.0 || zoom >= 0.5) return 0;
+
+    const int lod = std::floor(std::log2(1.0 / zoom));
+    return qMin(lod, MAX_OUTLINE_LEVEL_OF_DETAIL);
+}
+
 KisSelectionDecoration::KisSelectionDecoration(QPointer<KisView>view)
     : KisCanvasDecoration("selection", view),
       m_signalCompressor(500 /*ms*/, KisSignalCompressor::FIRST_INACTIVE),
       m_offset(0),
-      m_mode(Ants)
+      m_mode(Ants),
+      m_outlineLevelOfDetail(0)
 {
     KritaUtils::initAntsPen(&m_antsPen, &m_outlinePen,
                             ANT_LENGTH, ANT_SPACE);
@@ -90,13 +110,13 @@ void KisSelectionDecoration::selectionChanged()
     KisSelectionSP selection = view()->selection();
 
     if (selection && selectionIsActive()) {
-        if ((m_mode == Ants && selection->outlineCacheValid()) ||
+        if ((m_mode == Ants && selection->outlinePreviewValid(m_outlineLevelOfDetail)) ||
             (m_mode == Mask && selection->thumbnailImageValid())) {
 
             m_signalCompressor.stop();
 
             if (m_mode == Ants) {
-                m_outlinePath = selection->outlineCache();
+                m_outlinePath = selection->outlinePreview(m_outlineLevelOfDetail);
                 m_antsTimer->start();
             } else {
                 m_thumbnailImage = selection->thumbnailImage();
@@ -127,7 +147,9 @@ void KisSelectionDecoration::slotStartUpdateSelection()
     KisConfig cfg;
     QColor maskColor = cfg.selectionOverlayMaskColor();
 
-    view()->image()->addSpontaneousJob(new KisUpdateOutlineJob(selection, m_mode == Mask, maskColor));
+    view()->image()->addSpontaneousJob(
+        new KisUpdateOutlineJob(selection, m_mode == Mask, maskColor,
+                                m_mode == Ants ? m_outlineLevelOfDetail : 0));
 }
 
 void KisSelectionDecoration::antsAttackEvent()
@@ -148,6 +170,18 @@ void KisSelectionDecoration::drawDecoration(QPainter& gc, const QRectF& updateRe
     Q_UNUSED(canvas);
 
     if (!selectionIsActive()) return;
+
+    if (m_mode == Ants) {
+        const int lod = outlineLevelOfDetailForZoom(converter->effectiveZoom());
+
+        if (lod != m_outlineLevelOfDetail) {
+            m_outlineLevelOfDetail = lod;
+
+            // the outline for the new zoom will be fetched (or recalculated) later
+            QMetaObject::invokeMethod(this, "selectionChanged", Qt::QueuedConnection);
+        }
+    }
+
     if ((m_mode == Ants && m_outlinePath.isEmpty()) ||
         (m_mode == Mask && m_thumbnailImage.isNull())) return;
 
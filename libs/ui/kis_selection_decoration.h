@@ -66,6 +66,9 @@ private:
     QPen m_antsPen;
     QPen m_outlinePen;
     Mode m_mode;
+
+    /// the level of detail of the outline suitable for the current zoom
+    int m_outlineLevelOfDetail;
 };
 
 #endif
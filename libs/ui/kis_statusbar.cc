@@ -298,6 +298,14 @@ void KisStatusBar::updateMemoryStatus()
               formatSize(stats.historicalMemorySize),
               formatSize(stats.swapSize));
 
+    if (stats.deduplicationEnabled) {
+        longStats +=
+            i18nc("tooltip on statusbar memory reporting button",
+                  "\nDeduplicated tiles:\t %1 (%2%)",
+                  stats.deduplicatedTiles,
+                  QString::number(stats.deduplicationRatio * 100.0, 'f', 1));
+    }
+
     QString shortStats = formatSize(stats.imageSize);
     QIcon icon;
     qint64 warnLevel = stats.tilesHardLimit - stats.tilesHardLimit / 8;
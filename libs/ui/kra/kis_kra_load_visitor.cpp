@@ -24,6 +24,7 @@
 #include <QRect>
 #include <QBuffer>
 #include <QByteArray>
+#include <QHash>
 
 #include <KoColorSpaceRegistry.h>
 #include <KoColorProfile.h>
@@ -56,6 +57,7 @@
 #include "kis_dom_utils.h"
 #include "kis_raster_keyframe_channel.h"
 #include "kis_paint_device_frames_interface.h"
+#include "kis_image_config.h"
 
 using namespace KRA;
 
@@ -111,6 +113,9 @@ KisKraLoadVisitor::KisKraLoadVisitor(KisImageWSP image,
         m_store->popDirectory();
     }
     m_syntaxVersion = syntaxVersion;
+
+    KisImageConfig cfg;
+    m_lazyTileLoading = cfg.lazyTileLoading();
 }
 
 void KisKraLoadVisitor::setExternalUri(const QString &uri)
@@ -391,15 +396,30 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
         return loadPaintDeviceFrame(device, location, SimpleDevicePolicy());
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
+        QHash<QString, int> loadedFrames;
 
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
             QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
             Q_ASSERT(!frameFilename.isEmpty());
 
+            /**
+             * The frames stored in the same file share the tiles
+             * copy-on-write instead of being read twice
+             */
+            if (loadedFrames.contains(frameFilename)) {
+                const int srcId = loadedFrames.value(frameFilename);
+
+                frameInterface->uploadFrame(srcId, id, device);
+                frameInterface->setFrameDefaultPixel(frameInterface->frameDefaultPixel(srcId), id);
+                continue;
+            }
+
             if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
                 return false;
             }
+
+            loadedFrames.insert(frameFilename, id);
         }
     }
 
@@ -410,7 +430,19 @@ template<class DevicePolicy>
 bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy)
 {
     if (m_store->open(location)) {
-        if (!policy.read(device, m_store->device())) {
+        KisMappedFileSP mappedFile = mappedFileForCurrentEntry();
+
+        bool result = false;
+
+        if (mappedFile) {
+            KisMappedFileDevice mappedDevice(mappedFile, m_store->rawDataOffset(), m_store->size());
+            mappedDevice.open(QIODevice::ReadOnly);
+            result = policy.read(device, &mappedDevice);
+        } else {
+            result = policy.read(device, m_store->device());
+        }
+
+        if (!result) {
             m_errorMessages << i18n("Could not read pixel data: %1.", location);
             device->disconnect();
             m_store->close();
@@ -435,6 +467,30 @@ bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QStr
     return true;
 }
 
+KisMappedFileSP KisKraLoadVisitor::mappedFileForCurrentEntry()
+{
+    if (!m_lazyTileLoading || m_store->rawDataOffset() < 0) {
+        return KisMappedFileSP();
+    }
+
+    if (!m_mappedFile) {
+        m_mappedFile = new KisMappedFile(m_store->localFileName());
+
+        if (!m_mappedFile->isValid()) {
+            warnFile << "Cannot map" << m_store->localFileName() << "the tiles will be loaded into memory";
+            m_lazyTileLoading = false;
+            m_mappedFile = 0;
+        }
+    }
+
+    if (m_mappedFile &&
+        m_store->rawDataOffset() + m_store->size() > m_mappedFile->size()) {
+
+        return KisMappedFileSP();
+    }
+
+    return m_mappedFile;
+}
 
 bool KisKraLoadVisitor::loadProfile(KisPaintDeviceSP device, const QString& location)
 {
@@ -26,6 +26,7 @@
 // kritaimage
 #include "kis_types.h"
 #include "kis_node_visitor.h"
+#include "tiles3/swap/kis_mapped_file.h"
 
 class KisFilterConfiguration;
 class KoStore;
@@ -67,6 +68,12 @@ private:
     template<class DevicePolicy>
     bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy);
 
+    /**
+     * Returns the mapped file of the store if the currently opened
+     * entry can be read from it lazily, null otherwise
+     */
+    KisMappedFileSP mappedFileForCurrentEntry();
+
     bool loadProfile(KisPaintDeviceSP device,  const QString& location);
     bool loadFilterConfiguration(KisFilterConfiguration* kfc, const QString& location);
     bool loadMetaData(KisNode* node);
@@ -84,6 +91,9 @@ private:
     QString m_name;
     int m_syntaxVersion;
     QStringList m_errorMessages;
+
+    bool m_lazyTileLoading;
+    KisMappedFileSP m_mappedFile;
 };
 
 #endif // KIS_KRA_LOAD_VISITOR_H_
@@ -23,6 +23,9 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include <KoColorProfile.h>
 #include <KoStore.h>
@@ -61,6 +64,13 @@
 
 using namespace KRA;
 
+/**
+ * The encoded frames wait in memory until they are written into the
+ * store, so their total size is limited. The size of a frame is
+ * estimated by its uncompressed pixel data.
+ */
+static const qint64 MAX_PENDING_BYTES = 256 * 1024 * 1024;
+
 KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<const KisNode*, QString> nodeFileNames)
     : KisNodeVisitor()
     , m_store(store)
@@ -68,11 +78,24 @@ KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<
     , m_name(name)
     , m_nodeFileNames(nodeFileNames)
     , m_writer(new KisStorePaintDeviceWriter(store))
+    , m_pendingBytes(0)
 {
+    KisConfig cfg;
+    m_compressPixelData = cfg.compressKra();
+
+    /**
+     * With a single thread there is nothing to overlap the encoding
+     * with, so the devices are written directly into the store
+     */
+    const int threads = QThreadPool::globalInstance()->maxThreadCount();
+    m_maxPendingBytes = threads > 1 ? MAX_PENDING_BYTES : 0;
 }
 
 KisKraSaveVisitor::~KisKraSaveVisitor()
 {
+    Q_FOREACH (const PendingFrame &frame, m_pendingFrames) {
+        frame.data.waitForFinished();
+    }
     delete m_writer;
 }
 
@@ -264,6 +287,10 @@ struct SimpleDevicePolicy
     const quint8* defaultPixel(KisPaintDeviceSP dev) const {
         return dev->defaultPixel();
     }
+
+    QRect extent(KisPaintDeviceSP dev) const {
+        return dev->extent();
+    }
 };
 
 struct FramedDevicePolicy
@@ -279,6 +306,10 @@ struct FramedDevicePolicy
         return dev->framesInterface()->frameDefaultPixel(m_frameId);
     }
 
+    QRect extent(KisPaintDeviceSP dev) const {
+        return dev->framesInterface()->frameBounds(m_frameId);
+    }
+
     int m_frameId;
 };
 
@@ -286,8 +317,7 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
                                         QString location)
 {
     // Layer data
-    KisConfig cfg;
-    m_store->setCompressionEnabled(cfg.compressKra());
+    m_store->setCompressionEnabled(m_compressPixelData);
 
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
     QList<int> frames;
@@ -300,6 +330,7 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
         savePaintDeviceFrame(device, location, SimpleDevicePolicy());
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
+        QSet<QString> savedFilenames;
 
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
@@ -307,6 +338,10 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
             QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
             Q_ASSERT(!frameFilename.isEmpty());
 
+            // the frames with equal content share the file
+            if (savedFilenames.contains(frameFilename)) continue;
+            savedFilenames.insert(frameFilename);
+
             if (!savePaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
                 return false;
             }
@@ -318,9 +353,67 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
 }
 
 
+class KisBufferPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    bool write(const QByteArray &data) {
+        m_data.append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) {
+        m_data.append(data, length);
+        return true;
+    }
+
+    QByteArray m_data;
+};
+
+/**
+ * Runs in the thread pool. A null array means the device failed
+ * to encode itself.
+ */
+template<class DevicePolicy>
+QByteArray encodePaintDeviceFrame(KisPaintDeviceSP device, DevicePolicy policy)
+{
+    KisBufferPaintDeviceWriter writer;
+    if (!policy.write(device, writer) || writer.m_data.isEmpty()) {
+        return QByteArray();
+    }
+    return writer.m_data;
+}
+
 template<class DevicePolicy>
 bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy)
 {
+    if (m_maxPendingBytes > 0) {
+        const QRect extent = policy.extent(device);
+        const int pixelSize = device->colorSpace()->pixelSize();
+
+        PendingFrame frame;
+        frame.location = location;
+        frame.defaultPixel = QByteArray((const char*)policy.defaultPixel(device), pixelSize);
+        frame.estimatedSize = qint64(extent.width()) * extent.height() * pixelSize;
+
+        /**
+         * Make room for the new frame first, so that the limit holds
+         * even while the frame is being encoded. A frame bigger than
+         * the limit is the only one in flight.
+         */
+        bool result = true;
+        while (!m_pendingFrames.isEmpty() &&
+               m_pendingBytes + frame.estimatedSize > m_maxPendingBytes) {
+
+            result &= writePendingFrame();
+        }
+
+        frame.data = QtConcurrent::run(std::bind(&encodePaintDeviceFrame<DevicePolicy>, device, policy));
+        m_pendingFrames.enqueue(frame);
+        m_pendingBytes += frame.estimatedSize;
+
+        return result;
+    }
+
     if (m_store->open(location)) {
         if (!policy.write(device, *m_writer)) {
             device->disconnect();
@@ -338,6 +431,49 @@ bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString lo
     return true;
 }
 
+bool KisKraSaveVisitor::writePendingFrame()
+{
+    PendingFrame frame = m_pendingFrames.dequeue();
+    m_pendingBytes -= frame.estimatedSize;
+
+    const QByteArray data = frame.data.result();
+
+    if (data.isNull()) {
+        m_errorMessages << i18n("Failed to save the pixel data to %1.", frame.location);
+        return false;
+    }
+
+    bool result = true;
+
+    m_store->setCompressionEnabled(m_compressPixelData);
+
+    if (m_store->open(frame.location)) {
+        result = m_store->write(data) == data.size();
+        m_store->close();
+    }
+    if (result && m_store->open(frame.location + ".defaultpixel")) {
+        m_store->write(frame.defaultPixel);
+        m_store->close();
+    }
+
+    m_store->setCompressionEnabled(true);
+
+    if (!result) {
+        m_errorMessages << i18n("Failed to save the pixel data to %1.", frame.location);
+    }
+
+    return result;
+}
+
+bool KisKraSaveVisitor::finishEncoding()
+{
+    bool result = true;
+    while (!m_pendingFrames.isEmpty()) {
+        result &= writePendingFrame();
+    }
+    return result;
+}
+
 bool KisKraSaveVisitor::saveAnnotations(KisLayer* layer)
 {
     if (!layer) return false;
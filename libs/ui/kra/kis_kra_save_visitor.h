@@ -20,6 +20,8 @@
 #ifndef KIS_KRA_SAVE_VISITOR_H_
 #define KIS_KRA_SAVE_VISITOR_H_
 
+#include <QFuture>
+#include <QQueue>
 #include <QRect>
 #include <QStringList>
 
@@ -65,10 +67,28 @@ public:
 
     bool visit(KisSelectionMask *mask);
 
+    /**
+     * The pixel data of the devices is encoded in the thread pool and
+     * written into the store in the order of visiting, a few devices
+     * behind the visitor. Call this method after the traversal to write
+     * the rest of the devices. The store must not be closed before that.
+     *
+     * @return false if any of the devices failed to be written
+     */
+    bool finishEncoding();
+
     /// @return a list with everything that went wrong while saving
     QStringList errorMessages() const;
 
 private:
+    struct PendingFrame {
+        QString location;
+        QByteArray defaultPixel;
+        qint64 estimatedSize;
+        QFuture<QByteArray> data;
+    };
+
+    bool writePendingFrame();
 
     bool savePaintDevice(KisPaintDeviceSP device, QString location);
 
@@ -91,6 +111,11 @@ private:
     QMap<const KisNode*, QString> m_nodeFileNames;
     KisPaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
+
+    bool m_compressPixelData;
+    qint64 m_maxPendingBytes;
+    qint64 m_pendingBytes;
+    QQueue<PendingFrame> m_pendingFrames;
 };
 
 #endif // KIS_KRA_SAVE_VISITOR_H_
@@ -182,6 +182,7 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageWSP image, const QStrin
         visitor.setExternalUri(uri);
 
     image->rootLayer()->accept(visitor);
+    visitor.finishEncoding();
 
     m_d->errorMessages.append(visitor.errorMessages());
     if (!m_d->errorMessages.isEmpty()) {
@@ -65,6 +65,7 @@ KisOpenGLImageTextures::KisOpenGLImageTextures()
     m_conversionFlags = KoColorConversionTransformation::HighQuality;
     if (cfg.useBlackPointCompensation()) m_conversionFlags |= KoColorConversionTransformation::BlackpointCompensation;
     if (!cfg.allowLCMSOptimization()) m_conversionFlags |= KoColorConversionTransformation::NoOptimization;
+    if (cfg.useLutDisplayConversion()) m_conversionFlags |= KoColorConversionTransformation::PrecomputedLut;
 
     m_useOcio = cfg.useOcio();
 }
@@ -29,6 +29,7 @@
 #include <KoColorConversionTransformation.h>
 #include <KoChannelInfo.h>
 #include <kis_lod_transform.h>
+#include "tiles3/swap/kis_abstract_compression.h"
 
 
 class KisTextureTileUpdateInfo;
@@ -51,6 +52,15 @@ public:
             return m_data.data();
         }
 
+        inline int size() const {
+            return m_size;
+        }
+
+        inline void reset() {
+            m_data.reset();
+            m_size = 0;
+        }
+
         inline void ensureNotSmaller(int size) {
             if (size > m_size) {
                 try {
@@ -213,6 +223,60 @@ public:
         return m_patchPixels.data();
     }
 
+    /**
+     * Compresses the pixels and frees the uncompressed buffer. Used by
+     * the animation frame cache to keep more frames in memory.
+     */
+    void compressData(KisAbstractCompression *compression) {
+        if (!m_patchPixels.data() || !m_patchPixelsLength) return;
+
+        QByteArray buffer(compression->outputBufferSize(m_patchPixelsLength), Qt::Uninitialized);
+        const qint32 compressedSize =
+            compression->compress(m_patchPixels.data(), m_patchPixelsLength,
+                                  reinterpret_cast<quint8*>(buffer.data()), buffer.size());
+
+        // incompressible data is kept as it is
+        if (!compressedSize || compressedSize >= qint32(m_patchPixelsLength)) return;
+
+        buffer.resize(compressedSize);
+        buffer.squeeze();
+
+        m_compressedPatchPixels = buffer;
+        m_patchPixels.reset();
+    }
+
+    /**
+     * Restores the pixels of a compressed tile. The compressed copy is
+     * kept, so the decompressed buffer can be dropped again with
+     * releaseDecompressedData()
+     */
+    void decompressData(KisAbstractCompression *compression) {
+        if (m_patchPixels.data() || m_compressedPatchPixels.isEmpty()) return;
+
+        m_patchPixels.ensureNotSmaller(m_patchPixelsLength);
+        compression->decompress(reinterpret_cast<const quint8*>(m_compressedPatchPixels.constData()),
+                                m_compressedPatchPixels.size(),
+                                m_patchPixels.data(), m_patchPixelsLength);
+    }
+
+    void releaseDecompressedData() {
+        if (!m_compressedPatchPixels.isEmpty()) {
+            m_patchPixels.reset();
+        }
+    }
+
+    inline bool isCompressed() const {
+        return !m_compressedPatchPixels.isEmpty();
+    }
+
+    inline bool isDecompressed() const {
+        return m_patchPixels.data() != 0;
+    }
+
+    inline qint64 memoryUsage() const {
+        return m_patchPixels.size() + m_compressedPatchPixels.size();
+    }
+
     inline int patchLevelOfDetail() const {
         return m_patchLevelOfDetail;
     }
@@ -291,6 +355,7 @@ private:
     QRect m_originalTileRect;
 
     ConversionCache::Buffer m_patchPixels;
+    QByteArray m_compressedPatchPixels;
     static ConversionCache m_patchPixelsCache;
     static ConversionCache m_conversionCache;
 };
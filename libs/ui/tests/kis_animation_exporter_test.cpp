@@ -28,6 +28,7 @@
 #include "KoColor.h"
 #include "kis_time_range.h"
 #include "kis_keyframe_channel.h"
+#include "kis_config.h"
 
 
 void KisAnimationExporterTest::testAnimationExport()
@@ -95,4 +96,86 @@ void KisAnimationExporterTest::testAnimationExport()
     */
 }
 
+/**
+ * Sets the number of the export encoders and renderers for the
+ * duration of a test and restores the old values afterwards
+ */
+struct KisExporterTestConfig
+{
+    KisExporterTestConfig(int encoders, int renderers) {
+        KisConfig cfg;
+        m_oldEncoders = cfg.animationExportEncoders();
+        m_oldRenderers = cfg.animationRenderingClones();
+        cfg.setAnimationExportEncoders(encoders);
+        cfg.setAnimationRenderingClones(renderers);
+    }
+
+    ~KisExporterTestConfig() {
+        KisConfig cfg;
+        cfg.setAnimationExportEncoders(m_oldEncoders);
+        cfg.setAnimationRenderingClones(m_oldRenderers);
+    }
+
+private:
+    int m_oldEncoders;
+    int m_oldRenderers;
+};
+
+void KisAnimationExporterTest::testExportWithSeveralEncoders()
+{
+    KisDocument *document = KisPart::instance()->createDocument();
+    QRect rect(0,0,64,64);
+    TestUtil::MaskParent p(rect);
+    document->setCurrentImage(p.image);
+    document->setFileBatchMode(true);
+    const KoColorSpace *cs = p.image->colorSpace();
+
+    KUndo2Command parentCommand;
+
+    KisKeyframeChannel *rasterChannel = p.layer->getKeyframeChannel(KisKeyframeChannel::Content.id());
+
+    QVector<QColor> colors;
+    colors << Qt::red << Qt::green << Qt::blue << Qt::yellow << Qt::cyan << Qt::magenta;
+
+    for (int time = 1; time < colors.size(); time++) {
+        rasterChannel->addKeyframe(time, &parentCommand);
+    }
+    p.image->animationInterface()->setFullClipRange(KisTimeRange::fromTime(0, colors.size() - 1));
+
+    KisPaintDeviceSP dev = p.layer->paintDevice();
+
+    for (int time = 0; time < colors.size(); time++) {
+        p.image->animationInterface()->switchCurrentTimeAsync(time);
+        p.image->waitForDone();
+        dev->fill(rect, KoColor(colors[time], cs));
+    }
+
+    KisExporterTestConfig config(3, 2);
+
+    const QString prefix = "export-encoders-test";
+
+    for (int time = 0; time < colors.size(); time++) {
+        QFile::remove(prefix + QString("%1.png").arg(time, 4, 10, QChar('0')));
+    }
+
+    KisAnimationExporter exporter(document, prefix + ".png", 0, colors.size() - 1);
+    QCOMPARE(exporter.exportAnimation(), KisImportExportFilter::OK);
+
+    for (int time = 0; time < colors.size(); time++) {
+        const QString filename = prefix + QString("%1.png").arg(time, 4, 10, QChar('0'));
+        QVERIFY2(QFile::exists(filename), filename.toLatin1());
+
+        QImage exported(filename);
+        QCOMPARE(exported.size(), rect.size());
+
+        QImage expected(rect.size(), QImage::Format_ARGB32);
+        expected.fill(colors[time].rgba());
+
+        QPoint pt;
+        if (!TestUtil::compareQImages(pt, exported.convertToFormat(QImage::Format_ARGB32), expected)) {
+            QFAIL(QString("Frame %1 differs at %2,%3").arg(time).arg(pt.x()).arg(pt.y()).toLatin1());
+        }
+    }
+}
+
 QTEST_MAIN(KisAnimationExporterTest)
@@ -27,6 +27,7 @@ class KisAnimationExporterTest : public QObject
 
 private Q_SLOTS:
     void testAnimationExport();
+    void testExportWithSeveralEncoders();
 
 };
 #endif
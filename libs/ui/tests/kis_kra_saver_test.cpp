@@ -19,6 +19,7 @@
 #include "kis_kra_saver_test.h"
 
 #include <QTest>
+#include <QSignalSpy>
 
 #include <QBitArray>
 
@@ -48,6 +49,7 @@
 #include "testutil.h"
 #include "kis_keyframe_channel.h"
 #include "kis_image_animation_interface.h"
+#include "kis_layer_composition.h"
 
 #include "kis_transform_mask_params_interface.h"
 
@@ -319,4 +321,182 @@ void KisKraSaverTest::testRoundTripAnimation()
 
 }
 
+KisDocument* createCloneLayerDocument(const QString &fileName)
+{
+    QRect imageRect(0,0,512,512);
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "test image");
+
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer1);
+    layer1->paintDevice()->fill(QRect(100, 100, 50, 50), KoColor(Qt::black, cs));
+
+    KisCloneLayerSP cloneLayer = new KisCloneLayer(layer1, image, "clone1", OPACITY_OPAQUE_U8);
+    cloneLayer->setX(200);
+    image->addNode(cloneLayer);
+
+    image->initialRefreshGraph();
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setCurrentImage(image);
+    doc->setUrl(QUrl::fromLocalFile(QDir::current().absoluteFilePath(fileName)));
+    doc->setAutoSave(0);
+
+    return doc;
+}
+
+void KisKraSaverTest::testRoundTripBackgroundAutoSave()
+{
+    QScopedPointer<KisDocument> doc(createCloneLayerDocument("bg_autosave_test.kra"));
+
+    const QString autoSaveFile = doc->autoSaveFile(doc->localFilePath());
+    QFile::remove(autoSaveFile);
+
+    QSignalSpy finishedSpy(doc.data(), SIGNAL(clearStatusBarMessage()));
+    QSignalSpy messageSpy(doc.data(), SIGNAL(statusBarMessage(QString)));
+
+    doc->setModified(true);
+    doc->startBackgroundAutoSave();
+
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(messageSpy.count(), 1); // "Autosaving...", but no error
+    QVERIFY(QFile::exists(autoSaveFile));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    QVERIFY(doc2->loadNativeFormat(autoSaveFile));
+
+    KisImageSP image2 = doc2->image();
+    image2->waitForDone();
+
+    KisNodeSP layer = TestUtil::findNode(image2->root(), "paint1");
+    KisNodeSP clone = TestUtil::findNode(image2->root(), "clone1");
+    QVERIFY(layer);
+    QVERIFY(clone);
+
+    // the clone layer is linked to the saved copy of its source
+    KisCloneLayer *cloneLayer = dynamic_cast<KisCloneLayer*>(clone.data());
+    QVERIFY(cloneLayer);
+    QCOMPARE(KisNodeSP(cloneLayer->copyFrom()), layer);
+
+    QCOMPARE(image2->projection()->exactBounds(),
+             QRect(100, 100, 50, 50) | QRect(300, 100, 50, 50));
+
+    QFile::remove(autoSaveFile);
+}
+
+void KisKraSaverTest::testBackgroundAutoSaveCompositionsAndTime()
+{
+    QScopedPointer<KisDocument> doc(createCloneLayerDocument("bg_autosave_test.kra"));
+    KisImageSP image = doc->image();
+
+    KisNodeSP layer = TestUtil::findNode(image->root(), "paint1");
+    QVERIFY(layer);
+
+    KisLayerComposition *composition = new KisLayerComposition(image, "composition1");
+    layer->setVisible(false);
+    composition->store();
+    layer->setVisible(true);
+    image->addComposition(composition);
+
+    image->animationInterface()->switchCurrentTimeAsync(7);
+    image->waitForDone();
+
+    const QString autoSaveFile = doc->autoSaveFile(doc->localFilePath());
+    QFile::remove(autoSaveFile);
+
+    QSignalSpy finishedSpy(doc.data(), SIGNAL(clearStatusBarMessage()));
+
+    doc->setModified(true);
+    doc->startBackgroundAutoSave();
+
+    QVERIFY(finishedSpy.wait(10000));
+    QVERIFY(QFile::exists(autoSaveFile));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    QVERIFY(doc2->loadNativeFormat(autoSaveFile));
+
+    KisImageSP image2 = doc2->image();
+    image2->waitForDone();
+
+    QCOMPARE(image2->animationInterface()->currentUITime(), 7);
+    QCOMPARE(image2->compositions().size(), 1);
+
+    KisLayerComposition *composition2 = image2->compositions().first();
+    QCOMPARE(composition2->name(), QString("composition1"));
+
+    // the composition refers to the saved copies of the layers
+    KisNodeSP layer2 = TestUtil::findNode(image2->root(), "paint1");
+    QVERIFY(layer2);
+    QVERIFY(layer2->visible());
+
+    composition2->apply();
+    QVERIFY(!layer2->visible());
+
+    QFile::remove(autoSaveFile);
+}
+
+void KisKraSaverTest::testBackgroundAutoSaveActiveNodes()
+{
+    QScopedPointer<KisDocument> doc(createCloneLayerDocument("bg_autosave_test.kra"));
+    KisImageSP image = doc->image();
+
+    image->barrierLock();
+    QScopedPointer<KisDocument> snapshot(doc->cloneForBackgroundSaving());
+    image->unlock();
+
+    KisImageSP snapshotImage = snapshot->image();
+    QVERIFY(snapshotImage != image);
+
+    vKisNodeSP nodes;
+    nodes << TestUtil::findNode(image->root(), "clone1");
+    nodes << TestUtil::findNode(image->root(), "paint1");
+
+    vKisNodeSP clonedNodes =
+        KisDocument::findClonedNodes(image->root(), snapshotImage->root(), nodes);
+
+    QCOMPARE(clonedNodes.size(), 2);
+    QCOMPARE(clonedNodes[0]->name(), QString("clone1"));
+    QCOMPARE(clonedNodes[1]->name(), QString("paint1"));
+    QCOMPARE(clonedNodes[0]->image().data(), snapshotImage.data());
+    QCOMPARE(clonedNodes[1]->image().data(), snapshotImage.data());
+
+    // the clone layer of the snapshot reads from the snapshot
+    KisCloneLayer *cloneLayer = dynamic_cast<KisCloneLayer*>(clonedNodes[0].data());
+    QVERIFY(cloneLayer);
+    QCOMPARE(KisNodeSP(cloneLayer->copyFrom()), clonedNodes[1]);
+
+    // the nodes of other graphs are skipped
+    vKisNodeSP foreignNodes;
+    foreignNodes << KisNodeSP(new KisPaintLayer(image, "foreign", OPACITY_OPAQUE_U8));
+    QVERIFY(KisDocument::findClonedNodes(image->root(), snapshotImage->root(), foreignNodes).isEmpty());
+}
+
+void KisKraSaverTest::testBackgroundAutoSaveRetry()
+{
+    QScopedPointer<KisDocument> doc(createCloneLayerDocument("bg_autosave_test.kra"));
+
+    // the directory doesn't exist, so the autosave fails
+    doc->setUrl(QUrl::fromLocalFile(QDir::current().absoluteFilePath("nonexistent_dir/bg_autosave_test.kra")));
+
+    QSignalSpy finishedSpy(doc.data(), SIGNAL(clearStatusBarMessage()));
+    QSignalSpy messageSpy(doc.data(), SIGNAL(statusBarMessage(QString)));
+
+    doc->setAutoSave(1);
+    doc->setModified(true);
+    doc->startBackgroundAutoSave();
+
+    QVERIFY(finishedSpy.wait(10000));
+
+    // "Autosaving..." and the error message
+    QCOMPARE(messageSpy.count(), 2);
+    QVERIFY(!QFile::exists(doc->autoSaveFile(doc->localFilePath())));
+
+    // the autosave timer is restarted, so the save is retried in a second
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(messageSpy.count(), 4);
+
+    doc->setAutoSave(0);
+    doc->setModified(false);
+}
+
 QTEST_MAIN(KisKraSaverTest)
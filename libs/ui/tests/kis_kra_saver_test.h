@@ -39,6 +39,11 @@ private Q_SLOTS:
 
     void testRoundTripAnimation();
 
+    void testRoundTripBackgroundAutoSave();
+    void testBackgroundAutoSaveCompositionsAndTime();
+    void testBackgroundAutoSaveActiveNodes();
+    void testBackgroundAutoSaveRetry();
+
 };
 
 #endif
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_update_info_test.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "canvas/kis_update_info.h"
+#include "tiles3/swap/kis_compression_registry.h"
+
+
+void KisUpdateInfoTest::testCompressFrameData()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 300, 200, cs, "test");
+
+    // half of the image is flat, the other half is noise
+    KisPaintDeviceSP projection = image->projection();
+    projection->fill(QRect(0, 0, 300, 100), KoColor(Qt::red, cs));
+
+    QVector<quint8> noise(300 * 100 * cs->pixelSize());
+    qsrand(1);
+    for (int i = 0; i < noise.size(); i++) {
+        noise[i] = qrand() % 256;
+    }
+    projection->writeBytes(noise.constData(), QRect(0, 100, 300, 100));
+
+    const int tileSize = 128;
+    KisOpenGLUpdateInfoSP info = new KisOpenGLUpdateInfo(ConversionOptions());
+
+    for (int row = 0; row * tileSize < image->height(); row++) {
+        for (int col = 0; col * tileSize < image->width(); col++) {
+            const QRect tileRect(col * tileSize, row * tileSize, tileSize, tileSize);
+
+            KisTextureTileUpdateInfoSP tileInfo(
+                new KisTextureTileUpdateInfo(col, row, tileRect, image->bounds(), image->bounds(), 0));
+
+            tileInfo->retrieveData(image, QBitArray(), false, 0);
+            info->tileList << tileInfo;
+        }
+    }
+
+    QVector<QByteArray> originalData;
+    Q_FOREACH (KisTextureTileUpdateInfoSP tileInfo, info->tileList) {
+        originalData << QByteArray((const char*)tileInfo->data(), tileInfo->patchPixelsLength());
+    }
+
+    const qint64 originalUsage = info->memoryUsage();
+    QVERIFY(info->isDecompressed());
+
+    info->compressData(KisCompressionRegistry::fallbackId());
+
+    QVERIFY(!info->isDecompressed());
+    QVERIFY(info->memoryUsage() < originalUsage);
+
+    info->decompressData();
+    QVERIFY(info->isDecompressed());
+
+    for (int i = 0; i < info->tileList.size(); i++) {
+        KisTextureTileUpdateInfoSP tileInfo = info->tileList[i];
+        QCOMPARE(QByteArray((const char*)tileInfo->data(), tileInfo->patchPixelsLength()), originalData[i]);
+    }
+
+    const qint64 compressedUsage = info->memoryUsage();
+    info->releaseDecompressedData();
+
+    QVERIFY(!info->isDecompressed());
+    QVERIFY(info->memoryUsage() < compressedUsage);
+
+    // decompressing twice is fine
+    info->decompressData();
+    info->decompressData();
+
+    for (int i = 0; i < info->tileList.size(); i++) {
+        KisTextureTileUpdateInfoSP tileInfo = info->tileList[i];
+        QCOMPARE(QByteArray((const char*)tileInfo->data(), tileInfo->patchPixelsLength()), originalData[i]);
+    }
+}
+
+QTEST_MAIN(KisUpdateInfoTest)
@@ -25,8 +25,38 @@
 #include <klocalizedstring.h>
 
 #include "LcmsColorSpace.h"
+#include "LcmsColorLut.h"
 
 #include <QDebug>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+/**
+ * The flags actually passed to lcms: optimizations are disabled for the
+ * linear profiles and Krita-specific flags are removed
+ */
+static quint32 lcmsConversionFlags(const KoColorSpace *srcCs,
+                                   LcmsColorProfileContainer *srcProfile,
+                                   LcmsColorProfileContainer *dstProfile,
+                                   KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    if (srcCs->colorDepthId() == Integer8BitsColorDepthID
+            || srcCs->colorDepthId() == Integer16BitsColorDepthID) {
+
+        if ((srcProfile->name().contains(QLatin1String("linear"), Qt::CaseInsensitive) ||
+                dstProfile->name().contains(QLatin1String("linear"), Qt::CaseInsensitive)) &&
+                !conversionFlags.testFlag(KoColorConversionTransformation::NoOptimization)) {
+            conversionFlags |= KoColorConversionTransformation::NoOptimization;
+        }
+    }
+
+    conversionFlags &= ~KoColorConversionTransformation::PrecomputedLut;
+
+    return conversionFlags;
+}
 
 // -- KoLcmsColorConversionTransformation --
 
@@ -36,49 +66,50 @@ public:
     KoLcmsColorConversionTransformation(const KoColorSpace *srcCs, quint32 srcColorSpaceType, LcmsColorProfileContainer *srcProfile,
                                         const KoColorSpace *dstCs, quint32 dstColorSpaceType, LcmsColorProfileContainer *dstProfile,
                                         Intent renderingIntent,
-                                        ConversionFlags conversionFlags)
+                                        ConversionFlags conversionFlags,
+                                        QSharedPointer<const LcmsColorLut> lut = QSharedPointer<const LcmsColorLut>())
         : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
         , m_transform(0)
+        , m_srcColorSpaceType(srcColorSpaceType)
+        , m_lut(lut)
     {
         Q_ASSERT(srcCs);
         Q_ASSERT(dstCs);
         Q_ASSERT(renderingIntent < 4);
 
-        if (srcCs->colorDepthId() == Integer8BitsColorDepthID
-                || srcCs->colorDepthId() == Integer16BitsColorDepthID) {
-
-            if ((srcProfile->name().contains(QLatin1String("linear"), Qt::CaseInsensitive) ||
-                    dstProfile->name().contains(QLatin1String("linear"), Qt::CaseInsensitive)) &&
-                    !conversionFlags.testFlag(KoColorConversionTransformation::NoOptimization)) {
-                conversionFlags |= KoColorConversionTransformation::NoOptimization;
-            }
-        }
+        if (m_lut) return;
 
         m_transform = cmsCreateTransform(srcProfile->lcmsProfile(),
                                          srcColorSpaceType,
                                          dstProfile->lcmsProfile(),
                                          dstColorSpaceType,
                                          renderingIntent,
-                                         conversionFlags);
+                                         lcmsConversionFlags(srcCs, srcProfile, dstProfile, conversionFlags));
 
         Q_ASSERT(m_transform);
     }
 
     ~KoLcmsColorConversionTransformation()
     {
-        cmsDeleteTransform(m_transform);
+        if (m_transform) {
+            cmsDeleteTransform(m_transform);
+        }
     }
 
 public:
 
     virtual void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const
     {
-        Q_ASSERT(m_transform);
+        Q_ASSERT(m_transform || m_lut);
 
         qint32 srcPixelSize = srcColorSpace()->pixelSize();
         qint32 dstPixelSize = dstColorSpace()->pixelSize();
 
-        cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
+        if (m_lut) {
+            m_lut->transform(src, m_srcColorSpaceType, dst, numPixels);
+        } else {
+            cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
+        }
 
         // Lcms does nothing to the destination alpha channel so we must convert that manually.
         while (numPixels > 0) {
@@ -93,11 +124,69 @@ public:
     }
 private:
     mutable cmsHTRANSFORM m_transform;
+    quint32 m_srcColorSpaceType;
+    QSharedPointer<const LcmsColorLut> m_lut;
 };
 
 struct IccColorSpaceEngine::Private {
+    /**
+     * The lookup tables are shared by all the transformations between
+     * the same pair of profiles, the cache holds only weak references,
+     * so a table is freed together with its last transformation
+     */
+    QMutex lutsMutex;
+    QHash<QByteArray, QWeakPointer<const LcmsColorLut> > luts;
+
+    QSharedPointer<const LcmsColorLut> lut(const IccColorProfile *srcProfile, quint32 srcColorSpaceType,
+                                           const IccColorProfile *dstProfile, quint32 dstColorSpaceType,
+                                           quint32 renderingIntent, quint32 conversionFlags);
 };
 
+QSharedPointer<const LcmsColorLut>
+IccColorSpaceEngine::Private::lut(const IccColorProfile *srcProfile, quint32 srcColorSpaceType,
+                                  const IccColorProfile *dstProfile, quint32 dstColorSpaceType,
+                                  quint32 renderingIntent, quint32 conversionFlags)
+{
+    QByteArray key;
+    key += QCryptographicHash::hash(srcProfile->rawData(), QCryptographicHash::Md5);
+    key += QCryptographicHash::hash(dstProfile->rawData(), QCryptographicHash::Md5);
+    key += QByteArray::number(srcColorSpaceType) + ':';
+    key += QByteArray::number(dstColorSpaceType) + ':';
+    key += QByteArray::number(renderingIntent) + ':';
+    key += QByteArray::number(conversionFlags);
+
+    QMutexLocker l(&lutsMutex);
+
+    QSharedPointer<const LcmsColorLut> result = luts.value(key).toStrongRef();
+
+    if (!result) {
+        LcmsColorLut *newLut =
+            new LcmsColorLut(srcProfile->asLcms()->lcmsProfile(),
+                             dstProfile->asLcms()->lcmsProfile(), dstColorSpaceType,
+                             renderingIntent, conversionFlags,
+                             LcmsColorLut::gridSizeForFlags(conversionFlags));
+
+        if (!newLut->isValid()) {
+            delete newLut;
+            return result;
+        }
+
+        result = QSharedPointer<const LcmsColorLut>(newLut);
+
+        for (auto it = luts.begin(); it != luts.end();) {
+            if (it.value().isNull()) {
+                it = luts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        luts.insert(key, result);
+    }
+
+    return result;
+}
+
 IccColorSpaceEngine::IccColorSpaceEngine() : KoColorSpaceEngine("icc", i18n("ICC Engine")), d(new Private)
 {
 }
@@ -155,10 +244,27 @@ KoColorConversionTransformation *IccColorSpaceEngine::createColorTransformation(
     Q_ASSERT(srcColorSpace);
     Q_ASSERT(dstColorSpace);
 
+    const IccColorProfile *srcProfile = dynamic_cast<const IccColorProfile *>(srcColorSpace->profile());
+    const IccColorProfile *dstProfile = dynamic_cast<const IccColorProfile *>(dstColorSpace->profile());
+
+    const quint32 srcColorSpaceType = computeColorSpaceType(srcColorSpace);
+    const quint32 dstColorSpaceType = computeColorSpaceType(dstColorSpace);
+
+    QSharedPointer<const LcmsColorLut> lut;
+
+    if (conversionFlags.testFlag(KoColorConversionTransformation::PrecomputedLut) &&
+        LcmsColorLut::isSupported(srcColorSpaceType, dstColorSpaceType)) {
+
+        lut = d->lut(srcProfile, srcColorSpaceType,
+                     dstProfile, dstColorSpaceType,
+                     renderingIntent,
+                     lcmsConversionFlags(srcColorSpace, srcProfile->asLcms(), dstProfile->asLcms(), conversionFlags));
+    }
+
     return new KoLcmsColorConversionTransformation(
-               srcColorSpace, computeColorSpaceType(srcColorSpace),
-               dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
-               dynamic_cast<const IccColorProfile *>(dstColorSpace->profile())->asLcms(), renderingIntent, conversionFlags);
+               srcColorSpace, srcColorSpaceType, srcProfile->asLcms(),
+               dstColorSpace, dstColorSpaceType, dstProfile->asLcms(),
+               renderingIntent, conversionFlags, lut);
 
 }
 quint32 IccColorSpaceEngine::computeColorSpaceType(const KoColorSpace *cs) const
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "LcmsColorLut.h"
+
+#include <QtGlobal>
+
+static const int FRACTION_BITS = 15;
+static const quint32 FRACTION_ONE = 1 << FRACTION_BITS;
+static const quint32 FRACTION_HALF = FRACTION_ONE >> 1;
+
+namespace {
+
+struct GridPosition {
+    quint16 index;
+    quint16 fraction;
+};
+
+/**
+ * For every 16-bit channel value stores the node of the grid lying
+ * below the value and the distance to it in 1/FRACTION_ONE of the cell
+ */
+QVector<GridPosition> createGridPositions(int gridSize)
+{
+    QVector<GridPosition> positions(65536);
+
+    for (int x = 0; x < 65536; x++) {
+        const quint64 t = quint64(x) * (gridSize - 1);
+        quint32 index = t / 65535;
+        quint32 fraction = ((t % 65535) * FRACTION_ONE + 32767) / 65535;
+
+        if (index >= quint32(gridSize - 1)) {
+            index = gridSize - 2;
+            fraction = FRACTION_ONE;
+        }
+
+        positions[x].index = index;
+        positions[x].fraction = fraction;
+    }
+
+    return positions;
+}
+
+const QVector<GridPosition>& gridPositions(int gridSize)
+{
+    static const QVector<GridPosition> positions33 = createGridPositions(33);
+    static const QVector<GridPosition> positions65 = createGridPositions(65);
+
+    return gridSize == 65 ? positions65 : positions33;
+}
+
+inline quint16 channelTo16(quint8 value) {
+    return quint16(value) * 257;
+}
+
+inline quint16 channelTo16(quint16 value) {
+    return value;
+}
+
+inline void channelFrom16(quint32 value, quint8 *dst) {
+    // the same rounding as lcms' FROM_16_TO_8
+    *dst = quint8((value * 65281 + 8388608) >> 24);
+}
+
+inline void channelFrom16(quint32 value, quint16 *dst) {
+    *dst = quint16(value);
+}
+
+}
+
+LcmsColorLut::LcmsColorLut(cmsHPROFILE srcProfile,
+                           cmsHPROFILE dstProfile, quint32 dstColorSpaceType,
+                           quint32 renderingIntent, quint32 conversionFlags,
+                           int gridSize)
+    : m_gridSize(gridSize == 65 ? 65 : 33),
+      m_dstBytes(T_BYTES(dstColorSpaceType)),
+      m_dstChannels(T_CHANNELS(dstColorSpaceType) + T_EXTRA(dstColorSpaceType)),
+      m_dstColorChannels(T_CHANNELS(dstColorSpaceType))
+{
+    const quint32 lutDstType = (dstColorSpaceType & ~BYTES_SH(7)) | BYTES_SH(2);
+
+    cmsHTRANSFORM transform =
+        cmsCreateTransform(srcProfile, TYPE_RGB_16,
+                           dstProfile, lutDstType,
+                           renderingIntent, conversionFlags);
+
+    if (!transform) return;
+
+    const int numNodes = m_gridSize * m_gridSize * m_gridSize;
+
+    QVector<quint16> nodes(3 * numNodes);
+    quint16 *nodePtr = nodes.data();
+
+    for (int r = 0; r < m_gridSize; r++) {
+        for (int g = 0; g < m_gridSize; g++) {
+            for (int b = 0; b < m_gridSize; b++) {
+                *nodePtr++ = quint16((r * 65535 + (m_gridSize - 1) / 2) / (m_gridSize - 1));
+                *nodePtr++ = quint16((g * 65535 + (m_gridSize - 1) / 2) / (m_gridSize - 1));
+                *nodePtr++ = quint16((b * 65535 + (m_gridSize - 1) / 2) / (m_gridSize - 1));
+            }
+        }
+    }
+
+    // lcms doesn't touch the extra channels, so they should be initialized
+    m_table.fill(0, numNodes * m_dstChannels);
+
+    cmsDoTransform(transform, nodes.constData(), m_table.data(), numNodes);
+    cmsDeleteTransform(transform);
+}
+
+bool LcmsColorLut::isSupported(quint32 srcColorSpaceType, quint32 dstColorSpaceType)
+{
+    const bool srcSupported =
+        srcColorSpaceType == TYPE_BGRA_8 ||
+        srcColorSpaceType == TYPE_BGRA_16;
+
+    const int dstBytes = T_BYTES(dstColorSpaceType);
+
+    /**
+     * The extra channels go after the color ones when the swap flags
+     * cancel each other (e.g. BGRA) or are both unset (e.g. RGBA)
+     */
+    const bool extraChannelsLast =
+        !T_EXTRA(dstColorSpaceType) ||
+        bool(T_DOSWAP(dstColorSpaceType)) == bool(T_SWAPFIRST(dstColorSpaceType));
+
+    const bool dstSupported =
+        extraChannelsLast &&
+        !T_FLOAT(dstColorSpaceType) &&
+        !T_PLANAR(dstColorSpaceType) &&
+        !T_ENDIAN16(dstColorSpaceType) &&
+        (dstBytes == 1 || dstBytes == 2);
+
+    return srcSupported && dstSupported;
+}
+
+int LcmsColorLut::gridSizeForFlags(quint32 conversionFlags)
+{
+    return conversionFlags & cmsFLAGS_HIGHRESPRECALC ? 65 : 33;
+}
+
+bool LcmsColorLut::isValid() const
+{
+    return !m_table.isEmpty();
+}
+
+int LcmsColorLut::gridSize() const
+{
+    return m_gridSize;
+}
+
+void LcmsColorLut::transform(const quint8 *src, quint32 srcColorSpaceType, quint8 *dst, qint32 numPixels) const
+{
+    Q_ASSERT(isValid());
+
+    const bool src16 = T_BYTES(srcColorSpaceType) == 2;
+    const bool dst16 = m_dstBytes == 2;
+
+    if (src16) {
+        if (dst16) {
+            transformImpl<quint16, quint16>(src, dst, numPixels);
+        } else {
+            transformImpl<quint16, quint8>(src, dst, numPixels);
+        }
+    } else {
+        if (dst16) {
+            transformImpl<quint8, quint16>(src, dst, numPixels);
+        } else {
+            transformImpl<quint8, quint8>(src, dst, numPixels);
+        }
+    }
+}
+
+template <typename SrcChannel, typename DstChannel>
+void LcmsColorLut::transformImpl(const quint8 *src, quint8 *dst, qint32 numPixels) const
+{
+    const GridPosition *positions = gridPositions(m_gridSize).constData();
+    const quint16 *table = m_table.constData();
+
+    const int channels = m_dstChannels;
+    const int colorChannels = m_dstColorChannels;
+    const int db = channels;
+    const int dg = db * m_gridSize;
+    const int dr = dg * m_gridSize;
+
+    const SrcChannel *srcPtr = reinterpret_cast<const SrcChannel*>(src);
+    DstChannel *dstPtr = reinterpret_cast<DstChannel*>(dst);
+
+    for (qint32 i = 0; i < numPixels; i++) {
+        // BGRA
+        const GridPosition &pr = positions[channelTo16(srcPtr[2])];
+        const GridPosition &pg = positions[channelTo16(srcPtr[1])];
+        const GridPosition &pb = positions[channelTo16(srcPtr[0])];
+
+        const quint32 rx = pr.fraction;
+        const quint32 ry = pg.fraction;
+        const quint32 rz = pb.fraction;
+
+        /**
+         * Tetrahedral interpolation: the cube is split into six
+         * tetrahedra sharing the main diagonal, the pixel is
+         * interpolated between the four vertices of the one it
+         * belongs to.
+         */
+        int o1, o2;
+        quint32 w0, w1, w2, w3;
+
+        if (rx >= ry) {
+            if (ry >= rz) {
+                o1 = dr; o2 = dr + dg;
+                w0 = FRACTION_ONE - rx; w1 = rx - ry; w2 = ry - rz; w3 = rz;
+            } else if (rx >= rz) {
+                o1 = dr; o2 = dr + db;
+                w0 = FRACTION_ONE - rx; w1 = rx - rz; w2 = rz - ry; w3 = ry;
+            } else {
+                o1 = db; o2 = dr + db;
+                w0 = FRACTION_ONE - rz; w1 = rz - rx; w2 = rx - ry; w3 = ry;
+            }
+        } else {
+            if (rx >= rz) {
+                o1 = dg; o2 = dr + dg;
+                w0 = FRACTION_ONE - ry; w1 = ry - rx; w2 = rx - rz; w3 = rz;
+            } else if (ry >= rz) {
+                o1 = dg; o2 = dg + db;
+                w0 = FRACTION_ONE - ry; w1 = ry - rz; w2 = rz - rx; w3 = rx;
+            } else {
+                o1 = db; o2 = dg + db;
+                w0 = FRACTION_ONE - rz; w1 = rz - ry; w2 = ry - rx; w3 = rx;
+            }
+        }
+
+        const quint16 *c0 = table + pr.index * dr + pg.index * dg + pb.index * db;
+        const quint16 *c1 = c0 + o1;
+        const quint16 *c2 = c0 + o2;
+        const quint16 *c3 = c0 + dr + dg + db;
+
+        /**
+         * The weights sum up to FRACTION_ONE, so the sum fits into
+         * 32 bits. The loop is simple enough to be vectorized by
+         * the compiler. The extra channels are left untouched.
+         */
+        for (int ch = 0; ch < colorChannels; ch++) {
+            const quint32 value =
+                (c0[ch] * w0 + c1[ch] * w1 + c2[ch] * w2 + c3[ch] * w3 + FRACTION_HALF) >> FRACTION_BITS;
+
+            channelFrom16(value, dstPtr + ch);
+        }
+
+        srcPtr += 4;
+        dstPtr += channels;
+    }
+}
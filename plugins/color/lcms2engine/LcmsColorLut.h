@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef LCMS_COLOR_LUT_H
+#define LCMS_COLOR_LUT_H
+
+#include <QVector>
+#include <lcms2.h>
+
+
+/**
+ * A color transformation baked into a 3D lookup table.
+ *
+ * The table is sampled with an exact lcms transformation once, on a grid
+ * of gridSize^3 RGB points, and the pixels are converted with tetrahedral
+ * interpolation between the nodes of the grid. It is much cheaper than
+ * cmsDoTransform() when lcms cannot optimize the transformation itself
+ * (e.g. for 16-bit data or with NoOptimization flag), at the cost of
+ * a small error near the black point, where the transfer curves are
+ * the steepest.
+ *
+ * Only BGRA 8- and 16-bit sources (the layout of Krita's integer RGB
+ * color spaces) and integer destinations with the extra channels placed
+ * after the color ones are supported, see isSupported(). Like lcms, the
+ * table writes only the color channels of the destination, the extra
+ * (alpha) channels are left untouched.
+ *
+ * The table is immutable after construction, so a single instance can
+ * be shared between the threads.
+ */
+class LcmsColorLut
+{
+public:
+    LcmsColorLut(cmsHPROFILE srcProfile,
+                 cmsHPROFILE dstProfile, quint32 dstColorSpaceType,
+                 quint32 renderingIntent, quint32 conversionFlags,
+                 int gridSize);
+
+    static bool isSupported(quint32 srcColorSpaceType, quint32 dstColorSpaceType);
+
+    /**
+     * The grid size used for the given lcms flags: the usual 33 points
+     * per axis or 65 points for cmsFLAGS_HIGHRESPRECALC
+     */
+    static int gridSizeForFlags(quint32 conversionFlags);
+
+    bool isValid() const;
+    int gridSize() const;
+
+    void transform(const quint8 *src, quint32 srcColorSpaceType, quint8 *dst, qint32 numPixels) const;
+
+private:
+    template <typename SrcChannel, typename DstChannel>
+    void transformImpl(const quint8 *src, quint8 *dst, qint32 numPixels) const;
+
+private:
+    int m_gridSize;
+    int m_dstBytes;
+    int m_dstChannels;
+    int m_dstColorChannels;
+
+    /**
+     * Every node stores a 16-bit pixel laid out as the destination one
+     */
+    QVector<quint16> m_table;
+};
+
+#endif /* LCMS_COLOR_LUT_H */
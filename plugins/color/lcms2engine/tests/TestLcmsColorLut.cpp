@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "TestLcmsColorLut.h"
+
+#include <QTest>
+#include <QVector>
+
+#include <lcms2.h>
+
+#include "LcmsColorLut.h"
+
+
+namespace {
+
+/**
+ * A wide gamut matrix-shaper profile (Adobe RGB primaries), so that the
+ * conversion from sRGB is far from being an identity
+ */
+cmsHPROFILE createWideGamutProfile()
+{
+    cmsCIExyY whitePoint;
+    cmsWhitePointFromTemp(&whitePoint, 6504);
+
+    cmsCIExyYTRIPLE primaries = {
+        {0.6400, 0.3300, 1.0},
+        {0.2100, 0.7100, 1.0},
+        {0.1500, 0.0600, 1.0}
+    };
+
+    cmsToneCurve *gamma = cmsBuildGamma(0, 2.19921875);
+    cmsToneCurve *curves[3] = {gamma, gamma, gamma};
+
+    cmsHPROFILE profile = cmsCreateRGBProfile(&whitePoint, &primaries, curves);
+    cmsFreeToneCurve(gamma);
+
+    return profile;
+}
+
+template <typename T>
+void fillRandomPixels(QVector<T> &pixels, int numPixels)
+{
+    const int maxValue = (1 << (8 * sizeof(T))) - 1;
+
+    pixels.resize(4 * numPixels);
+
+    qsrand(1);
+    for (int i = 0; i < pixels.size(); i++) {
+        pixels[i] = qrand() % (maxValue + 1);
+    }
+
+    // the corners of the cube
+    for (int i = 0; i < 8; i++) {
+        pixels[4 * i + 0] = i & 1 ? maxValue : 0;
+        pixels[4 * i + 1] = i & 2 ? maxValue : 0;
+        pixels[4 * i + 2] = i & 4 ? maxValue : 0;
+    }
+}
+
+template <typename SrcChannel, typename DstChannel>
+void compareWithLcms(quint32 srcType, quint32 dstType, quint32 flags,
+                     int maxDifference, qreal maxMeanDifference)
+{
+    const int numPixels = 50000;
+
+    cmsHPROFILE srcProfile = cmsCreate_sRGBProfile();
+    cmsHPROFILE dstProfile = createWideGamutProfile();
+
+    QVector<SrcChannel> src;
+    fillRandomPixels(src, numPixels);
+
+    QVector<DstChannel> exact(4 * numPixels, 0);
+    // the alpha channel should be left untouched, like lcms does
+    const DstChannel alphaMarker = 123;
+    QVector<DstChannel> interpolated(4 * numPixels, alphaMarker);
+
+    cmsHTRANSFORM transform =
+        cmsCreateTransform(srcProfile, srcType, dstProfile, dstType,
+                           INTENT_PERCEPTUAL, flags | cmsFLAGS_NOOPTIMIZE);
+    QVERIFY(transform);
+
+    cmsDoTransform(transform, src.constData(), exact.data(), numPixels);
+    cmsDeleteTransform(transform);
+
+    QVERIFY(LcmsColorLut::isSupported(srcType, dstType));
+
+    LcmsColorLut lut(srcProfile, dstProfile, dstType,
+                     INTENT_PERCEPTUAL, flags,
+                     LcmsColorLut::gridSizeForFlags(flags));
+    QVERIFY(lut.isValid());
+
+    lut.transform(reinterpret_cast<const quint8*>(src.constData()), srcType,
+                  reinterpret_cast<quint8*>(interpolated.data()), numPixels);
+
+    int maxDiff = 0;
+    qint64 sumDiff = 0;
+
+    for (int i = 0; i < exact.size(); i++) {
+        // lcms doesn't write alpha
+        if (i % 4 == 3) {
+            QCOMPARE(interpolated[i], alphaMarker);
+            continue;
+        }
+
+        const int diff = qAbs(int(exact[i]) - int(interpolated[i]));
+        maxDiff = qMax(maxDiff, diff);
+        sumDiff += diff;
+    }
+
+    const qreal meanDiff = qreal(sumDiff) / (3 * numPixels);
+
+    // the corners are the nodes of the grid, they are exact
+    for (int i = 0; i < 4 * 8; i++) {
+        if (i % 4 == 3) continue;
+        QVERIFY(qAbs(int(exact[i]) - int(interpolated[i])) <= 1);
+    }
+
+    QVERIFY2(maxDiff <= maxDifference,
+             QString("max difference: %1").arg(maxDiff).toLatin1());
+    QVERIFY2(meanDiff <= maxMeanDifference,
+             QString("mean difference: %1").arg(meanDiff).toLatin1());
+
+    cmsCloseProfile(srcProfile);
+    cmsCloseProfile(dstProfile);
+}
+
+}
+
+void TestLcmsColorLut::testSupportedTypes()
+{
+    QVERIFY(LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_BGRA_8));
+    QVERIFY(LcmsColorLut::isSupported(TYPE_BGRA_16, TYPE_BGRA_8));
+    QVERIFY(LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_CMYK5_16));
+
+    QVERIFY(!LcmsColorLut::isSupported(TYPE_RGBA_FLT, TYPE_BGRA_8));
+    QVERIFY(!LcmsColorLut::isSupported(TYPE_CMYK5_8, TYPE_BGRA_8));
+    QVERIFY(!LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_RGBA_FLT));
+    QVERIFY(!LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_BGRA_16_SE));
+    QVERIFY(!LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_ARGB_8));
+    QVERIFY(!LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_ABGR_8));
+    QVERIFY(LcmsColorLut::isSupported(TYPE_BGRA_8, TYPE_RGBA_8));
+}
+
+void TestLcmsColorLut::testCompareWithLcms_data()
+{
+    QTest::addColumn<int>("srcDepth");
+    QTest::addColumn<int>("dstDepth");
+    QTest::addColumn<quint32>("flags");
+    QTest::addColumn<int>("maxDifference");
+    QTest::addColumn<qreal>("maxMeanDifference");
+
+    /**
+     * The error is the biggest near the black point, where the
+     * transfer curve of the destination is the steepest
+     */
+    QTest::newRow("8-8") << 8 << 8 << quint32(0) << 6 << 0.1;
+    QTest::newRow("8-8-hires") << 8 << 8 << quint32(cmsFLAGS_HIGHRESPRECALC) << 4 << 0.05;
+    QTest::newRow("16-8") << 16 << 8 << quint32(0) << 6 << 0.1;
+    QTest::newRow("8-16") << 8 << 16 << quint32(0) << 1536 << 24.0;
+    QTest::newRow("16-16") << 16 << 16 << quint32(0) << 1536 << 24.0;
+    QTest::newRow("16-16-hires") << 16 << 16 << quint32(cmsFLAGS_HIGHRESPRECALC) << 1024 << 12.0;
+}
+
+void TestLcmsColorLut::testCompareWithLcms()
+{
+    QFETCH(int, srcDepth);
+    QFETCH(int, dstDepth);
+    QFETCH(quint32, flags);
+    QFETCH(int, maxDifference);
+    QFETCH(qreal, maxMeanDifference);
+
+    if (srcDepth == 8 && dstDepth == 8) {
+        compareWithLcms<quint8, quint8>(TYPE_BGRA_8, TYPE_BGRA_8, flags, maxDifference, maxMeanDifference);
+    } else if (srcDepth == 16 && dstDepth == 8) {
+        compareWithLcms<quint16, quint8>(TYPE_BGRA_16, TYPE_BGRA_8, flags, maxDifference, maxMeanDifference);
+    } else if (srcDepth == 8 && dstDepth == 16) {
+        compareWithLcms<quint8, quint16>(TYPE_BGRA_8, TYPE_BGRA_16, flags, maxDifference, maxMeanDifference);
+    } else {
+        compareWithLcms<quint16, quint16>(TYPE_BGRA_16, TYPE_BGRA_16, flags, maxDifference, maxMeanDifference);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestLcmsColorLut)
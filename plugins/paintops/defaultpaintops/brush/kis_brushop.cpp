@@ -24,6 +24,10 @@
 #include "kis_brushop.h"
 
 #include <QRect>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <functional>
 
 #include <kis_image.h>
 #include <kis_vec.h>
@@ -33,6 +37,7 @@
 #include <KoColor.h>
 
 #include <kis_brush.h>
+#include <kis_auto_brush.h>
 #include <kis_global.h>
 #include <kis_paint_device.h>
 #include <kis_painter.h>
@@ -41,10 +46,25 @@
 #include <kis_pressure_sharpness_option.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_lod_transform.h>
+#include <kis_image_config.h>
+#include <kis_dab_cache.h>
+
+/**
+ * Dabs smaller than that are rendered faster than a job is scheduled
+ */
+static const int MIN_ASYNC_DAB_AREA = 128 * 128;
+
+/**
+ * Every slot keeps the last dab it rendered, so both the number of the
+ * slots and the total size of the dabs in flight are limited
+ */
+static const int MAX_DAB_SLOTS = 4;
+static const qint64 MAX_PENDING_DABS_BYTES = 64 * 1024 * 1024;
 
 
 KisBrushOp::KisBrushOp(const KisBrushBasedPaintOpSettings *settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
-    : KisBrushBasedPaintOp(settings, painter), m_opacityOption(node), m_hsvTransformation(0)
+    : KisBrushBasedPaintOp(settings, painter), m_opacityOption(node), m_hsvTransformation(0),
+      m_asyncDabsAllowed(false), m_runAheadDepth(0)
 {
     Q_UNUSED(image);
     Q_ASSERT(settings);
@@ -87,10 +107,30 @@ KisBrushOp::KisBrushOp(const KisBrushBasedPaintOpSettings *settings, KisPainter
 
     m_dabCache->setSharpnessPostprocessing(&m_sharpnessOption);
     m_rotationOption.applyFanCornersInfo(this);
+
+    /**
+     * Only the auto brush generates its mask from scratch for every
+     * dab, so only it gains from the parallel rendering. The
+     * postprocessing options need the state of the dab cache, which
+     * cannot be shared between the jobs.
+     */
+    KisImageConfig cfg;
+    m_asyncDabsAllowed =
+        cfg.parallelDabRendering() &&
+        QThreadPool::globalInstance()->maxThreadCount() > 1 &&
+        dynamic_cast<KisAutoBrush*>(m_brush.data()) &&
+        !m_sharpnessOption.isChecked() &&
+        !m_mirrorOption.isChecked() &&
+        !m_textureProperties.m_enabled;
 }
 
 KisBrushOp::~KisBrushOp()
 {
+    Q_FOREACH (const PendingDab &pending, m_pendingDabs) {
+        pending.result.waitForFinished();
+    }
+    m_pendingDabs.clear();
+
     qDeleteAll(m_hsvOptions);
     delete m_colorSource;
     delete m_hsvTransformation;
@@ -120,10 +160,11 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
     setCurrentScale(scale);
     setCurrentRotation(rotation);
 
+    const int dabWidth = brush->maskWidth(scale, rotation, 0, 0, info);
+    const int dabHeight = brush->maskHeight(scale, rotation, 0, 0, info);
+
     QPointF cursorPos =
-        m_scatterOption.apply(info,
-                              brush->maskWidth(scale, rotation, 0, 0, info),
-                              brush->maskHeight(scale, rotation, 0, 0, info));
+        m_scatterOption.apply(info, dabWidth, dabHeight);
 
     quint8 origOpacity = painter()->opacity();
 
@@ -139,6 +180,23 @@ KisSpacingInformation KisBrushOp::paintAt(const KisPaintInformation& info)
         m_colorSource->applyColorTransformation(m_hsvTransformation);
     }
 
+    if (m_runAheadDepth > 0 && canRenderDabAsynchronously(dabWidth, dabHeight)) {
+        renderDabAsynchronously(device->compositionSourceColorSpace(),
+                                dabWidth, dabHeight,
+                                cursorPos,
+                                scale, rotation,
+                                info,
+                                m_softnessOption.apply(info));
+
+        painter()->setOpacity(origOpacity);
+
+        return effectiveSpacing(scale, rotation,
+                                m_spacingOption, info);
+    }
+
+    // the dabs should reach the device in the order they were painted
+    finishAsynchronousDabs();
+
     QRect dabRect;
     KisFixedPaintDeviceSP dab = m_dabCache->fetchDab(device->compositionSourceColorSpace(),
                                 m_colorSource,
@@ -186,6 +244,170 @@ void KisBrushOp::paintLine(const KisPaintInformation& pi1, const KisPaintInforma
 	painter()->renderMirrorMask(rc, m_lineCacheDevice);
     }
     else {
+        m_runAheadDepth++;
         KisPaintOp::paintLine(pi1, pi2, currentDistance);
+        m_runAheadDepth--;
+
+        if (!m_runAheadDepth) {
+            finishAsynchronousDabs();
+        }
+    }
+}
+
+void KisBrushOp::paintBezierCurve(const KisPaintInformation &pi1,
+                                  const QPointF &control1,
+                                  const QPointF &control2,
+                                  const KisPaintInformation &pi2,
+                                  KisDistanceInformation *currentDistance)
+{
+    /**
+     * The curve is split into lines, let the dabs run ahead over
+     * all of them
+     */
+    m_runAheadDepth++;
+    KisPaintOp::paintBezierCurve(pi1, control1, control2, pi2, currentDistance);
+    m_runAheadDepth--;
+
+    if (!m_runAheadDepth) {
+        finishAsynchronousDabs();
+    }
+}
+
+KisBrushOp::RenderedDab KisBrushOp::renderDab(KisDabCache *dabCache,
+                                              const KoColorSpace *cs,
+                                              const KoColor &color,
+                                              const QPointF &cursorPos,
+                                              qreal scale, qreal rotation,
+                                              const KisPaintInformation &info,
+                                              qreal softness)
+{
+    RenderedDab rendered;
+    rendered.dab = dabCache->fetchDab(cs, color,
+                                      cursorPos,
+                                      scale, scale,
+                                      rotation,
+                                      info,
+                                      softness,
+                                      &rendered.rect);
+    return rendered;
+}
+
+bool KisBrushOp::canRenderDabAsynchronously(int dabWidth, int dabHeight) const
+{
+    return m_asyncDabsAllowed &&
+        m_colorSource->isUniformColor() &&
+        dabWidth * dabHeight >= MIN_ASYNC_DAB_AREA;
+}
+
+void KisBrushOp::renderDabAsynchronously(const KoColorSpace *cs,
+                                         int dabWidth, int dabHeight,
+                                         const QPointF &cursorPos,
+                                         qreal scale, qreal rotation,
+                                         const KisPaintInformation &info,
+                                         qreal softness)
+{
+    if (m_dabSlots.isEmpty()) {
+        const int numSlots = qBound(2, QThreadPool::globalInstance()->maxThreadCount(), MAX_DAB_SLOTS);
+
+        for (int i = 0; i < numSlots; i++) {
+            DabSlot slot;
+            slot.brush = m_brush->clone();
+
+            /**
+             * The dabs are already rendered in parallel, so the mask
+             * of every single dab is generated in one thread
+             */
+            KisAutoBrush *autoBrush = dynamic_cast<KisAutoBrush*>(slot.brush.data());
+            KIS_ASSERT_RECOVER_NOOP(autoBrush);
+            if (autoBrush) {
+                autoBrush->setThreadCount(1);
+            }
+
+            slot.dabCache = QSharedPointer<KisDabCache>(new KisDabCache(slot.brush));
+            slot.dabCache->setPrecisionOption(&m_precisionOption);
+            m_dabSlots << slot;
+        }
+    }
+
+    /**
+     * The bigger the dabs, the fewer of them are rendered at once. The
+     * free slots with the lowest indexes are used first, so the slots
+     * not needed for the big dabs don't allocate memory for them.
+     */
+    const qint64 dabBytes = qint64(dabWidth) * dabHeight * cs->pixelSize();
+    const int maxPendingDabs =
+        qBound(qint64(1), MAX_PENDING_DABS_BYTES / qMax(qint64(1), dabBytes), qint64(m_dabSlots.size()));
+
+    while (m_pendingDabs.size() >= maxPendingDabs) {
+        blitPendingDab();
+    }
+
+    int slotIndex = 0;
+    while (m_dabSlots[slotIndex].busy) {
+        slotIndex++;
+    }
+
+    DabSlot &slot = m_dabSlots[slotIndex];
+    slot.busy = true;
+
+    /**
+     * The job should not reference the distance information of the
+     * stroke, it is changed while the dab is being rendered
+     */
+    KisPaintInformation detachedInfo(info.pos(),
+                                     info.pressure(),
+                                     info.xTilt(),
+                                     info.yTilt(),
+                                     info.rotation(),
+                                     info.tangentialPressure(),
+                                     info.perspective(),
+                                     info.currentTime(),
+                                     info.drawingSpeed());
+
+    PendingDab pending;
+    pending.opacity = painter()->opacity();
+    pending.flow = painter()->flow();
+    pending.slot = slotIndex;
+    pending.result =
+        QtConcurrent::run(std::bind(&KisBrushOp::renderDab,
+                                    slot.dabCache.data(),
+                                    cs,
+                                    m_colorSource->uniformColor(),
+                                    cursorPos,
+                                    scale, rotation,
+                                    detachedInfo,
+                                    softness));
+
+    m_pendingDabs.enqueue(pending);
+}
+
+void KisBrushOp::blitPendingDab()
+{
+    PendingDab pending = m_pendingDabs.dequeue();
+    RenderedDab rendered = pending.result.result();
+
+    const quint8 origOpacity = painter()->opacity();
+    const quint8 origFlow = painter()->flow();
+
+    painter()->setOpacity(pending.opacity);
+    painter()->setFlow(pending.flow);
+
+    painter()->bltFixed(rendered.rect.topLeft(), rendered.dab, rendered.dab->bounds());
+    painter()->renderMirrorMaskSafe(rendered.rect, rendered.dab, true);
+
+    painter()->setOpacity(origOpacity);
+    painter()->setFlow(origFlow);
+
+    /**
+     * The dab belongs to the dab cache of the slot, so the slot
+     * can be reused only after blitting
+     */
+    m_dabSlots[pending.slot].busy = false;
+}
+
+void KisBrushOp::finishAsynchronousDabs()
+{
+    while (!m_pendingDabs.isEmpty()) {
+        blitPendingDab();
     }
 }
@@ -23,6 +23,11 @@
 #ifndef KIS_BRUSHOP_H_
 #define KIS_BRUSHOP_H_
 
+#include <QFuture>
+#include <QQueue>
+#include <QRect>
+#include <QSharedPointer>
+
 #include "kis_brush_based_paintop.h"
 #include <kis_pressure_darken_option.h>
 #include <kis_pressure_flow_opacity_option.h>
@@ -42,6 +47,9 @@ class KisBrushBasedPaintOpSettings;
 
 class KisPainter;
 class KisColorSource;
+class KisDabCache;
+class KoColor;
+class KoColorSpace;
 
 
 class KisBrushOp : public KisBrushBasedPaintOp
@@ -54,6 +62,53 @@ public:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info);
     void paintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2, KisDistanceInformation *currentDistance);
+    void paintBezierCurve(const KisPaintInformation &pi1,
+                          const QPointF &control1,
+                          const QPointF &control2,
+                          const KisPaintInformation &pi2,
+                          KisDistanceInformation *currentDistance);
+
+private:
+    struct RenderedDab {
+        KisFixedPaintDeviceSP dab;
+        QRect rect;
+    };
+
+    struct PendingDab {
+        QFuture<RenderedDab> result;
+        quint8 opacity;
+        quint8 flow;
+        int slot;
+    };
+
+    /**
+     * A brush and a dab cache owned by a single worker job at a time
+     */
+    struct DabSlot {
+        DabSlot() : busy(false) {}
+
+        KisBrushSP brush;
+        QSharedPointer<KisDabCache> dabCache;
+        bool busy;
+    };
+
+    static RenderedDab renderDab(KisDabCache *dabCache,
+                                 const KoColorSpace *cs,
+                                 const KoColor &color,
+                                 const QPointF &cursorPos,
+                                 qreal scale, qreal rotation,
+                                 const KisPaintInformation &info,
+                                 qreal softness);
+
+    bool canRenderDabAsynchronously(int dabWidth, int dabHeight) const;
+    void renderDabAsynchronously(const KoColorSpace *cs,
+                                 int dabWidth, int dabHeight,
+                                 const QPointF &cursorPos,
+                                 qreal scale, qreal rotation,
+                                 const KisPaintInformation &info,
+                                 qreal softness);
+    void blitPendingDab();
+    void finishAsynchronousDabs();
 
 private:
     KisColorSource *m_colorSource;
@@ -72,6 +127,11 @@ private:
     KoColorTransformation *m_hsvTransformation;
     KisPaintDeviceSP m_lineCacheDevice;
     KisPaintDeviceSP m_colorSourceDevice;
+
+    bool m_asyncDabsAllowed;
+    int m_runAheadDepth;
+    QVector<DabSlot> m_dabSlots;
+    QQueue<PendingDab> m_pendingDabs;
 };
 
 #endif // KIS_BRUSHOP_H_
@@ -27,6 +27,9 @@
 #include <brushengine/kis_paintop_settings.h>
 #include <kis_pressure_mirror_option.h>
 #include <kis_pressure_rotation_option.h>
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+#include <kis_image_config.h>
 
 class TestBrushOp : public TestUtil::QImageBasedTest
 {
@@ -235,4 +238,71 @@ void KisBrushOpTest::testMagicSeven()
     t.test();
 }
 
+/**
+ * Paints a line with a big auto brush, the dabs of which are rendered
+ * in parallel when the option is enabled
+ */
+KisPaintDeviceSP paintBigAutoBrushLine(bool parallelDabs)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), 800, 600, cs, "parallel dabs test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    QScopedPointer<KoCanvasResourceManager> manager(
+        utils::createResourceManager(image, layer, "LR_simple.kpp"));
+
+    KisPaintOpPresetSP preset =
+        manager->resource(KisCanvasResourceProvider::CurrentPaintOpPreset).value<KisPaintOpPresetSP>();
+
+    KisAutoBrush brush(new KisCircleMaskGenerator(300, 1.0, 0.5, 0.5, 2, true), 0.0, 0.0);
+    brush.setSpacing(0.1);
+
+    QDomDocument doc;
+    QDomElement brushElement = doc.createElement("Brush");
+    brush.toXML(doc, brushElement);
+    doc.appendChild(brushElement);
+    preset->settings()->setProperty("brush_definition", doc.toString());
+
+    KisImageConfig cfg;
+    const bool oldParallelDabs = cfg.parallelDabRendering();
+    cfg.setParallelDabRendering(parallelDabs);
+
+    KisResourcesSnapshotSP resources =
+        new KisResourcesSnapshot(image,
+                                 layer,
+                                 image->postExecutionUndoAdapter(),
+                                 manager.data());
+
+    KisPainter gc(layer->paintDevice());
+    resources->setupPainter(&gc);
+
+    KisDistanceInformation dist;
+    gc.paintLine(KisPaintInformation(QPointF(200, 200), 1.0),
+                 KisPaintInformation(QPointF(600, 400), 1.0),
+                 &dist);
+
+    cfg.setParallelDabRendering(oldParallelDabs);
+
+    return layer->paintDevice();
+}
+
+void KisBrushOpTest::testParallelDabRendering()
+{
+    KisPaintDeviceSP serialDevice = paintBigAutoBrushLine(false);
+    KisPaintDeviceSP parallelDevice = paintBigAutoBrushLine(true);
+
+    const QRect rc = serialDevice->exactBounds();
+    QVERIFY(!rc.isEmpty());
+    QCOMPARE(parallelDevice->exactBounds(), rc);
+
+    QImage serialImage = serialDevice->convertToQImage(0, rc);
+    QImage parallelImage = parallelDevice->convertToQImage(0, rc);
+
+    QPoint pt;
+    if (!TestUtil::compareQImages(pt, serialImage, parallelImage)) {
+        QFAIL(QString("The dabs rendered in parallel differ at %1,%2").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+}
+
 QTEST_MAIN(KisBrushOpTest)
@@ -28,6 +28,7 @@ private Q_SLOTS:
     void testRotationMirroring();
     void testRotationMirroringDrawingAngle();
     void testMagicSeven();
+    void testParallelDabRendering();
 };
 
 #endif /* __KIS_BRUSHOP_TEST_H */